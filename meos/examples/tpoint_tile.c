@@ -60,7 +60,8 @@ int main(void)
 
   bool spacesplit = true; /* Set this parameter to enable/disable space split */
   bool timesplit = true; /* Set this parameter to enable/disable time split */
-  bool bitmatrix = true; /* Set this parameter to enable/disable the bit matrix */
+  bool bitmatrix = true; /* Set this parameter to enable/disable the split
+                            over the tiles traversed by the temporal point */
   bool border_inc = true; /* Set this parameter to include/exclude the upper
                              border of the extent */
 
@@ -105,7 +106,7 @@ int main(void)
   /* Print information about the result */
   printf("\nNumber of fragments: %d\n", count);
   if (bitmatrix)
-    printf("Using a bitmatrix for the fragmentation\n");
+    printf("Using the tiles traversed by the temporal point for the fragmentation\n");
 
   /* Finalize MEOS */
   meos_finalize();
@@ -54,6 +54,26 @@ typedef struct
   Match *path;
 } SimilarityPathState;
 
+/**
+ * Structure to represent the state of an online simplifier
+ */
+struct SimplifyState
+{
+  double dist;          /**< Distance threshold */
+  bool syncdist;        /**< True when using the Synchronized Distance */
+  bool squishe;         /**< True when using SQUISH-E, false when using the
+                             opening window method */
+  int maxpts;           /**< Maximum number of instants in the window */
+  int count;            /**< Number of instants in the window */
+  TInstant **window;    /**< Instants in the window */
+  double *priority;     /**< Priority of the instants for SQUISH-E */
+  double *error;        /**< Error propagated by the removed instants for
+                             SQUISH-E */
+  int nemitted;         /**< Number of instants ready to be emitted */
+  int maxemitted;       /**< Size of the array of emitted instants */
+  TInstant **emitted;   /**< Instants ready to be emitted */
+};
+
 /*****************************************************************************/
 
 extern double temporal_similarity(const Temporal *temp1, const Temporal *temp2,
@@ -119,6 +119,10 @@ extern Temporal **temporal_time_split(const Temporal *temp, const Interval *dura
 extern Temporal **tnumber_value_time_split(const Temporal *temp, Datum size,
   const Interval *duration, Datum vorigin, TimestampTz torigin,
   Datum **value_buckets, TimestampTz **time_buckets, int *count);
+extern double *tnumber_value_time_histogram(const Temporal *temp, Datum size,
+  const Interval *duration, Datum vorigin, TimestampTz torigin,
+  Datum *value_start, TimestampTz *time_start, int *value_count,
+  int *time_count);
 
 /*****************************************************************************/
 
@@ -179,6 +179,18 @@ typedef enum
   COVERS =         3,
 } spatialRel;
 
+/**
+ * Opaque structure to represent a geometry prepared for evaluating the same
+ * spatial relationship against many temporal points
+ */
+typedef struct PreparedGeo PreparedGeo;
+
+/**
+ * Opaque structure to represent the state of an online simplifier of a live
+ * temporal value
+ */
+typedef struct SimplifyState SimplifyState;
+
 /**
  * Structure to represent the common structure of temporal values of
  * any temporal subtype
@@ -264,6 +276,45 @@ typedef struct
   int j;
 } Match;
 
+/**
+ * Structure to represent the aggregate values of the temporal points
+ * traversing a tile
+ */
+typedef struct
+{
+  STBox box;            /**< Tile */
+  int count;            /**< Number of temporal points traversing the tile */
+  Interval duration;    /**< Total duration of the fragments in the tile */
+  double distance;      /**< Total distance of the fragments in the tile */
+  double speed;         /**< Average speed of the fragments in the tile */
+} TileAgg;
+
+/**
+ * Structure to represent a fragment of a temporal value in a time bucket
+ * without constructing it. The instants of the fragment are the synthetic
+ * start instant (if any), the instants of the sequence in the index range
+ * [first, last), and the synthetic end instant (if any)
+ */
+typedef struct
+{
+  TimestampTz lower;      /**< Lower bound of the time bucket */
+  TimestampTz upper;      /**< Upper bound of the time bucket */
+  const TSequence *seq;   /**< Underlying sequence, NULL for an instant */
+  const TInstant *start;  /**< Synthetic start instant or NULL */
+  const TInstant *end;    /**< Synthetic end instant or NULL */
+  int first;              /**< First instant of the sequence in the bucket */
+  int last;               /**< Instant after the last one in the bucket */
+  bool lower_inc;         /**< Lower bound of the fragment is inclusive */
+  bool upper_inc;         /**< Upper bound of the fragment is inclusive */
+  interpType interp;      /**< Interpolation of the fragment */
+} TimeBucketView;
+
+/**
+ * Visitor function for the fragments of a temporal value split according to
+ * time buckets, the traversal stops when the function returns false
+ */
+typedef bool (*time_bucket_fn)(const TimeBucketView *view, void *state);
+
 /*****************************************************************************/
 
 /**
@@ -1930,9 +1981,11 @@ extern double nad_tfloat_tfloat(const Temporal *temp1, const Temporal *temp2);
 extern double nad_tfloat_tbox(const Temporal *temp, const TBox *box);
 extern double nad_tboxfloat_tboxfloat(const TBox *box1, const TBox *box2);
 extern double nad_tpoint_geo(const Temporal *temp, const GSERIALIZED *gs);
+extern double nad_tpoint_prepgeo(const Temporal *temp, const PreparedGeo *pgeo);
 extern double nad_tpoint_stbox(const Temporal *temp, const STBox *box);
 extern double nad_tpoint_tpoint(const Temporal *temp1, const Temporal *temp2);
 extern TInstant *nai_tpoint_geo(const Temporal *temp, const GSERIALIZED *gs);
+extern TInstant *nai_tpoint_prepgeo(const Temporal *temp, const PreparedGeo *pgeo);
 extern TInstant *nai_tpoint_tpoint(const Temporal *temp1, const Temporal *temp2);
 extern GSERIALIZED *shortestline_tpoint_geo(const Temporal *temp, const GSERIALIZED *gs);
 extern GSERIALIZED *shortestline_tpoint_tpoint(const Temporal *temp1, const Temporal *temp2);
@@ -1971,6 +2024,8 @@ extern Temporal *geomeas_to_tpoint(const GSERIALIZED *gs);
 extern Temporal *tgeogpoint_to_tgeompoint(const Temporal *temp);
 extern Temporal *tgeompoint_to_tgeogpoint(const Temporal *temp);
 bool tpoint_AsMVTGeom(const Temporal *temp, const STBox *bounds, int32_t extent, int32_t buffer, bool clip_geom, GSERIALIZED **gsarr, int64 **timesarr, int *count);
+extern bool tpointarr_AsMVTGeom(const Temporal **levels, int nlevels, double dist, const STBox *bounds, int32_t extent, int32_t buffer, bool clip_geom, GSERIALIZED **gsarr, int64 **timesarr, int *count);
+extern bool tpointarr_AsMVTCommands(const Temporal **temparr, int count, const STBox *bounds, int32_t extent, int32_t buffer, bool clip_geom, uint32_t **geomarr, int **geomoffsets, uint8_t **typearr, int64 **timesarr, int **timesoffsets);
 extern STBox *tpoint_expand_space(const Temporal *temp, double d);
 extern Temporal **tpoint_make_simple(const Temporal *temp, int *count);
 extern Temporal *tpoint_set_srid(const Temporal *temp, int32 srid);
@@ -1993,10 +2048,22 @@ extern int edisjoint_tpoint_geo(const Temporal *temp, const GSERIALIZED *gs);
 extern int edisjoint_tpoint_tpoint(const Temporal *temp1, const Temporal *temp2);
 extern int edwithin_tpoint_geo(const Temporal *temp, const GSERIALIZED *gs, double dist);
 extern int edwithin_tpoint_tpoint(const Temporal *temp1, const Temporal *temp2, double dist);
+extern int *edwithin_tpoint_tpointarr(const Temporal *temp, const Temporal **temparr, int count, double dist, size_t *newcount);
+extern int *edwithin_tpointarr_tpointarr(const Temporal **temparr1, int count1, const Temporal **temparr2, int count2, double dist, size_t *count);
+extern int *tpointarr_dwithin_join(const Temporal **temparr1, int count1, const Temporal **temparr2, int count2, double dist, double xsize, double ysize, const Interval *duration, Temporal ***tdwithin, size_t *count);
 extern int eintersects_tpoint_geo(const Temporal *temp, const GSERIALIZED *gs);
 extern int eintersects_tpoint_tpoint(const Temporal *temp1, const Temporal *temp2);
 extern int etouches_tpoint_geo(const Temporal *temp, const GSERIALIZED *gs);
 
+extern PreparedGeo *geo_prepare(const GSERIALIZED *gs);
+extern PreparedGeo *geog_prepare(const GSERIALIZED *gs, bool use_spheroid);
+extern void prepared_geo_free(PreparedGeo *pgeo);
+extern int acontains_prepgeo_tpoint(const PreparedGeo *pgeo, const Temporal *temp);
+extern int adisjoint_tpoint_prepgeo(const Temporal *temp, const PreparedGeo *pgeo);
+extern int aintersects_tpoint_prepgeo(const Temporal *temp, const PreparedGeo *pgeo);
+extern int edisjoint_tpoint_prepgeo(const Temporal *temp, const PreparedGeo *pgeo);
+extern int eintersects_tpoint_prepgeo(const Temporal *temp, const PreparedGeo *pgeo);
+
 /*****************************************************************************/
 
 /* Temporal spatial relationship functions for temporal points */
@@ -2006,6 +2073,8 @@ extern Temporal *tdisjoint_tpoint_geo(const Temporal *temp, const GSERIALIZED *g
 extern Temporal *tdisjoint_tpoint_tpoint (const Temporal *temp1, const Temporal *temp2, bool restr, bool atvalue);
 extern Temporal *tdwithin_tpoint_geo(const Temporal *temp, const GSERIALIZED *gs, double dist, bool restr, bool atvalue);
 extern Temporal *tdwithin_tpoint_tpoint(const Temporal *temp1, const Temporal *temp2, double dist, bool restr, bool atvalue);
+extern Temporal **tdwithin_tpoint_tpointarr(const Temporal *temp, const Temporal **temparr, int count, double dist, bool restr, bool atvalue, int **pos, size_t *newcount);
+extern Temporal **tdwithin_tpointarr_tpointarr(const Temporal **temparr1, int count1, const Temporal **temparr2, int count2, double dist, bool restr, bool atvalue, int **pairs, size_t *count);
 extern Temporal *tintersects_tpoint_geo(const Temporal *temp, const GSERIALIZED *gs, bool restr, bool atvalue);
 extern Temporal *tintersects_tpoint_tpoint (const Temporal *temp1, const Temporal *temp2, bool restr, bool atvalue);
 extern Temporal *ttouches_tpoint_geo(const Temporal *temp, const GSERIALIZED *gs, bool restr, bool atvalue);
@@ -2052,9 +2121,20 @@ extern SkipList *ttext_tmin_transfn(SkipList *state, const Temporal *temp);
 /* Simplification functions for temporal types */
 
 Temporal *temporal_simplify_dp(const Temporal *temp, double eps_dist, bool synchronized);
+Temporal **temporal_simplify_dp_pyramid(const Temporal *temp, double dist, int nlevels, bool syncdist);
+int temporal_pyramid_level(double dist, int nlevels, double tolerance);
 Temporal *temporal_simplify_max_dist(const Temporal *temp, double eps_dist, bool synchronized);
+Temporal *temporal_simplify_max_insts(const Temporal *temp, int npts, bool syncdist);
 Temporal *temporal_simplify_min_dist(const Temporal *temp, double dist);
 Temporal *temporal_simplify_min_tdelta(const Temporal *temp, const Interval *mint);
+Temporal *temporal_simplify_online(const Temporal *temp, double dist, bool syncdist, int maxpts, bool squishe);
+Temporal *temporal_simplify_vw(const Temporal *temp, int npts);
+SimplifyState *temporal_simplify_open(double dist, bool syncdist, int maxpts, bool squishe);
+int temporal_simplify_push(SimplifyState *state, const TInstant *inst);
+TInstant **temporal_simplify_emit(SimplifyState *state, int *count);
+int temporal_simplify_close(SimplifyState *state);
+Temporal *temporal_simplify_append(SimplifyState *state, Temporal *temp, double maxdist, const Interval *maxt);
+void temporal_simplify_free(SimplifyState *state);
 
 /*****************************************************************************/
 
@@ -2084,17 +2164,32 @@ extern Span *intspan_bucket_list(const Span *bounds, int size, int origin, int *
 extern STBox *stbox_tile(GSERIALIZED *point, TimestampTz t, double xsize, double ysize, double zsize, const Interval *duration, GSERIALIZED *sorigin, TimestampTz torigin, bool hast);
 extern STBox *stbox_tile_list(const STBox *bounds, double xsize, double ysize, double zsize, const Interval *duration, GSERIALIZED *sorigin, TimestampTz torigin, bool border_inc, int *count);
 extern Temporal **temporal_time_split(const Temporal *temp, const Interval *duration, TimestampTz torigin, TimestampTz **time_buckets, int *count);
+extern int temporal_time_split_visit(const Temporal *temp, const Interval *duration, TimestampTz torigin, time_bucket_fn visit, void *state);
 extern Temporal **tfloat_value_split(const Temporal *temp, double size, double origin, double **value_buckets, int *count);
 extern Temporal **tfloat_value_time_split(const Temporal *temp, double size, const Interval *duration, double vorigin, TimestampTz torigin, double **value_buckets, TimestampTz **time_buckets, int *count);
+extern double *tfloat_value_time_histogram(const Temporal *temp, double size, const Interval *duration, double vorigin, TimestampTz torigin, double *value_start, TimestampTz *time_start, int *value_count, int *time_count);
 extern TBox *tfloatbox_tile(double value, TimestampTz t, double vsize, const Interval *duration, double vorigin, TimestampTz torigin);
 extern TBox *tfloatbox_tile_list(const TBox *box, double xsize, const Interval *duration, double xorigin, TimestampTz torigin, int *count);
 extern TimestampTz timestamptz_bucket(TimestampTz timestamp, const Interval *duration, TimestampTz origin);
 extern Temporal **tint_value_split(const Temporal *temp, int size, int origin, int **value_buckets, int *count);
 extern Temporal **tint_value_time_split(const Temporal *temp, int size, const Interval *duration, int vorigin, TimestampTz torigin, int **value_buckets, TimestampTz **time_buckets, int *count);
 extern TBox *tintbox_tile(int value, TimestampTz t, int vsize, const Interval *duration, int vorigin, TimestampTz torigin);
+extern double *tnumber_time_split_integral(const Temporal *temp, const Interval *duration, TimestampTz torigin, TimestampTz **buckets, int *count);
+extern double *tnumber_time_split_max(const Temporal *temp, const Interval *duration, TimestampTz torigin, TimestampTz **buckets, int *count);
+extern double *tnumber_time_split_min(const Temporal *temp, const Interval *duration, TimestampTz torigin, TimestampTz **buckets, int *count);
+extern double *tnumber_time_split_twavg(const Temporal *temp, const Interval *duration, TimestampTz torigin, TimestampTz **buckets, int *count);
 extern TBox *tintbox_tile_list(const TBox *box, int xsize, const Interval *duration, int xorigin, TimestampTz torigin, int *count);
 extern Temporal **tpoint_space_split(const Temporal *temp, float xsize, float ysize, float zsize, GSERIALIZED *sorigin, bool bitmatrix, bool border_inc, GSERIALIZED ***space_buckets, int *count);
 extern Temporal **tpoint_space_time_split(const Temporal *temp, float xsize, float ysize, float zsize, const Interval *duration, GSERIALIZED *sorigin, TimestampTz torigin, bool bitmatrix, bool border_inc, GSERIALIZED ***space_buckets, TimestampTz **time_buckets, int *count);
+extern double *tpoint_time_split_length(const Temporal *temp, const Interval *duration, TimestampTz torigin, TimestampTz **buckets, int *count);
+extern TileAgg *tpointarr_tile_agg(const Temporal **temparr, int count, double xsize, double ysize, const Interval *duration, const GSERIALIZED *sorigin, TimestampTz torigin, int *ntiles);
+extern int64 geo_quadcell(const GSERIALIZED *gs, const STBox *bounds, int level);
+extern STBox *quadcell_stbox(int64 cell, const STBox *bounds);
+extern int64 quadcell_parent(int64 cell, int level);
+extern Temporal **tpoint_quad_split(const Temporal *temp, const STBox *bounds, int level, int64 **cells, int *count);
+extern int64 geo_hexcell(const GSERIALIZED *gs, double size, const GSERIALIZED *sorigin);
+extern GSERIALIZED *hexcell_geo(int64 cell, double size, const GSERIALIZED *sorigin);
+extern Temporal **tpoint_hex_split(const Temporal *temp, double size, const GSERIALIZED *sorigin, int64 **cells, int *count);
 extern Span *tstzspan_bucket_list(const Span *bounds, const Interval *duration, TimestampTz origin, int *count);
 
 /*****************************************************************************/
@@ -110,7 +110,8 @@ extern PJ_CONTEXT *proj_get_context(void);
 
 /*****************************************************************************
  * Macros for manipulating the 'flags' element where the less significant
- * bits are GTZXIICB, where
+ * bits are SGTZXIICB, where
+ *   S: has a segment index (only for TSequence)
  *   G: coordinates are geodetic
  *   T: has T coordinate,
  *   Z: has Z coordinate
@@ -139,6 +140,8 @@ extern PJ_CONTEXT *proj_get_context(void);
 #define MEOS_FLAG_Z          0x0020  // 32
 #define MEOS_FLAG_T          0x0040  // 64
 #define MEOS_FLAG_GEODETIC   0x0080  // 128
+/* The following flag is only used for TSequence */
+#define MEOS_FLAG_SEGIDX     0x0100  // 256
 
 #define MEOS_FLAGS_GET_BYVAL(flags)      ((bool) (((flags) & MEOS_FLAG_BYVAL)))
 #define MEOS_FLAGS_GET_ORDERED(flags)    ((bool) (((flags) & MEOS_FLAG_ORDERED)>>1))
@@ -147,6 +150,7 @@ extern PJ_CONTEXT *proj_get_context(void);
 #define MEOS_FLAGS_GET_Z(flags)          ((bool) (((flags) & MEOS_FLAG_Z)>>5))
 #define MEOS_FLAGS_GET_T(flags)          ((bool) (((flags) & MEOS_FLAG_T)>>6))
 #define MEOS_FLAGS_GET_GEODETIC(flags)   ((bool) (((flags) & MEOS_FLAG_GEODETIC)>>7))
+#define MEOS_FLAGS_GET_SEGIDX(flags)     ((bool) (((flags) & MEOS_FLAG_SEGIDX)>>8))
 
 #define MEOS_FLAGS_BYREF(flags)          ((bool) (((flags) & ! MEOS_FLAG_BYVAL)))
 
@@ -164,6 +168,8 @@ extern PJ_CONTEXT *proj_get_context(void);
   ((flags) = (value) ? ((flags) | MEOS_FLAG_T) : ((flags) & ~MEOS_FLAG_T))
 #define MEOS_FLAGS_SET_GEODETIC(flags, value) \
   ((flags) = (value) ? ((flags) | MEOS_FLAG_GEODETIC) : ((flags) & ~MEOS_FLAG_GEODETIC))
+#define MEOS_FLAGS_SET_SEGIDX(flags, value) \
+  ((flags) = (value) ? ((flags) | MEOS_FLAG_SEGIDX) : ((flags) & ~MEOS_FLAG_SEGIDX))
 
 #define MEOS_FLAGS_GET_INTERP(flags) (((flags) & MEOS_FLAGS_INTERP) >> 2)
 #define MEOS_FLAGS_SET_INTERP(flags, value) ((flags) = (((flags) & ~MEOS_FLAGS_INTERP) | ((value & 0x0003) << 2)))
@@ -44,6 +44,7 @@
 #include <postgres.h>
 /* PostGIS */
 #include <liblwgeom.h>
+#include <lwgeodetic_tree.h>
 /* MEOS */
 #include <meos.h>
 
@@ -81,11 +82,44 @@ extern GSERIALIZED *geo_reverse(const GSERIALIZED *geom);
 extern bool gserialized_azimuth(GSERIALIZED *gs1, GSERIALIZED *gs2,
   double *result);
 
+/**
+ * Structure keeping a geometry together with its GEOS prepared version, or
+ * with its spherical tree for geographies, so that the preparation is
+ * amortized over repeated spatial relationship and distance calls. The
+ * structures used for restricting temporal points to the geometry are
+ * computed on demand.
+ */
+struct PreparedGeo
+{
+  GSERIALIZED *gs;                      /**< Copy of the geometry */
+  GBOX box;                             /**< Bounding box of the geometry */
+  bool hasbox;                          /**< True if the box is available */
+  GEOSGeometry *geom;                   /**< GEOS geometry, NULL if geodetic */
+  const GEOSPreparedGeometry *prepgeom; /**< GEOS prepared geometry */
+  LWGEOM *lwgeom;                       /**< Geography, NULL if not geodetic */
+  CIRC_NODE *circtree;                  /**< Spherical tree of the geography */
+  bool use_spheroid;                    /**< True when geodetic distances are
+                                             computed on the spheroid */
+  struct PolyIndex *polyidx;            /**< Edge index of a polygonal
+                                             geometry, NULL if not yet */
+  struct GeoTiles *tiles;               /**< Geometry clipped to a grid of
+                                             tiles, NULL for small or
+                                             polygonal geometries */
+  bool hastiles;                        /**< True if the tiles have been
+                                             computed */
+};
+
+extern void prepared_geo_init(PreparedGeo *pgeo, const GSERIALIZED *gs);
+extern void prepared_geo_reset(PreparedGeo *pgeo);
+
 /* Functions adapted from lwgeom_geos.c */
 
 extern GEOSGeometry *POSTGIS2GEOS(const GSERIALIZED *pglwgeom);
 extern GSERIALIZED *GEOS2POSTGIS(GEOSGeom geom, char want3d);
 
+extern bool prepgeo_spatialrel(const PreparedGeo *pgeo,
+  const GSERIALIZED *gs, spatialRel rel);
+
 extern bool geometry_spatialrel(const GSERIALIZED *gs1,
   const GSERIALIZED *gs2, spatialRel rel);
 extern GSERIALIZED *geometry_intersection(const GSERIALIZED *gs1,
@@ -52,6 +52,22 @@ extern void tpointseq_expand_stbox(TSequence *seq, const TInstant *inst);
 extern void tpointseqarr_set_stbox(const TSequence **sequences, int count,
   STBox *box);
 
+/* Segment index of long temporal point sequences */
+
+/** Number of segments covered by each block of a segment index */
+#define SEGIDX_BLOCK_SIZE 64
+/** Minimum capacity in instants of a sequence for keeping a segment index */
+#define SEGIDX_MIN_COUNT 1024
+
+extern size_t tpointseq_segidx_size(const TInstant *inst, interpType interp,
+  int maxcount);
+extern void tpointseq_set_segidx(TSequence *seq);
+extern void tpointseq_copy_segidx(TSequence *dest, const TSequence *src);
+extern void tpointseq_segidx_update_last(TSequence *seq);
+extern bool *tpointseq_segidx_search(const TSequence *seq, const STBox *box);
+extern double *tpointseq_segidx_blocks(const TSequence *seq, int *count);
+extern void tpointseq_segidx_set_stbox(const TSequence *seq, STBox *box);
+
 /* Generic box functions */
 
 extern bool boxop_tpoint_stbox(const Temporal *temp, const STBox *box,
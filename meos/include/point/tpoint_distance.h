@@ -44,6 +44,24 @@
 
 /*****************************************************************************/
 
+/**
+ * Structure for storing the coordinates of a temporal point sequence in
+ * contiguous arrays, one per dimension, so that the distance kernels load
+ * several consecutive coordinates in a single vector
+ */
+typedef struct
+{
+  int count;            /**< Number of points */
+  bool hasz;            /**< True when the points have Z dimension */
+  double *x;            /**< Array of X coordinates */
+  double *y;            /**< Array of Y coordinates */
+  double *z;            /**< Array of Z coordinates, NULL for 2D points */
+  TimestampTz *t;       /**< Array of timestamps */
+  double *buf;          /**< Buffer for the results of the kernels */
+} TPointCoords;
+
+/*****************************************************************************/
+
 extern double tnumberinst_distance(const TInstant *inst1, const TInstant *inst2);
 extern double tpointinst_distance(const TInstant *inst1, const TInstant *inst2,
   datum_func2 func);
@@ -53,6 +71,13 @@ extern bool tgeogpoint_min_dist_at_timestamptz(const TInstant *start1,
   const TInstant *end1, const TInstant *start2, const TInstant *end2,
   Datum *mindist, TimestampTz *t);
 
+extern TPointCoords *tpointseq_coords(const TSequence *seq);
+extern void tpointcoords_free(TPointCoords *coords);
+extern int tpointcoords_findsplit(const TPointCoords *coords, int i1, int i2,
+  bool syncdist);
+extern double tpointcoords_nad(const TPointCoords *coords1,
+  const TPointCoords *coords2, bool linear);
+
 /*****************************************************************************/
 
 #endif
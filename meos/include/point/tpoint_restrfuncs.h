@@ -41,6 +41,7 @@
 #include <lwgeom_geos.h>
 /* MEOS */
 #include <meos.h>
+#include "point/tpoint_spatialrels.h"
 
 /** Symbolic constants for distinguishing between atGeometry and atGeometryTime */
 #define REST_TIME           true
@@ -48,12 +49,50 @@
 
 /*****************************************************************************/
 
+/**
+ * @brief Tiles of a geometry with many vertices used for computing its
+ * intersection with a temporal point
+ * @details The tiles form a regular grid covering the bounding box of the
+ * geometry, the tile in column @p i and row @p j has number
+ * @p j * @p nx + @p i
+ */
+typedef struct GeoTiles
+{
+  int count;              /**< Number of tiles */
+  int nx;                 /**< Number of columns of the grid */
+  int ny;                 /**< Number of rows of the grid */
+  double xmin;            /**< Minimum X value of the grid */
+  double ymin;            /**< Minimum Y value of the grid */
+  double size;            /**< Size of the tiles */
+  GSERIALIZED **geoms;    /**< Geometry clipped to each tile, NULL when the
+                               clipped geometry is empty */
+} GeoTiles;
+
+/** Minimum number of vertices of a geometry for computing its intersection
+ * with a temporal point tile by tile */
+#define GEOTILES_MIN_POINTS 4096
+/** Target number of vertices of a geometry per tile */
+#define GEOTILES_TILE_POINTS 256
+/** Maximum number of tiles of a geometry */
+#define GEOTILES_MAX_TILES 4096
+
 /* Restriction functions */
 
+extern bool clipt(double p, double q, double *t0, double *t1);
 extern TSequence **tpointseq_at_geom(const TSequence *seq,
   const GSERIALIZED *gs, int *count);
 extern Span *tpointseq_interperiods(const TSequence *seq,
-  const GSERIALIZED *gs, int *count);
+  GSERIALIZED *gsinter, int *count);
+extern GeoTiles *geotiles_make(const GSERIALIZED *gs);
+extern void geotiles_free(GeoTiles *tiles);
+extern GeoTiles *prepgeo_tiles(PreparedGeo *pgeo);
+extern Span *tpointseq_geom_interperiods(const TSequence *seq,
+  const GSERIALIZED *gs, GeoTiles *tiles, int *count);
+extern bool geo_polygonal(const GSERIALIZED *gs);
+extern Temporal *tpoint_restrict_prepgeo_time(const Temporal *temp,
+  PreparedGeo *pgeo, const Span *zspan, const Span *period, bool atfunc);
+extern Span *tpointseq_polygon_periods(const TSequence *seq, PolyIndex *idx,
+  int *count);
 
 /*****************************************************************************/
 
@@ -61,6 +61,41 @@ extern datum_func3 get_dwithin_fn(int16 flags1, int16 flags2);
 
 /*****************************************************************************/
 
+/**
+ * @brief Edge index of a polygonal geometry
+ * @details The index can be used for any number of segments, possibly of
+ * several temporal points, since each segment is numbered when it is split
+ * by #polyindex_segm_fractions
+ */
+typedef struct PolyIndex
+{
+  int nedges;         /**< Number of edges */
+  POINT2D *points;    /**< Start and end points of the edges */
+  double xmin;        /**< Minimum X value of the geometry */
+  double xmax;        /**< Maximum X value of the geometry */
+  double ymin;        /**< Minimum Y value of the geometry */
+  double ymax;        /**< Maximum Y value of the geometry */
+  int nstrips;        /**< Number of strips */
+  double height;      /**< Height of the strips */
+  int *offsets;       /**< Start of the edges of each strip in the ids array,
+                           the array has nstrips + 1 elements */
+  int *ids;           /**< Edge numbers sorted by strip */
+  int *marks;         /**< Last segment that visited each edge */
+  int segno;          /**< Number of the last segment processed */
+} PolyIndex;
+
+/** Maximum number of strips of the edge index of a polygonal geometry */
+#define POLYINDEX_MAX_STRIPS 1024
+
+extern PolyIndex *polyindex_make(const GSERIALIZED *gs);
+extern void polyindex_free(PolyIndex *idx);
+extern int polyindex_locate(const PolyIndex *idx, double x, double y);
+extern int polyindex_segm_fractions(PolyIndex *idx, const POINT2D *p1,
+  const POINT2D *p2, double **fracs, int *maxfracs);
+extern PolyIndex *prepgeo_polyindex(PreparedGeo *pgeo);
+
+/*****************************************************************************/
+
 extern Datum ea_disjoint_tpoint_geo(const Temporal *temp,
   const GSERIALIZED *gs, bool ever);
 extern int ea_spatialrel_tpoint_tpoint(const Temporal *temp1,
@@ -69,6 +104,12 @@ extern int ea_spatialrel_tpoint_tpoint(const Temporal *temp1,
 extern int ea_dwithin_tpoint_tpoint1(const Temporal *sync1,
   const Temporal *sync2, double dist, bool ever);
 
+extern bool ensure_valid_tpointarr_tpointarr(const Temporal **temparr1,
+  int count1, const Temporal **temparr2, int count2, double dist);
+extern int *tpointarr_dwithin_pairs(const Temporal **temparr1, int count1,
+  const Temporal **temparr2, int count2, double dist, bool **close,
+  size_t *count);
+
 /*****************************************************************************/
 
 #endif
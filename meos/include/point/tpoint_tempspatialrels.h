@@ -48,6 +48,8 @@
 
 extern Temporal *tinterrel_tpoint_geo(const Temporal *temp,
   const GSERIALIZED *gs, bool tinter, bool restr, bool atvalue);
+extern Temporal *tinterrel_tpoint_prepgeo(const Temporal *temp,
+  PreparedGeo *pgeo, bool tinter, bool restr, bool atvalue);
 extern Temporal *tinterrel_tpoint_tpoint(const Temporal *temp1,
   const Temporal *temp2, bool tinter, bool restr, bool atvalue);
 
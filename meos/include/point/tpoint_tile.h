@@ -39,17 +39,70 @@
 
 #define MAXDIMS 4
 
+/** Maximum level of a quadtree cell */
+#define QUADCELL_MAX_LEVEL 29
+/** Position of the level in the identifier of a quadtree cell */
+#define QUADCELL_LEVEL_SHIFT 58
+/** Mask of the Morton code in the identifier of a quadtree cell */
+#define QUADCELL_CODE_MASK ((UINT64CONST(1) << QUADCELL_LEVEL_SHIFT) - 1)
+
 /*****************************************************************************/
 
 /**
- * Structure for storing a bit matrix
+ * Struct for storing a segment of a temporal point traversing a tile
+ */
+typedef struct
+{
+  int64 tile;              /**< Number of the tile in the grid, or identifier
+                              of the cell for hexagonal grids */
+  int seqno;               /**< Number of the sequence in the temporal point */
+  int segno;               /**< Number of the segment in the sequence, or of
+                              the instant for discrete sequences */
+} TileSegm;
+
+/**
+ * Struct for storing the segments of a temporal point sorted by the tiles
+ * they traverse, used for splitting the temporal point in a single pass
+ */
+typedef struct
+{
+  int count;               /**< Number of elements in the array */
+  int size;                /**< Allocated size of the array */
+  int i;                   /**< Position of the first segment of the next
+                              tile */
+  TileSegm *segms;         /**< Array of segments */
+  double *lower;           /**< Minimum values of the tiles in the spatial
+                              dimensions, as computed when iterating the
+                              grid, for X, Y, and Z (if any) */
+} TileSweep;
+
+/**
+ * Struct for storing a time span during which a temporal point stays in a
+ * hexagon of a hexagonal grid
+ */
+typedef struct
+{
+  int64 cell;              /**< Identifier of the hexagon */
+  int seqno;               /**< Number of the sequence in the temporal point,
+                              or of the instant for discrete sequences */
+  Span period;             /**< Time span of the temporal point in the
+                              hexagon */
+} HexPiece;
+
+/**
+ * Struct for storing the time spans of a temporal point in the hexagons of a
+ * hexagonal grid while walking along its segments
  */
 typedef struct
 {
-  int ndims;             /**< Number of dimensions */
-  int count[MAXDIMS];    /**< Number of elements in each dimension */
-  uint8_t byte[1];       /**< beginning of variable-length data */
-} BitMatrix;
+  int count;               /**< Number of elements in the array */
+  int size;                /**< Allocated size of the array */
+  HexPiece *pieces;        /**< Array of time spans */
+  int64 cell;              /**< Identifier of the current hexagon */
+  TimestampTz lower;       /**< Start of the current time span */
+  bool lower_inc;          /**< True when the start of the current time span
+                              belongs to the current hexagon */
+} HexSweep;
 
 /**
  * Struct for storing the state that persists across multiple calls generating
@@ -67,8 +120,9 @@ typedef struct STboxGridState
   int64 tunits;            /**< Size of the time dimension, 0 for spatial only */
   STBox box;               /**< Bounding box of the grid */
   const Temporal *temp;    /**< Optional temporal point to be split */
-  BitMatrix *bm;           /**< Optional bit matrix for speeding up the
-                              computation of the split functions */
+  TileSweep *sweep;        /**< Optional segments of the temporal point
+                              sorted by tile for computing the split
+                              functions in a single pass */
   double x;                /**< Minimum x value of the current tile */
   double y;                /**< Minimum y value of the current tile */
   double z;                /**< Minimum z value of the current tile, if any */
@@ -80,9 +134,7 @@ typedef struct STboxGridState
 
 /*****************************************************************************/
 
-extern BitMatrix *bitmatrix_make(int *count, int ndims);
-extern int tpoint_set_tiles(const Temporal *temp, const STboxGridState *state,
-  BitMatrix *bm);
+extern int tpoint_set_tiles(const Temporal *temp, STboxGridState *state);
 extern Temporal *tpoint_at_tile(const Temporal *temp, const STBox *box);
 
 extern void stbox_tile_set(double x, double y, double z, TimestampTz t,
@@ -93,11 +145,14 @@ extern STboxGridState *stbox_tile_state_make(const Temporal *temp,
   POINT3DZ sorigin, TimestampTz torigin, bool border_inc);
 extern void stbox_tile_state_next(STboxGridState *state);
 extern bool stbox_tile_state_get(STboxGridState *state, STBox *box);
+extern void stbox_tile_state_free(STboxGridState *state);
 
 extern STboxGridState *tpoint_space_time_split_init(const Temporal *temp,
   float xsize, float ysize, float zsize, const Interval *duration,
   const GSERIALIZED *sorigin, TimestampTz torigin, bool bitmatrix, 
   bool border_inc, int *ntiles);
+extern Temporal *tpoint_space_time_split_next(STboxGridState *state,
+  STBox *box);
 
 /*****************************************************************************/
 
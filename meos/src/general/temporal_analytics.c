@@ -40,6 +40,7 @@
 #include <float.h>
 /* PostgreSQL */
 #include <postgres.h>
+#include <utils/float.h>
 /* PostGIS */
 #include <liblwgeom_internal.h>
 /* MEOS */
@@ -49,9 +50,11 @@
 #include "general/set.h"
 #include "general/span.h"
 #include "general/spanset.h"
+#include "general/temporal_boxops.h"
 #include "general/temporal_tile.h"
 #include "general/tsequence.h"
 #include "general/type_util.h"
+#include "point/tpoint_boxops.h"
 #include "point/tpoint_distance.h"
 #include "point/tpoint_spatialfuncs.h"
 
@@ -172,6 +175,220 @@ tstzspanset_tprecision(const SpanSet *ss, const Interval *duration,
   return spanset_make_free(spans, nspans, NORMALIZE, ORDER_NO);
 }
 
+/*****************************************************************************
+ * Resampling engine for temporal floats and temporal geometry points
+ *
+ * The functions below sample or set the precision of a continuous temporal
+ * float or geometry point sequence without creating a temporary instant for
+ * every bucket: the values of the sequence are read into contiguous arrays,
+ * the buckets are computed in a single pass over the segments, and the
+ * resulting sequence is built in a single allocation. The interpolation and
+ * the normalization reproduce those of #tsegment_value_at_timestamptz and
+ * #tinstarr_normalize so that the result is the same as the one of the
+ * generic code.
+ *****************************************************************************/
+
+/**
+ * @brief Return true if a temporal sequence can be sampled with the
+ * resampling engine
+ */
+static bool
+tsequence_tsample_engine(const TSequence *seq)
+{
+  return seq->count > 1 && ! MEOS_FLAGS_DISCRETE_INTERP(seq->flags) &&
+    (seq->temptype == T_TFLOAT || seq->temptype == T_TGEOMPOINT);
+}
+
+/**
+ * @brief Return the number of dimensions of the values of a temporal float
+ * or geometry point
+ */
+static int
+tsample_ndims(meosType temptype, int16 flags)
+{
+  if (temptype == T_TFLOAT)
+    return 1;
+  return MEOS_FLAGS_GET_Z(flags) ? 3 : 2;
+}
+
+/**
+ * @brief Read the timestamps and the values of a temporal float or geometry
+ * point sequence into arrays
+ * @param[in] seq Temporal sequence
+ * @param[in] ndims Number of dimensions of the values
+ * @param[out] times Array of timestamps
+ * @param[out] values Array of values, with one slice of @p seq->count
+ * elements per dimension
+ */
+static void
+tsequence_sample_read(const TSequence *seq, int ndims, TimestampTz *times,
+  double *values)
+{
+  int count = seq->count;
+  for (int i = 0; i < count; i++)
+  {
+    const TInstant *inst = TSEQUENCE_INST_N(seq, i);
+    times[i] = inst->t;
+    if (ndims == 1)
+      values[i] = DatumGetFloat8(tinstant_val(inst));
+    else if (ndims == 2)
+    {
+      const POINT2D *pt = DATUM_POINT2D_P(tinstant_val(inst));
+      values[i] = pt->x;
+      values[count + i] = pt->y;
+    }
+    else
+    {
+      const POINT3DZ *pt = DATUM_POINT3DZ_P(tinstant_val(inst));
+      values[i] = pt->x;
+      values[count + i] = pt->y;
+      values[2 * count + i] = pt->z;
+    }
+  }
+  return;
+}
+
+/**
+ * @brief Return true if the second of three consecutive samples is redundant
+ * @note The function mirrors #tsequence_norm_test
+ */
+static bool
+tsample_norm_test(const TimestampTz *times, const double *values, int ndims,
+  int maxcount, interpType interp, int i1, int i2, int i3)
+{
+  bool v1v2eq = true, v2v3eq = true, collinear = true;
+  double ratio = (double) (times[i2] - times[i1]) /
+    (double) (times[i3] - times[i1]);
+  for (int d = 0; d < ndims; d++)
+  {
+    const double *v = values + d * maxcount;
+    v1v2eq &= float8_eq(v[i1], v[i2]);
+    v2v3eq &= float8_eq(v[i2], v[i3]);
+    collinear &= fabs(v[i2] - (v[i1] + (v[i3] - v[i1]) * ratio)) <=
+      MEOS_EPSILON;
+  }
+  if (interp == STEP)
+    return v1v2eq;
+  return (v1v2eq && v2v3eq) || collinear;
+}
+
+/**
+ * @brief Remove the redundant samples of a temporal float or geometry point
+ * @return Number of samples after the normalization
+ * @note The function mirrors #tinstarr_normalize
+ */
+static int
+tsample_normalize(TimestampTz *times, double *values, int ndims,
+  int maxcount, int count, interpType interp)
+{
+  if (interp == DISCRETE || count < 2)
+    return count;
+  int i1 = 0, i2 = 1, nsamples = 1;
+  for (int i3 = 2; i3 < count; i3++)
+  {
+    if (tsample_norm_test(times, values, ndims, maxcount, interp, i1, i2, i3))
+    {
+      i2 = i3;
+      continue;
+    }
+    /* Keep the second sample */
+    times[nsamples] = times[i2];
+    for (int d = 0; d < ndims; d++)
+      values[d * maxcount + nsamples] = values[d * maxcount + i2];
+    i1 = nsamples++;
+    i2 = i3;
+  }
+  times[nsamples] = times[i2];
+  for (int d = 0; d < ndims; d++)
+    values[d * maxcount + nsamples] = values[d * maxcount + i2];
+  return nsamples + 1;
+}
+
+/**
+ * @brief Return a temporal float or geometry point sequence built in a single
+ * allocation from arrays of timestamps and values
+ * @param[in] seq Temporal sequence that was sampled
+ * @param[in] times Array of timestamps
+ * @param[in] values Array of values, with one slice of @p maxcount elements
+ * per dimension
+ * @param[in] ndims Number of dimensions of the values
+ * @param[in] maxcount Number of elements of every slice of the array of values
+ * @param[in] count Number of samples
+ * @param[in] interp Interpolation of the result
+ * @note The instants of the result have all the same size and thus they are
+ * copied from a prototype instant whose timestamp and value are then set
+ */
+static TSequence *
+tsequence_sample_make(const TSequence *seq, const TimestampTz *times,
+  const double *values, int ndims, int maxcount, int count, interpType interp)
+{
+  meosType temptype = seq->temptype;
+  Datum value;
+  if (temptype == T_TFLOAT)
+    value = Float8GetDatum(values[0]);
+  else
+    value = PointerGetDatum(geopoint_make(values[0], values[maxcount],
+      (ndims == 3) ? values[2 * maxcount] : 0.0, ndims == 3, false,
+      tpointseq_srid(seq)));
+  TInstant *proto = tinstant_make_free(value, temptype, times[0]);
+
+  /* Compute the size of the temporal sequence as in #tsequence_make_exp1 */
+  size_t bboxsize = DOUBLE_PAD(temporal_bbox_size(temptype));
+  size_t bboxsize_extra = bboxsize - sizeof(Span);
+  size_t instsize = DOUBLE_PAD(VARSIZE(proto));
+  size_t segidx_size = tpointseq_segidx_size(proto, interp, count);
+  size_t pdata = DOUBLE_PAD(sizeof(TSequence)) + bboxsize_extra +
+    sizeof(size_t) * count;
+  size_t memsize = pdata + instsize * count + segidx_size;
+
+  /* Create the temporal sequence */
+  TSequence *result = palloc0(memsize);
+  SET_VARSIZE(result, memsize);
+  result->count = result->maxcount = count;
+  result->temptype = temptype;
+  result->subtype = TSEQUENCE;
+  result->bboxsize = (int16) bboxsize;
+  MEOS_FLAGS_SET_CONTINUOUS(result->flags,
+    MEOS_FLAGS_GET_CONTINUOUS(proto->flags));
+  MEOS_FLAGS_SET_INTERP(result->flags, interp);
+  MEOS_FLAGS_SET_X(result->flags, true);
+  MEOS_FLAGS_SET_T(result->flags, true);
+  if (temptype == T_TGEOMPOINT)
+    MEOS_FLAGS_SET_Z(result->flags, ndims == 3);
+  /* Store the composing instants */
+  const TInstant **instants = palloc(sizeof(TInstant *) * count);
+  for (int i = 0; i < count; i++)
+  {
+    TInstant *inst = (TInstant *) ((char *) result + pdata + instsize * i);
+    memcpy(inst, proto, VARSIZE(proto));
+    inst->t = times[i];
+    if (ndims == 1)
+      inst->value = Float8GetDatum(values[i]);
+    else if (ndims == 2)
+    {
+      POINT2D *pt = DATUM_POINT2D_P(tinstant_val(inst));
+      pt->x = values[i];
+      pt->y = values[maxcount + i];
+    }
+    else
+    {
+      POINT3DZ *pt = DATUM_POINT3DZ_P(tinstant_val(inst));
+      pt->x = values[i];
+      pt->y = values[maxcount + i];
+      pt->z = values[2 * maxcount + i];
+    }
+    (TSEQUENCE_OFFSETS_PTR(result))[i] = instsize * i;
+    instants[i] = inst;
+  }
+  /* The bounds are both inclusive as in #tsequence_tsample */
+  tinstarr_compute_bbox(instants, count, true, true, interp,
+    TSEQUENCE_BBOX_PTR(result));
+  if (segidx_size > 0)
+    tpointseq_set_segidx(result);
+  pfree(instants); pfree(proto);
+  return result;
+}
+
 /*****************************************************************************
  * Time precision functions for temporal values
  *****************************************************************************/
@@ -193,6 +410,133 @@ tinstant_tprecision(const TInstant *inst, const Interval *duration,
   return tinstant_make(value, inst->temptype, lower);
 }
 
+/**
+ * @brief Return the time-weighted average of the instants of a bucket of a
+ * temporal float sequence
+ * @param[in,out] times,values Timestamps and values of the instants, which
+ * are normalized in place
+ * @param[in] count Number of instants
+ * @param[in] interp Interpolation
+ * @note The function mirrors the normalization of #tsequence_make and the
+ * computation of #tnumberseq_twavg
+ */
+static double
+tfloatseq_bucket_twavg(TimestampTz *times, double *values, int count,
+  interpType interp)
+{
+  count = tsample_normalize(times, values, 1, count, count, interp);
+  double duration = (double) (times[count - 1] - times[0]);
+  if (duration == 0.0)
+    return values[0];
+  double result = 0;
+  for (int i = 1; i < count; i++)
+  {
+    if (interp == LINEAR)
+    {
+      double min = Min(values[i - 1], values[i]);
+      double max = Max(values[i - 1], values[i]);
+      result += (max + min) * (double) (times[i] - times[i - 1]) / 2.0;
+    }
+    else
+      result += values[i - 1] * (double) (times[i] - times[i - 1]);
+  }
+  return result / duration;
+}
+
+/**
+ * @brief Return a temporal float sequence with the precision set to a time
+ * bucket using the resampling engine
+ * @param[in] seq Temporal value
+ * @param[in] lower_bucket First bucket
+ * @param[in] tunits Time size of the buckets in PostgreSQL time units
+ * @param[in] maxcount Number of buckets
+ * @note The loop is the one of #tsequence_tprecision
+ */
+static TSequence *
+tfloatseq_tprecision_fast(const TSequence *seq, TimestampTz lower_bucket,
+  int64 tunits, int maxcount)
+{
+  interpType interp = MEOS_FLAGS_GET_INTERP(seq->flags);
+  int count = seq->count;
+  /* Allocate all the arrays in a single chunk, a bucket contains at most
+   * the instants of the sequence plus its start and end instants */
+  size_t size = (sizeof(TimestampTz) + sizeof(double)) *
+    (2 * count + 2 + maxcount);
+  char *buf = palloc(size);
+  TimestampTz *times = (TimestampTz *) buf;
+  TimestampTz *btimes = times + count;
+  TimestampTz *otimes = btimes + count + 2;
+  double *values = (double *) (otimes + maxcount);
+  double *bvalues = values + count;
+  double *ovalues = bvalues + count + 2;
+  tsequence_sample_read(seq, 1, times, values);
+
+  TimestampTz lower = lower_bucket;
+  TimestampTz upper = lower_bucket + tunits;
+  int i = 0;   /* Instant of the input sequence being processed */
+  int k = 0;   /* Number of instants for computing the twAvg */
+  int l = 0;   /* Number of instants of the output sequence */
+  while (i < count)
+  {
+    int cmp = timestamptz_cmp_internal(times[i], upper);
+    /* If the instant is in the current bucket consume it */
+    if (cmp <= 0)
+    {
+      btimes[k] = times[i];
+      bvalues[k++] = values[i++];
+    }
+    /* If we have reached the end of the bucket */
+    if (cmp >= 0)
+    {
+      assert(k > 0);
+      /* Compute the value at the end of the bucket if we do not have it,
+       * which is strictly inside the segment ending at the current instant */
+      if (btimes[k - 1] < upper)
+      {
+        double v1 = values[i - 1], v2 = values[i];
+        double v = v1;
+        if (interp == LINEAR && ! float8_eq(v1, v2))
+        {
+          long double ratio = (long double) (upper - times[i - 1]) /
+            (long double) (times[i] - times[i - 1]);
+          v = v1 + (double) ((long double) (v2 - v1) * ratio);
+        }
+        btimes[k] = upper;
+        bvalues[k++] = v;
+      }
+      /* The instant at the end of the current bucket is the start of the next
+       * one excepted when the last bucket is empty */
+      TimestampTz lastt = btimes[k - 1];
+      double lastv = bvalues[k - 1];
+      otimes[l] = lower;
+      ovalues[l++] = tfloatseq_bucket_twavg(btimes, bvalues, k, interp);
+      if (i < count || seq->period.upper_inc)
+      {
+        btimes[0] = lastt;
+        bvalues[0] = lastv;
+        k = 1;
+      }
+      else
+        k = 0;
+      lower = upper;
+      upper += tunits;
+    }
+  }
+  /* Compute the twAvg of the last bucket */
+  if (k > 0)
+  {
+    otimes[l] = lower;
+    ovalues[l++] = tfloatseq_bucket_twavg(btimes, bvalues, k, interp);
+  }
+  /* The lower and upper bounds are both true since the tprecision operation
+   * amounts to a granularity change */
+  l = tsample_normalize(otimes, ovalues, 1, maxcount, l, interp);
+  TSequence *result = tsequence_sample_make(seq, otimes, ovalues, 1, maxcount,
+    l, interp);
+  pfree(buf);
+  return result;
+}
+
 /**
  * @brief Return a temporal sequence with the precision set to a time bucket
  * @param[in] seq Temporal value
@@ -217,6 +561,8 @@ tsequence_tprecision(const TSequence *seq, const Interval *duration,
     tunits;
   /* Number of buckets */
   int count = (int) (((int64) upper_bucket - (int64) lower_bucket) / tunits);
+  if (seq->temptype == T_TFLOAT && tsequence_tsample_engine(seq))
+    return tfloatseq_tprecision_fast(seq, lower_bucket, tunits, count);
   TInstant **ininsts = palloc(sizeof(TInstant *) * seq->count);
   TInstant **outinsts = palloc(sizeof(TInstant *) * count);
   lower = lower_bucket;
@@ -525,12 +871,123 @@ tsequence_tsample_iter(const TSequence *seq, TimestampTz lower_bucket,
           break;
         start = end;
         end = TSEQUENCE_INST_N(seq, ++i);
+        /* The start of the next segments is inclusive */
+        lower_inc = true;
       }
     }
   }
   return ninsts;
 }
 
+/**
+ * @brief Compute the samples of a temporal float or geometry point sequence
+ * at the bounds of the buckets
+ * @param[in] seq Temporal sequence
+ * @param[in] times,values Timestamps and values of the sequence as given by
+ * #tsequence_sample_read
+ * @param[in] ndims Number of dimensions of the values
+ * @param[in] lower_bucket,upper_bucket First and last buckets
+ * @param[in] tunits Time size of the buckets in PostgreSQL time units
+ * @param[in] maxcount Number of elements of every slice of the output array
+ * of values
+ * @param[out] stimes Array of timestamps of the samples
+ * @param[out] svalues Array of values of the samples, with one slice of
+ * @p maxcount elements per dimension
+ * @return Number of samples
+ * @note The loop is the one of the continuous case of #tsequence_tsample_iter
+ */
+static int
+tsequence_sample_merge(const TSequence *seq, const TimestampTz *times,
+  const double *values, int ndims, TimestampTz lower_bucket,
+  TimestampTz upper_bucket, int64 tunits, int maxcount, TimestampTz *stimes,
+  double *svalues)
+{
+  interpType interp = MEOS_FLAGS_GET_INTERP(seq->flags);
+  int count = seq->count;
+  TimestampTz lower = lower_bucket;
+  int nsamples = 0;
+  int i = 1; /* Current segment of the sequence */
+  while (i < count && lower < upper_bucket)
+  {
+    bool lower_inc = (i == 1) ? seq->period.lower_inc : true;
+    bool upper_inc = (i == count - 1) ? seq->period.upper_inc : false;
+    TimestampTz t1 = times[i - 1], t2 = times[i];
+    /* If the segment contains the lower bound of the bucket */
+    if ((t1 < lower || (t1 == lower && lower_inc)) &&
+        (lower < t2 || (lower == t2 && upper_inc)))
+    {
+      stimes[nsamples] = lower;
+      long double ratio = (long double) (lower - t1) /
+        (long double) (t2 - t1);
+      for (int d = 0; d < ndims; d++)
+      {
+        double v1 = values[d * count + i - 1];
+        double v2 = values[d * count + i];
+        double v;
+        if (t1 == lower || (interp != LINEAR && lower < t2))
+          v = v1;
+        else if (lower == t2)
+          v = v2;
+        else
+          v = v1 + (double) ((long double) (v2 - v1) * ratio);
+        svalues[d * maxcount + nsamples] = v;
+      }
+      nsamples++;
+      /* Advance the bucket */
+      lower += tunits;
+    }
+    /* Advance the bucket if it is before the start of the segment */
+    else if (t1 >= lower)
+      lower += tunits;
+    /* Advance the segment if it is before the lower bound of the bucket */
+    else
+    {
+      /* If there are no more segments */
+      if (i == count - 1)
+        break;
+      i++;
+    }
+  }
+  return nsamples;
+}
+
+/**
+ * @brief Return a temporal float or geometry point sequence sampled according
+ * to period buckets using the resampling engine
+ * @param[in] seq Temporal value
+ * @param[in] lower_bucket,upper_bucket First and last buckets
+ * @param[in] tunits Time size of the buckets in PostgreSQL time units
+ * @param[in] maxcount Maximum number of samples
+ * @param[in] interp Interpolation of the result
+ * @return On empty result return @p NULL
+ */
+static TSequence *
+tsequence_tsample_fast(const TSequence *seq, TimestampTz lower_bucket,
+  TimestampTz upper_bucket, int64 tunits, int maxcount, interpType interp)
+{
+  int ndims = tsample_ndims(seq->temptype, seq->flags);
+  /* Allocate all the arrays in a single chunk */
+  size_t size = (sizeof(TimestampTz) + sizeof(double) * ndims) *
+    (seq->count + maxcount);
+  char *buf = palloc(size);
+  TimestampTz *times = (TimestampTz *) buf;
+  TimestampTz *stimes = times + seq->count;
+  double *values = (double *) (stimes + maxcount);
+  double *svalues = values + ndims * seq->count;
+  tsequence_sample_read(seq, ndims, times, values);
+  int count = tsequence_sample_merge(seq, times, values, ndims, lower_bucket,
+    upper_bucket, tunits, maxcount, stimes, svalues);
+  TSequence *result = NULL;
+  if (count > 0)
+  {
+    count = tsample_normalize(stimes, svalues, ndims, maxcount, count, interp);
+    result = tsequence_sample_make(seq, stimes, svalues, ndims, maxcount,
+      count, interp);
+  }
+  pfree(buf);
+  return result;
+}
+
 /**
  * @brief Return a temporal value sampled according to period buckets
  * @param[in] seq Temporal value
@@ -553,12 +1010,57 @@ tsequence_tsample(const TSequence *seq, const Interval *duration,
     tunits;
   /* Number of buckets */
   int count = (int) (((int64) upper_bucket - (int64) lower_bucket) / tunits) + 1;
+  if (tsequence_tsample_engine(seq))
+    return tsequence_tsample_fast(seq, lower_bucket, upper_bucket, tunits,
+      count, interp);
   TInstant **instants = palloc(sizeof(TInstant *) * count);
   int ninsts = tsequence_tsample_iter(seq, lower_bucket, upper_bucket, tunits,
     &instants[0]);
   return tsequence_make_free(instants, ninsts, true, true, interp, NORMALIZE);
 }
 
+/**
+ * @brief Return a temporal float or geometry point sequence set sampled
+ * according to period buckets into a discrete sequence using the resampling
+ * engine
+ * @param[in] ss Temporal value
+ * @param[in] lower_bucket,upper_bucket First and last buckets
+ * @param[in] tunits Time size of the buckets in PostgreSQL time units
+ * @param[in] maxcount Maximum number of samples
+ * @return On empty result return @p NULL
+ */
+static TSequence *
+tsequenceset_disc_tsample_fast(const TSequenceSet *ss,
+  TimestampTz lower_bucket, TimestampTz upper_bucket, int64 tunits,
+  int maxcount)
+{
+  int ndims = tsample_ndims(ss->temptype, ss->flags);
+  /* Allocate all the arrays in a single chunk, the input arrays are reused
+   * for all the sequences */
+  size_t size = (sizeof(TimestampTz) + sizeof(double) * ndims) *
+    (ss->totalcount + maxcount);
+  char *buf = palloc(size);
+  TimestampTz *times = (TimestampTz *) buf;
+  TimestampTz *stimes = times + ss->totalcount;
+  double *values = (double *) (stimes + maxcount);
+  double *svalues = values + ndims * ss->totalcount;
+  int count = 0;
+  for (int i = 0; i < ss->count; i++)
+  {
+    const TSequence *seq = TSEQUENCESET_SEQ_N(ss, i);
+    if (seq->count < 2)
+      continue;
+    tsequence_sample_read(seq, ndims, times, values);
+    count += tsequence_sample_merge(seq, times, values, ndims, lower_bucket,
+      upper_bucket, tunits, maxcount, &stimes[count], &svalues[count]);
+  }
+  TSequence *result = (count == 0) ? NULL :
+    tsequence_sample_make(TSEQUENCESET_SEQ_N(ss, 0), stimes, svalues, ndims,
+      maxcount, count, DISCRETE);
+  pfree(buf);
+  return result;
+}
+
 /**
  * @brief Return a temporal value sampled according to period buckets
  * @param[in] ss Temporal value
@@ -579,6 +1081,9 @@ tsequenceset_disc_tsample(const TSequenceSet *ss, const Interval *duration,
     tunits;
   /* Number of buckets */
   int count = (int) (((int64) upper_bucket - (int64) lower_bucket) / tunits) + 1;
+  if (ss->temptype == T_TFLOAT || ss->temptype == T_TGEOMPOINT)
+    return tsequenceset_disc_tsample_fast(ss, lower_bucket, upper_bucket,
+      tunits, count);
   TInstant **instants = palloc(sizeof(TInstant *) * count);
   /* Loop for each segment */
   int ninsts = 0;
@@ -1489,75 +1994,91 @@ dist3d_pt_seg(POINT3DZ *p, POINT3DZ *A, POINT3DZ *B)
   return dist3d_pt_pt(p, &c);
 }
 
+/**
+ * @brief Return the distance between an instant of a temporal point and the
+ * segment defined by two other instants
+ * @param[in] start,end Instants defining the segment
+ * @param[in] inst Instant
+ * @param[in] interp Interpolation of the segment
+ * @param[in] syncdist True when using the Synchronized Euclidean Distance
+ */
+static double
+tpointinst_simplify_dist(const TInstant *start, const TInstant *end,
+  const TInstant *inst, interpType interp, bool syncdist)
+{
+  double result;
+  Datum value;
+  if (MEOS_FLAGS_GET_Z(inst->flags))
+  {
+    POINT3DZ *p3k = (POINT3DZ *) DATUM_POINT3DZ_P(tinstant_val(inst));
+    if (syncdist)
+    {
+      value = tsegment_value_at_timestamptz(start, end, interp, inst->t);
+      POINT3DZ *p3_sync = (POINT3DZ *) DATUM_POINT3DZ_P(value);
+      result = dist3d_pt_pt(p3k, p3_sync);
+      pfree(DatumGetPointer(value));
+    }
+    else
+      result = dist3d_pt_seg(p3k,
+        (POINT3DZ *) DATUM_POINT3DZ_P(tinstant_val(start)),
+        (POINT3DZ *) DATUM_POINT3DZ_P(tinstant_val(end)));
+  }
+  else
+  {
+    POINT2D *p2k = (POINT2D *) DATUM_POINT2D_P(tinstant_val(inst));
+    if (syncdist)
+    {
+      value = tsegment_value_at_timestamptz(start, end, interp, inst->t);
+      POINT2D *p2_sync = (POINT2D *) DATUM_POINT2D_P(value);
+      result = dist2d_pt_pt(p2k, p2_sync);
+      pfree(DatumGetPointer(value));
+    }
+    else
+      result = dist2d_pt_seg(p2k,
+        (POINT2D *) DATUM_POINT2D_P(tinstant_val(start)),
+        (POINT2D *) DATUM_POINT2D_P(tinstant_val(end)));
+  }
+  return result;
+}
+
 /**
  * @brief Find a split when simplifying the temporal sequence point using the
  * Douglas-Peucker line simplification algorithm
  * @param[in] seq Temporal sequence
+ * @param[in] coords Optional coordinates of the sequence, used for finding the
+ * split with the distance kernels
  * @param[in] i1,i2 Indexes of the reference instants
  * @param[in] syncdist True when using the Synchronized Euclidean Distance
  * @param[out] split Location of the split
  * @param[out] dist Distance at the split
  */
 static void
-tpointseq_findsplit(const TSequence *seq, int i1, int i2, bool syncdist,
-  int *split, double *dist)
+tpointseq_findsplit(const TSequence *seq, const TPointCoords *coords, int i1,
+  int i2, bool syncdist, int *split, double *dist)
 {
-  POINT2D *p2k, *p2_sync, *p2a, *p2b;
-  POINT3DZ *p3k, *p3_sync, *p3a, *p3b;
-  Datum value;
   interpType interp = MEOS_FLAGS_GET_INTERP(seq->flags);
-  bool hasz = MEOS_FLAGS_GET_Z(seq->flags);
   double d = -1;
   *split = i1;
   *dist = -1;
   if (i1 + 1 >= i2)
     return;
 
-  /* Initialization of values wrt instants i1 and i2 */
-  const TInstant *start = TSEQUENCE_INST_N(seq, i1);
-  const TInstant *end = TSEQUENCE_INST_N(seq, i2);
-  if (hasz)
-  {
-    p3a = (POINT3DZ *) DATUM_POINT3DZ_P(tinstant_val(start));
-    p3b = (POINT3DZ *) DATUM_POINT3DZ_P(tinstant_val(end));
-  }
-  else
+  /* Find the split with the distance kernels and only compute the distance
+   * at the split */
+  int first = i1 + 1, last = i2;
+  if (coords)
   {
-    p2a = (POINT2D *) DATUM_POINT2D_P(tinstant_val(start));
-    p2b = (POINT2D *) DATUM_POINT2D_P(tinstant_val(end));
+    first = tpointcoords_findsplit(coords, i1, i2, syncdist);
+    last = first + 1;
   }
 
   /* Loop for every instant between i1 and i2 */
-  for (int idx = i1 + 1; idx < i2; idx++)
+  const TInstant *start = TSEQUENCE_INST_N(seq, i1);
+  const TInstant *end = TSEQUENCE_INST_N(seq, i2);
+  for (int idx = first; idx < last; idx++)
   {
-    double d_tmp;
-    const TInstant *inst = TSEQUENCE_INST_N(seq, idx);
-    if (hasz)
-    {
-      p3k = (POINT3DZ *) DATUM_POINT3DZ_P(tinstant_val(inst));
-      if (syncdist)
-      {
-        value = tsegment_value_at_timestamptz(start, end, interp, inst->t);
-        p3_sync = (POINT3DZ *) DATUM_POINT3DZ_P(value);
-        d_tmp = dist3d_pt_pt(p3k, p3_sync);
-        pfree(DatumGetPointer(value));
-      }
-      else
-        d_tmp = dist3d_pt_seg(p3k, p3a, p3b);
-    }
-    else
-    {
-      p2k = (POINT2D *) DATUM_POINT2D_P(tinstant_val(inst));
-      if (syncdist)
-      {
-        value = tsegment_value_at_timestamptz(start, end, interp, inst->t);
-        p2_sync = (POINT2D *) DATUM_POINT2D_P(value);
-        d_tmp = dist2d_pt_pt(p2k, p2_sync);
-        pfree(DatumGetPointer(value));
-      }
-      else
-        d_tmp = dist2d_pt_seg(p2k, p2a, p2b);
-    }
+    double d_tmp = tpointinst_simplify_dist(start, end,
+      TSEQUENCE_INST_N(seq, idx), interp, syncdist);
     if (d_tmp > d)
     {
       /* record the maximum */
@@ -1569,6 +2090,21 @@ tpointseq_findsplit(const TSequence *seq, int i1, int i2, bool syncdist,
   return;
 }
 
+/**
+ * @brief Return the coordinates of a temporal sequence point for finding the
+ * splits with the distance kernels, or @p NULL when they cannot be used
+ * @note The Synchronized Euclidean Distance of geodetic points interpolates
+ * on the spheroid and thus the kernels are not used
+ */
+static TPointCoords *
+tpointseq_simplify_coords(const TSequence *seq, bool syncdist)
+{
+  if (! tgeo_type(seq->temptype) ||
+      (syncdist && MEOS_FLAGS_GET_GEODETIC(seq->flags)))
+    return NULL;
+  return tpointseq_coords(seq);
+}
+
 /*****************************************************************************/
 
 /**
@@ -1592,6 +2128,7 @@ tsequence_simplify_max_dist(const TSequence *seq, double dist, bool syncdist,
            ninsts = 0;     /* Number of instants in the result */
   int split;          /* Index of the split */
   double d;           /* Distance */
+  TPointCoords *coords = tpointseq_simplify_coords(seq, syncdist);
   for (int i = 0; i < seq->count; i++)
   {
     cur = TSEQUENCE_INST_N(seq, i);
@@ -1605,7 +2142,7 @@ tsequence_simplify_max_dist(const TSequence *seq, double dist, bool syncdist,
     if (seq->temptype == T_TFLOAT)
       tfloatseq_findsplit(seq, start, i, &split, &d);
     else /* tgeo_type(seq->temptype) */
-      tpointseq_findsplit(seq, start, i, syncdist, &split, &d);
+      tpointseq_findsplit(seq, coords, start, i, syncdist, &split, &d);
     bool dosplit = (d >= 0 && (d > dist || start + i + 1 < minpts));
     if (dosplit)
     {
@@ -1615,6 +2152,8 @@ tsequence_simplify_max_dist(const TSequence *seq, double dist, bool syncdist,
       continue;
     }
   }
+  if (coords)
+    tpointcoords_free(coords);
   if (ninsts > 0 && instants[ninsts - 1] != cur)
     instants[ninsts++] = cur;
   TSequence *result = tsequence_make(instants, ninsts,
@@ -1735,6 +2274,7 @@ tsequence_simplify_dp(const TSequence *seq, double dist, bool syncdist,
     outlist = outlist_static;
   }
 
+  TPointCoords *coords = tpointseq_simplify_coords(seq, syncdist);
   i1 = 0;
   stack[++sp] = seq->count - 1;
   /* Add first point to output list */
@@ -1745,7 +2285,8 @@ tsequence_simplify_dp(const TSequence *seq, double dist, bool syncdist,
     if (seq->temptype == T_TFLOAT)
       tfloatseq_findsplit(seq, i1, stack[sp], &split, &d);
     else /* tgeo_type(seq->temptype) */
-      tpointseq_findsplit(seq, i1, stack[sp], syncdist, &split, &d);
+      tpointseq_findsplit(seq, coords, i1, stack[sp], syncdist, &split,
+        &d);
     bool dosplit = (d >= 0 && (d > dist || outn + sp + 1 < minpts));
     if (dosplit)
       stack[++sp] = split;
@@ -1756,6 +2297,8 @@ tsequence_simplify_dp(const TSequence *seq, double dist, bool syncdist,
     }
   }
   while (sp >= 0);
+  if (coords)
+    tpointcoords_free(coords);
 
   /* Order the list of points kept */
   qsort(outlist, outn, sizeof(int), int_cmp);
@@ -1834,3 +2377,1050 @@ temporal_simplify_dp(const Temporal *temp, double dist, bool syncdist)
 }
 
 /*****************************************************************************/
+
+/*****************************************************************************
+ * Simplification with a budget of instants
+ *
+ * Contrary to the above functions, which receive a distance threshold, the
+ * following functions receive the number of instants of the result and keep
+ * the instants that minimize the error. This is useful, e.g., for producing
+ * vector tiles of predictable size. Both functions use a priority queue:
+ * - The top-down Douglas-Peucker variant repeatedly splits the segment whose
+ *   farthest instant is the farthest among all segments.
+ * - The bottom-up Visvalingam-Whyatt algorithm repeatedly removes the instant
+ *   whose triangle with its neighbours has the smallest area.
+ * The instants of all the sequences of a sequence set compete for the same
+ * budget, where the bounds of every sequence are always kept.
+ *
+ * The bottom-up algorithm runs in O(n log n) for n instants, since removing
+ * an instant only updates the areas of its two neighbours. This is not the
+ * case for the top-down variant: the farthest instant of the two segments
+ * resulting from a split is found by scanning them, so that every split
+ * costs the length of the segment split. For k instants kept the cost is
+ * thus O(n log k) when the splits are balanced but O(n k) in the worst case,
+ * as for the batch Douglas-Peucker algorithm.
+ *****************************************************************************/
+
+/**
+ * Structure to represent an element of the priority queue used for
+ * simplifying with a budget of instants
+ */
+typedef struct
+{
+  double key;         /**< Priority, the largest one is at the top */
+  int i1;             /**< Index of the first instant or of the instant */
+  int i2;             /**< Index of the last instant */
+  int split;          /**< Index of the split */
+  int seqno;          /**< Number of the sequence */
+  int stamp;          /**< Version of the element, used for lazy deletion */
+} SimplifyHeapElem;
+
+/**
+ * Structure to represent the priority queue used for simplifying with a
+ * budget of instants
+ */
+typedef struct
+{
+  int count;              /**< Number of elements */
+  int maxcount;           /**< Size of the array of elements */
+  SimplifyHeapElem *elems; /**< Array of elements */
+} SimplifyHeap;
+
+/**
+ * @brief Push an element into a priority queue
+ */
+static void
+simplifyheap_push(SimplifyHeap *heap, SimplifyHeapElem elem)
+{
+  if (heap->count == heap->maxcount)
+  {
+    heap->maxcount *= 2;
+    heap->elems = repalloc(heap->elems,
+      sizeof(SimplifyHeapElem) * heap->maxcount);
+  }
+  /* Sift up */
+  int i = heap->count++;
+  while (i > 0)
+  {
+    int parent = (i - 1) / 2;
+    if (heap->elems[parent].key >= elem.key)
+      break;
+    heap->elems[i] = heap->elems[parent];
+    i = parent;
+  }
+  heap->elems[i] = elem;
+  return;
+}
+
+/**
+ * @brief Pop the element with the largest priority from a priority queue
+ */
+static SimplifyHeapElem
+simplifyheap_pop(SimplifyHeap *heap)
+{
+  assert(heap->count > 0);
+  SimplifyHeapElem result = heap->elems[0];
+  SimplifyHeapElem last = heap->elems[--heap->count];
+  /* Sift down */
+  int i = 0;
+  while (true)
+  {
+    int child = 2 * i + 1;
+    if (child >= heap->count)
+      break;
+    if (child + 1 < heap->count &&
+        heap->elems[child + 1].key > heap->elems[child].key)
+      child++;
+    if (last.key >= heap->elems[child].key)
+      break;
+    heap->elems[i] = heap->elems[child];
+    i = child;
+  }
+  if (heap->count > 0)
+    heap->elems[i] = last;
+  return result;
+}
+
+/**
+ * @brief Return the instants of a temporal sequence (set) in a single array
+ * @param[in] temp Temporal value
+ * @param[out] nseqs Number of sequences
+ * @param[out] offsets Index of the first instant of every sequence in the
+ * array, the last element of the array being the total number of instants
+ */
+static const TInstant **
+temporal_simplify_instants(const Temporal *temp, int *nseqs, int **offsets)
+{
+  const TSequence **sequences;
+  if (temp->subtype == TSEQUENCE)
+  {
+    *nseqs = 1;
+    sequences = palloc(sizeof(TSequence *));
+    sequences[0] = (const TSequence *) temp;
+  }
+  else /* temp->subtype == TSEQUENCESET */
+  {
+    const TSequenceSet *ss = (const TSequenceSet *) temp;
+    *nseqs = ss->count;
+    sequences = palloc(sizeof(TSequence *) * ss->count);
+    for (int i = 0; i < ss->count; i++)
+      sequences[i] = TSEQUENCESET_SEQ_N(ss, i);
+  }
+  int *offs = palloc(sizeof(int) * (*nseqs + 1));
+  offs[0] = 0;
+  for (int i = 0; i < *nseqs; i++)
+    offs[i + 1] = offs[i] + sequences[i]->count;
+  const TInstant **result = palloc(sizeof(TInstant *) * offs[*nseqs]);
+  for (int i = 0; i < *nseqs; i++)
+    for (int j = 0; j < sequences[i]->count; j++)
+      result[offs[i] + j] = TSEQUENCE_INST_N(sequences[i], j);
+  pfree(sequences);
+  *offsets = offs;
+  return result;
+}
+
+/**
+ * @brief Return a temporal sequence (set) restricted to the instants that are
+ * kept by the simplification
+ * @param[in] temp Temporal value
+ * @param[in] instants Array of instants of the temporal value
+ * @param[in] nseqs Number of sequences
+ * @param[in] offsets Index of the first instant of every sequence in the array
+ * @param[in] keep Array stating whether every instant is kept
+ * @param[in] normalize True if the result is normalized. It is not when
+ * simplifying with a budget of instants to ensure the number of instants.
+ */
+static Temporal *
+temporal_simplify_keep(const Temporal *temp, const TInstant **instants,
+  int nseqs, const int *offsets, const bool *keep, bool normalize)
+{
+  const TInstant **kept = palloc(sizeof(TInstant *) * offsets[nseqs]);
+  TSequence **sequences = palloc(sizeof(TSequence *) * nseqs);
+  for (int i = 0; i < nseqs; i++)
+  {
+    const TSequence *seq = (temp->subtype == TSEQUENCE) ?
+      (const TSequence *) temp :
+      TSEQUENCESET_SEQ_N((const TSequenceSet *) temp, i);
+    int ninsts = 0;
+    for (int j = offsets[i]; j < offsets[i + 1]; j++)
+    {
+      if (keep[j])
+        kept[ninsts++] = instants[j];
+    }
+    sequences[i] = tsequence_make(kept, ninsts, seq->period.lower_inc,
+      seq->period.upper_inc, LINEAR, normalize);
+  }
+  pfree(kept);
+  if (temp->subtype == TSEQUENCE)
+  {
+    Temporal *result = (Temporal *) sequences[0];
+    pfree(sequences);
+    return result;
+  }
+  return (Temporal *) tsequenceset_make_free(sequences, nseqs, normalize);
+}
+
+/**
+ * @brief Return the number of instants kept by default when simplifying with
+ * a budget of instants, i.e., the bounds of every sequence, and mark them
+ */
+static int
+temporal_simplify_bounds(int nseqs, const int *offsets, bool *keep)
+{
+  int result = 0;
+  for (int i = 0; i < nseqs; i++)
+  {
+    keep[offsets[i]] = true;
+    keep[offsets[i + 1] - 1] = true;
+    result += (offsets[i + 1] - offsets[i] == 1) ? 1 : 2;
+  }
+  return result;
+}
+
+/**
+ * @brief Ensure the validity of the arguments of the simplification with a
+ * budget of instants
+ */
+static bool
+ensure_valid_simplify_npts(const Temporal *temp, int npts)
+{
+  if (! ensure_not_null((void *) temp) ||
+      ! ensure_tnumber_tgeo_type(temp->temptype))
+    return false;
+  if (npts < 2)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "The number of instants must be at least 2: %d", npts);
+    return false;
+  }
+  return true;
+}
+
+/**
+ * @brief Push into the priority queue the split of a segment of a sequence
+ * when simplifying with a budget of instants using Douglas-Peucker
+ */
+static void
+tsequence_simplify_dp_push(SimplifyHeap *heap, const TSequence *seq,
+  const TPointCoords *coords, int seqno, int offset, int i1, int i2,
+  bool syncdist)
+{
+  int split;
+  double d;
+  /* For temporal floats only Synchronized Distance is used */
+  if (seq->temptype == T_TFLOAT)
+    tfloatseq_findsplit(seq, i1, i2, &split, &d);
+  else /* tgeo_type(seq->temptype) */
+    tpointseq_findsplit(seq, coords, i1, i2, syncdist, &split, &d);
+  if (d < 0)
+    return;
+  SimplifyHeapElem elem = {d, offset + i1, offset + i2, offset + split, seqno, 0};
+  simplifyheap_push(heap, elem);
+  return;
+}
+
+/**
+ * @ingroup meos_temporal_analytics_simplify
+ * @brief Return a temporal float/point simplified to a given number of
+ * instants using a top-down Douglas-Peucker line simplification algorithm
+ * @param[in] temp Temporal value
+ * @param[in] npts Number of instants of the result
+ * @param[in] syncdist True when the Synchronized Distance is used, false when
+ * the spatial-only distance is used. Only used for temporal points.
+ * @details The segment whose farthest instant is the farthest among all the
+ * segments is split until the result has the given number of instants. The
+ * bounds of every sequence are always kept, and thus the result may have more
+ * instants than requested for sequence sets with many sequences. Contrary to
+ * #temporal_simplify_vw, the cost is not O(n log n): every split scans the
+ * segment split, which gives O(n k) in the worst case for k instants kept.
+ * @note The function applies only for temporal sequences or sequence sets with
+ * linear interpolation. In all other cases, it returns a copy of the temporal
+ * value.
+ * @csqlfn #Temporal_simplify_max_insts()
+ */
+Temporal *
+temporal_simplify_max_insts(const Temporal *temp, int npts, bool syncdist)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_valid_simplify_npts(temp, npts))
+    return NULL;
+
+  if (temp->subtype == TINSTANT || ! MEOS_FLAGS_LINEAR_INTERP(temp->flags) ||
+      temporal_num_instants(temp) <= npts)
+    return temporal_cp(temp);
+
+  int nseqs, *offsets;
+  const TInstant **instants = temporal_simplify_instants(temp, &nseqs,
+    &offsets);
+  bool *keep = palloc0(sizeof(bool) * offsets[nseqs]);
+  int nkept = temporal_simplify_bounds(nseqs, offsets, keep);
+  const TSequence **sequences = palloc(sizeof(TSequence *) * nseqs);
+  TPointCoords **coords = palloc(sizeof(TPointCoords *) * nseqs);
+  SimplifyHeap heap;
+  heap.count = 0;
+  heap.maxcount = 64;
+  heap.elems = palloc(sizeof(SimplifyHeapElem) * heap.maxcount);
+  for (int i = 0; i < nseqs; i++)
+  {
+    sequences[i] = (temp->subtype == TSEQUENCE) ? (const TSequence *) temp :
+      TSEQUENCESET_SEQ_N((const TSequenceSet *) temp, i);
+    coords[i] = tpointseq_simplify_coords(sequences[i], syncdist);
+    tsequence_simplify_dp_push(&heap, sequences[i], coords[i], i, offsets[i],
+      0, sequences[i]->count - 1, syncdist);
+  }
+
+  /* Split the farthest segment until the budget is exhausted */
+  while (nkept < npts && heap.count > 0)
+  {
+    SimplifyHeapElem elem = simplifyheap_pop(&heap);
+    keep[elem.split] = true;
+    nkept++;
+    int i = elem.seqno, off = offsets[i];
+    tsequence_simplify_dp_push(&heap, sequences[i], coords[i], i, off,
+      elem.i1 - off, elem.split - off, syncdist);
+    tsequence_simplify_dp_push(&heap, sequences[i], coords[i], i, off,
+      elem.split - off, elem.i2 - off, syncdist);
+  }
+
+  Temporal *result = temporal_simplify_keep(temp, instants, nseqs, offsets,
+    keep, NORMALIZE_NO);
+  for (int i = 0; i < nseqs; i++)
+    if (coords[i])
+      tpointcoords_free(coords[i]);
+  pfree(coords); pfree(sequences); pfree(heap.elems);
+  pfree(instants); pfree(offsets); pfree(keep);
+  return result;
+}
+
+/*****************************************************************************/
+
+/**
+ * @brief Return the area of the triangle defined by three instants of a
+ * temporal float or point
+ * @details For temporal floats the triangle is defined in the plane (time,
+ * value), where the time is expressed in seconds. For temporal points the
+ * triangle is defined in the space, where the time is not considered.
+ */
+static double
+tinstant_triangle_area(const TInstant *inst1, const TInstant *inst2,
+  const TInstant *inst3)
+{
+  if (inst1->temptype == T_TFLOAT)
+  {
+    double ratio = (double) (inst2->t - inst1->t) /
+      (double) (inst3->t - inst1->t);
+    double val1 = DatumGetFloat8(tinstant_val(inst1));
+    double val3 = DatumGetFloat8(tinstant_val(inst3));
+    double value_interp = val1 + (val3 - val1) * ratio;
+    return 0.5 * fabs(DatumGetFloat8(tinstant_val(inst2)) - value_interp) *
+      ((double) (inst3->t - inst1->t) / USECS_PER_SEC);
+  }
+  if (MEOS_FLAGS_GET_Z(inst1->flags))
+  {
+    const POINT3DZ *p1 = DATUM_POINT3DZ_P(tinstant_val(inst1));
+    const POINT3DZ *p2 = DATUM_POINT3DZ_P(tinstant_val(inst2));
+    const POINT3DZ *p3 = DATUM_POINT3DZ_P(tinstant_val(inst3));
+    double ux = p2->x - p1->x, uy = p2->y - p1->y, uz = p2->z - p1->z;
+    double vx = p3->x - p1->x, vy = p3->y - p1->y, vz = p3->z - p1->z;
+    return 0.5 * hypot3d(uy * vz - uz * vy, uz * vx - ux * vz,
+      ux * vy - uy * vx);
+  }
+  const POINT2D *p1 = DATUM_POINT2D_P(tinstant_val(inst1));
+  const POINT2D *p2 = DATUM_POINT2D_P(tinstant_val(inst2));
+  const POINT2D *p3 = DATUM_POINT2D_P(tinstant_val(inst3));
+  return 0.5 * fabs((p2->x - p1->x) * (p3->y - p1->y) -
+    (p3->x - p1->x) * (p2->y - p1->y));
+}
+
+/**
+ * @ingroup meos_temporal_analytics_simplify
+ * @brief Return a temporal float/point simplified to a given number of
+ * instants using the Visvalingam-Whyatt line simplification algorithm
+ * @param[in] temp Temporal value
+ * @param[in] npts Number of instants of the result
+ * @details The instant whose triangle with its neighbours has the smallest
+ * area is removed until the result has the given number of instants. The
+ * area of the neighbours is then recomputed, where as usual the area of an
+ * instant is never less than the one of the instants removed before it. The
+ * bounds of every sequence are always kept, and thus the result may have more
+ * instants than requested for sequence sets with many sequences.
+ * @note The function applies only for temporal sequences or sequence sets with
+ * linear interpolation. In all other cases, it returns a copy of the temporal
+ * value.
+ * @csqlfn #Temporal_simplify_vw()
+ */
+Temporal *
+temporal_simplify_vw(const Temporal *temp, int npts)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_valid_simplify_npts(temp, npts))
+    return NULL;
+
+  int ninsts = temporal_num_instants(temp);
+  if (temp->subtype == TINSTANT || ! MEOS_FLAGS_LINEAR_INTERP(temp->flags) ||
+      ninsts <= npts)
+    return temporal_cp(temp);
+
+  int nseqs, *offsets;
+  const TInstant **instants = temporal_simplify_instants(temp, &nseqs,
+    &offsets);
+  bool *keep = palloc0(sizeof(bool) * ninsts);
+  int nbounds = temporal_simplify_bounds(nseqs, offsets, keep);
+  /* Doubly-linked list of the instants that are not removed */
+  int *prev = palloc(sizeof(int) * ninsts);
+  int *next = palloc(sizeof(int) * ninsts);
+  int *stamp = palloc0(sizeof(int) * ninsts);
+  SimplifyHeap heap;
+  heap.count = 0;
+  heap.maxcount = ninsts;
+  heap.elems = palloc(sizeof(SimplifyHeapElem) * heap.maxcount);
+  for (int i = 0; i < ninsts; i++)
+  {
+    prev[i] = i - 1;
+    next[i] = i + 1;
+    if (keep[i])
+      continue;
+    /* The largest priority is the smallest area */
+    double area = tinstant_triangle_area(instants[i - 1], instants[i],
+      instants[i + 1]);
+    SimplifyHeapElem elem = {-area, i, i, i, 0, 0};
+    simplifyheap_push(&heap, elem);
+  }
+
+  /* Remove the instant with the smallest area until reaching the budget */
+  int nremain = ninsts;
+  while (nremain > Max(npts, nbounds) && heap.count > 0)
+  {
+    SimplifyHeapElem elem = simplifyheap_pop(&heap);
+    int i = elem.i1;
+    /* Skip the elements that have been superseded */
+    if (elem.stamp != stamp[i])
+      continue;
+    stamp[i] = -1;
+    nremain--;
+    next[prev[i]] = next[i];
+    prev[next[i]] = prev[i];
+    int neighbours[2] = {prev[i], next[i]};
+    for (int j = 0; j < 2; j++)
+    {
+      int k = neighbours[j];
+      if (keep[k])
+        continue;
+      double area = Max(-elem.key, tinstant_triangle_area(instants[prev[k]],
+        instants[k], instants[next[k]]));
+      SimplifyHeapElem elem1 = {-area, k, k, k, 0, ++stamp[k]};
+      simplifyheap_push(&heap, elem1);
+    }
+  }
+  for (int i = 0; i < ninsts; i++)
+    keep[i] = keep[i] || stamp[i] >= 0;
+
+  Temporal *result = temporal_simplify_keep(temp, instants, nseqs, offsets,
+    keep, NORMALIZE_NO);
+  pfree(prev); pfree(next); pfree(stamp); pfree(heap.elems);
+  pfree(instants); pfree(offsets); pfree(keep);
+  return result;
+}
+
+/*****************************************************************************
+ * Multi-resolution simplification
+ *
+ * Map clients request the same temporal values at many zoom levels. The
+ * following functions compute in a single pass a level-of-detail pyramid in
+ * which the level k is simplified with the Douglas-Peucker algorithm using a
+ * tolerance of dist * 2^k. Since the split chosen by the algorithm for a
+ * segment does not depend on the tolerance, the full split tree is computed
+ * once and every instant receives a significance, i.e., the minimum of its
+ * distance and the significance of the instant that split its parent segment.
+ * An instant is then kept for a tolerance if and only if its significance is
+ * greater than the tolerance, and thus every level of the pyramid is the same
+ * as the one given by #temporal_simplify_dp.
+ *****************************************************************************/
+
+/**
+ * @brief Compute the significance of the instants of a temporal sequence
+ * float/point for the Douglas-Peucker line simplification algorithm
+ * @param[in] seq Temporal sequence
+ * @param[in] syncdist True when the Synchronized Distance is used, false when
+ * the spatial-only distance is used
+ * @param[out] sig Array of significances, the bounds of the sequence have a
+ * significance of @p DBL_MAX
+ */
+static void
+tsequence_dp_significance(const TSequence *seq, bool syncdist, double *sig)
+{
+  int count = seq->count;
+  sig[0] = sig[count - 1] = DBL_MAX;
+  if (count < 3)
+    return;
+  /* Recursion stack with the end of the segments and their significance */
+  int *stack = palloc(sizeof(int) * count);
+  double *sigstack = palloc(sizeof(double) * count);
+  TPointCoords *coords = tpointseq_simplify_coords(seq, syncdist);
+  int sp = -1, i1 = 0, split;
+  double d;
+  stack[++sp] = count - 1;
+  sigstack[sp] = DBL_MAX;
+  do
+  {
+    /* For temporal floats only Synchronized Distance is used */
+    if (seq->temptype == T_TFLOAT)
+      tfloatseq_findsplit(seq, i1, stack[sp], &split, &d);
+    else /* tgeo_type(seq->temptype) */
+      tpointseq_findsplit(seq, coords, i1, stack[sp], syncdist, &split, &d);
+    if (d >= 0)
+    {
+      sig[split] = Min(d, sigstack[sp]);
+      stack[++sp] = split;
+      sigstack[sp] = sig[split];
+    }
+    else
+      i1 = stack[sp--];
+  }
+  while (sp >= 0);
+  if (coords)
+    tpointcoords_free(coords);
+  pfree(stack); pfree(sigstack);
+  return;
+}
+
+/**
+ * @ingroup meos_temporal_analytics_simplify
+ * @brief Return a level-of-detail pyramid of a temporal float/point
+ * simplified using the Douglas-Peucker line simplification algorithm
+ * @param[in] temp Temporal value
+ * @param[in] dist Distance of the first level in the units of the values for
+ * temporal floats or the units of the coordinate system for temporal points,
+ * the distance is doubled for every subsequent level
+ * @param[in] nlevels Number of levels
+ * @param[in] syncdist True when the Synchronized Distance is used, false when
+ * the spatial-only distance is used. Only used for temporal points.
+ * @return Array of @p nlevels temporal values, where the level k is the same
+ * as the result of #temporal_simplify_dp with a distance of @p dist * 2^k
+ * @note The funcion applies only for temporal sequences or sequence sets with
+ * linear interpolation. In all other cases, all the levels are a copy of the
+ * temporal value.
+ * @csqlfn #Temporal_simplify_dp_pyramid()
+ */
+Temporal **
+temporal_simplify_dp_pyramid(const Temporal *temp, double dist, int nlevels,
+  bool syncdist)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) temp) ||
+      ! ensure_tnumber_tgeo_type(temp->temptype) ||
+      ! ensure_positive_datum(Float8GetDatum(dist), T_FLOAT8))
+    return NULL;
+  if (nlevels < 1)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "The number of levels must be at least 1: %d", nlevels);
+    return NULL;
+  }
+
+  Temporal **result = palloc(sizeof(Temporal *) * nlevels);
+  if (temp->subtype == TINSTANT || ! MEOS_FLAGS_LINEAR_INTERP(temp->flags))
+  {
+    for (int i = 0; i < nlevels; i++)
+      result[i] = temporal_cp(temp);
+    return result;
+  }
+
+  int nseqs, *offsets;
+  const TInstant **instants = temporal_simplify_instants(temp, &nseqs,
+    &offsets);
+  double *sig = palloc(sizeof(double) * offsets[nseqs]);
+  for (int i = 0; i < nseqs; i++)
+  {
+    const TSequence *seq = (temp->subtype == TSEQUENCE) ?
+      (const TSequence *) temp :
+      TSEQUENCESET_SEQ_N((const TSequenceSet *) temp, i);
+    tsequence_dp_significance(seq, syncdist, &sig[offsets[i]]);
+  }
+  bool *keep = palloc(sizeof(bool) * offsets[nseqs]);
+  double tolerance = dist;
+  for (int i = 0; i < nlevels; i++)
+  {
+    for (int j = 0; j < offsets[nseqs]; j++)
+      keep[j] = sig[j] > tolerance;
+    result[i] = temporal_simplify_keep(temp, instants, nseqs, offsets, keep,
+      NORMALIZE);
+    tolerance *= 2;
+  }
+  pfree(instants); pfree(offsets); pfree(sig); pfree(keep);
+  return result;
+}
+
+/**
+ * @ingroup meos_temporal_analytics_simplify
+ * @brief Return the level of a level-of-detail pyramid to use for a
+ * tolerance
+ * @param[in] dist Distance of the first level of the pyramid
+ * @param[in] nlevels Number of levels of the pyramid
+ * @param[in] tolerance Tolerance, e.g., the size of a pixel
+ * @return Coarsest level whose distance does not exceed the tolerance, or the
+ * first level when the tolerance is less than the distance of the first level
+ * @see #temporal_simplify_dp_pyramid
+ */
+int
+temporal_pyramid_level(double dist, int nlevels, double tolerance)
+{
+  int result = 0;
+  while (result < nlevels - 1 && dist * 2 <= tolerance)
+  {
+    dist *= 2;
+    result++;
+  }
+  return result;
+}
+
+/*****************************************************************************
+ * Online simplification
+ *
+ * The instants of a live temporal value are pushed one by one into a window
+ * of bounded size and the instants that are kept by the simplification are
+ * emitted as soon as they are final, so that they can be appended to an
+ * expandable temporal value as the data arrives. Two methods are provided:
+ * - The opening window method extends the window while the distance of the
+ *   intermediate instants to the segment joining its bounds does not exceed
+ *   the threshold. Otherwise, the instant at the maximum distance is kept and
+ *   the window restarts from it. When the window does not exceed the maximum
+ *   number of instants, the result is the same as the one of
+ *   #temporal_simplify_max_dist.
+ * - The SQUISH-E method removes from the window the instants whose priority
+ *   does not exceed the threshold, where the priority of an instant is its
+ *   distance to the segment joining its neighbours plus the maximum priority
+ *   of the removed instants between them, which bounds the error introduced
+ *   by the removal. When the window is full, its oldest instant is kept.
+ *****************************************************************************/
+
+/**
+ * @brief Return the distance between an instant of a temporal float or point
+ * and the linear segment defined by two other instants
+ */
+static double
+tinstant_simplify_dist(const TInstant *start, const TInstant *end,
+  const TInstant *inst, bool syncdist)
+{
+  if (inst->temptype != T_TFLOAT)
+    return tpointinst_simplify_dist(start, end, inst, LINEAR, syncdist);
+  /* For temporal floats only the Synchronized Distance is used */
+  double startval = DatumGetFloat8(tinstant_val(start));
+  double endval = DatumGetFloat8(tinstant_val(end));
+  double ratio = (double) (inst->t - start->t) / (double) (end->t - start->t);
+  double value_interp = startval + (endval - startval) * ratio;
+  return fabs(DatumGetFloat8(tinstant_val(inst)) - value_interp);
+}
+
+/**
+ * @brief Append a copy of an instant to the instants emitted by an online
+ * simplifier
+ */
+static void
+simplify_state_emit(SimplifyState *state, TInstant *inst)
+{
+  if (state->nemitted == state->maxemitted)
+  {
+    state->maxemitted *= 2;
+    state->emitted = repalloc(state->emitted,
+      sizeof(TInstant *) * state->maxemitted);
+  }
+  state->emitted[state->nemitted++] = tinstant_copy(inst);
+  return;
+}
+
+/**
+ * @brief Remove the first instants of the window of an online simplifier
+ * @param[in] state State
+ * @param[in] n Number of instants to remove
+ */
+static void
+simplify_state_shift(SimplifyState *state, int n)
+{
+  for (int i = 0; i < n; i++)
+    pfree(state->window[i]);
+  state->count -= n;
+  memmove(state->window, &state->window[n], sizeof(TInstant *) * state->count);
+  memmove(state->priority, &state->priority[n], sizeof(double) * state->count);
+  memmove(state->error, &state->error[n], sizeof(double) * state->count);
+  return;
+}
+
+/**
+ * @brief Compute the priority of an intermediate instant of the window of an
+ * online simplifier using the SQUISH-E method
+ */
+static void
+simplify_state_priority(SimplifyState *state, int i)
+{
+  state->priority[i] = state->error[i] + tinstant_simplify_dist(
+    state->window[i - 1], state->window[i + 1], state->window[i],
+    state->syncdist);
+  return;
+}
+
+/**
+ * @brief Push an instant into an online simplifier using the opening window
+ * method
+ */
+static void
+simplify_push_openwindow(SimplifyState *state)
+{
+  int n = state->count;
+  if (n < 3)
+    return;
+  /* Find the instant at the maximum distance to the segment joining the
+   * bounds of the window */
+  const TInstant *start = state->window[0];
+  const TInstant *end = state->window[n - 1];
+  int split = 0;
+  double d = -1;
+  for (int i = 1; i < n - 1; i++)
+  {
+    double d_tmp = tinstant_simplify_dist(start, end, state->window[i],
+      state->syncdist);
+    if (d_tmp > d)
+    {
+      d = d_tmp;
+      split = i;
+    }
+  }
+  /* When the window is full, keep its last intermediate instant */
+  if (d <= state->dist && n == state->maxpts)
+    split = n - 2;
+  else if (d <= state->dist)
+    return;
+  simplify_state_emit(state, state->window[split]);
+  simplify_state_shift(state, split);
+  return;
+}
+
+/**
+ * @brief Push an instant into an online simplifier using the SQUISH-E method
+ */
+static void
+simplify_push_squishe(SimplifyState *state)
+{
+  int n = state->count;
+  state->error[n - 1] = 0.0;
+  if (n < 3)
+    return;
+  simplify_state_priority(state, n - 2);
+  /* Remove the intermediate instants whose priority does not exceed the
+   * threshold */
+  while (state->count > 2)
+  {
+    int min = 1;
+    for (int i = 2; i < state->count - 1; i++)
+    {
+      if (state->priority[i] < state->priority[min])
+        min = i;
+    }
+    double priority = state->priority[min];
+    if (priority > state->dist)
+      break;
+    pfree(state->window[min]);
+    state->count--;
+    memmove(&state->window[min], &state->window[min + 1],
+      sizeof(TInstant *) * (state->count - min));
+    memmove(&state->priority[min], &state->priority[min + 1],
+      sizeof(double) * (state->count - min));
+    memmove(&state->error[min], &state->error[min + 1],
+      sizeof(double) * (state->count - min));
+    /* Propagate the error of the removed instant to its neighbours */
+    state->error[min - 1] = Max(state->error[min - 1], priority);
+    state->error[min] = Max(state->error[min], priority);
+    if (min - 1 > 0)
+      simplify_state_priority(state, min - 1);
+    if (min < state->count - 1)
+      simplify_state_priority(state, min);
+  }
+  /* When the window is full, keep its oldest intermediate instant */
+  if (state->count == state->maxpts)
+  {
+    simplify_state_emit(state, state->window[1]);
+    simplify_state_shift(state, 1);
+  }
+  return;
+}
+
+/**
+ * @ingroup meos_temporal_analytics_simplify
+ * @brief Return a new online simplifier for the instants of a live temporal
+ * float or point
+ * @param[in] dist Distance threshold in the units of the values for temporal
+ * floats or the units of the coordinate system for temporal points
+ * @param[in] syncdist True when the Synchronized Euclidean Distance (SED) is
+ * used, false when the spatial-only distance is used. Only used for temporal
+ * points.
+ * @param[in] maxpts Maximum number of instants kept in memory, which must be
+ * at least 3
+ * @param[in] squishe True when using the SQUISH-E method, false when using the
+ * opening window method
+ * @return On error return @p NULL
+ * @see #temporal_simplify_push, #temporal_simplify_emit,
+ * #temporal_simplify_close, #temporal_simplify_free
+ */
+SimplifyState *
+temporal_simplify_open(double dist, bool syncdist, int maxpts, bool squishe)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_positive_datum(Float8GetDatum(dist), T_FLOAT8))
+    return NULL;
+  if (maxpts < 3)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "The maximum number of instants of an online simplifier must be at least 3");
+    return NULL;
+  }
+
+  SimplifyState *result = palloc0(sizeof(SimplifyState));
+  result->dist = dist;
+  result->syncdist = syncdist;
+  result->squishe = squishe;
+  result->maxpts = maxpts;
+  result->window = palloc(sizeof(TInstant *) * maxpts);
+  result->priority = palloc0(sizeof(double) * maxpts);
+  result->error = palloc0(sizeof(double) * maxpts);
+  result->maxemitted = 64;
+  result->emitted = palloc(sizeof(TInstant *) * result->maxemitted);
+  return result;
+}
+
+/**
+ * @ingroup meos_temporal_analytics_simplify
+ * @brief Push an instant of a live temporal float or point into an online
+ * simplifier
+ * @param[in,out] state State
+ * @param[in] inst Temporal instant, which is copied
+ * @return Number of instants kept by the simplification that are ready to be
+ * emitted. On error return -1
+ */
+int
+temporal_simplify_push(SimplifyState *state, const TInstant *inst)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) state) || ! ensure_not_null((void *) inst) ||
+      ! ensure_tnumber_tgeo_type(inst->temptype))
+    return -1;
+  if (! temptype_continuous(inst->temptype))
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_TYPE,
+      "The temporal value must be a temporal float or a temporal point");
+    return -1;
+  }
+  if (state->count > 0)
+  {
+    const TInstant *last = state->window[state->count - 1];
+    if (! ensure_same_temporal_type((Temporal *) last, (Temporal *) inst) ||
+        ! ensure_spatial_validity((Temporal *) last, (Temporal *) inst))
+      return -1;
+    if (last->t >= inst->t)
+    {
+      char *str1 = pg_timestamptz_out(last->t);
+      char *str2 = pg_timestamptz_out(inst->t);
+      meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+        "Timestamps for temporal value must be increasing: %s, %s", str1, str2);
+      pfree(str1); pfree(str2);
+      return -1;
+    }
+  }
+
+  state->window[state->count++] = tinstant_copy(inst);
+  /* The first instant is always kept */
+  if (state->count == 1)
+  {
+    simplify_state_emit(state, state->window[0]);
+    return state->nemitted;
+  }
+  if (state->squishe)
+    simplify_push_squishe(state);
+  else
+    simplify_push_openwindow(state);
+  return state->nemitted;
+}
+
+/**
+ * @ingroup meos_temporal_analytics_simplify
+ * @brief Return the instants kept by an online simplifier that are final
+ * @param[in,out] state State
+ * @param[out] count Number of elements in the output array
+ * @return Array of instants in increasing order of time, which are no longer
+ * referenced by the state and must be freed by the caller, or @p NULL when
+ * there is no instant to emit
+ */
+TInstant **
+temporal_simplify_emit(SimplifyState *state, int *count)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) state) || ! ensure_not_null((void *) count))
+    return NULL;
+
+  *count = state->nemitted;
+  if (state->nemitted == 0)
+    return NULL;
+  TInstant **result = palloc(sizeof(TInstant *) * state->nemitted);
+  memcpy(result, state->emitted, sizeof(TInstant *) * state->nemitted);
+  state->nemitted = 0;
+  return result;
+}
+
+/**
+ * @ingroup meos_temporal_analytics_simplify
+ * @brief Close an online simplifier, that is, mark the last instant pushed
+ * as kept by the simplification so that it is emitted
+ * @param[in,out] state State
+ * @return Number of instants ready to be emitted. On error return -1
+ * @note The instants pushed afterwards start a new simplified value
+ */
+int
+temporal_simplify_close(SimplifyState *state)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) state))
+    return -1;
+
+  /* The first instant of the window has already been emitted. With SQUISH-E
+   * the intermediate instants of the window are kept by the simplification,
+   * while with the opening window method they are not */
+  int first = state->squishe ? 1 : state->count - 1;
+  for (int i = Max(first, 1); i < state->count; i++)
+    simplify_state_emit(state, state->window[i]);
+  for (int i = 0; i < state->count; i++)
+    pfree(state->window[i]);
+  state->count = 0;
+  return state->nemitted;
+}
+
+/**
+ * @ingroup meos_temporal_analytics_simplify
+ * @brief Append the instants kept by an online simplifier that are final to
+ * an expandable temporal value
+ * @param[in,out] state State
+ * @param[in,out] temp Temporal value, may be @p NULL for the first call
+ * @param[in] maxdist Maximum distance for defining a gap
+ * @param[in] maxt Maximum time interval for defining a gap
+ * @return Temporal value with the instants appended, or @p NULL when no
+ * instant has been emitted yet
+ * @note As for #temporal_append_tinstant, always use the function to
+ * overwrite the existing temporal value
+ */
+Temporal *
+temporal_simplify_append(SimplifyState *state, Temporal *temp, double maxdist,
+  const Interval *maxt)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) state))
+    return NULL;
+
+  for (int i = 0; i < state->nemitted; i++)
+  {
+    TInstant *inst = state->emitted[i];
+    if (! temp)
+      temp = (Temporal *) tinstant_copy(inst);
+    else
+      temp = temporal_append_tinstant(temp, inst, maxdist, maxt, true);
+    pfree(inst);
+  }
+  state->nemitted = 0;
+  return temp;
+}
+
+/**
+ * @ingroup meos_temporal_analytics_simplify
+ * @brief Free an online simplifier and the instants it references
+ * @param[in] state State
+ */
+void
+temporal_simplify_free(SimplifyState *state)
+{
+  if (! state)
+    return;
+  for (int i = 0; i < state->count; i++)
+    pfree(state->window[i]);
+  for (int i = 0; i < state->nemitted; i++)
+    pfree(state->emitted[i]);
+  pfree(state->window);
+  pfree(state->priority);
+  pfree(state->error);
+  pfree(state->emitted);
+  pfree(state);
+  return;
+}
+
+/*****************************************************************************/
+
+/**
+ * @brief Return a temporal sequence float or point simplified by pushing its
+ * instants into an online simplifier
+ * @param[in] seq Temporal value
+ * @param[in,out] state State
+ */
+static TSequence *
+tsequence_simplify_online(const TSequence *seq, SimplifyState *state)
+{
+  for (int i = 0; i < seq->count; i++)
+    temporal_simplify_push(state, TSEQUENCE_INST_N(seq, i));
+  temporal_simplify_close(state);
+  int count;
+  TInstant **instants = temporal_simplify_emit(state, &count);
+  TSequence *result = tsequence_make((const TInstant **) instants, count,
+    (count == 1) ? true : seq->period.lower_inc,
+    (count == 1) ? true : seq->period.upper_inc, LINEAR, NORMALIZE);
+  pfree_array((void **) instants, count);
+  return result;
+}
+
+/**
+ * @ingroup meos_temporal_analytics_simplify
+ * @brief Return a temporal float or point simplified by pushing its instants
+ * into an online simplifier
+ * @details Each sequence of the temporal value is simplified independently by
+ * pushing its instants one by one and closing the simplifier after its last
+ * instant. When the window of the opening window method never becomes full,
+ * the result is the same as the one of #temporal_simplify_max_dist.
+ * @param[in] temp Temporal value
+ * @param[in] dist Distance threshold
+ * @param[in] syncdist True when the Synchronized Euclidean Distance (SED) is
+ * used, false when the spatial-only distance is used
+ * @param[in] maxpts Maximum number of instants kept in memory
+ * @param[in] squishe True when using the SQUISH-E method, false when using the
+ * opening window method
+ * @return On error return @p NULL
+ * @see #temporal_simplify_open
+ * @csqlfn #Temporal_simplify_opening_window(), #Temporal_simplify_squishe()
+ */
+Temporal *
+temporal_simplify_online(const Temporal *temp, double dist, bool syncdist,
+  int maxpts, bool squishe)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) temp) ||
+      ! ensure_tnumber_tgeo_type(temp->temptype))
+    return NULL;
+  SimplifyState *state = temporal_simplify_open(dist, syncdist, maxpts,
+    squishe);
+  if (! state)
+    return NULL;
+
+  Temporal *result;
+  assert(temptype_subtype(temp->subtype));
+  if (temp->subtype == TINSTANT || ! MEOS_FLAGS_LINEAR_INTERP(temp->flags))
+    result = temporal_cp(temp);
+  else if (temp->subtype == TSEQUENCE)
+    result = (Temporal *) tsequence_simplify_online((TSequence *) temp, state);
+  else /* temp->subtype == TSEQUENCESET */
+  {
+    const TSequenceSet *ss = (const TSequenceSet *) temp;
+    TSequence **sequences = palloc(sizeof(TSequence *) * ss->count);
+    for (int i = 0; i < ss->count; i++)
+      sequences[i] = tsequence_simplify_online(TSEQUENCESET_SEQ_N(ss, i),
+        state);
+    result = (Temporal *) tsequenceset_make_free(sequences, ss->count,
+      NORMALIZE);
+  }
+  temporal_simplify_free(state);
+  return result;
+}
+
+/*****************************************************************************/
@@ -52,6 +52,7 @@
 #include "general/tsequenceset.h"
 #include "general/type_parser.h"
 #include "general/type_util.h"
+#include "point/tpoint_boxops.h"
 #include "point/tpoint_parser.h"
 #include "point/tpoint_spatialfuncs.h"
 #include "npoint/tnpoint_distance.h"
@@ -618,6 +619,104 @@ tsequence_insert(const TSequence *seq1, const TSequence *seq2, bool connect)
     return (Temporal *) tcontseq_insert(seq1, seq2);
 }
 
+/**
+ * @brief Return true if the value of a temporal instant attains a bound of
+ * the value dimensions of the bounding box of a continuous temporal sequence
+ * @details The value bounds of the bounding box of a continuous sequence are
+ * attained by its instants, except for geodetic points and network points
+ * whose segments may extend beyond their instants. In this case the function
+ * always returns true since the bounding box must be recomputed.
+ * @param[in] seq Temporal sequence
+ * @param[in] inst Temporal instant of the sequence
+ */
+static bool
+tcontseq_bbox_bound_inst(const TSequence *seq, const TInstant *inst)
+{
+  assert(seq); assert(inst);
+  if (talpha_type(seq->temptype))
+    return false;
+  bboxunion box;
+  tinstant_set_bbox(inst, &box);
+  if (tnumber_type(seq->temptype))
+  {
+    const TBox *seqbox = (TBox *) TSEQUENCE_BBOX_PTR(seq);
+    meosType basetype = seqbox->span.basetype;
+    return datum_eq(box.b.span.lower, seqbox->span.lower, basetype) ||
+      datum_eq(box.b.span.upper, seqbox->span.upper, basetype);
+  }
+  if (tgeo_type(seq->temptype) && ! MEOS_FLAGS_GET_GEODETIC(seq->flags))
+  {
+    const STBox *seqbox = (STBox *) TSEQUENCE_BBOX_PTR(seq);
+    if (box.g.xmin == seqbox->xmin || box.g.xmax == seqbox->xmax ||
+        box.g.ymin == seqbox->ymin || box.g.ymax == seqbox->ymax)
+      return true;
+    return MEOS_FLAGS_GET_Z(seq->flags) &&
+      (box.g.zmin == seqbox->zmin || box.g.zmax == seqbox->zmax);
+  }
+  return true;
+}
+
+/**
+ * @brief Return a continuous temporal sequence from the instants that remain
+ * after deleting some instants of a sequence
+ * @details When no deleted instant attains a value bound of the bounding box
+ * of the sequence, the bounding box of the result is obtained by updating
+ * the time span of the one of the sequence, which avoids scanning all the
+ * remaining instants. Normalization does not change the bounding box either
+ * since the removed instants are in the segment joining their neighbours.
+ * Otherwise, long planar temporal points take the spatial extent of the
+ * result from its segment index, whose block boxes are computed anyway,
+ * instead of scanning the instants a second time. The block boxes of the
+ * sequence cannot be reused for the result since deleting instants shifts
+ * the blocks.
+ * @param[in] seq Temporal sequence
+ * @param[in] instants Remaining instants
+ * @param[in] count Number of elements in the array
+ * @param[in] lower_inc,upper_inc True if the respective bound is inclusive
+ * @param[in] normalize True if the resulting value should be normalized
+ * @param[in] samebox True if no deleted instant attains a value bound
+ */
+static TSequence *
+tcontseq_delete_make(const TSequence *seq, const TInstant **instants,
+  int count, bool lower_inc, bool upper_inc, bool normalize, bool samebox)
+{
+  interpType interp = MEOS_FLAGS_GET_INTERP(seq->flags);
+  /* An exclusive bound of the result may make exclusive a value bound of the
+   * bounding box of a temporal float */
+  if (samebox && ((! lower_inc && tcontseq_bbox_bound_inst(seq, instants[0])) ||
+      (! upper_inc && tcontseq_bbox_bound_inst(seq, instants[count - 1]))))
+    samebox = false;
+  bool segidx = tpointseq_segidx_size(instants[0], interp, count) > 0;
+  if (! samebox && ! segidx)
+    return tsequence_make(instants, count, lower_inc, upper_inc, interp,
+      normalize);
+
+  /* The remaining instants come from a valid sequence, only the bounds must
+   * be verified */
+  if (! ensure_valid_tinstarr_common(instants, count, lower_inc, upper_inc,
+      interp))
+    return NULL;
+  /* The time span is the first component of all bounding boxes */
+  bboxunion bbox;
+  memcpy(&bbox, TSEQUENCE_BBOX_PTR(seq),
+    DOUBLE_PAD(temporal_bbox_size(seq->temptype)));
+  span_set(TimestampTzGetDatum(instants[0]->t),
+    TimestampTzGetDatum(instants[count - 1]->t), lower_inc, upper_inc,
+    T_TIMESTAMPTZ, T_TSTZSPAN, &bbox.p);
+  TSequence *result = tsequence_make_exp1(instants, count, count, lower_inc,
+    upper_inc, interp, normalize, &bbox);
+  /* The spatial extent is taken from the segment index of the result, which
+   * may not have one if normalization reduced the number of instants */
+  if (! samebox)
+  {
+    if (MEOS_FLAGS_GET_SEGIDX(result->flags))
+      tpointseq_segidx_set_stbox(result, (STBox *) TSEQUENCE_BBOX_PTR(result));
+    else
+      tsequence_compute_bbox(result);
+  }
+  return result;
+}
+
 /**
  * @brief Delete a timestamp from a continuous temporal sequence
  * @details If an instant has the same timestamp, it will be removed. If the
@@ -646,6 +745,7 @@ tcontseq_delete_timestamptz(const TSequence *seq, TimestampTz t)
   int ninsts = 0;
   bool lower_inc1 = seq->period.lower_inc;
   bool upper_inc1 = seq->period.upper_inc;
+  bool samebox = true;
   for (int i = 0; i < seq->count; i++)
   {
     const TInstant *inst = TSEQUENCE_INST_N(seq, i);
@@ -657,15 +757,16 @@ tcontseq_delete_timestamptz(const TSequence *seq, TimestampTz t)
         lower_inc1 = true;
       else if (i == seq->count - 1)
         upper_inc1 = false;
+      if (tcontseq_bbox_bound_inst(seq, inst))
+        samebox = false;
     }
   }
   if (ninsts == 0)
     return NULL;
   else if (ninsts == 1)
     lower_inc1 = upper_inc1 = true;
-  interpType interp = MEOS_FLAGS_GET_INTERP(seq->flags);
-  TSequence *result = tsequence_make((const TInstant **) instants, ninsts,
-    lower_inc1, upper_inc1, interp, NORMALIZE);
+  TSequence *result = tcontseq_delete_make(seq, (const TInstant **) instants,
+    ninsts, lower_inc1, upper_inc1, NORMALIZE, samebox);
   pfree(instants);
   return result;
 }
@@ -736,6 +837,7 @@ tcontseq_delete_tstzset(const TSequence *seq, const Set *s)
     nfree = 0;  /* number of instants removed */
   bool lower_inc1 = seq->period.lower_inc;
   bool upper_inc1 = seq->period.upper_inc;
+  bool samebox = true;
   while (i < seq->count && j < s->count)
   {
     inst = TSEQUENCE_INST_N(seq, i);
@@ -751,6 +853,8 @@ tcontseq_delete_tstzset(const TSequence *seq, const Set *s)
         lower_inc1 = true;
       else if (i == seq->count - 1)
         upper_inc1 = true;
+      if (tcontseq_bbox_bound_inst(seq, inst))
+        samebox = false;
       i++; /* advance instants */
       j++; /* advance timestamps */
       nfree++; /* advance number of instants removed */
@@ -771,9 +875,8 @@ tcontseq_delete_tstzset(const TSequence *seq, const Set *s)
     return NULL;
   else if (ninsts == 1)
     lower_inc1 = upper_inc1 = true;
-  interpType interp = MEOS_FLAGS_GET_INTERP(seq->flags);
-  TSequence *result = tsequence_make((const TInstant **) instants, ninsts,
-    lower_inc1, upper_inc1, interp, NORMALIZE_NO);
+  TSequence *result = tcontseq_delete_make(seq, (const TInstant **) instants,
+    ninsts, lower_inc1, upper_inc1, NORMALIZE_NO, samebox);
   pfree(instants);
   return result;
 }
@@ -821,6 +924,7 @@ tcontseq_delete_tstzspan(const TSequence *seq, const Span *s)
   int ninsts = 0;
   bool lower_inc1 = seq->period.lower_inc;
   bool upper_inc1 = seq->period.upper_inc;
+  bool samebox = true;
   for (int i = 0; i < seq->count; i++)
   {
     const TInstant *inst = TSEQUENCE_INST_N(seq, i);
@@ -832,15 +936,16 @@ tcontseq_delete_tstzspan(const TSequence *seq, const Span *s)
         lower_inc1 = true;
       else if (i == seq->count - 1)
         upper_inc1 = false;
+      if (tcontseq_bbox_bound_inst(seq, inst))
+        samebox = false;
     }
   }
   if (ninsts == 0)
     return NULL;
   else if (ninsts == 1)
     lower_inc1 = upper_inc1 = true;
-  interpType interp = MEOS_FLAGS_GET_INTERP(seq->flags);
-  TSequence *result = tsequence_make((const TInstant **) instants, ninsts,
-    lower_inc1, upper_inc1, interp, NORMALIZE);
+  TSequence *result = tcontseq_delete_make(seq, (const TInstant **) instants,
+    ninsts, lower_inc1, upper_inc1, NORMALIZE, samebox);
   pfree(instants);
   return result;
 }
@@ -896,6 +1001,7 @@ tcontseq_delete_tstzspanset(const TSequence *seq, const SpanSet *ss)
   int ninsts = 0;
   bool lower_inc1 = seq->period.lower_inc;
   bool upper_inc1 = seq->period.upper_inc;
+  bool samebox = true;
   for (int i = 0; i < seq->count; i++)
   {
     const TInstant *inst = TSEQUENCE_INST_N(seq, i);
@@ -907,15 +1013,16 @@ tcontseq_delete_tstzspanset(const TSequence *seq, const SpanSet *ss)
         lower_inc1 = true;
       else if (i == seq->count - 1)
         upper_inc1 = false;
+      if (tcontseq_bbox_bound_inst(seq, inst))
+        samebox = false;
     }
   }
   if (ninsts == 0)
     return NULL;
   else if (ninsts == 1)
     lower_inc1 = upper_inc1 = true;
-  interpType interp = MEOS_FLAGS_GET_INTERP(seq->flags);
-  TSequence *result = tsequence_make((const TInstant **) instants, ninsts,
-    lower_inc1, upper_inc1, interp, NORMALIZE);
+  TSequence *result = tcontseq_delete_make(seq, (const TInstant **) instants,
+    ninsts, lower_inc1, upper_inc1, NORMALIZE, samebox);
   pfree(instants);
   return result;
 }
@@ -1648,7 +1755,11 @@ tsequence_append_tinstant(TSequence *seq, const TInstant *inst, double maxdist,
     size_t size_last = DOUBLE_PAD(VARSIZE(last));
     char *new = (char *) last + size_last;
     size_t size_seq = VARSIZE(seq);
-    size_t avail_size = (char *) seq + size_seq - new;
+    /* The segment index, if any, is kept at the end of the sequence */
+    size_t segidx_size = MEOS_FLAGS_GET_SEGIDX(seq->flags) ?
+      tpointseq_segidx_size(TSEQUENCE_INST_N(seq, 0), interp, seq->maxcount) :
+      0;
+    size_t avail_size = (char *) seq + size_seq - segidx_size - new;
     if (size > avail_size)
       /* There is not enough available space */
       break;
@@ -1662,6 +1773,9 @@ tsequence_append_tinstant(TSequence *seq, const TInstant *inst, double maxdist,
       seq->count++;
     }
     memcpy(new, inst, VARSIZE(inst));
+    /* Update the entries of the segment index covering the new instant */
+    if (segidx_size > 0)
+      tpointseq_segidx_update_last(seq);
     /* Expand the bounding box and return */
     tsequence_expand_bbox(seq, inst);
     return (Temporal *) seq;
@@ -51,6 +51,7 @@
 #include "general/temporal_restrict.h"
 #include "general/tsequence.h"
 #include "general/type_util.h"
+#include "point/tpoint_spatialfuncs.h"
 
 /*****************************************************************************
  * Span bucket functions
@@ -1170,6 +1171,601 @@ temporal_time_split(const Temporal *temp, const Interval *duration, TimestampTz
     count);
 }
 
+/*****************************************************************************
+ * Time split visitor
+ *****************************************************************************/
+
+/**
+ * @brief Return the n-th instant of a time bucket view
+ * @note The instants of a view are the synthetic start instant (if any),
+ * the instants of the underlying sequence in the index range, and the
+ * synthetic end instant (if any)
+ */
+static const TInstant *
+timebucketview_inst_n(const TimeBucketView *view, int n)
+{
+  if (view->start)
+  {
+    if (n == 0)
+      return view->start;
+    n--;
+  }
+  if (n < view->last - view->first)
+    return TSEQUENCE_INST_N(view->seq, view->first + n);
+  return view->end;
+}
+
+/**
+ * @brief Return the number of instants of a time bucket view
+ */
+static int
+timebucketview_count(const TimeBucketView *view)
+{
+  return (view->start ? 1 : 0) + (view->last - view->first) +
+    (view->end ? 1 : 0);
+}
+
+/**
+ * @brief Visit a temporal instant as a single time bucket view
+ * @param[in] inst Temporal value
+ * @param[in] tunits Size of the time buckets in PostgreSQL time units
+ * @param[in] torigin Time origin of the tiles
+ * @param[in] visit Visitor function
+ * @param[in] state Visitor state
+ */
+static int
+tinstant_time_split_visit(const TInstant *inst, int64 tunits,
+  TimestampTz torigin, time_bucket_fn visit, void *state)
+{
+  TimeBucketView view;
+  view.lower = timestamptz_bucket1(inst->t, tunits, torigin);
+  view.upper = view.lower + tunits;
+  view.seq = NULL;
+  view.start = inst;
+  view.end = NULL;
+  view.first = view.last = 0;
+  view.lower_inc = view.upper_inc = true;
+  view.interp = DISCRETE;
+  visit(&view, state);
+  return 1;
+}
+
+/**
+ * @brief Visit the fragments of a temporal discrete sequence split according
+ * to time buckets
+ * @param[in] seq Temporal value
+ * @param[in] start Start timestamp of the buckets
+ * @param[in] tunits Size of the time buckets in PostgreSQL time units
+ * @param[in] visit Visitor function
+ * @param[in] state Visitor state
+ */
+static int
+tdiscseq_time_split_visit(const TSequence *seq, TimestampTz start,
+  int64 tunits, time_bucket_fn visit, void *state)
+{
+  TimeBucketView view;
+  view.seq = seq;
+  view.start = view.end = NULL;
+  view.lower_inc = view.upper_inc = true;
+  view.interp = DISCRETE;
+  TimestampTz lower = start;
+  TimestampTz upper = start + tunits;
+  int i = 0,       /* counter for instants of temporal value */
+      first = 0,   /* first instant of the next split */
+      nfrags = 0;  /* counter for resulting fragments */
+  while (i < seq->count)
+  {
+    const TInstant *inst = TSEQUENCE_INST_N(seq, i);
+    if (lower <= inst->t && inst->t < upper)
+      i++;
+    else
+    {
+      if (i > first)
+      {
+        view.lower = lower; view.upper = upper;
+        view.first = first; view.last = i;
+        nfrags++;
+        if (! visit(&view, state))
+          return nfrags;
+        first = i;
+      }
+      lower = upper;
+      upper += tunits;
+    }
+  }
+  if (i > first)
+  {
+    view.lower = lower; view.upper = upper;
+    view.first = first; view.last = i;
+    nfrags++;
+    visit(&view, state);
+  }
+  return nfrags;
+}
+
+/**
+ * @brief Visit the fragments of a temporal continuous sequence split
+ * according to time buckets
+ * @details The logic follows that of #tcontseq_time_split_iter() except that
+ * the fragments are not constructed. Each fragment is given to the visitor as
+ * a range of instants of the sequence, possibly extended with synthetic
+ * instants at the bucket bounds. The synthetic end instant of a bucket is
+ * reused as the synthetic start instant of the next one.
+ * @param[in] seq Temporal value
+ * @param[in] start,end Start and end timestamps of the buckets
+ * @param[in] tunits Size of the time buckets in PostgreSQL time units
+ * @param[in] visit Visitor function
+ * @param[in] state Visitor state
+ * @param[out] stop True when the visitor asked to stop the traversal
+ * @note This function is called for each sequence of a temporal sequence set
+ */
+static int
+tcontseq_time_split_visit(const TSequence *seq, TimestampTz start,
+  TimestampTz end, int64 tunits, time_bucket_fn visit, void *state,
+  bool *stop)
+{
+  TimestampTz lower = start;
+  TimestampTz upper = lower + tunits;
+  /* Filter the time buckets before the sequence */
+  while (lower < end &&
+    (DatumGetTimestampTz(seq->period.lower) >= upper ||
+     lower > DatumGetTimestampTz(seq->period.upper) ||
+     (lower == DatumGetTimestampTz(seq->period.upper) && ! seq->period.upper_inc)))
+  {
+    lower = upper;
+    upper += tunits;
+  }
+
+  interpType interp = MEOS_FLAGS_GET_INTERP(seq->flags);
+  TimeBucketView view;
+  view.seq = seq;
+  view.interp = interp;
+  /* Synthetic start instant of the current bucket, if any */
+  TInstant *vstart = NULL;
+  int i = 0,      /* counter for instants of temporal value */
+      first = 0,  /* first instant of the sequence in the current bucket */
+      nfrags = 0; /* counter for visited fragments */
+  *stop = false;
+  while (i < seq->count)
+  {
+    const TInstant *inst = TSEQUENCE_INST_N(seq, i);
+    /* If the instant is in the bucket */
+    if ((lower <= inst->t && inst->t < upper) ||
+      (inst->t == upper && (interp == LINEAR || i == seq->count - 1)))
+    {
+      i++;
+      continue;
+    }
+
+    /* Compute the value at the end of the bucket */
+    const TInstant *last = (i > first) ? TSEQUENCE_INST_N(seq, i - 1) :
+      vstart;
+    assert(last);
+    TInstant *vend = NULL;
+    if (last->t < upper)
+    {
+      if (interp == LINEAR)
+        vend = tsegment_at_timestamptz(last, inst, interp, upper);
+      else
+        /* The last two values of sequences with step interpolation and
+         * exclusive upper bound must be equal */
+        vend = tinstant_make(tinstant_val(last), seq->temptype, upper);
+    }
+
+    /* Visit the fragment */
+    view.lower = lower; view.upper = upper;
+    view.start = vstart; view.end = vend;
+    view.first = first; view.last = i;
+    view.lower_inc = (nfrags == 0) ? seq->period.lower_inc : true;
+    view.upper_inc = (timebucketview_count(&view) > 1) ? false : true;
+    nfrags++;
+    bool cont = visit(&view, state);
+    if (vstart)
+      pfree(vstart);
+    vstart = NULL;
+    if (! cont)
+    {
+      if (vend)
+        pfree(vend);
+      *stop = true;
+      return nfrags;
+    }
+
+    /* Set up for the next bucket */
+    lower = upper;
+    upper += tunits;
+    /* The second condition is needed for filtering unnecesary time buckets
+     * that are in the gaps between sequences composing a sequence set */
+    if (lower >= end || ! contains_span_timestamptz(&seq->period, lower))
+    {
+      if (vend)
+        pfree(vend);
+      return nfrags;
+    }
+    /* The end value of the previous bucket is the start of the new bucket */
+    if (lower < inst->t && vend)
+    {
+      vstart = vend;
+      first = i;
+    }
+    else
+    {
+      if (vend)
+        pfree(vend);
+      first = (lower < inst->t) ? i - 1 : i;
+    }
+  }
+  view.lower = lower; view.upper = upper;
+  view.start = vstart; view.end = NULL;
+  view.first = first; view.last = i;
+  view.lower_inc = (nfrags == 0) ? seq->period.lower_inc : true;
+  view.upper_inc = seq->period.upper_inc;
+  nfrags++;
+  if (! visit(&view, state))
+    *stop = true;
+  if (vstart)
+    pfree(vstart);
+  return nfrags;
+}
+
+/**
+ * @brief Visit the fragments of a temporal sequence set split according to
+ * time buckets
+ * @param[in] ss Temporal value
+ * @param[in] end End timestamp of the buckets
+ * @param[in] tunits Size of the time buckets in PostgreSQL time units
+ * @param[in] torigin Time origin of the tiles
+ * @param[in] visit Visitor function
+ * @param[in] state Visitor state
+ * @note The fragments of the composing sequences that fall in the same time
+ * bucket are visited one after the other
+ */
+static int
+tsequenceset_time_split_visit(const TSequenceSet *ss, TimestampTz end,
+  int64 tunits, TimestampTz torigin, time_bucket_fn visit, void *state)
+{
+  int nfrags = 0;
+  bool stop = false;
+  for (int i = 0; i < ss->count && ! stop; i++)
+  {
+    const TSequence *seq = TSEQUENCESET_SEQ_N(ss, i);
+    TimestampTz start = timestamptz_bucket1(
+      DatumGetTimestampTz(seq->period.lower), tunits, torigin);
+    nfrags += tcontseq_time_split_visit(seq, start, end, tunits, visit, state,
+      &stop);
+  }
+  return nfrags;
+}
+
+/**
+ * @ingroup meos_temporal_analytics_tile
+ * @brief Visit the fragments of a temporal value split according to time
+ * buckets without constructing them
+ * @details The visitor receives for each fragment a view composed of the
+ * bounds of the time bucket, a range of instants of the underlying sequence,
+ * and the synthetic instants at the bucket bounds computed by interpolation.
+ * The view and its synthetic instants are only valid during the call to the
+ * visitor. The traversal stops when the visitor returns false.
+ * @param[in] temp Temporal value
+ * @param[in] duration Size of the time buckets
+ * @param[in] torigin Time origin of the buckets
+ * @param[in] visit Visitor function
+ * @param[in] state Visitor state
+ * @return Number of visited fragments, -1 on error
+ * @note Contrary to #temporal_time_split(), the fragments of a sequence set
+ * are visited per composing sequence, and thus the same time bucket may be
+ * visited several times in a row
+ */
+int
+temporal_time_split_visit(const Temporal *temp, const Interval *duration,
+  TimestampTz torigin, time_bucket_fn visit, void *state)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) temp) || ! ensure_not_null((void *) visit) ||
+      ! ensure_valid_duration(duration))
+    return -1;
+
+  Datum start_bucket, end_bucket;
+  Span s;
+  temporal_set_tstzspan(temp, &s);
+  tstzspan_no_buckets(&s, duration, torigin, &start_bucket, &end_bucket);
+  int64 tunits = interval_units(duration);
+  TimestampTz start = DatumGetTimestampTz(start_bucket);
+  TimestampTz end = DatumGetTimestampTz(end_bucket);
+  bool stop;
+  assert(temptype_subtype(temp->subtype));
+  switch (temp->subtype)
+  {
+    case TINSTANT:
+      return tinstant_time_split_visit((const TInstant *) temp, tunits,
+        torigin, visit, state);
+    case TSEQUENCE:
+      return MEOS_FLAGS_DISCRETE_INTERP(temp->flags) ?
+        tdiscseq_time_split_visit((const TSequence *) temp, start, tunits,
+          visit, state) :
+        tcontseq_time_split_visit((const TSequence *) temp, start, end,
+          tunits, visit, state, &stop);
+    default: /* TSEQUENCESET */
+      return tsequenceset_time_split_visit((const TSequenceSet *) temp, end,
+        tunits, torigin, visit, state);
+  }
+}
+
+/*****************************************************************************
+ * Time-bucketed aggregates
+ *****************************************************************************/
+
+/**
+ * @brief Enumeration for the time-bucketed aggregates
+ */
+typedef enum
+{
+  TBUCKET_INTEGRAL,
+  TBUCKET_TWAVG,
+  TBUCKET_MIN,
+  TBUCKET_MAX,
+  TBUCKET_LENGTH,
+} TBucketAggFunc;
+
+/**
+ * @brief Structure for accumulating a time-bucketed aggregate
+ */
+typedef struct
+{
+  TBucketAggFunc func;  /**< Aggregate function */
+  meosType basetype;    /**< Base type of the temporal value */
+  TimestampTz *buckets; /**< Output array of bucket lower bounds */
+  double *values;       /**< Output array of aggregate values */
+  int count;            /**< Number of buckets already output */
+  bool hasbucket;       /**< True when a bucket is being accumulated */
+  TimestampTz lower;    /**< Lower bound of the current bucket */
+  double sum;           /**< Integral, length, min, or max of the bucket */
+  double duration;      /**< Duration of the continuous fragments */
+  double valuesum;      /**< Sum of the values used when duration is 0 */
+  int nvalues;          /**< Number of values used when duration is 0 */
+} TBucketAggState;
+
+/**
+ * @brief Output the aggregate value of the current bucket
+ */
+static void
+tbucketagg_flush(TBucketAggState *state)
+{
+  if (! state->hasbucket)
+    return;
+  double value = state->sum;
+  if (state->func == TBUCKET_TWAVG)
+    value = (state->duration == 0.0) ? state->valuesum / state->nvalues :
+      state->sum / state->duration;
+  state->buckets[state->count] = state->lower;
+  state->values[state->count++] = value;
+  state->hasbucket = false;
+  return;
+}
+
+/**
+ * @brief Visitor accumulating a time-bucketed aggregate
+ */
+static bool
+tbucketagg_visit(const TimeBucketView *view, void *st)
+{
+  TBucketAggState *state = (TBucketAggState *) st;
+  if (state->hasbucket && state->lower != view->lower)
+    tbucketagg_flush(state);
+
+  int count = timebucketview_count(view);
+  const TInstant *inst1 = timebucketview_inst_n(view, 0);
+  double value1 = (state->func == TBUCKET_LENGTH) ? 0.0 :
+    datum_double(tinstant_val(inst1), state->basetype);
+  if (! state->hasbucket)
+  {
+    state->hasbucket = true;
+    state->lower = view->lower;
+    state->sum = (state->func == TBUCKET_MIN || state->func == TBUCKET_MAX) ?
+      value1 : 0.0;
+    state->duration = state->valuesum = 0.0;
+    state->nvalues = 0;
+  }
+
+  /* Discrete fragments have no duration */
+  if (view->interp == DISCRETE)
+  {
+    if (state->func == TBUCKET_LENGTH)
+      return true;
+    for (int i = 0; i < count; i++)
+    {
+      double value = datum_double(
+        tinstant_val(timebucketview_inst_n(view, i)), state->basetype);
+      if (state->func == TBUCKET_MIN)
+        state->sum = Min(state->sum, value);
+      else if (state->func == TBUCKET_MAX)
+        state->sum = Max(state->sum, value);
+      else if (state->func == TBUCKET_TWAVG)
+      {
+        state->valuesum += value;
+        state->nvalues++;
+      }
+    }
+    return true;
+  }
+
+  datum_func2 func = (state->func == TBUCKET_LENGTH) ?
+    pt_distance_fn(inst1->flags) : NULL;
+  if (state->func == TBUCKET_TWAVG)
+  {
+    state->valuesum += value1;
+    state->nvalues++;
+  }
+  else if (state->func == TBUCKET_MIN)
+    state->sum = Min(state->sum, value1);
+  else if (state->func == TBUCKET_MAX)
+    state->sum = Max(state->sum, value1);
+  for (int i = 1; i < count; i++)
+  {
+    const TInstant *inst2 = timebucketview_inst_n(view, i);
+    if (state->func == TBUCKET_LENGTH)
+    {
+      if (view->interp == LINEAR)
+        state->sum += DatumGetFloat8(func(tinstant_val(inst1),
+          tinstant_val(inst2)));
+      inst1 = inst2;
+      continue;
+    }
+    double value2 = datum_double(tinstant_val(inst2), state->basetype);
+    double dt = (double) (inst2->t - inst1->t);
+    switch (state->func)
+    {
+      case TBUCKET_INTEGRAL:
+      case TBUCKET_TWAVG:
+        state->sum += (view->interp == LINEAR) ?
+          (Max(value1, value2) + Min(value1, value2)) * dt / 2.0 :
+          value1 * dt;
+        break;
+      case TBUCKET_MIN:
+        state->sum = Min(state->sum, value2);
+        break;
+      default: /* TBUCKET_MAX */
+        state->sum = Max(state->sum, value2);
+    }
+    inst1 = inst2;
+    value1 = value2;
+  }
+  state->duration += (double) (timebucketview_inst_n(view, count - 1)->t -
+    timebucketview_inst_n(view, 0)->t);
+  return true;
+}
+
+/**
+ * @brief Return an aggregate of each time bucket of a temporal value
+ * @param[in] temp Temporal value
+ * @param[in] duration Size of the time buckets
+ * @param[in] torigin Time origin of the buckets
+ * @param[in] func Aggregate function
+ * @param[out] buckets Array of bucket lower bounds
+ * @param[out] count Number of values in the output array
+ */
+static double *
+temporal_time_split_agg(const Temporal *temp, const Interval *duration,
+  TimestampTz torigin, TBucketAggFunc func, TimestampTz **buckets, int *count)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) temp) || ! ensure_not_null((void *) buckets) ||
+      ! ensure_not_null((void *) count) || ! ensure_valid_duration(duration))
+    return NULL;
+  if (func == TBUCKET_LENGTH ? ! ensure_tgeo_type(temp->temptype) :
+      ! ensure_tnumber_type(temp->temptype))
+    return NULL;
+
+  Datum start_bucket, end_bucket;
+  Span s;
+  temporal_set_tstzspan(temp, &s);
+  int nbuckets = tstzspan_no_buckets(&s, duration, torigin, &start_bucket,
+    &end_bucket);
+  TBucketAggState state;
+  memset(&state, 0, sizeof(TBucketAggState));
+  state.func = func;
+  state.basetype = temptype_basetype(temp->temptype);
+  state.buckets = palloc(sizeof(TimestampTz) * nbuckets);
+  state.values = palloc(sizeof(double) * nbuckets);
+  temporal_time_split_visit(temp, duration, torigin, &tbucketagg_visit,
+    &state);
+  tbucketagg_flush(&state);
+  *buckets = state.buckets;
+  *count = state.count;
+  return state.values;
+}
+
+/**
+ * @ingroup meos_temporal_analytics_tile
+ * @brief Return the integral of each time bucket of a temporal number
+ * @param[in] temp Temporal value
+ * @param[in] duration Size of the time buckets
+ * @param[in] torigin Time origin of the buckets
+ * @param[out] buckets Array of bucket lower bounds
+ * @param[out] count Number of values in the output array
+ * @csqlfn #Tnumber_time_split_integral()
+ */
+double *
+tnumber_time_split_integral(const Temporal *temp, const Interval *duration,
+  TimestampTz torigin, TimestampTz **buckets, int *count)
+{
+  return temporal_time_split_agg(temp, duration, torigin, TBUCKET_INTEGRAL,
+    buckets, count);
+}
+
+/**
+ * @ingroup meos_temporal_analytics_tile
+ * @brief Return the time-weighted average of each time bucket of a temporal
+ * number
+ * @param[in] temp Temporal value
+ * @param[in] duration Size of the time buckets
+ * @param[in] torigin Time origin of the buckets
+ * @param[out] buckets Array of bucket lower bounds
+ * @param[out] count Number of values in the output array
+ * @csqlfn #Tnumber_time_split_twavg()
+ */
+double *
+tnumber_time_split_twavg(const Temporal *temp, const Interval *duration,
+  TimestampTz torigin, TimestampTz **buckets, int *count)
+{
+  return temporal_time_split_agg(temp, duration, torigin, TBUCKET_TWAVG,
+    buckets, count);
+}
+
+/**
+ * @ingroup meos_temporal_analytics_tile
+ * @brief Return the minimum value of each time bucket of a temporal number
+ * @param[in] temp Temporal value
+ * @param[in] duration Size of the time buckets
+ * @param[in] torigin Time origin of the buckets
+ * @param[out] buckets Array of bucket lower bounds
+ * @param[out] count Number of values in the output array
+ * @csqlfn #Tnumber_time_split_min()
+ */
+double *
+tnumber_time_split_min(const Temporal *temp, const Interval *duration,
+  TimestampTz torigin, TimestampTz **buckets, int *count)
+{
+  return temporal_time_split_agg(temp, duration, torigin, TBUCKET_MIN,
+    buckets, count);
+}
+
+/**
+ * @ingroup meos_temporal_analytics_tile
+ * @brief Return the maximum value of each time bucket of a temporal number
+ * @param[in] temp Temporal value
+ * @param[in] duration Size of the time buckets
+ * @param[in] torigin Time origin of the buckets
+ * @param[out] buckets Array of bucket lower bounds
+ * @param[out] count Number of values in the output array
+ * @csqlfn #Tnumber_time_split_max()
+ */
+double *
+tnumber_time_split_max(const Temporal *temp, const Interval *duration,
+  TimestampTz torigin, TimestampTz **buckets, int *count)
+{
+  return temporal_time_split_agg(temp, duration, torigin, TBUCKET_MAX,
+    buckets, count);
+}
+
+/**
+ * @ingroup meos_temporal_analytics_tile
+ * @brief Return the length traversed in each time bucket of a temporal point
+ * @param[in] temp Temporal value
+ * @param[in] duration Size of the time buckets
+ * @param[in] torigin Time origin of the buckets
+ * @param[out] buckets Array of bucket lower bounds
+ * @param[out] count Number of values in the output array
+ * @csqlfn #Tpoint_time_split_length()
+ */
+double *
+tpoint_time_split_length(const Temporal *temp, const Interval *duration,
+  TimestampTz torigin, TimestampTz **buckets, int *count)
+{
+  return temporal_time_split_agg(temp, duration, torigin, TBUCKET_LENGTH,
+    buckets, count);
+}
+
 /*****************************************************************************
  * Value split functions for temporal numbers
  *****************************************************************************/
@@ -1776,6 +2372,178 @@ tnumber_value_time_split(const Temporal *temp, Datum size, const Interval *durat
   return fragments;
 }
 
+/*****************************************************************************
+ * Value and time histogram functions for temporal numbers
+ *****************************************************************************/
+
+/**
+ * @brief Structure for accumulating the duration of a temporal number in a
+ * grid of value and time buckets
+ */
+typedef struct
+{
+  double vstart;        /**< Lower bound of the first value bucket */
+  double vsize;         /**< Size of the value buckets */
+  int vcount;           /**< Number of value buckets */
+  TimestampTz tstart;   /**< Lower bound of the first time bucket */
+  int64 tunits;         /**< Size of the time buckets */
+  int tcount;           /**< Number of time buckets */
+  double *durations;    /**< Dense array of durations of the cells */
+} ValueTimeHistogram;
+
+/**
+ * @brief Return the number of the value bucket containing a value
+ */
+static int
+histogram_value_bucket(const ValueTimeHistogram *hist, double value)
+{
+  int result = (int) floor((value - hist->vstart) / hist->vsize);
+  return Max(0, Min(result, hist->vcount - 1));
+}
+
+/**
+ * @brief Add the time interval spent in a value bucket to the cells of the
+ * time buckets it overlaps
+ * @param[in] hist Histogram
+ * @param[in] t1,t2 Bounds of the time interval, relative to the start of the
+ * first time bucket
+ * @param[in] vbucket Number of the value bucket
+ */
+static void
+histogram_add(ValueTimeHistogram *hist, double t1, double t2, int vbucket)
+{
+  int j = (int) floor(t1 / hist->tunits);
+  j = Max(0, Min(j, hist->tcount - 1));
+  double *row = &hist->durations[vbucket * hist->tcount];
+  while (j < hist->tcount)
+  {
+    double lower = (double) j * hist->tunits;
+    double upper = lower + hist->tunits;
+    if (lower >= t2)
+      break;
+    double d = Min(t2, upper) - Max(t1, lower);
+    if (d > 0)
+      row[j] += d;
+    j++;
+  }
+  return;
+}
+
+/**
+ * @brief Accumulate the durations of a temporal continuous sequence number
+ * @details For a linear segment the times at which the value crosses the
+ * value bucket bounds are interpolated analytically
+ */
+static void
+tnumbercontseq_value_time_histogram(const TSequence *seq,
+  ValueTimeHistogram *hist)
+{
+  meosType basetype = temptype_basetype(seq->temptype);
+  bool linear = MEOS_FLAGS_LINEAR_INTERP(seq->flags);
+  const TInstant *inst1 = TSEQUENCE_INST_N(seq, 0);
+  double value1 = datum_double(tinstant_val(inst1), basetype);
+  double t1 = (double) (inst1->t - hist->tstart);
+  for (int i = 1; i < seq->count; i++)
+  {
+    const TInstant *inst2 = TSEQUENCE_INST_N(seq, i);
+    double value2 = datum_double(tinstant_val(inst2), basetype);
+    double t2 = (double) (inst2->t - hist->tstart);
+    if (! linear || value1 == value2)
+      histogram_add(hist, t1, t2, histogram_value_bucket(hist, value1));
+    else
+    {
+      double min = Min(value1, value2), max = Max(value1, value2);
+      int first = histogram_value_bucket(hist, min);
+      int last = histogram_value_bucket(hist, max);
+      for (int k = first; k <= last; k++)
+      {
+        double lower = hist->vstart + k * hist->vsize;
+        double vlow = Max(min, lower);
+        double vhigh = Min(max, lower + hist->vsize);
+        if (vhigh <= vlow)
+          continue;
+        /* Times at which the segment reaches the bounds of the bucket */
+        double ta = t1 + (vlow - value1) / (value2 - value1) * (t2 - t1);
+        double tb = t1 + (vhigh - value1) / (value2 - value1) * (t2 - t1);
+        histogram_add(hist, Min(ta, tb), Max(ta, tb), k);
+      }
+    }
+    inst1 = inst2;
+    value1 = value2;
+    t1 = t2;
+  }
+  return;
+}
+
+/**
+ * @brief Return the duration of a temporal number in each cell of a grid of
+ * value and time buckets
+ * @param[in] temp Temporal value
+ * @param[in] size Size of the value buckets
+ * @param[in] duration Size of the time buckets
+ * @param[in] vorigin Value origin of the buckets
+ * @param[in] torigin Time origin of the buckets
+ * @param[out] value_start Lower bound of the first value bucket
+ * @param[out] time_start Lower bound of the first time bucket
+ * @param[out] value_count Number of value buckets
+ * @param[out] time_count Number of time buckets
+ * @return Dense array of durations in microseconds, where the cell of the
+ * i-th value bucket and the j-th time bucket is at position
+ * `i * time_count + j`
+ * @note The function computes in one pass over the segments what would be
+ * obtained by adding the durations of the fragments returned by
+ * #tnumber_value_time_split() without constructing them. Instants and
+ * discrete sequences have no duration.
+ */
+double *
+tnumber_value_time_histogram(const Temporal *temp, Datum size,
+  const Interval *duration, Datum vorigin, TimestampTz torigin,
+  Datum *value_start, TimestampTz *time_start, int *value_count,
+  int *time_count)
+{
+  meosType basetype = temptype_basetype(temp->temptype);
+  ensure_positive_datum(size, basetype);
+  ensure_valid_duration(duration);
+
+  Span s;
+  Datum start_bucket, end_bucket, start_time_bucket, end_time_bucket;
+  /* Compute the value bounds */
+  tnumber_set_span(temp, &s);
+  int vcount = span_no_buckets(&s, size, vorigin, &start_bucket,
+    &end_bucket);
+  /* Compute the time bounds */
+  temporal_set_tstzspan(temp, &s);
+  int tcount = tstzspan_no_buckets(&s, duration, torigin, &start_time_bucket,
+    &end_time_bucket);
+
+  ValueTimeHistogram hist;
+  hist.vstart = datum_double(start_bucket, basetype);
+  hist.vsize = datum_double(size, basetype);
+  hist.vcount = vcount;
+  hist.tstart = DatumGetTimestampTz(start_time_bucket);
+  hist.tunits = interval_units(duration);
+  hist.tcount = tcount;
+  hist.durations = palloc0(sizeof(double) * vcount * tcount);
+
+  /* Instants and discrete sequences have no duration */
+  if (temp->subtype == TSEQUENCE && ! MEOS_FLAGS_DISCRETE_INTERP(temp->flags))
+    tnumbercontseq_value_time_histogram((const TSequence *) temp, &hist);
+  else if (temp->subtype == TSEQUENCESET)
+  {
+    const TSequenceSet *ss = (const TSequenceSet *) temp;
+    for (int i = 0; i < ss->count; i++)
+      tnumbercontseq_value_time_histogram(TSEQUENCESET_SEQ_N(ss, i), &hist);
+  }
+
+  if (value_start)
+    *value_start = start_bucket;
+  if (time_start)
+    *time_start = hist.tstart;
+  *value_count = vcount;
+  *time_count = tcount;
+  return hist.durations;
+}
+
 #if MEOS
 /**
  * @ingroup meos_temporal_analytics_tile
@@ -1927,6 +2695,48 @@ tfloat_value_time_split(const Temporal *temp, double size, const Interval *durat
   pfree(datum_buckets);
   return result;
 }
+
+/**
+ * @ingroup meos_temporal_analytics_tile
+ * @brief Return the duration of a temporal float in each cell of a grid of
+ * value and time buckets
+ * @param[in] temp Temporal value
+ * @param[in] size Size of the value buckets
+ * @param[in] duration Size of the time buckets
+ * @param[in] vorigin Value origin of the buckets
+ * @param[in] torigin Time origin of the buckets
+ * @param[out] value_start Lower bound of the first value bucket
+ * @param[out] time_start Lower bound of the first time bucket
+ * @param[out] value_count Number of value buckets
+ * @param[out] time_count Number of time buckets
+ * @return Dense array of durations in microseconds, where the cell of the
+ * i-th value bucket and the j-th time bucket is at position
+ * `i * time_count + j`
+ * @csqlfn #Tfloat_value_time_histogram()
+ */
+double *
+tfloat_value_time_histogram(const Temporal *temp, double size,
+  const Interval *duration, double vorigin, TimestampTz torigin,
+  double *value_start, TimestampTz *time_start, int *value_count,
+  int *time_count)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) temp) ||
+      ! ensure_not_null((void *) value_count) ||
+      ! ensure_not_null((void *) time_count) ||
+      ! ensure_temporal_isof_type(temp, T_TFLOAT) ||
+      ! ensure_positive_datum(Float8GetDatum(size), T_FLOAT8) ||
+      ! ensure_valid_duration(duration))
+    return NULL;
+
+  Datum start;
+  double *result = tnumber_value_time_histogram(temp, Float8GetDatum(size),
+    duration, Float8GetDatum(vorigin), torigin, &start, time_start,
+    value_count, time_count);
+  if (value_start)
+    *value_start = DatumGetFloat8(start);
+  return result;
+}
 #endif /* MEOS */
 
 /*****************************************************************************/
@@ -60,6 +60,7 @@
 #include "general/temporal_boxops.h"
 #include "general/type_util.h"
 #include "general/type_parser.h"
+#include "point/tpoint_boxops.h"
 #include "point/tpoint_parser.h"
 #include "point/tpoint_spatialfuncs.h"
 #if NPOINT
@@ -833,9 +834,12 @@ tsequence_make_exp1(const TInstant **instants, int count, int maxcount,
     insts_size = DOUBLE_PAD((size_t) ((double) insts_size * maxcount / count));
   else
     maxcount = newcount;
+  /* Long sequences keep a segment index at the end, after the free space of
+   * expandable sequences */
+  size_t segidx_size = tpointseq_segidx_size(norminsts[0], interp, maxcount);
   /* Total size of the struct */
   size_t memsize = DOUBLE_PAD(sizeof(TSequence)) + bboxsize_extra +
-    sizeof(size_t) * maxcount + insts_size;
+    sizeof(size_t) * maxcount + insts_size + segidx_size;
 
   /* Create the temporal sequence */
   TSequence *result = palloc0(memsize);
@@ -874,6 +878,8 @@ tsequence_make_exp1(const TInstant **instants, int count, int maxcount,
     (TSEQUENCE_OFFSETS_PTR(result))[i] = pos;
     pos += DOUBLE_PAD(VARSIZE(norminsts[i]));
   }
+  if (segidx_size > 0)
+    tpointseq_set_segidx(result);
   if (interp != DISCRETE && normalize && count > 1)
     pfree(norminsts);
   return result;
@@ -1405,16 +1411,28 @@ tsequence_compact(const TSequence *seq)
     insts_size += DOUBLE_PAD(VARSIZE(TSEQUENCE_INST_N(seq, i)));
   size_t seqsize = DOUBLE_PAD(sizeof(TSequence)) + bboxsize_extra +
     sizeof(size_t) * seq->count;
+  /* Size of the segment index, if any */
+  size_t segidx_size = tpointseq_segidx_size(TSEQUENCE_INST_N(seq, 0),
+    MEOS_FLAGS_GET_INTERP(seq->flags), seq->count);
   /* Create the sequence */
-  TSequence *result = palloc0(seqsize + insts_size);
+  TSequence *result = palloc0(seqsize + insts_size + segidx_size);
   /* Copy until the last used element of the offsets array */
   memcpy(result, seq, seqsize);
   /* Set the size and maxcount of the compacted sequence */
-  SET_VARSIZE(result, seqsize + insts_size);
+  SET_VARSIZE(result, seqsize + insts_size + segidx_size);
   result->maxcount = seq->count;
   /* Copy the instants */
   memcpy(((char *) result) + seqsize, (char *) TSEQUENCE_INST_N(seq, 0),
     insts_size);
+  /* Carry the segment index of the expandable sequence or build it */
+  MEOS_FLAGS_SET_SEGIDX(result->flags, false);
+  if (segidx_size > 0)
+  {
+    if (MEOS_FLAGS_GET_SEGIDX(seq->flags))
+      tpointseq_copy_segidx(result, seq);
+    else
+      tpointseq_set_segidx(result);
+  }
 #if DEBUG_EXPAND
   meos_error(WARNING, 0, " Sequence -> %d ", seq->count);
 #endif
@@ -1451,11 +1469,14 @@ tsequence_restart(TSequence *seq, int count)
   /* Copy the last instants at the beginning */
   last_n = TSEQUENCE_INST_N(seq, seq->count - count);
   memcpy(first, last_n, inst_size);
-  /* Update the count and the bounding box */
+  /* Update the count, the bounding box, and the segment index if any, whose
+   * space is reserved for the maximum number of instants */
   seq->count = count;
   size_t bboxsize = DOUBLE_PAD(temporal_bbox_size(seq->temptype));
   if (bboxsize != 0)
     tsequence_compute_bbox(seq);
+  if (MEOS_FLAGS_GET_SEGIDX(seq->flags))
+    tpointseq_set_segidx(seq);
   return;
 }
 
@@ -3054,8 +3075,11 @@ tsequence_eq(const TSequence *seq1, const TSequence *seq2)
 {
   assert(seq1); assert(seq2);
   assert(seq1->temptype == seq2->temptype);
-  /* If number of sequences, flags, or periods are not equal */
-  if (seq1->count != seq2->count || seq1->flags != seq2->flags ||
+  /* If number of sequences, flags, or periods are not equal. The segment
+   * index flag is not taken into account since it does not change the value */
+  int16 flags1 = seq1->flags & ~MEOS_FLAG_SEGIDX;
+  int16 flags2 = seq2->flags & ~MEOS_FLAG_SEGIDX;
+  if (seq1->count != seq2->count || flags1 != flags2 ||
       ! span_eq(&seq1->period, &seq2->period))
     return false;
 
@@ -3102,10 +3126,12 @@ tsequence_cmp(const TSequence *seq1, const TSequence *seq2)
   /* seq1->count == seq2->count because of the bounding box and the
    * composing instant tests above */
 
-  /* Compare flags  */
-  if (seq1->flags < seq2->flags)
+  /* Compare flags without the segment index flag */
+  int16 flags1 = seq1->flags & ~MEOS_FLAG_SEGIDX;
+  int16 flags2 = seq2->flags & ~MEOS_FLAG_SEGIDX;
+  if (flags1 < flags2)
     return -1;
-  if (seq1->flags > seq2->flags)
+  if (flags1 > flags2)
     return 1;
 
   /* The two values are equal */
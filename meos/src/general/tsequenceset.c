@@ -51,6 +51,7 @@
 #include "general/temporal_boxops.h"
 #include "general/type_parser.h"
 #include "general/type_util.h"
+#include "point/tpoint_boxops.h"
 #include "point/tpoint_parser.h"
 #include "point/tpoint_spatialfuncs.h"
 #if NPOINT
@@ -1421,15 +1422,27 @@ tsequenceset_compact(const TSequenceSet *ss)
   size_t ssheader = DOUBLE_PAD(sizeof(TSequenceSet)) + bboxsize_extra;
   /* Total size of the composing sequences */
   size_t seqs_size = 0;
-  /* Array keeping the total size of the instants of each composing sequence */
+  /* Arrays keeping the total size of the instants and the size of the
+   * segment index of each composing sequence */
   size_t *insts_size = palloc0(sizeof(size_t) * ss->count);
+  size_t *segidx_size = palloc0(sizeof(size_t) * ss->count);
   const TSequence *seq;
   for (int i = 0; i < ss->count; i++)
   {
     seq = TSEQUENCESET_SEQ_N(ss, i);
+    /* Sequences without free space are copied entirely, including their
+     * segment index if any */
+    if (seq->count == seq->maxcount)
+    {
+      seqs_size += DOUBLE_PAD(VARSIZE(seq));
+      continue;
+    }
     for (int j = 0; j < seq->count; j++)
       insts_size[i] += DOUBLE_PAD(VARSIZE(TSEQUENCE_INST_N(seq, j)));
-    seqs_size += seqheader + sizeof(size_t) * seq->count + insts_size[i];
+    segidx_size[i] = tpointseq_segidx_size(TSEQUENCE_INST_N(seq, 0),
+      MEOS_FLAGS_GET_INTERP(seq->flags), seq->count);
+    seqs_size += seqheader + sizeof(size_t) * seq->count + insts_size[i] +
+      segidx_size[i];
   }
   /* Compute the total size of the sequence set */
   size_t ss_size = ssheader + sizeof(size_t) * ss->count + seqs_size;
@@ -1448,30 +1461,44 @@ tsequenceset_compact(const TSequenceSet *ss)
   {
     seq = TSEQUENCESET_SEQ_N(ss, i);
     size_t pdata_seq = seqheader + sizeof(size_t) * seq->count;
+    size_t seq_size;
     /* Copy the entire sequence if it has no extra space */
     if (seq->count == seq->maxcount)
+    {
       memcpy(((char *) result) + pdata_ss + pos, seq, VARSIZE(seq));
+      seq_size = DOUBLE_PAD(VARSIZE(seq));
+    }
     else
     {
       /* Copy until the last used element of the offsets array */
       memcpy(((char *) result) + pdata_ss + pos, seq, pdata_seq);
       /* Set the size and maxcount of the compacted sequence */
       TSequence *resultseq = (TSequence *) ((char *) result + pdata_ss + pos);
-      SET_VARSIZE(resultseq, pdata_seq + insts_size[i]);
+      seq_size = pdata_seq + insts_size[i] + segidx_size[i];
+      SET_VARSIZE(resultseq, seq_size);
       resultseq->maxcount = seq->count;
       /* Copy the instants */
       memcpy(((char *) result) + pdata_ss + pos + pdata_seq,
         ((char *) seq) + seqheader + sizeof(size_t) * seq->maxcount,
         insts_size[i]);
+      /* Carry the segment index of the expandable sequence or build it */
+      MEOS_FLAGS_SET_SEGIDX(resultseq->flags, false);
+      if (segidx_size[i] > 0)
+      {
+        if (MEOS_FLAGS_GET_SEGIDX(seq->flags))
+          tpointseq_copy_segidx(resultseq, seq);
+        else
+          tpointseq_set_segidx(resultseq);
+      }
 #if DEBUG_EXPAND
       meos_error(WARNING, 0, " Sequence -> %d ", seq->count);
 #endif
     }
     /* Set the offset */
     (TSEQUENCESET_OFFSETS_PTR(result))[i] = pos;
-    pos += pdata_seq + insts_size[i];
+    pos += seq_size;
   }
-  pfree(insts_size);
+  pfree(insts_size); pfree(segidx_size);
   return result;
 }
 
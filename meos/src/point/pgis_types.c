@@ -50,7 +50,9 @@
 #include <lwgeom_geos.h>
 /* MEOS */
 #include "point/tpoint.h"
+#include "point/tpoint_restrfuncs.h"
 #include "point/tpoint_spatialfuncs.h"
+#include "point/tpoint_spatialrels.h"
 
 /* To avoid including lwgeom_functions_analytic.h */
 extern int point_in_polygon(LWPOLY *polygon, LWPOINT *point);
@@ -768,6 +770,218 @@ geometry_spatialrel(const GSERIALIZED *gs1, const GSERIALIZED *gs2,
   }
 }
 
+/**
+ * @ingroup meos_temporal_spatial_rel_ever
+ * @brief Return a geometry prepared for evaluating spatial relationships
+ * against many other geometries
+ * @details The geometry is copied and, if it is not geodetic, it is converted
+ * to GEOS and prepared once so that the repeated calls only need to convert
+ * the other argument. For geographies, the spherical tree used by the
+ * distance functions is computed once instead. The prepared geometry must be
+ * freed with #prepared_geo_free.
+ * @param[in] gs Geometry
+ * @note PostGIS keeps the same structure in the @p fn_extra field of the SQL
+ * functions in file @p lwgeom_geos_prepared.c
+ */
+PreparedGeo *
+geo_prepare(const GSERIALIZED *gs)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) gs))
+    return NULL;
+
+  PreparedGeo *result = palloc0(sizeof(PreparedGeo));
+  result->gs = palloc(VARSIZE(gs));
+  memcpy(result->gs, gs, VARSIZE(gs));
+  result->hasbox = (gserialized_get_gbox_p(gs, &result->box) == LW_SUCCESS);
+  result->use_spheroid = true;
+  if (gserialized_is_empty(gs))
+    return result;
+  /* GEOS does not handle geographies, keep their spherical tree instead */
+  if (FLAGS_GET_GEODETIC(gs->gflags))
+  {
+    result->lwgeom = lwgeom_from_gserialized(result->gs);
+    result->circtree = lwgeom_calculate_circ_tree(result->lwgeom);
+    return result;
+  }
+
+  initGEOS(lwnotice, lwgeom_geos_error);
+  result->geom = POSTGIS2GEOS(gs);
+  if (! result->geom)
+  {
+    pfree(result->gs); pfree(result);
+    meos_error(ERROR, MEOS_ERR_INTERNAL_TYPE_ERROR,
+      "Geometry could not be converted to GEOS");
+    return NULL;
+  }
+  result->prepgeom = GEOSPrepare(result->geom);
+  if (! result->prepgeom)
+  {
+    GEOSGeom_destroy(result->geom);
+    pfree(result->gs); pfree(result);
+    meos_error(ERROR, MEOS_ERR_INTERNAL_TYPE_ERROR,
+      "Geometry could not be prepared by GEOS");
+    return NULL;
+  }
+  return result;
+}
+
+/**
+ * @ingroup meos_temporal_dist
+ * @brief Return a geography prepared for computing distances against many
+ * temporal points
+ * @param[in] gs Geography
+ * @param[in] use_spheroid True when the distances are computed on the WGS84
+ * spheroid, false when they are computed on the sphere, which is faster but
+ * less precise
+ * @see #geo_prepare
+ */
+PreparedGeo *
+geog_prepare(const GSERIALIZED *gs, bool use_spheroid)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) gs))
+    return NULL;
+  if (! FLAGS_GET_GEODETIC(gs->gflags))
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "Only geodetic coordinates supported");
+    return NULL;
+  }
+  PreparedGeo *result = geo_prepare(gs);
+  result->use_spheroid = use_spheroid;
+  return result;
+}
+
+/**
+ * @brief Initialize a prepared geometry for a single call, which only keeps
+ * the structures computed on demand while restricting temporal points to the
+ * geometry
+ * @details This is used when the GEOS preparation of the geometry would not
+ * be amortized, the structures kept are shared by all the sequences of the
+ * temporal point.
+ * @param[out] pgeo Prepared geometry
+ * @param[in] gs Geometry, which is not copied and must outlive the structure
+ * @note The structure must be freed with #prepared_geo_reset
+ */
+void
+prepared_geo_init(PreparedGeo *pgeo, const GSERIALIZED *gs)
+{
+  memset(pgeo, 0, sizeof(PreparedGeo));
+  pgeo->gs = (GSERIALIZED *) gs;
+  pgeo->hasbox = (gserialized_get_gbox_p(gs, &pgeo->box) == LW_SUCCESS);
+  pgeo->use_spheroid = true;
+  return;
+}
+
+/**
+ * @brief Free the structures of a prepared geometry computed on demand
+ * @param[in] pgeo Prepared geometry
+ */
+void
+prepared_geo_reset(PreparedGeo *pgeo)
+{
+  if (pgeo->polyidx)
+    polyindex_free(pgeo->polyidx);
+  if (pgeo->tiles)
+    geotiles_free(pgeo->tiles);
+  pgeo->polyidx = NULL;
+  pgeo->tiles = NULL;
+  pgeo->hastiles = false;
+  return;
+}
+
+/**
+ * @ingroup meos_temporal_spatial_rel_ever
+ * @brief Free a prepared geometry
+ * @param[in] pgeo Prepared geometry
+ */
+void
+prepared_geo_free(PreparedGeo *pgeo)
+{
+  if (! pgeo)
+    return;
+  prepared_geo_reset(pgeo);
+  if (pgeo->prepgeom)
+    GEOSPreparedGeom_destroy(pgeo->prepgeom);
+  if (pgeo->geom)
+    GEOSGeom_destroy(pgeo->geom);
+  if (pgeo->circtree)
+    circ_tree_free(pgeo->circtree);
+  if (pgeo->lwgeom)
+    lwgeom_free(pgeo->lwgeom);
+  pfree(pgeo->gs);
+  pfree(pgeo);
+  return;
+}
+
+/**
+ * @brief Return true if a prepared geometry and a geometry satisfy a given
+ * spatial relationship, where the prepared geometry is the first argument
+ * @param[in] pgeo Prepared geometry
+ * @param[in] gs Geometry
+ * @param[in] rel Spatial relationship
+ * @pre The prepared geometry is not geodetic and not empty
+ * @note PostGIS functions: @p ST_Intersects(PG_FUNCTION_ARGS),
+ * @p contains(PG_FUNCTION_ARGS), @p covers(PG_FUNCTION_ARGS) when the cache
+ * holds a prepared geometry
+ */
+bool
+prepgeo_spatialrel(const PreparedGeo *pgeo, const GSERIALIZED *gs,
+  spatialRel rel)
+{
+  assert(pgeo->prepgeom);
+  assert(gserialized_get_srid(pgeo->gs) == gserialized_get_srid(gs));
+
+  /* A.Intersects(Empty) == FALSE */
+  if (gserialized_is_empty(gs))
+    return false;
+
+  /* Short-circuit: if the bounding boxes do not overlap return FALSE */
+  GBOX box;
+  if (pgeo->hasbox && gserialized_get_gbox_p(gs, &box) &&
+      gbox_overlaps_2d(&pgeo->box, &box) == LW_FALSE)
+    return false;
+
+  GEOSGeometry *geos = POSTGIS2GEOS(gs);
+  if (! geos)
+  {
+    meos_error(ERROR, MEOS_ERR_INTERNAL_TYPE_ERROR,
+      "Second argument geometry could not be converted to GEOS");
+    return false;
+  }
+
+  /* Call GEOS function */
+  assert(rel == INTERSECTS || rel == CONTAINS || rel == TOUCHES ||
+    rel == COVERS);
+  char result;
+  switch (rel)
+  {
+    case INTERSECTS:
+      result = GEOSPreparedIntersects(pgeo->prepgeom, geos);
+      break;
+    case CONTAINS:
+      result = GEOSPreparedContains(pgeo->prepgeom, geos);
+      break;
+    case TOUCHES:
+      result = GEOSPreparedTouches(pgeo->prepgeom, geos);
+      break;
+    case COVERS:
+      result = GEOSPreparedCovers(pgeo->prepgeom, geos);
+      break;
+    default:
+      /* keep compiler quiet */
+      result = 0;
+  }
+  GEOSGeom_destroy(geos);
+  if (result == 2)
+  {
+    meos_error(ERROR, MEOS_ERR_INTERNAL_TYPE_ERROR, "GEOS returned error");
+    return false;
+  }
+  return (bool) result;
+}
+
 /**
  * @brief Return true if two geometries satisfy a spatial relationship given
  * by a pattern
@@ -48,6 +48,9 @@
 #include <assert.h>
 /* PostgreSQL */
 #include <utils/timestamp.h>
+#if POSTGRESQL_VERSION_NUMBER >= 160000
+  #include "varatt.h"
+#endif
 /* PostGIS */
 #include <liblwgeom.h>
 /* MEOS */
@@ -188,6 +191,345 @@ tpointseqarr_set_stbox(const TSequence **sequences, int count, STBox *box)
   return;
 }
 
+/*****************************************************************************
+ * Segment index of temporal point sequences
+ *
+ * Long temporal point sequences keep after their instants a two-level index
+ * of the spatial extent of their segments. Each leaf entry covers a block of
+ * #SEGIDX_BLOCK_SIZE consecutive segments and each node entry covers
+ * #SEGIDX_BLOCK_SIZE consecutive leaf entries. An entry is an array of
+ * doubles xmin, xmax, ymin, ymax and, if the sequence has Z dimension, zmin,
+ * zmax. The node entries are stored before the leaf entries and the index is
+ * located at the end of the sequence. Its space is reserved for the maximum
+ * number of instants of the sequence, so that expandable sequences keep
+ * their index up to date when instants are appended in place, while only
+ * the entries covering the current instants are valid. Since the segments of
+ * a linear or step
+ * sequence of planar points are contained in the box of their instants, the
+ * index allows functions scanning the segments to skip blocks that do not
+ * intersect a box.
+ *****************************************************************************/
+
+/**
+ * @brief Return the number of leaf entries of the segment index of a
+ * sequence with a given number of instants
+ */
+static int
+segidx_nblocks(int count)
+{
+  /* The number of segments is count - 1 */
+  return (count - 2) / SEGIDX_BLOCK_SIZE + 1;
+}
+
+/**
+ * @brief Return the number of node entries of a segment index with a given
+ * number of leaf entries
+ */
+static int
+segidx_nnodes(int nblocks)
+{
+  return (nblocks - 1) / SEGIDX_BLOCK_SIZE + 1;
+}
+
+/**
+ * @brief Return the size in bytes of the segment index of a temporal point
+ * sequence, or 0 if the sequence does not keep a segment index
+ * @details A segment index is only kept for linear or step sequences of
+ * planar points that can hold at least #SEGIDX_MIN_COUNT instants
+ * @param[in] inst First instant of the sequence
+ * @param[in] interp Interpolation
+ * @param[in] maxcount Maximum number of instants of the sequence
+ */
+size_t
+tpointseq_segidx_size(const TInstant *inst, interpType interp, int maxcount)
+{
+  if (inst->temptype != T_TGEOMPOINT || interp == DISCRETE ||
+      maxcount < SEGIDX_MIN_COUNT)
+    return 0;
+  int nblocks = segidx_nblocks(maxcount);
+  int ncoords = MEOS_FLAGS_GET_Z(inst->flags) ? 6 : 4;
+  return sizeof(double) * ncoords * (segidx_nnodes(nblocks) + nblocks);
+}
+
+/**
+ * @brief Return a pointer to the first node entry of the segment index of a
+ * temporal point sequence
+ */
+static double *
+tpointseq_segidx_ptr(const TSequence *seq)
+{
+  size_t size = tpointseq_segidx_size(TSEQUENCE_INST_N(seq, 0),
+    MEOS_FLAGS_GET_INTERP(seq->flags), seq->maxcount);
+  return (double *) ((char *) seq + VARSIZE(seq) - size);
+}
+
+/**
+ * @brief Return a pointer to the first leaf entry of the segment index of a
+ * temporal point sequence
+ */
+static double *
+tpointseq_segidx_blocks_ptr(const TSequence *seq)
+{
+  int ncoords = MEOS_FLAGS_GET_Z(seq->flags) ? 6 : 4;
+  return tpointseq_segidx_ptr(seq) +
+    ncoords * segidx_nnodes(segidx_nblocks(seq->maxcount));
+}
+
+/**
+ * @brief Set a leaf entry of the segment index of a temporal point sequence,
+ * consecutive blocks share their bounding instant
+ */
+static void
+segidx_set_block(const TSequence *seq, int i, double *entry)
+{
+  bool hasz = MEOS_FLAGS_GET_Z(seq->flags);
+  int first = i * SEGIDX_BLOCK_SIZE;
+  int last = Min(first + SEGIDX_BLOCK_SIZE, seq->count - 1);
+  for (int j = first; j <= last; j++)
+  {
+    GSERIALIZED *point = DatumGetGserializedP(
+      tinstant_val(TSEQUENCE_INST_N(seq, j)));
+    double x, y, z;
+    point_get_coords(point, hasz, &x, &y, &z);
+    if (j == first)
+    {
+      entry[0] = entry[1] = x;
+      entry[2] = entry[3] = y;
+      if (hasz)
+        entry[4] = entry[5] = z;
+      continue;
+    }
+    entry[0] = Min(entry[0], x); entry[1] = Max(entry[1], x);
+    entry[2] = Min(entry[2], y); entry[3] = Max(entry[3], y);
+    if (hasz)
+    {
+      entry[4] = Min(entry[4], z); entry[5] = Max(entry[5], z);
+    }
+  }
+  return;
+}
+
+/**
+ * @brief Set the leaf entries of the segment index of a temporal point
+ * sequence
+ */
+static void
+segidx_set_blocks(const TSequence *seq, double *blocks)
+{
+  int ncoords = MEOS_FLAGS_GET_Z(seq->flags) ? 6 : 4;
+  int nblocks = segidx_nblocks(seq->count);
+  for (int i = 0; i < nblocks; i++)
+    segidx_set_block(seq, i, blocks + ncoords * i);
+  return;
+}
+
+/**
+ * @brief Set a node entry of a segment index from its leaf entries
+ */
+static void
+segidx_set_node(const double *blocks, int nblocks, int ncoords, int i,
+  double *entry)
+{
+  int first = i * SEGIDX_BLOCK_SIZE;
+  int last = Min(first + SEGIDX_BLOCK_SIZE, nblocks) - 1;
+  memcpy(entry, blocks + ncoords * first, sizeof(double) * ncoords);
+  for (int j = first + 1; j <= last; j++)
+  {
+    const double *block = blocks + ncoords * j;
+    for (int k = 0; k < ncoords; k += 2)
+    {
+      entry[k] = Min(entry[k], block[k]);
+      entry[k + 1] = Max(entry[k + 1], block[k + 1]);
+    }
+  }
+  return;
+}
+
+/**
+ * @brief Initialize the segment index of a temporal point sequence
+ * @pre The space for the index has been allocated at the end of the sequence
+ * as given by #tpointseq_segidx_size
+ */
+void
+tpointseq_set_segidx(TSequence *seq)
+{
+  assert(seq); assert(seq->temptype == T_TGEOMPOINT);
+  int ncoords = MEOS_FLAGS_GET_Z(seq->flags) ? 6 : 4;
+  int nblocks = segidx_nblocks(seq->count);
+  int nnodes = segidx_nnodes(nblocks);
+  double *nodes = tpointseq_segidx_ptr(seq);
+  double *blocks = tpointseq_segidx_blocks_ptr(seq);
+  segidx_set_blocks(seq, blocks);
+  /* Compute the node entries from the leaf entries */
+  for (int i = 0; i < nnodes; i++)
+    segidx_set_node(blocks, nblocks, ncoords, i, nodes + ncoords * i);
+  MEOS_FLAGS_SET_SEGIDX(seq->flags, true);
+  return;
+}
+
+/**
+ * @brief Copy the segment index of a temporal point sequence into another
+ * sequence with the same instants
+ * @details This is used when compacting an expandable sequence, whose index
+ * is laid out for its maximum number of instants
+ * @pre The space for the index has been allocated at the end of the
+ * destination sequence as given by #tpointseq_segidx_size
+ */
+void
+tpointseq_copy_segidx(TSequence *dest, const TSequence *src)
+{
+  assert(dest); assert(src); assert(dest->count == src->count);
+  assert(MEOS_FLAGS_GET_SEGIDX(src->flags));
+  int ncoords = MEOS_FLAGS_GET_Z(src->flags) ? 6 : 4;
+  int nblocks = segidx_nblocks(src->count);
+  int nnodes = segidx_nnodes(nblocks);
+  memcpy(tpointseq_segidx_ptr(dest), tpointseq_segidx_ptr(src),
+    sizeof(double) * ncoords * nnodes);
+  memcpy(tpointseq_segidx_blocks_ptr(dest), tpointseq_segidx_blocks_ptr(src),
+    sizeof(double) * ncoords * nblocks);
+  MEOS_FLAGS_SET_SEGIDX(dest->flags, true);
+  return;
+}
+
+/**
+ * @brief Update the segment index of a temporal point sequence after an
+ * instant has been appended in place or its last instant has been replaced
+ * @details Since the last instant only belongs to the last block, only the
+ * last leaf entry and the last node entry are recomputed. When the instant
+ * starts a new block or a new node, these entries are the new ones.
+ */
+void
+tpointseq_segidx_update_last(TSequence *seq)
+{
+  assert(seq); assert(MEOS_FLAGS_GET_SEGIDX(seq->flags));
+  int ncoords = MEOS_FLAGS_GET_Z(seq->flags) ? 6 : 4;
+  int nblocks = segidx_nblocks(seq->count);
+  int nnodes = segidx_nnodes(nblocks);
+  double *nodes = tpointseq_segidx_ptr(seq);
+  double *blocks = tpointseq_segidx_blocks_ptr(seq);
+  segidx_set_block(seq, nblocks - 1, blocks + ncoords * (nblocks - 1));
+  segidx_set_node(blocks, nblocks, ncoords, nnodes - 1,
+    nodes + ncoords * (nnodes - 1));
+  return;
+}
+
+/**
+ * @brief Return true if an entry of a segment index intersects the spatial
+ * dimension of a spatiotemporal box
+ */
+static bool
+segidx_entry_overlaps(const double *entry, const STBox *box, bool hasz)
+{
+  if (entry[1] < box->xmin || entry[0] > box->xmax ||
+      entry[3] < box->ymin || entry[2] > box->ymax)
+    return false;
+  if (hasz && (entry[5] < box->zmin || entry[4] > box->zmax))
+    return false;
+  return true;
+}
+
+/**
+ * @brief Return an array stating for each block of segments of a temporal
+ * point sequence whether it may intersect the spatial dimension of a
+ * spatiotemporal box, or NULL if the sequence does not have a segment index
+ * @details The segments of the i-th block are those starting at the instants
+ * i * #SEGIDX_BLOCK_SIZE to (i + 1) * #SEGIDX_BLOCK_SIZE - 1. The test
+ * considers the borders of the box as inclusive.
+ * @param[in] seq Temporal point sequence
+ * @param[in] box Spatiotemporal box
+ * @pre The box has X dimension and the arguments have the same SRID
+ */
+bool *
+tpointseq_segidx_search(const TSequence *seq, const STBox *box)
+{
+  assert(seq); assert(box); assert(MEOS_FLAGS_GET_X(box->flags));
+  if (! MEOS_FLAGS_GET_SEGIDX(seq->flags))
+    return NULL;
+
+  bool hasz_seq = MEOS_FLAGS_GET_Z(seq->flags);
+  bool hasz = hasz_seq && MEOS_FLAGS_GET_Z(box->flags);
+  int ncoords = hasz_seq ? 6 : 4;
+  int nblocks = segidx_nblocks(seq->count);
+  int nnodes = segidx_nnodes(nblocks);
+  const double *nodes = tpointseq_segidx_ptr(seq);
+  const double *blocks = tpointseq_segidx_blocks_ptr(seq);
+  bool *result = palloc0(sizeof(bool) * nblocks);
+  for (int i = 0; i < nnodes; i++)
+  {
+    /* The blocks of a node that does not intersect the box remain false */
+    if (! segidx_entry_overlaps(nodes + ncoords * i, box, hasz))
+      continue;
+    int first = i * SEGIDX_BLOCK_SIZE;
+    int last = Min(first + SEGIDX_BLOCK_SIZE, nblocks);
+    for (int j = first; j < last; j++)
+      result[j] = segidx_entry_overlaps(blocks + ncoords * j, box, hasz);
+  }
+  return result;
+}
+
+/**
+ * @brief Return the bounding boxes of the blocks of segments of a temporal
+ * point sequence, which are taken from the segment index if the sequence has
+ * one and are computed otherwise
+ * @details The blocks are those of the segment index and each box is an
+ * array of doubles xmin, xmax, ymin, ymax and, if the sequence has Z
+ * dimension, zmin, zmax
+ * @param[in] seq Temporal point sequence
+ * @param[out] count Number of blocks
+ * @pre The sequence is planar
+ */
+double *
+tpointseq_segidx_blocks(const TSequence *seq, int *count)
+{
+  assert(seq); assert(seq->temptype == T_TGEOMPOINT);
+  int ncoords = MEOS_FLAGS_GET_Z(seq->flags) ? 6 : 4;
+  int nblocks = segidx_nblocks(seq->count);
+  double *result = palloc(sizeof(double) * ncoords * nblocks);
+  if (MEOS_FLAGS_GET_SEGIDX(seq->flags))
+    memcpy(result, tpointseq_segidx_blocks_ptr(seq),
+      sizeof(double) * ncoords * nblocks);
+  else
+    segidx_set_blocks(seq, result);
+  *count = nblocks;
+  return result;
+}
+
+/**
+ * @brief Set the spatial extent of a spatiotemporal box from the segment
+ * index of a temporal point sequence
+ * @details The extent is the union of the node entries of the index, which
+ * avoids scanning the instants of the sequence
+ * @param[in] seq Temporal point sequence
+ * @param[out] box Spatiotemporal box, whose other components are unchanged
+ */
+void
+tpointseq_segidx_set_stbox(const TSequence *seq, STBox *box)
+{
+  assert(seq); assert(box); assert(MEOS_FLAGS_GET_SEGIDX(seq->flags));
+  bool hasz = MEOS_FLAGS_GET_Z(seq->flags);
+  int ncoords = hasz ? 6 : 4;
+  int nnodes = segidx_nnodes(segidx_nblocks(seq->count));
+  const double *nodes = tpointseq_segidx_ptr(seq);
+  double entry[6];
+  memcpy(entry, nodes, sizeof(double) * ncoords);
+  for (int i = 1; i < nnodes; i++)
+  {
+    const double *node = nodes + ncoords * i;
+    for (int k = 0; k < ncoords; k += 2)
+    {
+      entry[k] = Min(entry[k], node[k]);
+      entry[k + 1] = Max(entry[k + 1], node[k + 1]);
+    }
+  }
+  box->xmin = entry[0]; box->xmax = entry[1];
+  box->ymin = entry[2]; box->ymax = entry[3];
+  if (hasz)
+  {
+    box->zmin = entry[4]; box->zmax = entry[5];
+  }
+  return;
+}
+
 /*****************************************************************************
  * Boxes functions
  * These functions can be used for defining MultiEntry Search Trees (a.k.a.
@@ -34,6 +34,12 @@
 
 #include "point/tpoint_distance.h"
 
+/* C */
+#if defined(__AVX__)
+  #include <immintrin.h>
+#elif defined(__SSE2__)
+  #include <emmintrin.h>
+#endif
 /* PostGIS */
 #include <lwgeodetic_tree.h>
 #include <measures.h>
@@ -44,8 +50,10 @@
 #include "general/lifting.h"
 #include "general/tinstant.h"
 #include "general/tsequence.h"
+#include "general/type_util.h"
 #include "point/pgis_types.h"
 #include "point/geography_funcs.h"
+#include "point/tpoint_boxops.h"
 #include "point/tpoint_spatialfuncs.h"
 
 /* Function not exported by PostGIS */
@@ -102,12 +110,14 @@ tinstant_distance(const TInstant *inst1, const TInstant *inst2,
  * @details When the first geometry is a segment it also computes a value
  * between 0 and 1 that represents the location in the segment of the closest
  * point to the second geometry, as a fraction of total segment length.
+ * For geodetic coordinates, the spherical tree of the second geometry can be
+ * given in the argument @p tree2 to avoid computing it at every call.
  * @note Function inspired by PostGIS function lw_dist2d_distancepoint
  * from measures.c
  */
 static double
-lw_distance_fraction(const LWGEOM *geom1, const LWGEOM *geom2, int mode,
-  double *fraction)
+lw_distance_fraction(const LWGEOM *geom1, const LWGEOM *geom2,
+  const CIRC_NODE *tree2, int mode, double *fraction)
 {
   double result;
   if (FLAGS_GET_GEODETIC(geom1->flags))
@@ -117,9 +127,13 @@ lw_distance_fraction(const LWGEOM *geom1, const LWGEOM *geom2, int mode,
     GEOGRAPHIC_POINT closest1, closest2;
     GEOGRAPHIC_EDGE e;
     CIRC_NODE *circ_tree1 = lwgeom_calculate_circ_tree(geom1);
-    CIRC_NODE *circ_tree2 = lwgeom_calculate_circ_tree(geom2);
-    circ_tree_distance_tree_internal(circ_tree1, circ_tree2, FP_TOLERANCE,
-      &min_dist, &max_dist, &closest1, &closest2);
+    CIRC_NODE *circ_tree2 = tree2 ? NULL : lwgeom_calculate_circ_tree(geom2);
+    circ_tree_distance_tree_internal(circ_tree1,
+      tree2 ? tree2 : circ_tree2, FP_TOLERANCE, &min_dist, &max_dist,
+      &closest1, &closest2);
+    circ_tree_free(circ_tree1);
+    if (circ_tree2)
+      circ_tree_free(circ_tree2);
     result = sphere_distance(&closest1, &closest2);
     if (fraction != NULL)
     {
@@ -419,6 +433,497 @@ tpoint_min_dist_at_timestamptz(const TInstant *start1, const TInstant *end1,
     return tgeompoint_min_dist_at_timestamptz(start1, end1, start2, end2, value, t);
 }
 
+/*****************************************************************************
+ * Distance kernels on coordinate arrays
+ * The kernels process several points per iteration with AVX or SSE2
+ * instructions when the compiler targets them, e.g., with -mavx2 or by
+ * default on x86-64, and with plain loops otherwise. The points remaining
+ * after the last full vector are processed by the plain loops, which compute
+ * the same operations in the same order. The minimum and maximum are
+ * searched in a separate pass.
+ *****************************************************************************/
+
+#if defined(__AVX__)
+  #define VEC_WIDTH 4
+  typedef __m256d vec_double;
+  #define vec_load(p)      _mm256_loadu_pd(p)
+  #define vec_store(p, v)  _mm256_storeu_pd(p, v)
+  #define vec_set1(d)      _mm256_set1_pd(d)
+  #define vec_add(a, b)    _mm256_add_pd(a, b)
+  #define vec_sub(a, b)    _mm256_sub_pd(a, b)
+  #define vec_mul(a, b)    _mm256_mul_pd(a, b)
+  #define vec_div(a, b)    _mm256_div_pd(a, b)
+  #define vec_min(a, b)    _mm256_min_pd(a, b)
+  #define vec_max(a, b)    _mm256_max_pd(a, b)
+  #define vec_and(a, b)    _mm256_and_pd(a, b)
+  #define vec_gt(a, b)     _mm256_cmp_pd(a, b, _CMP_GT_OQ)
+#elif defined(__SSE2__)
+  #define VEC_WIDTH 2
+  typedef __m128d vec_double;
+  #define vec_load(p)      _mm_loadu_pd(p)
+  #define vec_store(p, v)  _mm_storeu_pd(p, v)
+  #define vec_set1(d)      _mm_set1_pd(d)
+  #define vec_add(a, b)    _mm_add_pd(a, b)
+  #define vec_sub(a, b)    _mm_sub_pd(a, b)
+  #define vec_mul(a, b)    _mm_mul_pd(a, b)
+  #define vec_div(a, b)    _mm_div_pd(a, b)
+  #define vec_min(a, b)    _mm_min_pd(a, b)
+  #define vec_max(a, b)    _mm_max_pd(a, b)
+  #define vec_and(a, b)    _mm_and_pd(a, b)
+  #define vec_gt(a, b)     _mm_cmpgt_pd(a, b)
+#endif /* __AVX__ */
+
+#ifdef VEC_WIDTH
+/**
+ * @brief Return the minimum of the lanes of a vector
+ */
+static inline double
+vec_hmin(vec_double v)
+{
+  double lanes[VEC_WIDTH];
+  vec_store(lanes, v);
+  double result = lanes[0];
+  for (int i = 1; i < VEC_WIDTH; i++)
+    result = (lanes[i] < result) ? lanes[i] : result;
+  return result;
+}
+#endif /* VEC_WIDTH */
+
+/**
+ * @brief Return the coordinates of a temporal point sequence in contiguous
+ * arrays
+ * @param[in] seq Temporal point sequence
+ */
+TPointCoords *
+tpointseq_coords(const TSequence *seq)
+{
+  bool hasz = MEOS_FLAGS_GET_Z(seq->flags);
+  int ndims = hasz ? 4 : 3;
+  /* Allocate the structure and all the arrays in a single chunk */
+  TPointCoords *result = palloc(sizeof(TPointCoords) +
+    sizeof(double) * ndims * seq->count +
+    sizeof(TimestampTz) * seq->count);
+  result->count = seq->count;
+  result->hasz = hasz;
+  result->x = (double *) (result + 1);
+  result->y = result->x + seq->count;
+  result->buf = result->y + seq->count;
+  result->z = hasz ? result->buf + seq->count : NULL;
+  result->t = (TimestampTz *) (result->buf + (ndims - 2) * seq->count);
+  for (int i = 0; i < seq->count; i++)
+  {
+    const TInstant *inst = TSEQUENCE_INST_N(seq, i);
+    if (hasz)
+    {
+      const POINT3DZ *pt = DATUM_POINT3DZ_P(tinstant_val(inst));
+      result->x[i] = pt->x;
+      result->y[i] = pt->y;
+      result->z[i] = pt->z;
+    }
+    else
+    {
+      const POINT2D *pt = DATUM_POINT2D_P(tinstant_val(inst));
+      result->x[i] = pt->x;
+      result->y[i] = pt->y;
+    }
+    result->t[i] = inst->t;
+  }
+  return result;
+}
+
+/**
+ * @brief Free the coordinates of a temporal point sequence
+ */
+void
+tpointcoords_free(TPointCoords *coords)
+{
+  pfree(coords);
+  return;
+}
+
+/**
+ * @brief Set in the buffer the squared distance between the points in the
+ * range [i1 + 1, i2 - 1] and the segment defined by the points i1 and i2
+ */
+static void
+tpointcoords_dist2_seg(const TPointCoords *coords, int i1, int i2)
+{
+  const double *restrict x = coords->x, *restrict y = coords->y;
+  const double *restrict z = coords->z;
+  double *restrict buf = coords->buf;
+  double ax = x[i1], ay = y[i1], dx = x[i2] - ax, dy = y[i2] - ay;
+  int k = i1 + 1;
+  if (z)
+  {
+    double az = z[i1], dz = z[i2] - az;
+    double len2 = dx * dx + dy * dy + dz * dz;
+    double inv = (len2 > 0) ? 1.0 / len2 : 0.0;
+#ifdef VEC_WIDTH
+    vec_double vax = vec_set1(ax), vay = vec_set1(ay), vaz = vec_set1(az),
+      vdx = vec_set1(dx), vdy = vec_set1(dy), vdz = vec_set1(dz),
+      vinv = vec_set1(inv), zero = vec_set1(0.0), one = vec_set1(1.0);
+    for (; k + VEC_WIDTH <= i2; k += VEC_WIDTH)
+    {
+      vec_double px = vec_sub(vec_load(&x[k]), vax),
+        py = vec_sub(vec_load(&y[k]), vay), pz = vec_sub(vec_load(&z[k]), vaz);
+      vec_double r = vec_mul(vec_add(vec_add(vec_mul(px, vdx),
+        vec_mul(py, vdy)), vec_mul(pz, vdz)), vinv);
+      r = vec_min(vec_max(r, zero), one);
+      vec_double ex = vec_sub(px, vec_mul(r, vdx)),
+        ey = vec_sub(py, vec_mul(r, vdy)), ez = vec_sub(pz, vec_mul(r, vdz));
+      vec_store(&buf[k], vec_add(vec_add(vec_mul(ex, ex), vec_mul(ey, ey)),
+        vec_mul(ez, ez)));
+    }
+#endif /* VEC_WIDTH */
+    for (; k < i2; k++)
+    {
+      double px = x[k] - ax, py = y[k] - ay, pz = z[k] - az;
+      double r = (px * dx + py * dy + pz * dz) * inv;
+      r = (r < 0.0) ? 0.0 : ((r > 1.0) ? 1.0 : r);
+      double ex = px - r * dx, ey = py - r * dy, ez = pz - r * dz;
+      buf[k] = ex * ex + ey * ey + ez * ez;
+    }
+  }
+  else
+  {
+    double len2 = dx * dx + dy * dy;
+    double inv = (len2 > 0) ? 1.0 / len2 : 0.0;
+#ifdef VEC_WIDTH
+    vec_double vax = vec_set1(ax), vay = vec_set1(ay), vdx = vec_set1(dx),
+      vdy = vec_set1(dy), vinv = vec_set1(inv), zero = vec_set1(0.0),
+      one = vec_set1(1.0);
+    for (; k + VEC_WIDTH <= i2; k += VEC_WIDTH)
+    {
+      vec_double px = vec_sub(vec_load(&x[k]), vax),
+        py = vec_sub(vec_load(&y[k]), vay);
+      vec_double r = vec_mul(vec_add(vec_mul(px, vdx), vec_mul(py, vdy)),
+        vinv);
+      r = vec_min(vec_max(r, zero), one);
+      vec_double ex = vec_sub(px, vec_mul(r, vdx)),
+        ey = vec_sub(py, vec_mul(r, vdy));
+      vec_store(&buf[k], vec_add(vec_mul(ex, ex), vec_mul(ey, ey)));
+    }
+#endif /* VEC_WIDTH */
+    for (; k < i2; k++)
+    {
+      double px = x[k] - ax, py = y[k] - ay;
+      double r = (px * dx + py * dy) * inv;
+      r = (r < 0.0) ? 0.0 : ((r > 1.0) ? 1.0 : r);
+      double ex = px - r * dx, ey = py - r * dy;
+      buf[k] = ex * ex + ey * ey;
+    }
+  }
+  return;
+}
+
+/**
+ * @brief Set in the buffer the squared Synchronized Euclidean Distance
+ * between the points in the range [i1 + 1, i2 - 1] and the segment defined by
+ * the points i1 and i2
+ * @note The fractions of time are computed in a first pass since there is no
+ * SSE2 or AVX instruction converting 64-bit integers into doubles
+ */
+static void
+tpointcoords_sed2_seg(const TPointCoords *coords, int i1, int i2)
+{
+  const double *restrict x = coords->x, *restrict y = coords->y;
+  const double *restrict z = coords->z;
+  const TimestampTz *restrict t = coords->t;
+  double *restrict buf = coords->buf;
+  double ax = x[i1], ay = y[i1], dx = x[i2] - ax, dy = y[i2] - ay;
+  TimestampTz ta = t[i1];
+  double inv = 1.0 / (double) (t[i2] - ta);
+  for (int k = i1 + 1; k < i2; k++)
+    buf[k] = (double) (t[k] - ta) * inv;
+  int k = i1 + 1;
+  if (z)
+  {
+    double az = z[i1], dz = z[i2] - az;
+#ifdef VEC_WIDTH
+    vec_double vax = vec_set1(ax), vay = vec_set1(ay), vaz = vec_set1(az),
+      vdx = vec_set1(dx), vdy = vec_set1(dy), vdz = vec_set1(dz);
+    for (; k + VEC_WIDTH <= i2; k += VEC_WIDTH)
+    {
+      vec_double r = vec_load(&buf[k]);
+      vec_double ex = vec_sub(vec_sub(vec_load(&x[k]), vax), vec_mul(r, vdx)),
+        ey = vec_sub(vec_sub(vec_load(&y[k]), vay), vec_mul(r, vdy)),
+        ez = vec_sub(vec_sub(vec_load(&z[k]), vaz), vec_mul(r, vdz));
+      vec_store(&buf[k], vec_add(vec_add(vec_mul(ex, ex), vec_mul(ey, ey)),
+        vec_mul(ez, ez)));
+    }
+#endif /* VEC_WIDTH */
+    for (; k < i2; k++)
+    {
+      double r = buf[k];
+      double ex = x[k] - ax - r * dx, ey = y[k] - ay - r * dy,
+        ez = z[k] - az - r * dz;
+      buf[k] = ex * ex + ey * ey + ez * ez;
+    }
+  }
+  else
+  {
+#ifdef VEC_WIDTH
+    vec_double vax = vec_set1(ax), vay = vec_set1(ay), vdx = vec_set1(dx),
+      vdy = vec_set1(dy);
+    for (; k + VEC_WIDTH <= i2; k += VEC_WIDTH)
+    {
+      vec_double r = vec_load(&buf[k]);
+      vec_double ex = vec_sub(vec_sub(vec_load(&x[k]), vax), vec_mul(r, vdx)),
+        ey = vec_sub(vec_sub(vec_load(&y[k]), vay), vec_mul(r, vdy));
+      vec_store(&buf[k], vec_add(vec_mul(ex, ex), vec_mul(ey, ey)));
+    }
+#endif /* VEC_WIDTH */
+    for (; k < i2; k++)
+    {
+      double r = buf[k];
+      double ex = x[k] - ax - r * dx, ey = y[k] - ay - r * dy;
+      buf[k] = ex * ex + ey * ey;
+    }
+  }
+  return;
+}
+
+/**
+ * @brief Return the index of the point in the range [i1 + 1, i2 - 1] that is
+ * the farthest from the segment defined by the points i1 and i2, or i1 if the
+ * range is empty
+ * @param[in] coords Coordinates of a temporal point sequence
+ * @param[in] i1,i2 Indexes of the points defining the segment
+ * @param[in] syncdist True when using the Synchronized Euclidean Distance
+ */
+int
+tpointcoords_findsplit(const TPointCoords *coords, int i1, int i2,
+  bool syncdist)
+{
+  if (i1 + 1 >= i2)
+    return i1;
+  if (syncdist)
+    tpointcoords_sed2_seg(coords, i1, i2);
+  else
+    tpointcoords_dist2_seg(coords, i1, i2);
+  const double *restrict buf = coords->buf;
+  int result = i1 + 1;
+  for (int k = i1 + 2; k < i2; k++)
+  {
+    if (buf[k] > buf[result])
+      result = k;
+  }
+  return result;
+}
+
+/**
+ * @brief Return the minimum of the first values of a buffer
+ */
+static double
+tpointcoords_buf_min(const double *restrict buf, int count)
+{
+  double result = buf[0];
+  int i = 1;
+#ifdef VEC_WIDTH
+  if (count >= VEC_WIDTH)
+  {
+    vec_double vmin = vec_load(buf);
+    for (i = VEC_WIDTH; i + VEC_WIDTH <= count; i += VEC_WIDTH)
+      vmin = vec_min(vmin, vec_load(&buf[i]));
+    result = vec_hmin(vmin);
+  }
+#endif /* VEC_WIDTH */
+  for (; i < count; i++)
+    result = (buf[i] < result) ? buf[i] : result;
+  return result;
+}
+
+/**
+ * @brief Return the index of the first minimum of the first values of a
+ * buffer
+ */
+static int
+tpointcoords_buf_argmin(const double *restrict buf, int count)
+{
+  double min = tpointcoords_buf_min(buf, count);
+  int result = 0;
+  while (buf[result] != min)
+    result++;
+  return result;
+}
+
+/**
+ * @brief Set in the buffer of the first sequence the squared distance between
+ * the points of two synchronized sequences at each instant
+ */
+static void
+tpointcoords_dist2_inst(const TPointCoords *coords1,
+  const TPointCoords *coords2)
+{
+  const double *restrict x1 = coords1->x, *restrict y1 = coords1->y;
+  const double *restrict z1 = coords1->z;
+  const double *restrict x2 = coords2->x, *restrict y2 = coords2->y;
+  const double *restrict z2 = coords2->z;
+  double *restrict buf = coords1->buf;
+  int count = coords1->count, i = 0;
+  if (z1)
+  {
+#ifdef VEC_WIDTH
+    for (; i + VEC_WIDTH <= count; i += VEC_WIDTH)
+    {
+      vec_double dx = vec_sub(vec_load(&x1[i]), vec_load(&x2[i])),
+        dy = vec_sub(vec_load(&y1[i]), vec_load(&y2[i])),
+        dz = vec_sub(vec_load(&z1[i]), vec_load(&z2[i]));
+      vec_store(&buf[i], vec_add(vec_add(vec_mul(dx, dx), vec_mul(dy, dy)),
+        vec_mul(dz, dz)));
+    }
+#endif /* VEC_WIDTH */
+    for (; i < count; i++)
+    {
+      double dx = x1[i] - x2[i], dy = y1[i] - y2[i], dz = z1[i] - z2[i];
+      buf[i] = dx * dx + dy * dy + dz * dz;
+    }
+  }
+  else
+  {
+#ifdef VEC_WIDTH
+    for (; i + VEC_WIDTH <= count; i += VEC_WIDTH)
+    {
+      vec_double dx = vec_sub(vec_load(&x1[i]), vec_load(&x2[i])),
+        dy = vec_sub(vec_load(&y1[i]), vec_load(&y2[i]));
+      vec_store(&buf[i], vec_add(vec_mul(dx, dx), vec_mul(dy, dy)));
+    }
+#endif /* VEC_WIDTH */
+    for (; i < count; i++)
+    {
+      double dx = x1[i] - x2[i], dy = y1[i] - y2[i];
+      buf[i] = dx * dx + dy * dy;
+    }
+  }
+  return;
+}
+
+/**
+ * @brief Set in the buffer of the first sequence the squared minimum distance
+ * in each segment of two synchronized sequences with linear interpolation,
+ * and in the buffer of the second sequence the fraction of the segment at
+ * which this minimum is reached
+ * @details The difference between the two points in a segment moves linearly
+ * and thus the minimum distance of the segment is the distance between the
+ * origin and the segment defined by the differences at the start and at the
+ * end of the segment.
+ */
+static void
+tpointcoords_dist2_diffseg(const TPointCoords *coords1,
+  const TPointCoords *coords2)
+{
+  const double *restrict x1 = coords1->x, *restrict y1 = coords1->y;
+  const double *restrict z1 = coords1->z;
+  const double *restrict x2 = coords2->x, *restrict y2 = coords2->y;
+  const double *restrict z2 = coords2->z;
+  double *restrict buf = coords1->buf;
+  double *restrict frac = coords2->buf;
+  int nsegs = coords1->count - 1, i = 0;
+#ifdef VEC_WIDTH
+  vec_double zero = vec_set1(0.0), one = vec_set1(1.0);
+#endif /* VEC_WIDTH */
+  if (z1)
+  {
+#ifdef VEC_WIDTH
+    for (; i + VEC_WIDTH <= nsegs; i += VEC_WIDTH)
+    {
+      vec_double ax = vec_sub(vec_load(&x1[i]), vec_load(&x2[i])),
+        ay = vec_sub(vec_load(&y1[i]), vec_load(&y2[i])),
+        az = vec_sub(vec_load(&z1[i]), vec_load(&z2[i]));
+      vec_double dx = vec_sub(vec_sub(vec_load(&x1[i + 1]),
+          vec_load(&x2[i + 1])), ax),
+        dy = vec_sub(vec_sub(vec_load(&y1[i + 1]), vec_load(&y2[i + 1])), ay),
+        dz = vec_sub(vec_sub(vec_load(&z1[i + 1]), vec_load(&z2[i + 1])), az);
+      vec_double len2 = vec_add(vec_add(vec_mul(dx, dx), vec_mul(dy, dy)),
+        vec_mul(dz, dz));
+      vec_double dot = vec_add(vec_add(vec_mul(ax, dx), vec_mul(ay, dy)),
+        vec_mul(az, dz));
+      /* The mask sets to 0 the fraction of the constant segments */
+      vec_double r = vec_and(vec_div(vec_sub(zero, dot), len2),
+        vec_gt(len2, zero));
+      r = vec_min(vec_max(r, zero), one);
+      vec_double ex = vec_add(ax, vec_mul(r, dx)),
+        ey = vec_add(ay, vec_mul(r, dy)), ez = vec_add(az, vec_mul(r, dz));
+      vec_store(&buf[i], vec_add(vec_add(vec_mul(ex, ex), vec_mul(ey, ey)),
+        vec_mul(ez, ez)));
+      vec_store(&frac[i], r);
+    }
+#endif /* VEC_WIDTH */
+    for (; i < nsegs; i++)
+    {
+      double ax = x1[i] - x2[i], ay = y1[i] - y2[i], az = z1[i] - z2[i];
+      double dx = x1[i + 1] - x2[i + 1] - ax, dy = y1[i + 1] - y2[i + 1] - ay,
+        dz = z1[i + 1] - z2[i + 1] - az;
+      double len2 = dx * dx + dy * dy + dz * dz;
+      double r = (len2 > 0) ? - (ax * dx + ay * dy + az * dz) / len2 : 0.0;
+      r = (r < 0.0) ? 0.0 : ((r > 1.0) ? 1.0 : r);
+      double ex = ax + r * dx, ey = ay + r * dy, ez = az + r * dz;
+      buf[i] = ex * ex + ey * ey + ez * ez;
+      frac[i] = r;
+    }
+  }
+  else
+  {
+#ifdef VEC_WIDTH
+    for (; i + VEC_WIDTH <= nsegs; i += VEC_WIDTH)
+    {
+      vec_double ax = vec_sub(vec_load(&x1[i]), vec_load(&x2[i])),
+        ay = vec_sub(vec_load(&y1[i]), vec_load(&y2[i]));
+      vec_double dx = vec_sub(vec_sub(vec_load(&x1[i + 1]),
+          vec_load(&x2[i + 1])), ax),
+        dy = vec_sub(vec_sub(vec_load(&y1[i + 1]), vec_load(&y2[i + 1])), ay);
+      vec_double len2 = vec_add(vec_mul(dx, dx), vec_mul(dy, dy));
+      vec_double dot = vec_add(vec_mul(ax, dx), vec_mul(ay, dy));
+      /* The mask sets to 0 the fraction of the constant segments */
+      vec_double r = vec_and(vec_div(vec_sub(zero, dot), len2),
+        vec_gt(len2, zero));
+      r = vec_min(vec_max(r, zero), one);
+      vec_double ex = vec_add(ax, vec_mul(r, dx)),
+        ey = vec_add(ay, vec_mul(r, dy));
+      vec_store(&buf[i], vec_add(vec_mul(ex, ex), vec_mul(ey, ey)));
+      vec_store(&frac[i], r);
+    }
+#endif /* VEC_WIDTH */
+    for (; i < nsegs; i++)
+    {
+      double ax = x1[i] - x2[i], ay = y1[i] - y2[i];
+      double dx = x1[i + 1] - x2[i + 1] - ax, dy = y1[i + 1] - y2[i + 1] - ay;
+      double len2 = dx * dx + dy * dy;
+      double r = (len2 > 0) ? - (ax * dx + ay * dy) / len2 : 0.0;
+      r = (r < 0.0) ? 0.0 : ((r > 1.0) ? 1.0 : r);
+      double ex = ax + r * dx, ey = ay + r * dy;
+      buf[i] = ex * ex + ey * ey;
+      frac[i] = r;
+    }
+  }
+  return;
+}
+
+/**
+ * @brief Return the nearest approach distance between two synchronized
+ * temporal point sequences given by their coordinates
+ * @details For linear interpolation the minimum of each segment is reached
+ * at its bounds or inside it and thus the distances at the instants need not
+ * be computed.
+ * @param[in] coords1,coords2 Coordinates of the sequences
+ * @param[in] linear True when the sequences have linear interpolation
+ * @pre The sequences are synchronized and planar
+ * @note The buffers of both sequences are overwritten
+ */
+double
+tpointcoords_nad(const TPointCoords *coords1, const TPointCoords *coords2,
+  bool linear)
+{
+  assert(coords1->count == coords2->count);
+  if (! linear || coords1->count < 2)
+  {
+    tpointcoords_dist2_inst(coords1, coords2);
+    return sqrt(tpointcoords_buf_min(coords1->buf, coords1->count));
+  }
+  tpointcoords_dist2_diffseg(coords1, coords2);
+  return sqrt(tpointcoords_buf_min(coords1->buf, coords1->count - 1));
+}
+
 /*****************************************************************************/
 
 /**
@@ -454,6 +959,110 @@ distance_tpoint_point(const Temporal *temp, const GSERIALIZED *gs)
   return tfunc_temporal_base(temp, PointerGetDatum(gs), &lfinfo);
 }
 
+/**
+ * @brief Return the temporal distance between two synchronized planar
+ * temporal point sequences
+ * @details The distance at the instants is computed with the function used
+ * by the lifted distance. For linear interpolation, the kernel on the
+ * segments of differences gives the fraction of each segment at which its
+ * minimum distance is reached, and the turning point is only computed for
+ * the segments where this fraction is not at a bound.
+ * @pre The sequences are both linear or both step
+ */
+static TSequence *
+distance_tpointseq_tpointseq_coords(const TSequence *seq1,
+  const TSequence *seq2)
+{
+  assert(seq1->count == seq2->count);
+  datum_func2 func = pt_distance_fn(seq1->flags);
+  TPointCoords *coords1 = NULL, *coords2 = NULL;
+  const double *frac = NULL;
+  if (MEOS_FLAGS_LINEAR_INTERP(seq1->flags) && seq1->count > 1)
+  {
+    coords1 = tpointseq_coords(seq1);
+    coords2 = tpointseq_coords(seq2);
+    tpointcoords_dist2_diffseg(coords1, coords2);
+    frac = coords2->buf;
+  }
+  TInstant **instants = palloc(sizeof(TInstant *) * seq1->count * 2);
+  int ninsts = 0;
+  for (int i = 0; i < seq1->count; i++)
+  {
+    const TInstant *inst1 = TSEQUENCE_INST_N(seq1, i);
+    const TInstant *inst2 = TSEQUENCE_INST_N(seq2, i);
+    if (frac && i > 0 && frac[i - 1] > 0.0 && frac[i - 1] < 1.0)
+    {
+      const TInstant *prev1 = TSEQUENCE_INST_N(seq1, i - 1);
+      const TInstant *prev2 = TSEQUENCE_INST_N(seq2, i - 1);
+      Datum value;
+      TimestampTz t;
+      /* Avoid adding a turning point at the timestamp of the previous
+       * instant */
+      if (tgeompoint_min_dist_at_timestamptz(prev1, inst1, prev2, inst2,
+          &value, &t) && t != prev1->t)
+        instants[ninsts++] = tinstant_make(value, T_TFLOAT, t);
+    }
+    instants[ninsts++] = tinstant_make(func(tinstant_val(inst1),
+      tinstant_val(inst2)), T_TFLOAT, inst1->t);
+  }
+  if (coords1)
+  {
+    tpointcoords_free(coords1); tpointcoords_free(coords2);
+  }
+  return tsequence_make_free(instants, ninsts, seq1->period.lower_inc,
+    seq1->period.upper_inc, MEOS_FLAGS_GET_INTERP(seq1->flags), NORMALIZE);
+}
+
+/**
+ * @brief Return the temporal distance between two planar temporal points
+ * using the distance kernels on coordinate arrays
+ * @pre The temporal points are continuous and have both linear or both step
+ * interpolation
+ */
+static Temporal *
+distance_tpoint_tpoint_coords(const Temporal *temp1, const Temporal *temp2)
+{
+  Temporal *sync1, *sync2;
+  if (! intersection_temporal_temporal(temp1, temp2, SYNCHRONIZE_NOCROSS,
+      &sync1, &sync2))
+    return NULL;
+
+  Temporal *result;
+  if (sync1->subtype == TSEQUENCE)
+    result = (Temporal *) distance_tpointseq_tpointseq_coords(
+      (TSequence *) sync1, (TSequence *) sync2);
+  else
+  {
+    const TSequenceSet *ss1 = (TSequenceSet *) sync1;
+    const TSequenceSet *ss2 = (TSequenceSet *) sync2;
+    TSequence **sequences = palloc(sizeof(TSequence *) * ss1->count);
+    for (int i = 0; i < ss1->count; i++)
+      sequences[i] = distance_tpointseq_tpointseq_coords(
+        TSEQUENCESET_SEQ_N(ss1, i), TSEQUENCESET_SEQ_N(ss2, i));
+    result = (Temporal *) tsequenceset_make_free(sequences, ss1->count,
+      NORMALIZE);
+  }
+  pfree(sync1); pfree(sync2);
+  return result;
+}
+
+/**
+ * @brief Return true if the distance between two temporal points is
+ * computed with the distance kernels on coordinate arrays, that is, when
+ * the points are planar, continuous, and have both linear or both step
+ * interpolation
+ */
+static bool
+tpoint_tpoint_coords(const Temporal *temp1, const Temporal *temp2)
+{
+  return ! MEOS_FLAGS_GET_GEODETIC(temp1->flags) &&
+    temp1->subtype != TINSTANT && temp2->subtype != TINSTANT &&
+    ! MEOS_FLAGS_DISCRETE_INTERP(temp1->flags) &&
+    ! MEOS_FLAGS_DISCRETE_INTERP(temp2->flags) &&
+    MEOS_FLAGS_LINEAR_INTERP(temp1->flags) ==
+      MEOS_FLAGS_LINEAR_INTERP(temp2->flags);
+}
+
 /**
  * @ingroup meos_temporal_dist
  * @brief Return the temporal distance between two temporal points
@@ -468,6 +1077,9 @@ distance_tpoint_tpoint(const Temporal *temp1, const Temporal *temp2)
       ! ensure_same_dimensionality(temp1->flags, temp2->flags))
     return NULL;
 
+  if (tpoint_tpoint_coords(temp1, temp2))
+    return distance_tpoint_tpoint_coords(temp1, temp2);
+
   LiftedFunctionInfo lfinfo;
   memset(&lfinfo, 0, sizeof(LiftedFunctionInfo));
   lfinfo.func = (varfunc) pt_distance_fn(temp1->flags);
@@ -487,12 +1099,241 @@ distance_tpoint_tpoint(const Temporal *temp1, const Temporal *temp2)
  * Nearest approach instant (NAI)
  *****************************************************************************/
 
+/**
+ * @brief Return the distance and the timestamp of the nearest approach instant
+ * between a temporal sequence point with linear interpolation and a
+ * geometry/geography
+ * @param[in] inst1,inst2 Temporal segment
+ * @param[in] geo Geometry/geography
+ * @param[in] tree Spherical tree of the geography, may be NULL
+ * @param[out] t Timestamp
+ * @result Distance
+ */
+static double
+nai_tpointsegm_linear_geo1(const TInstant *inst1, const TInstant *inst2,
+  const LWGEOM *geo, const CIRC_NODE *tree, TimestampTz *t)
+{
+  Datum value1 = tinstant_val(inst1);
+  Datum value2 = tinstant_val(inst2);
+  double dist;
+  double fraction;
+
+  /* Constant segment */
+  if (datum_point_eq(value1, value2))
+  {
+    GSERIALIZED *gs = DatumGetGserializedP(value1);
+    LWGEOM *point = lwgeom_from_gserialized(gs);
+    dist = lw_distance_fraction(point, geo, tree, DIST_MIN, NULL);
+    lwgeom_free(point);
+    *t = inst1->t;
+    return dist;
+  }
+
+  /* The trajectory is a line */
+  LWGEOM *line = (LWGEOM *) lwline_make(value1, value2);
+  dist = lw_distance_fraction(line, geo, tree, DIST_MIN, &fraction);
+  lwgeom_free(line);
+
+  if (fabsl(fraction) < MEOS_EPSILON)
+    *t = inst1->t;
+  else if (fabsl(fraction - 1.0) < MEOS_EPSILON)
+    *t = inst2->t;
+  else
+  {
+    double duration = (double) (inst2->t - inst1->t);
+    *t = inst1->t + (TimestampTz) (duration * fraction);
+  }
+  return dist;
+}
+
+/**
+ * @brief Block of segments of a temporal point sequence with the lower bound
+ * of its distance to a geometry
+ */
+typedef struct
+{
+  double lb;          /**< Lower bound of the distance */
+  int i;              /**< Number of the block */
+} NaiBlock;
+
+/**
+ * @brief Comparator function for blocks of segments
+ */
+static int
+nai_block_cmp(const NaiBlock *l, const NaiBlock *r)
+{
+  if (l->lb != r->lb)
+    return (l->lb < r->lb) ? -1 : 1;
+  return (l->i < r->i) ? -1 : ((l->i > r->i) ? 1 : 0);
+}
+
+/**
+ * @brief Return the distance between the bounding box of a block of segments
+ * and the bounding box of a geometry
+ */
+static double
+nai_block_lower_bound(const double *entry, const GBOX *gbox, bool hasz)
+{
+  double dx = Max(0.0, Max(entry[0] - gbox->xmax, gbox->xmin - entry[1]));
+  double dy = Max(0.0, Max(entry[2] - gbox->ymax, gbox->ymin - entry[3]));
+  if (! hasz)
+    return hypot(dx, dy);
+  double dz = Max(0.0, Max(entry[4] - gbox->zmax, gbox->zmin - entry[5]));
+  return hypot3d(dx, dy, dz);
+}
+
+/**
+ * @brief Return the minimum distance between a planar temporal sequence point
+ * and a geometry using a branch-and-bound search on the blocks of segments
+ * @details The blocks of the segment index of the sequence are visited in
+ * ascending order of the distance between their bounding box and the one of
+ * the geometry, until the distance of the next block is greater than the
+ * current minimum. When several segments are at the minimum distance, the
+ * first one is selected as when scanning all the segments.
+ * @param[in] seq Temporal point
+ * @param[in] geo Geometry
+ * @param[in] mindist Minimum distance found so far, or DBL_MAX at the beginning
+ * @param[out] pos Position of the segment, or of the instant for sequences
+ * without linear interpolation, at the minimum distance
+ * @param[out] t Timestamp of the nearest approach instant
+ * @note The output arguments are only set when the minimum distance is less
+ * than the one given as argument
+ */
+static double
+tpointseq_geo_min_dist_bnb(const TSequence *seq, const LWGEOM *geo,
+  double mindist, int *pos, TimestampTz *t)
+{
+  assert(seq->temptype == T_TGEOMPOINT);
+  bool linear = MEOS_FLAGS_LINEAR_INTERP(seq->flags) && seq->count > 1;
+  bool hasz = MEOS_FLAGS_GET_Z(seq->flags) && FLAGS_GET_Z(geo->flags);
+  int ncoords = MEOS_FLAGS_GET_Z(seq->flags) ? 6 : 4;
+  GBOX gbox;
+  lwgeom_calculate_gbox(geo, &gbox);
+
+  /* Sort the blocks by the lower bound of their distance */
+  int nblocks;
+  double *entries = tpointseq_segidx_blocks(seq, &nblocks);
+  NaiBlock *blocks = palloc(sizeof(NaiBlock) * nblocks);
+  for (int i = 0; i < nblocks; i++)
+  {
+    blocks[i].lb = nai_block_lower_bound(entries + ncoords * i, &gbox, hasz);
+    blocks[i].i = i;
+  }
+  pfree(entries);
+  qsort(blocks, (size_t) nblocks, sizeof(NaiBlock),
+    (qsort_comparator) &nai_block_cmp);
+
+  bool found = false;
+  int best = -1;
+  for (int i = 0; i < nblocks; i++)
+  {
+    if (blocks[i].lb > mindist)
+      break;
+    int first = blocks[i].i * SEGIDX_BLOCK_SIZE;
+    int last = Min(first + SEGIDX_BLOCK_SIZE, seq->count - 1);
+    /* A block whose lower bound equals the minimum can only contain segments
+     * at the same distance, which are kept only if they come earlier */
+    if (found && blocks[i].lb == mindist && first > best)
+      continue;
+    /* Segments start at instants [first, last - 1] while the instants of the
+     * block are [first, last] */
+    int end = linear ? last : last + 1;
+    for (int j = first; j < end; j++)
+    {
+      const TInstant *inst1 = TSEQUENCE_INST_N(seq, j);
+      double dist;
+      TimestampTz t1;
+      if (linear)
+        dist = nai_tpointsegm_linear_geo1(inst1, TSEQUENCE_INST_N(seq, j + 1),
+          geo, NULL, &t1);
+      else
+      {
+        LWGEOM *point = lwgeom_from_gserialized(
+          DatumGetGserializedP(tinstant_val(inst1)));
+        dist = lw_distance_fraction(point, geo, NULL, DIST_MIN, NULL);
+        lwgeom_free(point);
+        t1 = inst1->t;
+      }
+      if (dist < mindist || (found && dist == mindist && j < best))
+      {
+        mindist = dist;
+        best = j;
+        found = true;
+        *pos = j;
+        *t = t1;
+      }
+    }
+  }
+  pfree(blocks);
+  return mindist;
+}
+
+/**
+ * @brief Return true if the nearest approach functions for a temporal
+ * sequence point and a geometry use the branch-and-bound search
+ */
+static inline bool
+tpointseq_geo_bnb(const TSequence *seq)
+{
+  return seq->temptype == T_TGEOMPOINT && seq->count > SEGIDX_BLOCK_SIZE;
+}
+
+/**
+ * @brief Return true if the nearest approach distance and the shortest line
+ * between a temporal point and a geometry use the branch-and-bound search
+ */
+static bool
+tpoint_geo_bnb(const Temporal *temp)
+{
+  return temp->temptype == T_TGEOMPOINT && temp->subtype != TINSTANT &&
+    temporal_num_instants(temp) > SEGIDX_BLOCK_SIZE;
+}
+
+/**
+ * @brief Return the minimum distance between a planar temporal point and a
+ * geometry using a branch-and-bound search on the blocks of segments of its
+ * sequences
+ * @param[in] temp Temporal point
+ * @param[in] geo Geometry
+ * @param[out] seq Sequence containing the segment at the minimum distance
+ * @param[out] pos Position of the segment, or of the instant for sequences
+ * without linear interpolation, at the minimum distance
+ * @pre The temporal point is a sequence or a sequence set
+ */
+static double
+tpoint_geo_min_dist_bnb(const Temporal *temp, const LWGEOM *geo,
+  const TSequence **seq, int *pos)
+{
+  assert(temp->subtype == TSEQUENCE || temp->subtype == TSEQUENCESET);
+  if (temp->subtype == TSEQUENCE)
+  {
+    TimestampTz t;
+    *seq = (const TSequence *) temp;
+    return tpointseq_geo_min_dist_bnb(*seq, geo, DBL_MAX, pos, &t);
+  }
+  const TSequenceSet *ss = (const TSequenceSet *) temp;
+  double result = DBL_MAX;
+  for (int i = 0; i < ss->count; i++)
+  {
+    TimestampTz t;
+    const TSequence *seq1 = TSEQUENCESET_SEQ_N(ss, i);
+    double dist = tpointseq_geo_min_dist_bnb(seq1, geo, result, pos, &t);
+    if (dist < result)
+    {
+      result = dist;
+      *seq = seq1;
+    }
+  }
+  return result;
+}
+
 /**
  * @brief Return the new current nearest approach instant between a temporal
  * sequence point with step interpolation and a geometry/geography
  * (iterator function)
  * @param[in] seq Temporal point
  * @param[in] geo Geometry/geography
+ * @param[in] tree Spherical tree of the geography, may be NULL
  * @param[in] mindist Current minimum distance, it is set at DBL_MAX at the
  * begining but contains the minimum distance found in the previous
  * sequences of a temporal sequence set
@@ -501,15 +1342,25 @@ distance_tpoint_tpoint(const Temporal *temp1, const Temporal *temp2)
  */
 static double
 nai_tpointseq_discstep_geo_iter(const TSequence *seq, const LWGEOM *geo,
-  double mindist, const TInstant **result)
+  const CIRC_NODE *tree, double mindist, const TInstant **result)
 {
+  if (tpointseq_geo_bnb(seq))
+  {
+    int pos = -1;
+    TimestampTz t;
+    mindist = tpointseq_geo_min_dist_bnb(seq, geo, mindist, &pos, &t);
+    if (pos >= 0)
+      *result = TSEQUENCE_INST_N(seq, pos);
+    return mindist;
+  }
+
   for (int i = 0; i < seq->count; i++)
   {
     const TInstant *inst = TSEQUENCE_INST_N(seq, i);
     Datum value = tinstant_val(inst);
     GSERIALIZED *gs = DatumGetGserializedP(value);
     LWGEOM *point = lwgeom_from_gserialized(gs);
-    double dist = lw_distance_fraction(point, geo, DIST_MIN, NULL);
+    double dist = lw_distance_fraction(point, geo, tree, DIST_MIN, NULL);
     if (dist < mindist)
     {
       mindist = dist;
@@ -525,12 +1376,14 @@ nai_tpointseq_discstep_geo_iter(const TSequence *seq, const LWGEOM *geo,
  * point with step interpolation and a geometry/geography
  * @param[in] seq Temporal point
  * @param[in] geo Geometry/geography
+ * @param[in] tree Spherical tree of the geography, may be NULL
  */
 static TInstant *
-nai_tpointseq_discstep_geo(const TSequence *seq, const LWGEOM *geo)
+nai_tpointseq_discstep_geo(const TSequence *seq, const LWGEOM *geo,
+  const CIRC_NODE *tree)
 {
   const TInstant *inst = NULL; /* make compiler quiet */
-  nai_tpointseq_discstep_geo_iter(seq, geo, DBL_MAX, &inst);
+  nai_tpointseq_discstep_geo_iter(seq, geo, tree, DBL_MAX, &inst);
   return tinstant_copy(inst);
 }
 
@@ -539,90 +1392,53 @@ nai_tpointseq_discstep_geo(const TSequence *seq, const LWGEOM *geo)
  * point with step interpolation and a geometry/geography
  * @param[in] ss Temporal point
  * @param[in] geo Geometry/geography
+ * @param[in] tree Spherical tree of the geography, may be NULL
  */
 static TInstant *
-nai_tpointseqset_step_geo(const TSequenceSet *ss, const LWGEOM *geo)
+nai_tpointseqset_step_geo(const TSequenceSet *ss, const LWGEOM *geo,
+  const CIRC_NODE *tree)
 {
   const TInstant *inst = NULL; /* make compiler quiet */
   double mindist = DBL_MAX;
   for (int i = 0; i < ss->count; i++)
     mindist = nai_tpointseq_discstep_geo_iter(TSEQUENCESET_SEQ_N(ss, i), geo,
-      mindist, &inst);
+      tree, mindist, &inst);
   assert(inst != NULL);
   return tinstant_copy(inst);
 }
 
 /*****************************************************************************/
 
-/**
- * @brief Return the distance and the timestamp of the nearest approach instant
- * between a temporal sequence point with linear interpolation and a
- * geometry/geography
- * @param[in] inst1,inst2 Temporal segment
- * @param[in] geo Geometry/geography
- * @param[out] t Timestamp
- * @result Distance
- */
-static double
-nai_tpointsegm_linear_geo1(const TInstant *inst1, const TInstant *inst2,
-  const LWGEOM *geo, TimestampTz *t)
-{
-  Datum value1 = tinstant_val(inst1);
-  Datum value2 = tinstant_val(inst2);
-  double dist;
-  double fraction;
-
-  /* Constant segment */
-  if (datum_point_eq(value1, value2))
-  {
-    GSERIALIZED *gs = DatumGetGserializedP(value1);
-    LWGEOM *point = lwgeom_from_gserialized(gs);
-    dist = lw_distance_fraction(point, geo, DIST_MIN, NULL);
-    lwgeom_free(point);
-    *t = inst1->t;
-    return dist;
-  }
-
-  /* The trajectory is a line */
-  LWGEOM *line = (LWGEOM *) lwline_make(value1, value2);
-  dist = lw_distance_fraction(line, geo, DIST_MIN, &fraction);
-  lwgeom_free(line);
-
-  if (fabsl(fraction) < MEOS_EPSILON)
-    *t = inst1->t;
-  else if (fabsl(fraction - 1.0) < MEOS_EPSILON)
-    *t = inst2->t;
-  else
-  {
-    double duration = (double) (inst2->t - inst1->t);
-    *t = inst1->t + (TimestampTz) (duration * fraction);
-  }
-  return dist;
-}
-
 /**
  * @brief Return the distance and the timestamp of the nearest approach instant
  * between a temporal sequence point with linear interpolation and a
  * geometry/geography (iterator function)
  * @param[in] seq Temporal point
  * @param[in] geo Geometry/geography
+ * @param[in] tree Spherical tree of the geography, may be NULL
  * @param[in] mindist Minimum distance found so far, or DBL_MAX at the beginning
  * @param[out] t Timestamp
  */
 static double
 nai_tpointseq_linear_geo_iter(const TSequence *seq, const LWGEOM *geo,
-  double mindist, TimestampTz *t)
+  const CIRC_NODE *tree, double mindist, TimestampTz *t)
 {
   double dist;
   const TInstant *inst1 = TSEQUENCE_INST_N(seq, 0);
 
+  if (tpointseq_geo_bnb(seq))
+  {
+    int pos;
+    return tpointseq_geo_min_dist_bnb(seq, geo, mindist, &pos, t);
+  }
+
   if (seq->count == 1)
   {
     /* Instantaneous sequence */
     Datum value1 = tinstant_val(inst1);
     GSERIALIZED *gs = DatumGetGserializedP(value1);
     LWGEOM *point = lwgeom_from_gserialized(gs);
-    dist = lw_distance_fraction(point, geo, DIST_MIN, NULL);
+    dist = lw_distance_fraction(point, geo, tree, DIST_MIN, NULL);
     if (dist < mindist)
     {
       mindist = dist;
@@ -637,7 +1453,7 @@ nai_tpointseq_linear_geo_iter(const TSequence *seq, const LWGEOM *geo,
     for (int i = 0; i < seq->count - 1; i++)
     {
       const TInstant *inst2 = TSEQUENCE_INST_N(seq, i + 1);
-      dist = nai_tpointsegm_linear_geo1(inst1, inst2, geo, &t1);
+      dist = nai_tpointsegm_linear_geo1(inst1, inst2, geo, tree, &t1);
       if (dist < mindist)
       {
         mindist = dist;
@@ -656,10 +1472,11 @@ nai_tpointseq_linear_geo_iter(const TSequence *seq, const LWGEOM *geo,
  * point with linear interpolation and a geometry (iterator function)
  */
 static TInstant *
-nai_tpointseq_linear_geo(const TSequence *seq, const LWGEOM *geo)
+nai_tpointseq_linear_geo(const TSequence *seq, const LWGEOM *geo,
+  const CIRC_NODE *tree)
 {
   TimestampTz t;
-  nai_tpointseq_linear_geo_iter(seq, geo, DBL_MAX, &t);
+  nai_tpointseq_linear_geo_iter(seq, geo, tree, DBL_MAX, &t);
   /* The closest point may be at an exclusive bound */
   Datum value;
   tsequence_value_at_timestamptz(seq, t, false, &value);
@@ -671,7 +1488,8 @@ nai_tpointseq_linear_geo(const TSequence *seq, const LWGEOM *geo)
  * point with linear interpolation and a geometry
  */
 static TInstant *
-nai_tpointseqset_linear_geo(const TSequenceSet *ss, const LWGEOM *geo)
+nai_tpointseqset_linear_geo(const TSequenceSet *ss, const LWGEOM *geo,
+  const CIRC_NODE *tree)
 {
   TimestampTz t = 0; /* make compiler quiet */
   double mindist = DBL_MAX;
@@ -679,7 +1497,7 @@ nai_tpointseqset_linear_geo(const TSequenceSet *ss, const LWGEOM *geo)
   {
     TimestampTz t1;
     double dist = nai_tpointseq_linear_geo_iter(TSEQUENCESET_SEQ_N(ss, i), geo,
-      mindist, &t1);
+      tree, mindist, &t1);
     if (dist < mindist)
     {
       mindist = dist;
@@ -696,6 +1514,32 @@ nai_tpointseqset_linear_geo(const TSequenceSet *ss, const LWGEOM *geo)
 
 /*****************************************************************************/
 
+/**
+ * @brief Return the nearest approach instant between a temporal point and
+ * a geometry/geography
+ * @param[in] temp Temporal point
+ * @param[in] geo Geometry/geography
+ * @param[in] tree Spherical tree of the geography, may be NULL
+ */
+static TInstant *
+nai_tpoint_geo1(const Temporal *temp, const LWGEOM *geo, const CIRC_NODE *tree)
+{
+  assert(temptype_subtype(temp->subtype));
+  switch (temp->subtype)
+  {
+    case TINSTANT:
+      return tinstant_copy((TInstant *) temp);
+    case TSEQUENCE:
+      return MEOS_FLAGS_LINEAR_INTERP(temp->flags) ?
+        nai_tpointseq_linear_geo((TSequence *) temp, geo, tree) :
+        nai_tpointseq_discstep_geo((TSequence *) temp, geo, tree);
+    default: /* TSEQUENCESET */
+      return MEOS_FLAGS_LINEAR_INTERP(temp->flags) ?
+        nai_tpointseqset_linear_geo((TSequenceSet *) temp, geo, tree) :
+        nai_tpointseqset_step_geo((TSequenceSet *) temp, geo, tree);
+  }
+}
+
 /**
  * @ingroup meos_temporal_dist
  * @brief Return the nearest approach instant between a temporal point and
@@ -713,27 +1557,123 @@ nai_tpoint_geo(const Temporal *temp, const GSERIALIZED *gs)
     return NULL;
 
   LWGEOM *geo = lwgeom_from_gserialized(gs);
-  TInstant *result;
-  assert(temptype_subtype(temp->subtype));
-  switch (temp->subtype)
+  /* Compute the spherical tree of a geography only once */
+  CIRC_NODE *tree = (temp->subtype != TINSTANT &&
+    MEOS_FLAGS_GET_GEODETIC(temp->flags)) ?
+    lwgeom_calculate_circ_tree(geo) : NULL;
+  TInstant *result = nai_tpoint_geo1(temp, geo, tree);
+  if (tree)
+    circ_tree_free(tree);
+  lwgeom_free(geo);
+  return result;
+}
+
+/**
+ * @ingroup meos_temporal_dist
+ * @brief Return the nearest approach instant between a temporal point and
+ * a prepared geometry
+ * @details For geographies, the spherical tree kept in the prepared
+ * geography is reused
+ * @param[in] temp Temporal point
+ * @param[in] pgeo Prepared geometry
+ * @see #geo_prepare
+ */
+TInstant *
+nai_tpoint_prepgeo(const Temporal *temp, const PreparedGeo *pgeo)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) pgeo))
+    return NULL;
+  if (! pgeo->circtree)
+    return nai_tpoint_geo(temp, pgeo->gs);
+  if (! ensure_valid_tpoint_geo(temp, pgeo->gs) ||
+      ! ensure_same_dimensionality_tpoint_gs(temp, pgeo->gs))
+    return NULL;
+  return nai_tpoint_geo1(temp, pgeo->lwgeom, pgeo->circtree);
+}
+
+/**
+ * @brief Return the squared nearest approach distance between two
+ * synchronized planar temporal point sequences and the timestamp at which it
+ * is reached
+ * @details The kernels select the first instant or segment at the minimum
+ * distance and the turning point is only computed for this segment
+ * @pre The sequences are both linear or both step
+ */
+static double
+nai_tpointseq_tpointseq_coords(const TSequence *seq1, const TSequence *seq2,
+  TimestampTz *t)
+{
+  TPointCoords *coords1 = tpointseq_coords(seq1);
+  TPointCoords *coords2 = tpointseq_coords(seq2);
+  double result;
+  if (! MEOS_FLAGS_LINEAR_INTERP(seq1->flags) || seq1->count < 2)
   {
-    case TINSTANT:
-      result = tinstant_copy((TInstant *) temp);
-      break;
-    case TSEQUENCE:
-      result = MEOS_FLAGS_LINEAR_INTERP(temp->flags) ?
-        nai_tpointseq_linear_geo((TSequence *) temp, geo) :
-        nai_tpointseq_discstep_geo((TSequence *) temp, geo);
-      break;
-    default: /* TSEQUENCESET */
-      result = MEOS_FLAGS_LINEAR_INTERP(temp->flags) ?
-        nai_tpointseqset_linear_geo((TSequenceSet *) temp, geo) :
-        nai_tpointseqset_step_geo((TSequenceSet *) temp, geo);
+    tpointcoords_dist2_inst(coords1, coords2);
+    int i = tpointcoords_buf_argmin(coords1->buf, seq1->count);
+    result = coords1->buf[i];
+    *t = coords1->t[i];
   }
-  lwgeom_free(geo);
+  else
+  {
+    tpointcoords_dist2_diffseg(coords1, coords2);
+    int i = tpointcoords_buf_argmin(coords1->buf, seq1->count - 1);
+    result = coords1->buf[i];
+    double r = coords2->buf[i];
+    Datum value;
+    if (r <= 0.0 || r >= 1.0 || ! tgeompoint_min_dist_at_timestamptz(
+          TSEQUENCE_INST_N(seq1, i), TSEQUENCE_INST_N(seq1, i + 1),
+          TSEQUENCE_INST_N(seq2, i), TSEQUENCE_INST_N(seq2, i + 1),
+          &value, t))
+      /* The minimum is at a bound of the segment */
+      *t = (r <= 0.5) ? coords1->t[i] : coords1->t[i + 1];
+  }
+  tpointcoords_free(coords1); tpointcoords_free(coords2);
   return result;
 }
 
+/**
+ * @brief Return the nearest approach instant between two planar temporal
+ * points using the distance kernels on coordinate arrays
+ * @pre The temporal points are continuous and have both linear or both step
+ * interpolation
+ */
+static TInstant *
+nai_tpoint_tpoint_coords(const Temporal *temp1, const Temporal *temp2)
+{
+  Temporal *sync1, *sync2;
+  if (! intersection_temporal_temporal(temp1, temp2, SYNCHRONIZE_NOCROSS,
+      &sync1, &sync2))
+    return NULL;
+
+  TimestampTz t;
+  if (sync1->subtype == TSEQUENCE)
+    nai_tpointseq_tpointseq_coords((TSequence *) sync1, (TSequence *) sync2,
+      &t);
+  else
+  {
+    const TSequenceSet *ss1 = (TSequenceSet *) sync1;
+    const TSequenceSet *ss2 = (TSequenceSet *) sync2;
+    double mindist = DBL_MAX;
+    for (int i = 0; i < ss1->count; i++)
+    {
+      TimestampTz t1;
+      double dist = nai_tpointseq_tpointseq_coords(TSEQUENCESET_SEQ_N(ss1, i),
+        TSEQUENCESET_SEQ_N(ss2, i), &t1);
+      if (dist < mindist)
+      {
+        mindist = dist;
+        t = t1;
+      }
+    }
+  }
+  pfree(sync1); pfree(sync2);
+  /* The closest point may be at an exclusive bound => 3rd argument = false */
+  Datum value;
+  temporal_value_at_timestamptz(temp1, t, false, &value);
+  return tinstant_make_free(value, temp1->temptype, t);
+}
+
 /**
  * @ingroup meos_temporal_dist
  * @brief Return the nearest approach instant between two temporal points
@@ -748,6 +1688,9 @@ nai_tpoint_tpoint(const Temporal *temp1, const Temporal *temp2)
       ! ensure_same_dimensionality(temp1->flags, temp2->flags))
     return NULL;
 
+  if (tpoint_tpoint_coords(temp1, temp2))
+    return nai_tpoint_tpoint_coords(temp1, temp2);
+
   /* Compute the temporal distance, it may be NULL if the points do not
    * intersect on time */
   Temporal *dist = distance_tpoint_tpoint(temp1, temp2);
@@ -782,6 +1725,16 @@ nad_tpoint_geo(const Temporal *temp, const GSERIALIZED *gs)
       ! ensure_same_dimensionality_tpoint_gs(temp, gs))
     return -1.0;
 
+  if (tpoint_geo_bnb(temp))
+  {
+    LWGEOM *geo = lwgeom_from_gserialized(gs);
+    const TSequence *seq;
+    int pos;
+    double result = tpoint_geo_min_dist_bnb(temp, geo, &seq, &pos);
+    lwgeom_free(geo);
+    return result;
+  }
+
   datum_func2 func = distance_fn(temp->flags);
   Datum traj = PointerGetDatum(tpoint_trajectory(temp));
   double result = DatumGetFloat8(func(traj, PointerGetDatum(gs)));
@@ -789,6 +1742,44 @@ nad_tpoint_geo(const Temporal *temp, const GSERIALIZED *gs)
   return result;
 }
 
+/**
+ * @ingroup meos_temporal_dist
+ * @brief Return the nearest approach distance between a temporal point and
+ * a prepared geometry
+ * @details For geographies, the distance is computed between the spherical
+ * tree of the trajectory and the one kept in the prepared geography, on the
+ * sphere or on the spheroid as stated when preparing it
+ * @param[in] temp Temporal point
+ * @param[in] pgeo Prepared geometry
+ * @see #geog_prepare
+ */
+double
+nad_tpoint_prepgeo(const Temporal *temp, const PreparedGeo *pgeo)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) pgeo))
+    return -1.0;
+  if (! pgeo->circtree)
+    return nad_tpoint_geo(temp, pgeo->gs);
+  if (! ensure_valid_tpoint_geo(temp, pgeo->gs) ||
+      ! ensure_same_dimensionality_tpoint_gs(temp, pgeo->gs))
+    return -1.0;
+
+  SPHEROID s;
+  spheroid_init(&s, WGS84_MAJOR_AXIS, WGS84_MINOR_AXIS);
+  if (! pgeo->use_spheroid)
+    s.a = s.b = s.radius;
+  GSERIALIZED *traj = tpoint_trajectory(temp);
+  LWGEOM *geo = lwgeom_from_gserialized(traj);
+  CIRC_NODE *tree = lwgeom_calculate_circ_tree(geo);
+  double result = circ_tree_distance_tree(tree, pgeo->circtree, &s,
+    FP_TOLERANCE);
+  circ_tree_free(tree);
+  lwgeom_free(geo);
+  pfree(traj);
+  return result;
+}
+
 /**
  * @ingroup meos_temporal_dist
  * @brief Return the nearest approach distance between a spatiotemporal box
@@ -893,6 +1884,46 @@ nad_tpoint_stbox(const Temporal *temp, const STBox *box)
   return result;
 }
 
+/**
+ * @brief Return the nearest approach distance between two planar temporal
+ * points using the distance kernels on coordinate arrays
+ * @pre The temporal points have both linear or both non-linear interpolation
+ */
+static double
+nad_tpoint_tpoint_coords(const Temporal *temp1, const Temporal *temp2)
+{
+  Temporal *sync1, *sync2;
+  if (! intersection_temporal_temporal(temp1, temp2, SYNCHRONIZE_NOCROSS,
+      &sync1, &sync2))
+    return -1.0;
+
+  double result = DBL_MAX;
+  if (sync1->subtype == TINSTANT)
+    result = tpointinst_distance((TInstant *) sync1, (TInstant *) sync2,
+      pt_distance_fn(sync1->flags));
+  else
+  {
+    int count = (sync1->subtype == TSEQUENCE) ? 1 :
+      ((TSequenceSet *) sync1)->count;
+    bool linear = MEOS_FLAGS_LINEAR_INTERP(sync1->flags);
+    for (int i = 0; i < count; i++)
+    {
+      const TSequence *seq1 = (sync1->subtype == TSEQUENCE) ?
+        (TSequence *) sync1 : TSEQUENCESET_SEQ_N((TSequenceSet *) sync1, i);
+      const TSequence *seq2 = (sync2->subtype == TSEQUENCE) ?
+        (TSequence *) sync2 : TSEQUENCESET_SEQ_N((TSequenceSet *) sync2, i);
+      TPointCoords *coords1 = tpointseq_coords(seq1);
+      TPointCoords *coords2 = tpointseq_coords(seq2);
+      double dist = tpointcoords_nad(coords1, coords2, linear);
+      if (dist < result)
+        result = dist;
+      tpointcoords_free(coords1); tpointcoords_free(coords2);
+    }
+  }
+  pfree(sync1); pfree(sync2);
+  return result;
+}
+
 /**
  * @ingroup meos_temporal_dist
  * @brief Return the nearest approach distance between two temporal points
@@ -907,6 +1938,12 @@ nad_tpoint_tpoint(const Temporal *temp1, const Temporal *temp2)
       ! ensure_same_dimensionality(temp1->flags, temp2->flags))
     return -1.0;
 
+  /* Use the distance kernels for planar points with the same interpolation */
+  if (! MEOS_FLAGS_GET_GEODETIC(temp1->flags) &&
+      MEOS_FLAGS_LINEAR_INTERP(temp1->flags) ==
+        MEOS_FLAGS_LINEAR_INTERP(temp2->flags))
+    return nad_tpoint_tpoint_coords(temp1, temp2);
+
   Temporal *dist = distance_tpoint_tpoint(temp1, temp2);
   if (dist == NULL)
     return -1.0;
@@ -974,8 +2011,35 @@ shortestline_tpoint_geo(const Temporal *temp, const GSERIALIZED *gs)
   if (geodetic && ! ensure_has_not_Z_gs(gs))
     return NULL;
 
-  GSERIALIZED *traj = tpoint_trajectory(temp);
   GSERIALIZED *result;
+  if (tpoint_geo_bnb(temp))
+  {
+    /* Compute the shortest line from the segment at the minimum distance */
+    LWGEOM *geo = lwgeom_from_gserialized(gs);
+    const TSequence *seq;
+    int pos;
+    tpoint_geo_min_dist_bnb(temp, geo, &seq, &pos);
+    lwgeom_free(geo);
+    Datum value1 = tinstant_val(TSEQUENCE_INST_N(seq, pos));
+    GSERIALIZED *segm;
+    bool linear = MEOS_FLAGS_LINEAR_INTERP(seq->flags) && seq->count > 1;
+    if (linear)
+    {
+      LWGEOM *line = (LWGEOM *) lwline_make(value1,
+        tinstant_val(TSEQUENCE_INST_N(seq, pos + 1)));
+      segm = geo_serialize(line);
+      lwgeom_free(line);
+    }
+    else
+      segm = DatumGetGserializedP(value1);
+    result = MEOS_FLAGS_GET_Z(temp->flags) ?
+      geometry_shortestline3d(segm, gs) : geo_shortestline2d(segm, gs);
+    if (linear)
+      pfree(segm);
+    return result;
+  }
+
+  GSERIALIZED *traj = tpoint_trajectory(temp);
   if (geodetic)
     /* Notice that geography_shortestline_internal is a MobilityDB function */
     result = geography_shortestline_internal(traj, gs, true);
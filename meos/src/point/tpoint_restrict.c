@@ -34,6 +34,7 @@
 
 /* C */
 #include <assert.h>
+#include <limits.h>
 /* PostgreSQL */
 #include <postgres.h>
 #include <utils/float.h>
@@ -50,6 +51,9 @@
 #include "general/temporal_restrict.h"
 #include "general/tsequence.h"
 #include "general/type_util.h"
+#include "point/pgis_types.h"
+#include "point/tpoint_boxops.h"
+#include "point/tpoint_restrfuncs.h"
 #include "point/tpoint_spatialfuncs.h"
 #include "point/tpoint_spatialrels.h"
 
@@ -665,6 +669,9 @@ tpointseq_linear_at_stbox_xyz(const TSequence *seq, const STBox *box,
   TSequence **sequences = palloc(sizeof(TSequence *) * seq->count);
   TInstant **instants = palloc(sizeof(TInstant *) * seq->count);
   TInstant **tofree = palloc(sizeof(TInstant *) * seq->count * 2);
+  /* Blocks of segments that may intersect the box, if the sequence has a
+   * segment index */
+  bool *blocks = tpointseq_segidx_search(seq, box);
   const TInstant *inst1 = TSEQUENCE_INST_N(seq, 0);
   GSERIALIZED *p1 = DatumGetGserializedP(tinstant_val(inst1));
   bool lower_inc = seq->period.lower_inc;
@@ -678,7 +685,17 @@ tpointseq_linear_at_stbox_xyz(const TSequence *seq, const STBox *box,
     GSERIALIZED *p3, *p4;
     TInstant *inst1_2d, *inst2_2d;
     bool makeseq = false;
-    if (geopoint_eq(p1, p2))
+    if (blocks && (i - 1) % SEGIDX_BLOCK_SIZE == 0 &&
+        ! blocks[(i - 1) / SEGIDX_BLOCK_SIZE])
+    {
+      /* None of the segments of the block intersects the box, end the
+       * current sequence, if any, and skip to the last instant of the block.
+       * The loop increment moves to the first segment of the next block */
+      i = Min(i - 1 + SEGIDX_BLOCK_SIZE, seq->count - 1);
+      inst2 = TSEQUENCE_INST_N(seq, i);
+      makeseq = true;
+    }
+    else if (geopoint_eq(p1, p2))
     {
       /* Constant segment */
       if (tpointinst_restrict_stbox_iter(inst1, box, border_inc, REST_AT))
@@ -846,6 +863,8 @@ tpointseq_linear_at_stbox_xyz(const TSequence *seq, const STBox *box,
       lower_inc, upper_inc, LINEAR, NORMALIZE_NO);
   pfree_array((void **) tofree, nfree);
   pfree(instants);
+  if (blocks)
+    pfree(blocks);
   if (nseqs == 0)
   {
     pfree(sequences);
@@ -1139,6 +1158,9 @@ tpointseq_at_stbox_segm(const TSequence *seq, const STBox *box,
   bool hast = MEOS_FLAGS_GET_T(box->flags);
   TSequence **sequences = palloc(sizeof(TSequence *) * (seq->count - 1));
   const TInstant **instants = palloc(sizeof(TInstant *) * seq->count);
+  /* Blocks of segments that may intersect the box, if the sequence has a
+   * segment index */
+  bool *blocks = tpointseq_segidx_search(seq, box);
   const TInstant *inst1 = TSEQUENCE_INST_N(seq, 0);
   GSERIALIZED *p1 = DatumGetGserializedP(tinstant_val(inst1));
   bool lower_inc = seq->period.lower_inc;
@@ -1151,7 +1173,16 @@ tpointseq_at_stbox_segm(const TSequence *seq, const STBox *box,
     GSERIALIZED *p2 = DatumGetGserializedP(tinstant_val(inst2));
     /* Keep the segment if intersects the bounding box */
     bool inter = false;
-    if (geopoint_eq(p1, p2))
+    if (blocks && (i - 1) % SEGIDX_BLOCK_SIZE == 0 &&
+        ! blocks[(i - 1) / SEGIDX_BLOCK_SIZE])
+    {
+      /* None of the segments of the block intersects the box, skip to the
+       * last instant of the block */
+      i = Min(i - 1 + SEGIDX_BLOCK_SIZE, seq->count - 1);
+      inst2 = TSEQUENCE_INST_N(seq, i);
+      p2 = DatumGetGserializedP(tinstant_val(inst2));
+    }
+    else if (geopoint_eq(p1, p2))
     {
       /* Constant segment */
       if (tpointinst_restrict_stbox_iter(inst1, box, border_inc, REST_AT))
@@ -1198,6 +1229,8 @@ tpointseq_at_stbox_segm(const TSequence *seq, const STBox *box,
     sequences[nseqs++] = tsequence_make(instants, ninsts, lower_inc_seq,
       upper_inc, LINEAR, NORMALIZE_NO);
   pfree(instants);
+  if (blocks)
+    pfree(blocks);
   return tsequenceset_make_free(sequences, nseqs, NORMALIZE);
 }
 
@@ -1657,11 +1690,687 @@ tpointseq_interperiods(const TSequence *seq, GSERIALIZED *gsinter, int *count)
   return result;
 }
 
+/*****************************************************************************
+ * Intersection of a temporal point and a geometry with many vertices
+ *
+ * Computing with GEOS the intersection of the trajectory of a temporal point
+ * and a geometry that is not handled by the edge index below, such as a
+ * multilinestring with many vertices, has a cost that depends on the size of
+ * the whole geometry. Instead, the bounding box of the geometry is split into
+ * a regular grid of tiles and the geometry is clipped once to all the tiles
+ * by recursively halving the grid, so that each vertex is only visited a
+ * logarithmic number of times. The tiles are kept in the prepared geometry
+ * and are thus shared by all the sequences of a temporal point and, when the
+ * geometry is cached, by all the temporal points. A trajectory is then
+ * intersected with the clipped geometries of the tiles overlapping the
+ * bounding box of one of its segments and the resulting periods are merged.
+ * Since the tiles are closed, the pieces of the intersection located on the
+ * border of two tiles are found in both tiles, which is taken care of when
+ * normalizing the periods.
+ *****************************************************************************/
+
+/**
+ * @brief Clip a geometry to the tiles in a range of columns and rows of the
+ * grid
+ * @param[in,out] tiles Tiles
+ * @param[in] gs Geometry clipped to the box of the range of tiles, which is
+ * freed by the function if it is not the original geometry
+ * @param[in] owned True if the geometry was computed by the function
+ * @param[in] i1,i2 First and last column
+ * @param[in] j1,j2 First and last row
+ * @param[in] srid SRID of the geometry
+ */
+static void
+geotiles_clip(GeoTiles *tiles, GSERIALIZED *gs, bool owned, int i1, int i2,
+  int j1, int j2, int32_t srid)
+{
+  if (i1 == i2 && j1 == j2)
+  {
+    if (owned)
+      tiles->geoms[j1 * tiles->nx + i1] = gs;
+    else
+    {
+      GSERIALIZED *copy = palloc(VARSIZE(gs));
+      memcpy(copy, gs, VARSIZE(gs));
+      tiles->geoms[j1 * tiles->nx + i1] = copy;
+    }
+    return;
+  }
+  /* Split the range in two halves along its longest dimension */
+  int ranges[2][4] = {{i1, i2, j1, j2}, {i1, i2, j1, j2}};
+  if (i2 - i1 >= j2 - j1)
+  {
+    ranges[0][1] = (i1 + i2) / 2;
+    ranges[1][0] = ranges[0][1] + 1;
+  }
+  else
+  {
+    ranges[0][3] = (j1 + j2) / 2;
+    ranges[1][2] = ranges[0][3] + 1;
+  }
+  for (int k = 0; k < 2; k++)
+  {
+    const int *r = ranges[k];
+    LWPOLY *poly = lwpoly_construct_envelope(srid,
+      tiles->xmin + r[0] * tiles->size, tiles->ymin + r[2] * tiles->size,
+      tiles->xmin + (r[1] + 1) * tiles->size,
+      tiles->ymin + (r[3] + 1) * tiles->size);
+    GSERIALIZED *box = geo_serialize((LWGEOM *) poly);
+    lwpoly_free(poly);
+    GSERIALIZED *inter = geometry_intersection(gs, box);
+    pfree(box);
+    if (gserialized_is_empty(inter))
+      pfree(inter);
+    else
+      geotiles_clip(tiles, inter, true, r[0], r[1], r[2], r[3], srid);
+  }
+  if (owned)
+    pfree(gs);
+  return;
+}
+
+/**
+ * @brief Return the tiles of a planar geometry, or NULL if the geometry has
+ * less than #GEOTILES_MIN_POINTS vertices
+ * @pre The geometry is not empty
+ */
+GeoTiles *
+geotiles_make(const GSERIALIZED *gs)
+{
+  if (FLAGS_GET_GEODETIC(gs->gflags))
+    return NULL;
+  LWGEOM *geom = lwgeom_from_gserialized(gs);
+  uint32_t npoints = lwgeom_count_vertices(geom);
+  lwgeom_free(geom);
+  if (npoints < GEOTILES_MIN_POINTS)
+    return NULL;
+
+  /* Compute the size of the tiles from the target number of vertices per
+   * tile, ensuring that long and thin geometries do not generate too many
+   * tiles */
+  STBox box;
+  geo_set_stbox(gs, &box);
+  int ntiles = Min((int) (npoints / GEOTILES_TILE_POINTS), GEOTILES_MAX_TILES);
+  double width = box.xmax - box.xmin, height = box.ymax - box.ymin;
+  double size = Max(width, height) / ntiles;
+  if (width > 0.0 && height > 0.0)
+    size = Max(size, sqrt(width * height / ntiles));
+  /* All the vertices are located at the same point */
+  if (size <= 0.0)
+    return NULL;
+  int nx = Max((int) ceil(width / size), 1);
+  int ny = Max((int) ceil(height / size), 1);
+  if (nx * ny < 2)
+    return NULL;
+
+  GeoTiles *result = palloc(sizeof(GeoTiles));
+  result->count = nx * ny;
+  result->nx = nx;
+  result->ny = ny;
+  result->xmin = box.xmin;
+  result->ymin = box.ymin;
+  result->size = size;
+  result->geoms = palloc0(sizeof(GSERIALIZED *) * result->count);
+  geotiles_clip(result, (GSERIALIZED *) gs, false, 0, nx - 1, 0, ny - 1,
+    box.srid);
+  return result;
+}
+
+/**
+ * @brief Free the tiles of a geometry
+ */
+void
+geotiles_free(GeoTiles *tiles)
+{
+  for (int i = 0; i < tiles->count; i++)
+  {
+    if (tiles->geoms[i])
+      pfree(tiles->geoms[i]);
+  }
+  pfree(tiles->geoms);
+  pfree(tiles);
+  return;
+}
+
+/**
+ * @brief Return the tiles of a prepared geometry, which are computed the
+ * first time they are needed, or NULL if the geometry is handled without
+ * tiles, that is, if it is polygonal or has few vertices
+ */
+GeoTiles *
+prepgeo_tiles(PreparedGeo *pgeo)
+{
+  if (! pgeo->hastiles)
+  {
+    pgeo->tiles = (gserialized_is_empty(pgeo->gs) || geo_polygonal(pgeo->gs)) ?
+      NULL : geotiles_make(pgeo->gs);
+    pgeo->hastiles = true;
+  }
+  return pgeo->tiles;
+}
+
+/**
+ * @brief Return the range of columns or rows of the tiles overlapping an
+ * interval of values in one dimension, or false if there is none
+ * @param[in] min,max Interval of values
+ * @param[in] origin,size,n Origin, size, and number of the tiles
+ * @param[out] first,last Range of columns or rows
+ */
+static bool
+geotiles_range(double min, double max, double origin, double size, int n,
+  int *first, int *last)
+{
+  if (max < origin || min > origin + n * size)
+    return false;
+  /* The tiles are closed, a value on a border belongs to both tiles */
+  *first = Max((int) ceil((min - origin) / size) - 1, 0);
+  *last = Min((int) floor((max - origin) / size), n - 1);
+  return true;
+}
+
+/**
+ * @brief Get the periods at which a temporal sequence point with linear
+ * interpolation intersects a geometry
+ * @param[in] seq Temporal point
+ * @param[in] gs Geometry
+ * @param[in] tiles Tiles of the geometry, may be NULL
+ * @param[out] count Number of elements in the resulting array
+ * @result Ordered array of disjoint periods, or NULL if the temporal point
+ * does not intersect the geometry
+ * @pre The temporal sequence is simple, that is, non self-intersecting, and
+ * both the temporal point and the geometry are in 2D
+ */
+Span *
+tpointseq_geom_interperiods(const TSequence *seq, const GSERIALIZED *gs,
+  GeoTiles *tiles, int *count)
+{
+  GSERIALIZED *traj = tpointseq_trajectory(seq);
+  GSERIALIZED *gsinter;
+  Span *result = NULL;
+  *count = 0;
+  if (! tiles)
+  {
+    gsinter = geometry_intersection(traj, gs);
+    if (! gserialized_is_empty(gsinter))
+      result = tpointseq_interperiods(seq, gsinter, count);
+    pfree(gsinter); pfree(traj);
+    return result;
+  }
+
+  /* Select the tiles overlapping the bounding box of a segment, rather than
+   * the bounding box of the whole sequence */
+  bool *selected = palloc0(sizeof(bool) * tiles->count);
+  const POINT2D *p1 = DATUM_POINT2D_P(tinstant_val(TSEQUENCE_INST_N(seq, 0)));
+  /* An instantaneous sequence is taken as a segment with two equal points */
+  for (int i = Min(1, seq->count - 1); i < seq->count; i++)
+  {
+    const POINT2D *p2 =
+      DATUM_POINT2D_P(tinstant_val(TSEQUENCE_INST_N(seq, i)));
+    int i1, i2, j1, j2;
+    if (geotiles_range(Min(p1->x, p2->x), Max(p1->x, p2->x), tiles->xmin,
+          tiles->size, tiles->nx, &i1, &i2) &&
+        geotiles_range(Min(p1->y, p2->y), Max(p1->y, p2->y), tiles->ymin,
+          tiles->size, tiles->ny, &j1, &j2))
+    {
+      for (int j = j1; j <= j2; j++)
+        for (int k = i1; k <= i2; k++)
+          selected[j * tiles->nx + k] = true;
+    }
+    p1 = p2;
+  }
+
+  /* Intersect the trajectory with the selected tiles */
+  int maxpers = 16, npers = 0;
+  Span *periods = palloc(sizeof(Span) * maxpers);
+  for (int i = 0; i < tiles->count; i++)
+  {
+    if (! selected[i] || ! tiles->geoms[i])
+      continue;
+    gsinter = geometry_intersection(traj, tiles->geoms[i]);
+    if (! gserialized_is_empty(gsinter))
+    {
+      int npers1;
+      Span *periods1 = tpointseq_interperiods(seq, gsinter, &npers1);
+      if (npers1 > 0)
+      {
+        if (npers + npers1 > maxpers)
+        {
+          maxpers = Max(2 * maxpers, npers + npers1);
+          periods = repalloc(periods, sizeof(Span) * maxpers);
+        }
+        memcpy(&periods[npers], periods1, sizeof(Span) * npers1);
+        npers += npers1;
+        pfree(periods1);
+      }
+    }
+    pfree(gsinter);
+  }
+  pfree(traj); pfree(selected);
+  if (npers > 0)
+    result = spanarr_normalize(periods, npers, ORDER, count);
+  pfree(periods);
+  return result;
+}
+
+/*****************************************************************************
+ * Restriction of a temporal point to a polygonal geometry
+ *
+ * The restriction of a temporal point with linear interpolation to a polygon
+ * or a multipolygon is computed without constructing the trajectory and
+ * calling GEOS. The edges of the rings of the geometry are distributed into
+ * horizontal strips covering its bounding box. Each segment of the temporal
+ * point is split at its crossings with the edges of the strips it spans and
+ * each resulting piece is classified as inside or outside the geometry with a
+ * point-in-polygon test on the edges of a single strip. The geometry is
+ * considered as closed, that is, its boundary belongs to it. The geometry is
+ * assumed to be valid, as for GEOS.
+ *****************************************************************************/
+
+/**
+ * @brief Return true if the restriction of a temporal point to a geometry is
+ * computed with the edge index of the geometry, that is, if the geometry is
+ * a planar polygon or multipolygon
+ */
+bool
+geo_polygonal(const GSERIALIZED *gs)
+{
+  int type = gserialized_get_type(gs);
+  return (type == POLYGONTYPE || type == MULTIPOLYGONTYPE) &&
+    ! FLAGS_GET_GEODETIC(gs->gflags) && ! gserialized_is_empty(gs);
+}
+
+/**
+ * @brief Return the strip of an edge index containing a Y value
+ */
+static int
+polyindex_strip(const PolyIndex *idx, double y)
+{
+  int result = (int) ((y - idx->ymin) / idx->height);
+  return Max(0, Min(result, idx->nstrips - 1));
+}
+
+/**
+ * @brief Return the edge index of a polygonal geometry
+ * @pre The geometry is a non-empty polygon or multipolygon
+ */
+PolyIndex *
+polyindex_make(const GSERIALIZED *gs)
+{
+  LWGEOM *geom = lwgeom_from_gserialized(gs);
+  LWPOLY **polys;
+  int npolys;
+  if (geom->type == POLYGONTYPE)
+  {
+    polys = (LWPOLY **) &geom;
+    npolys = 1;
+  }
+  else /* geom->type == MULTIPOLYGONTYPE */
+  {
+    LWMPOLY *mpoly = lwgeom_as_lwmpoly(geom);
+    polys = mpoly->geoms;
+    npolys = (int) mpoly->ngeoms;
+  }
+
+  /* Collect the edges of all the rings */
+  int nedges = 0;
+  for (int i = 0; i < npolys; i++)
+    for (uint32_t j = 0; j < polys[i]->nrings; j++)
+      nedges += Max((int) polys[i]->rings[j]->npoints - 1, 0);
+  PolyIndex *result = palloc0(sizeof(PolyIndex));
+  result->points = palloc(sizeof(POINT2D) * 2 * Max(nedges, 1));
+  result->xmin = result->ymin = DBL_MAX;
+  result->xmax = result->ymax = -DBL_MAX;
+  int k = 0;
+  for (int i = 0; i < npolys; i++)
+  {
+    for (uint32_t j = 0; j < polys[i]->nrings; j++)
+    {
+      const POINTARRAY *pa = polys[i]->rings[j];
+      for (uint32_t l = 0; l + 1 < pa->npoints; l++)
+      {
+        result->points[2 * k] = *getPoint2d_cp(pa, l);
+        result->points[2 * k + 1] = *getPoint2d_cp(pa, l + 1);
+        const POINT2D *p = &result->points[2 * k];
+        result->xmin = Min(result->xmin, p->x);
+        result->xmax = Max(result->xmax, p->x);
+        result->ymin = Min(result->ymin, p->y);
+        result->ymax = Max(result->ymax, p->y);
+        k++;
+      }
+    }
+  }
+  result->nedges = nedges;
+  lwgeom_free(geom);
+
+  /* Distribute the edges into the strips */
+  result->nstrips = (result->ymax > result->ymin) ?
+    Max(1, Min(nedges / 4, POLYINDEX_MAX_STRIPS)) : 1;
+  result->height = (result->ymax > result->ymin) ?
+    (result->ymax - result->ymin) / result->nstrips : 1.0;
+  result->offsets = palloc0(sizeof(int) * (result->nstrips + 1));
+  for (int i = 0; i < nedges; i++)
+  {
+    const POINT2D *a = &result->points[2 * i];
+    const POINT2D *b = a + 1;
+    int first = polyindex_strip(result, Min(a->y, b->y));
+    int last = polyindex_strip(result, Max(a->y, b->y));
+    for (int j = first; j <= last; j++)
+      result->offsets[j + 1]++;
+  }
+  for (int i = 0; i < result->nstrips; i++)
+    result->offsets[i + 1] += result->offsets[i];
+  result->ids = palloc(sizeof(int) * Max(result->offsets[result->nstrips], 1));
+  int *pos = palloc(sizeof(int) * result->nstrips);
+  memcpy(pos, result->offsets, sizeof(int) * result->nstrips);
+  for (int i = 0; i < nedges; i++)
+  {
+    const POINT2D *a = &result->points[2 * i];
+    const POINT2D *b = a + 1;
+    int first = polyindex_strip(result, Min(a->y, b->y));
+    int last = polyindex_strip(result, Max(a->y, b->y));
+    for (int j = first; j <= last; j++)
+      result->ids[pos[j]++] = i;
+  }
+  pfree(pos);
+  /* Segment numbers start at 1 */
+  result->marks = palloc0(sizeof(int) * Max(nedges, 1));
+  return result;
+}
+
+/**
+ * @brief Free the edge index of a polygonal geometry
+ */
+void
+polyindex_free(PolyIndex *idx)
+{
+  pfree(idx->points); pfree(idx->offsets); pfree(idx->ids);
+  pfree(idx->marks); pfree(idx);
+  return;
+}
+
+/**
+ * @brief Return the edge index of a prepared geometry, which is computed the
+ * first time it is needed, or NULL if the geometry does not satisfy
+ * #geo_polygonal
+ */
+PolyIndex *
+prepgeo_polyindex(PreparedGeo *pgeo)
+{
+  if (! pgeo->polyidx && geo_polygonal(pgeo->gs))
+    pgeo->polyidx = polyindex_make(pgeo->gs);
+  return pgeo->polyidx;
+}
+
+/**
+ * @brief Return true if a point is on an edge, taking into account roundoff
+ * errors
+ */
+static bool
+point_on_edge(const POINT2D *a, const POINT2D *b, double x, double y)
+{
+  if (x < Min(a->x, b->x) - MEOS_EPSILON || x > Max(a->x, b->x) + MEOS_EPSILON ||
+      y < Min(a->y, b->y) - MEOS_EPSILON || y > Max(a->y, b->y) + MEOS_EPSILON)
+    return false;
+  double len = hypot(b->x - a->x, b->y - a->y);
+  if (len == 0.0)
+    return true;
+  double cross = (b->x - a->x) * (y - a->y) - (b->y - a->y) * (x - a->x);
+  return fabs(cross) / len <= MEOS_EPSILON;
+}
+
+/**
+ * @brief Return -1, 0, or 1 depending on whether a point is outside, on the
+ * boundary, or in the interior of a polygonal geometry
+ * @details The function applies the even-odd rule on the edges of the strip
+ * containing the point, which are the only ones that can cross the
+ * horizontal ray starting at the point.
+ */
+int
+polyindex_locate(const PolyIndex *idx, double x, double y)
+{
+  if (x < idx->xmin - MEOS_EPSILON || x > idx->xmax + MEOS_EPSILON ||
+      y < idx->ymin - MEOS_EPSILON || y > idx->ymax + MEOS_EPSILON)
+    return -1;
+  bool inside = false;
+  int strip = polyindex_strip(idx, y);
+  for (int i = idx->offsets[strip]; i < idx->offsets[strip + 1]; i++)
+  {
+    const POINT2D *a = &idx->points[2 * idx->ids[i]];
+    const POINT2D *b = a + 1;
+    if (point_on_edge(a, b, x, y))
+      return 0;
+    if ((a->y > y) != (b->y > y) &&
+        x < a->x + (y - a->y) * (b->x - a->x) / (b->y - a->y))
+      inside = ! inside;
+  }
+  return inside ? 1 : -1;
+}
+
+/**
+ * @brief Return true if a point is in the interior or on the boundary of a
+ * polygonal geometry
+ */
+static bool
+polyindex_contains(const PolyIndex *idx, double x, double y)
+{
+  return polyindex_locate(idx, x, y) >= 0;
+}
+
+/**
+ * @brief Comparator function for doubles
+ */
+static int
+double_sort_cmp(const double *l, const double *r)
+{
+  return (*l < *r) ? -1 : ((*l > *r) ? 1 : 0);
+}
+
+/**
+ * @brief Return in the last argument the fractions of a segment at which it
+ * crosses or touches an edge of a polygonal geometry, including the two
+ * bounds of the segment, sorted and without duplicates
+ * @param[in] idx Edge index
+ * @param[in] p1,p2 Start and end points of the segment
+ * @param[in,out] fracs Array of fractions, may be reallocated
+ * @param[in,out] maxfracs Size of the array of fractions
+ * @result Number of fractions
+ */
+int
+polyindex_segm_fractions(PolyIndex *idx, const POINT2D *p1,
+  const POINT2D *p2, double **fracs, int *maxfracs)
+{
+  /* Number the segment for visiting each edge once, the marks are cleared
+   * when the numbers are exhausted */
+  if (idx->segno == INT_MAX)
+  {
+    memset(idx->marks, 0, sizeof(int) * Max(idx->nedges, 1));
+    idx->segno = 0;
+  }
+  int segno = ++idx->segno;
+  double *result = *fracs;
+  int nfracs = 0;
+  result[nfracs++] = 0.0;
+  double dx = p2->x - p1->x, dy = p2->y - p1->y;
+  double len2 = dx * dx + dy * dy;
+  double sxmin = Min(p1->x, p2->x), sxmax = Max(p1->x, p2->x);
+  double symin = Min(p1->y, p2->y), symax = Max(p1->y, p2->y);
+  if (sxmax >= idx->xmin && sxmin <= idx->xmax &&
+      symax >= idx->ymin && symin <= idx->ymax)
+  {
+    int first = polyindex_strip(idx, symin);
+    int last = polyindex_strip(idx, symax);
+    for (int i = idx->offsets[first]; i < idx->offsets[last + 1]; i++)
+    {
+      int edge = idx->ids[i];
+      /* An edge spanning several strips is only considered once */
+      if (idx->marks[edge] == segno)
+        continue;
+      idx->marks[edge] = segno;
+      const POINT2D *a = &idx->points[2 * edge];
+      const POINT2D *b = a + 1;
+      if (Max(a->x, b->x) < sxmin || Min(a->x, b->x) > sxmax ||
+          Max(a->y, b->y) < symin || Min(a->y, b->y) > symax)
+        continue;
+      /* Make room for two additional fractions */
+      if (nfracs + 2 >= *maxfracs)
+      {
+        *maxfracs *= 2;
+        result = *fracs = repalloc(result, sizeof(double) * *maxfracs);
+      }
+      double ex = b->x - a->x, ey = b->y - a->y;
+      double qx = a->x - p1->x, qy = a->y - p1->y;
+      double denom = dx * ey - dy * ex;
+      if (denom != 0.0)
+      {
+        /* The segment and the edge are not parallel */
+        double s = (qx * ey - qy * ex) / denom;
+        double u = (qx * dy - qy * dx) / denom;
+        if (s >= -MEOS_EPSILON && s <= 1.0 + MEOS_EPSILON &&
+            u >= -MEOS_EPSILON && u <= 1.0 + MEOS_EPSILON)
+          result[nfracs++] = Max(0.0, Min(s, 1.0));
+      }
+      else if (point_on_edge(p1, p2, a->x, a->y) ||
+        point_on_edge(p1, p2, b->x, b->y))
+      {
+        /* The segment and the edge are collinear and overlap, keep the
+         * edge end points located on the segment */
+        double s1 = (qx * dx + qy * dy) / len2;
+        double s2 = ((b->x - p1->x) * dx + (b->y - p1->y) * dy) / len2;
+        if (s1 > 0.0 && s1 < 1.0)
+          result[nfracs++] = s1;
+        if (s2 > 0.0 && s2 < 1.0)
+          result[nfracs++] = s2;
+      }
+    }
+  }
+  if (nfracs + 1 >= *maxfracs)
+  {
+    *maxfracs *= 2;
+    result = *fracs = repalloc(result, sizeof(double) * *maxfracs);
+  }
+  result[nfracs++] = 1.0;
+  /* Sort the fractions and remove duplicates */
+  qsort(result, (size_t) nfracs, sizeof(double),
+    (qsort_comparator) &double_sort_cmp);
+  int count = 1;
+  for (int i = 1; i < nfracs; i++)
+  {
+    if (result[i] != result[count - 1])
+      result[count++] = result[i];
+  }
+  return count;
+}
+
+/**
+ * @brief Return the periods at which a temporal point sequence with linear
+ * interpolation intersects a polygonal geometry
+ * @param[in] seq Temporal point
+ * @param[in] idx Edge index of the geometry
+ * @param[out] count Number of elements in the resulting array
+ * @result Ordered array of disjoint periods, or NULL if the temporal point
+ * does not intersect the geometry
+ * @pre The sequence has at least two instants. The Z dimension of the
+ * temporal point, if any, is not taken into account.
+ */
+Span *
+tpointseq_polygon_periods(const TSequence *seq, PolyIndex *idx, int *count)
+{
+  assert(seq->count > 1); assert(MEOS_FLAGS_LINEAR_INTERP(seq->flags));
+  TimestampTz start = DatumGetTimestampTz(seq->period.lower);
+  TimestampTz end = DatumGetTimestampTz(seq->period.upper);
+  int maxfracs = 64, maxpers = 64, npers = 0;
+  double *fracs = palloc(sizeof(double) * maxfracs);
+  Span *periods = palloc(sizeof(Span) * maxpers);
+  const TInstant *inst1 = TSEQUENCE_INST_N(seq, 0);
+  POINT2D p1 = *DATUM_POINT2D_P(tinstant_val(inst1));
+  for (int i = 1; i < seq->count; i++)
+  {
+    const TInstant *inst2 = TSEQUENCE_INST_N(seq, i);
+    POINT2D p2 = *DATUM_POINT2D_P(tinstant_val(inst2));
+    double duration = (double) (inst2->t - inst1->t);
+    int nfracs = 1;
+    bool constant = (p1.x == p2.x && p1.y == p2.y);
+    if (! constant)
+      nfracs = polyindex_segm_fractions(idx, &p1, &p2, &fracs, &maxfracs);
+    /* Make room for the periods of the segment */
+    if (npers + 2 * nfracs >= maxpers)
+    {
+      maxpers = Max(2 * maxpers, npers + 2 * nfracs + 1);
+      periods = repalloc(periods, sizeof(Span) * maxpers);
+    }
+    if (constant)
+    {
+      if (polyindex_contains(idx, p1.x, p1.y))
+        span_set(TimestampTzGetDatum(inst1->t), TimestampTzGetDatum(inst2->t),
+          true, true, T_TIMESTAMPTZ, T_TSTZSPAN, &periods[npers++]);
+    }
+    else
+    {
+      bool prev_inside = false;
+      for (int j = 0; j < nfracs; j++)
+      {
+        TimestampTz t1 = inst1->t + (TimestampTz) (duration * fracs[j]);
+        /* Classify the piece of the segment from the current fraction to the
+         * next one by its middle point */
+        bool inside = false;
+        if (j < nfracs - 1)
+        {
+          double mid = (fracs[j] + fracs[j + 1]) / 2.0;
+          inside = polyindex_contains(idx, p1.x + (p2.x - p1.x) * mid,
+            p1.y + (p2.y - p1.y) * mid);
+        }
+        if (inside)
+        {
+          TimestampTz t2 = inst1->t + (TimestampTz) (duration * fracs[j + 1]);
+          span_set(TimestampTzGetDatum(t1), TimestampTzGetDatum(t2), true,
+            true, T_TIMESTAMPTZ, T_TSTZSPAN, &periods[npers++]);
+        }
+        /* The point at the fraction touches the geometry */
+        else if (! prev_inside && polyindex_contains(idx,
+            p1.x + (p2.x - p1.x) * fracs[j], p1.y + (p2.y - p1.y) * fracs[j]))
+          span_set(TimestampTzGetDatum(t1), TimestampTzGetDatum(t1), true,
+            true, T_TIMESTAMPTZ, T_TSTZSPAN, &periods[npers++]);
+        prev_inside = inside;
+      }
+    }
+    inst1 = inst2;
+    p1 = p2;
+  }
+  pfree(fracs);
+
+  /* Take into account the bounds of the sequence */
+  int k = 0;
+  for (int i = 0; i < npers; i++)
+  {
+    Span *s = &periods[i];
+    if (DatumGetTimestampTz(s->lower) == start)
+      s->lower_inc = seq->period.lower_inc;
+    if (DatumGetTimestampTz(s->upper) == end)
+      s->upper_inc = seq->period.upper_inc;
+    /* Remove the instantaneous periods at an exclusive bound */
+    if (s->lower == s->upper && (! s->lower_inc || ! s->upper_inc))
+      continue;
+    periods[k++] = *s;
+  }
+  if (k == 0)
+  {
+    pfree(periods);
+    *count = 0;
+    return NULL;
+  }
+  Span *result = spanarr_normalize(periods, k, ORDER_NO, count);
+  pfree(periods);
+  return result;
+}
+
 /**
  * @brief Return a temporal sequence point with linear interpolation
  * restricted to a geometry
- * @details The computation is based on the PostGIS function @p ST_Intersection
- * which delegates the computation to GEOS. The geometry must be in 2D.
+ * @details For polygons and multipolygons the computation is done by
+ * #tpointseq_polygon_periods. Otherwise, the computation is based on the
+ * PostGIS function @p ST_Intersection which delegates the computation to
+ * GEOS, tile by tile for geometries with many vertices. The geometry must be
+ * in 2D.
  * When computing the intersection the Z values of the temporal point must
  * be dropped since the Z values "are copied, averaged or interpolated"
  * as stated in https://postgis.net/docs/ST_Intersection.html
@@ -1670,12 +2379,13 @@ tpointseq_interperiods(const TSequence *seq, GSERIALIZED *gsinter, int *count)
  * @note Instantaneous sequences must be managed since this function is called
  * after restricting to the time dimension
  * @pre The arguments have the same SRID, the geometry is 2D and is not empty.
- * This is verified in #tpoint_restrict_geom_time
+ * This is verified in #tpoint_restrict_prepgeo_time
  */
 static TSequenceSet *
-tpointseq_linear_at_geom(const TSequence *seq, const GSERIALIZED *gs)
+tpointseq_linear_at_geom(const TSequence *seq, PreparedGeo *pgeo)
 {
   assert(MEOS_FLAGS_LINEAR_INTERP(seq->flags));
+  const GSERIALIZED *gs = pgeo->gs;
   TSequenceSet *result;
 
   /* Instantaneous sequence */
@@ -1695,6 +2405,22 @@ tpointseq_linear_at_geom(const TSequence *seq, const GSERIALIZED *gs)
   if (! overlaps_stbox_stbox(&box1, &box2))
     return NULL;
 
+  /* Polygonal geometries are handled without computing the intersection of
+   * the trajectory and the geometry */
+  PolyIndex *idx = prepgeo_polyindex(pgeo);
+  if (idx)
+  {
+    int npers;
+    Span *periods = tpointseq_polygon_periods(seq, idx, &npers);
+    if (npers == 0)
+      return NULL;
+    SpanSet *ss = spanset_make_free(periods, npers, NORMALIZE_NO, ORDER_NO);
+    /* Recover the Z values from the original sequence */
+    result = tcontseq_restrict_tstzspanset(seq, ss, REST_AT);
+    pfree(ss);
+    return result;
+  }
+
   /* Convert the point to 2D before computing the restriction to geometry */
   bool hasz = MEOS_FLAGS_GET_Z(seq->flags);
   TSequence *seq2d = hasz ?
@@ -1707,20 +2433,14 @@ tpointseq_linear_at_geom(const TSequence *seq, const GSERIALIZED *gs)
   TSequence **simpleseqs = tpointseq_make_simple(seq2d, &nsimple);
   Span *allperiods = NULL; /* make compiler quiet */
   int totalpers = 0;
-  GSERIALIZED *traj, *gsinter;
-  Datum inter;
+  /* Geometries with many vertices are intersected tile by tile */
+  GeoTiles *tiles = prepgeo_tiles(pgeo);
 
   if (nsimple == 1)
   {
     /* Particular case when the input sequence is simple */
     pfree_array((void **) simpleseqs, nsimple);
-    traj = tpointseq_trajectory(seq2d);
-    inter = geom_intersection2d(PointerGetDatum(traj), PointerGetDatum(gs));
-    gsinter = DatumGetGserializedP(inter);
-    if (! gserialized_is_empty(gsinter))
-      allperiods = tpointseq_interperiods(seq2d, gsinter, &totalpers);
-    PG_FREE_IF_COPY_P(gsinter, DatumGetPointer(inter));
-    pfree(DatumGetPointer(inter)); pfree(traj);
+    allperiods = tpointseq_geom_interperiods(seq2d, gs, tiles, &totalpers);
     if (totalpers == 0)
     {
       if (hasz)
@@ -1738,17 +2458,9 @@ tpointseq_linear_at_geom(const TSequence *seq, const GSERIALIZED *gs)
     /* Loop for every simple fragment of the sequence */
     for (int i = 0; i < nsimple; i++)
     {
-      traj = tpointseq_trajectory(simpleseqs[i]);
-      inter = geom_intersection2d(PointerGetDatum(traj), PointerGetDatum(gs));
-      gsinter = DatumGetGserializedP(inter);
-      if (! gserialized_is_empty(gsinter))
-      {
-        periods[i] = tpointseq_interperiods(simpleseqs[i], gsinter,
-          &npers[i]);
-        totalpers += npers[i];
-      }
-      PG_FREE_IF_COPY_P(gsinter, DatumGetPointer(inter));
-      pfree(DatumGetPointer(inter)); pfree(traj);
+      periods[i] = tpointseq_geom_interperiods(simpleseqs[i], gs, tiles,
+        &npers[i]);
+      totalpers += npers[i];
     }
     pfree_array((void **) simpleseqs, nsimple);
     if (totalpers == 0)
@@ -1790,7 +2502,7 @@ tpointseq_linear_at_geom(const TSequence *seq, const GSERIALIZED *gs)
  * filter wrt the Z dimension after that since while doing this, the subtype of
  * the temporal point may change from a sequence to a sequence set.
  * @param[in] seq Temporal point
- * @param[in] gs Geometry
+ * @param[in] pgeo Prepared geometry
  * @param[in] zspan Span of values to restrict the Z dimension
  * @param[in] period Period to restrict the T dimension
  * @param[in] atfunc True if the restriction is at, false for minus
@@ -1799,11 +2511,11 @@ tpointseq_linear_at_geom(const TSequence *seq, const GSERIALIZED *gs)
  * restriction with respect to the time dimension.
  * @pre Instantaneous sequences have been managed in the calling function
  */
-TSequenceSet *
-tpointseq_linear_restrict_geom_time(const TSequence *seq,
-  const GSERIALIZED *gs, const Span *zspan, const Span *period, bool atfunc)
+static TSequenceSet *
+tpointseq_linear_restrict_prepgeo_time(const TSequence *seq,
+  PreparedGeo *pgeo, const Span *zspan, const Span *period, bool atfunc)
 {
-  assert(seq); ensure_not_null((void *) gs);
+  assert(seq); assert(pgeo);
   assert(tgeo_type(seq->temptype));
   assert(MEOS_FLAGS_LINEAR_INTERP(seq->flags));
   assert(seq->count > 1);
@@ -1816,7 +2528,7 @@ tpointseq_linear_restrict_geom_time(const TSequence *seq,
   TSequenceSet *at_xyt = NULL;
   if (at_t)
   {
-    at_xyt = tpointseq_linear_at_geom(at_t, gs);
+    at_xyt = tpointseq_linear_at_geom(at_t, pgeo);
     if (period)
       pfree(at_t);
   }
@@ -1869,20 +2581,20 @@ tpointseq_linear_restrict_geom_time(const TSequence *seq,
 }
 
 /**
- * @ingroup meos_internal_temporal_restrict
  * @brief Return a temporal point sequence restricted to (the complement of) a
- * geometry and possibly a Z span and a timestamptz span
+ * prepared geometry and possibly a Z span and a timestamptz span
  * @param[in] seq Temporal point
- * @param[in] gs Geometry
+ * @param[in] pgeo Prepared geometry
  * @param[in] zspan Span of values to restrict the Z dimension
  * @param[in] period Period to restrict the T dimension
  * @param[in] atfunc True if the restriction is at, false for minus
  */
-Temporal *
-tpointseq_restrict_geom_time(const TSequence *seq, const GSERIALIZED *gs,
+static Temporal *
+tpointseq_restrict_prepgeo_time(const TSequence *seq, PreparedGeo *pgeo,
   const Span *zspan, const Span *period, bool atfunc)
 {
-  assert(seq); assert(gs); assert(tgeo_type(seq->temptype));
+  assert(seq); assert(pgeo); assert(tgeo_type(seq->temptype));
+  const GSERIALIZED *gs = pgeo->gs;
   interpType interp = MEOS_FLAGS_GET_INTERP(seq->flags);
 
   /* Instantaneous sequence */
@@ -1903,25 +2615,47 @@ tpointseq_restrict_geom_time(const TSequence *seq, const GSERIALIZED *gs,
     return (Temporal *) tpointseq_step_restrict_geom_time((TSequence *) seq,
       gs, zspan, period, atfunc);
   else /* interp == LINEAR */
-    return (Temporal *) tpointseq_linear_restrict_geom_time((TSequence *) seq,
-      gs, zspan, period, atfunc);
+    return (Temporal *) tpointseq_linear_restrict_prepgeo_time(
+      (TSequence *) seq, pgeo, zspan, period, atfunc);
 }
 
 /**
  * @ingroup meos_internal_temporal_restrict
+ * @brief Return a temporal point sequence restricted to (the complement of) a
+ * geometry and possibly a Z span and a timestamptz span
+ * @param[in] seq Temporal point
+ * @param[in] gs Geometry
+ * @param[in] zspan Span of values to restrict the Z dimension
+ * @param[in] period Period to restrict the T dimension
+ * @param[in] atfunc True if the restriction is at, false for minus
+ */
+Temporal *
+tpointseq_restrict_geom_time(const TSequence *seq, const GSERIALIZED *gs,
+  const Span *zspan, const Span *period, bool atfunc)
+{
+  assert(seq); assert(gs);
+  PreparedGeo pgeo;
+  prepared_geo_init(&pgeo, gs);
+  Temporal *result = tpointseq_restrict_prepgeo_time(seq, &pgeo, zspan,
+    period, atfunc);
+  prepared_geo_reset(&pgeo);
+  return result;
+}
+
+/**
  * @brief Return a temporal point sequence set restricted to (the complement
- * of) a geometry and possibly a Z span and a timestamptz span
+ * of) a prepared geometry and possibly a Z span and a timestamptz span
  * @param[in] ss Temporal point
- * @param[in] gs Geometry
+ * @param[in] pgeo Prepared geometry
  * @param[in] zspan Span of values to restrict the Z dimension
  * @param[in] period Period to restrict the T dimension
  * @param[in] atfunc True if the restriction is at, false for minus
  */
-TSequenceSet *
-tpointseqset_restrict_geom_time(const TSequenceSet *ss, const GSERIALIZED *gs,
+static TSequenceSet *
+tpointseqset_restrict_prepgeo_time(const TSequenceSet *ss, PreparedGeo *pgeo,
   const Span *zspan, const Span *period, bool atfunc)
 {
-  assert(ss); assert(gs); assert(tgeo_type(ss->temptype));
+  assert(ss); assert(pgeo); assert(tgeo_type(ss->temptype));
   const TSequence *seq;
   TSequenceSet *result = NULL;
 
@@ -1930,14 +2664,14 @@ tpointseqset_restrict_geom_time(const TSequenceSet *ss, const GSERIALIZED *gs,
   {
     seq = TSEQUENCESET_SEQ_N(ss, 0);
     /* We can safely cast since the composing sequences are continuous */
-    return (TSequenceSet *) tpointseq_restrict_geom_time(seq, gs, zspan,
+    return (TSequenceSet *) tpointseq_restrict_prepgeo_time(seq, pgeo, zspan,
       period, atfunc);
   }
 
   /* General case */
   STBox box2;
   /* Non-empty geometries have a bounding box */
-  geo_set_stbox(gs, &box2);
+  geo_set_stbox(pgeo->gs, &box2);
 
   /* Initialize to 0 due to the bounding box test below */
   TSequenceSet **seqsets = palloc0(sizeof(TSequenceSet *) * ss->count);
@@ -1953,8 +2687,8 @@ tpointseqset_restrict_geom_time(const TSequenceSet *ss, const GSERIALIZED *gs,
     else
     {
       /* We can safely cast since the composing sequences are continuous */
-      seqsets[i] = (TSequenceSet *) tpointseq_restrict_geom_time(seq, gs,
-        zspan, period, atfunc);
+      seqsets[i] = (TSequenceSet *) tpointseq_restrict_prepgeo_time(seq,
+        pgeo, zspan, period, atfunc);
       if (seqsets[i])
         totalseqs += seqsets[i]->count;
     }
@@ -1968,19 +2702,47 @@ tpointseqset_restrict_geom_time(const TSequenceSet *ss, const GSERIALIZED *gs,
 
 /**
  * @ingroup meos_internal_temporal_restrict
- * @brief Return a temporal point restricted to (the complement of) a geometry
- * and possibly a Z span and a timestamptz span
- * @param[in] temp Temporal point
+ * @brief Return a temporal point sequence set restricted to (the complement
+ * of) a geometry and possibly a Z span and a timestamptz span
+ * @param[in] ss Temporal point
  * @param[in] gs Geometry
  * @param[in] zspan Span of values to restrict the Z dimension
  * @param[in] period Period to restrict the T dimension
  * @param[in] atfunc True if the restriction is at, false for minus
  */
+TSequenceSet *
+tpointseqset_restrict_geom_time(const TSequenceSet *ss, const GSERIALIZED *gs,
+  const Span *zspan, const Span *period, bool atfunc)
+{
+  assert(ss); assert(gs);
+  PreparedGeo pgeo;
+  prepared_geo_init(&pgeo, gs);
+  TSequenceSet *result = tpointseqset_restrict_prepgeo_time(ss, &pgeo, zspan,
+    period, atfunc);
+  prepared_geo_reset(&pgeo);
+  return result;
+}
+
+/**
+ * @ingroup meos_internal_temporal_restrict
+ * @brief Return a temporal point restricted to (the complement of) a
+ * prepared geometry and possibly a Z span and a timestamptz span
+ * @details The structures of the prepared geometry computed on demand, such
+ * as the edge index of a polygonal geometry, are shared by all the sequences
+ * of the temporal point and by the successive calls with the same prepared
+ * geometry.
+ * @param[in] temp Temporal point
+ * @param[in] pgeo Prepared geometry
+ * @param[in] zspan Span of values to restrict the Z dimension
+ * @param[in] period Period to restrict the T dimension
+ * @param[in] atfunc True if the restriction is at, false for minus
+ */
 Temporal *
-tpoint_restrict_geom_time(const Temporal *temp, const GSERIALIZED *gs,
+tpoint_restrict_prepgeo_time(const Temporal *temp, PreparedGeo *pgeo,
   const Span *zspan, const Span *period, bool atfunc)
 {
-  assert(temp); assert(gs); assert(tgeo_type(temp->temptype));
+  assert(temp); assert(pgeo); assert(tgeo_type(temp->temptype));
+  const GSERIALIZED *gs = pgeo->gs;
   if (gserialized_is_empty(gs))
     return atfunc ? NULL : temporal_cp(temp);
   /* Ensure validity of the arguments */
@@ -2031,18 +2793,41 @@ tpoint_restrict_geom_time(const Temporal *temp, const GSERIALIZED *gs,
         gs, zspan, period, atfunc);
       break;
     case TSEQUENCE:
-      result = tpointseq_restrict_geom_time((TSequence *) temp1,
-        gs, zspan, period, atfunc);
+      result = tpointseq_restrict_prepgeo_time((TSequence *) temp1,
+        pgeo, zspan, period, atfunc);
       break;
     default: /* TSEQUENCESET */
-      result = (Temporal *) tpointseqset_restrict_geom_time((TSequenceSet *)
-          temp1, gs, zspan, period, atfunc);
+      result = (Temporal *) tpointseqset_restrict_prepgeo_time((TSequenceSet *)
+          temp1, pgeo, zspan, period, atfunc);
   }
   if (interp == LINEAR && atfunc)
     pfree(temp1);
   return result;
 }
 
+/**
+ * @ingroup meos_internal_temporal_restrict
+ * @brief Return a temporal point restricted to (the complement of) a geometry
+ * and possibly a Z span and a timestamptz span
+ * @param[in] temp Temporal point
+ * @param[in] gs Geometry
+ * @param[in] zspan Span of values to restrict the Z dimension
+ * @param[in] period Period to restrict the T dimension
+ * @param[in] atfunc True if the restriction is at, false for minus
+ */
+Temporal *
+tpoint_restrict_geom_time(const Temporal *temp, const GSERIALIZED *gs,
+  const Span *zspan, const Span *period, bool atfunc)
+{
+  assert(temp); assert(gs);
+  PreparedGeo pgeo;
+  prepared_geo_init(&pgeo, gs);
+  Temporal *result = tpoint_restrict_prepgeo_time(temp, &pgeo, zspan, period,
+    atfunc);
+  prepared_geo_reset(&pgeo);
+  return result;
+}
+
 #if MEOS
 /**
  * @ingroup meos_temporal_restrict
@@ -57,6 +57,7 @@
 #include "point/stbox.h"
 #include "point/tpoint.h"
 #include "point/tpoint_distance.h"
+#include "point/tpoint_restrfuncs.h"
 #if NPOINT
   #include "npoint/tnpoint_spatialfuncs.h"
 #endif
@@ -3679,6 +3680,704 @@ tpoint_AsMVTGeom(const Temporal *temp, const STBox *bounds, int32_t extent,
   return true;
 }
 
+/**
+ * @ingroup meos_temporal_spatial_transf
+ * @brief Return a temporal point transformed to Mapbox Vector Tile format
+ * using a level-of-detail pyramid of the temporal point
+ * @param[in] levels Levels of the pyramid
+ * @param[in] nlevels Number of levels of the pyramid
+ * @param[in] dist Distance of the first level of the pyramid
+ * @param[in] bounds Bounds
+ * @param[in] extent Extent
+ * @param[in] buffer Buffer
+ * @param[in] clip_geom True when the geometry is clipped
+ * @param[out] gsarr Array of geometries
+ * @param[out] timesarr Array of timestamps
+ * @param[out] count Number of elements in the output array
+ * @details The coarsest level whose distance does not exceed the resolution
+ * of the tile is transformed, which avoids simplifying the full temporal
+ * point for every tile
+ * @see #temporal_simplify_dp_pyramid
+ * @csqlfn #Tpointarr_AsMVTGeom()
+ */
+bool
+tpointarr_AsMVTGeom(const Temporal **levels, int nlevels, double dist,
+  const STBox *bounds, int32_t extent, int32_t buffer, bool clip_geom,
+  GSERIALIZED **gsarr, int64 **timesarr, int *count)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) levels) || ! ensure_not_null((void *) bounds))
+    return false;
+  if (nlevels < 1)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "The number of levels must be at least 1: %d", nlevels);
+    return false;
+  }
+
+  /* Use the resolution of the simplification in #tpoint_mvt, the bounds and
+   * the extent are verified by #tpoint_AsMVTGeom */
+  int level = 0;
+  if (extent > 0)
+  {
+    double resx = (bounds->xmax - bounds->xmin) / extent;
+    double resy = (bounds->ymax - bounds->ymin) / extent;
+    level = temporal_pyramid_level(dist, nlevels, Min(resx, resy) / 2);
+  }
+  return tpoint_AsMVTGeom(levels[level], bounds, extent, buffer, clip_geom,
+    gsarr, timesarr, count);
+}
+
+/*****************************************************************************
+ * Mapbox Vector Tile geometry encoding for arrays of temporal points
+ *
+ * The following functions transform an array of temporal points to a tile
+ * and encode the result directly as the command stream of the geometry of an
+ * MVT feature. The stages of #tpoint_mvt, i.e., the removal of the repeated
+ * points, the simplification, the transformation into tile coordinate space,
+ * the snapping to integer precision, and the clipping, are fused into a
+ * single pass over the coordinates of every sequence, which are read into
+ * scratch arrays shared by all the temporal points. No intermediate temporal
+ * value or geometry is built. The command stream and the timestamps of all
+ * the temporal points are written into shared buffers. The timestamps are
+ * aligned with the vertices of the command stream, i.e., the n-th timestamp
+ * of a temporal point is the one of its n-th vertex.
+ *****************************************************************************/
+
+/* MVT geometry commands and geometry types */
+#define MVT_CMD_MOVETO  1
+#define MVT_CMD_LINETO  2
+#define MVT_POINT       1
+#define MVT_LINESTRING  2
+
+/**
+ * @brief Structure storing the buffers for encoding temporal points into MVT
+ * geometries
+ */
+typedef struct
+{
+  uint32_t *geoms;        /**< Command stream of the geometries */
+  int ngeoms;             /**< Number of elements of the command stream */
+  int maxgeoms;           /**< Maximum number of elements of the stream */
+  int64 *times;           /**< Timestamps of the vertices in Unix epoch */
+  int ntimes;             /**< Number of timestamps */
+  int maxtimes;           /**< Maximum number of timestamps */
+  int32_t cx;             /**< Current x coordinate of the cursor */
+  int32_t cy;             /**< Current y coordinate of the cursor */
+  int lcmd;               /**< Position of the LineTo command of the line */
+  int lnverts;            /**< Number of vertices of the line */
+  int lngeoms;            /**< Size of the command stream before the line */
+  int lntimes;            /**< Number of timestamps before the line */
+  int32_t lcx;            /**< Cursor before the line */
+  int32_t lcy;            /**< Cursor before the line */
+  double *x;              /**< Scratch array of X coordinates */
+  double *y;              /**< Scratch array of Y coordinates */
+  double *dist;           /**< Scratch array of distances */
+  TimestampTz *t;         /**< Scratch array of timestamps */
+  int *stack;             /**< Scratch stack of the simplification */
+  bool *keep;             /**< Scratch array of the points kept */
+  int maxinsts;           /**< Maximum number of points of the scratch */
+  double fx;              /**< X scale of the transformation to the tile */
+  double fy;              /**< Y scale of the transformation to the tile */
+  double xoff;            /**< X offset of the transformation to the tile */
+  double yoff;            /**< Y offset of the transformation to the tile */
+  double res;             /**< Resolution of the tile in the input units */
+  double cmin;            /**< Minimum coordinate of the clipping box */
+  double cmax;            /**< Maximum coordinate of the clipping box */
+  bool clip;              /**< True when the geometries are clipped */
+} MVTBuffer;
+
+/**
+ * @brief Return a command integer of an MVT geometry
+ */
+static inline uint32_t
+mvt_command(uint32_t id, int count)
+{
+  return (id & 0x7) | ((uint32_t) count << 3);
+}
+
+/**
+ * @brief Return a parameter integer of an MVT geometry zigzag-encoded
+ */
+static inline uint32_t
+mvt_zigzag(int32_t value)
+{
+  return ((uint32_t) value << 1) ^ (uint32_t) (value >> 31);
+}
+
+/**
+ * @brief Ensure that the buffers for encoding MVT geometries have space for
+ * additional elements
+ */
+static void
+mvtbuffer_reserve(MVTBuffer *buf, int ngeoms, int ntimes)
+{
+  if (buf->ngeoms + ngeoms > buf->maxgeoms)
+  {
+    while (buf->ngeoms + ngeoms > buf->maxgeoms)
+      buf->maxgeoms *= 2;
+    buf->geoms = repalloc(buf->geoms, sizeof(uint32_t) * buf->maxgeoms);
+  }
+  if (buf->ntimes + ntimes > buf->maxtimes)
+  {
+    while (buf->ntimes + ntimes > buf->maxtimes)
+      buf->maxtimes *= 2;
+    buf->times = repalloc(buf->times, sizeof(int64) * buf->maxtimes);
+  }
+  return;
+}
+
+/**
+ * @brief Ensure that the scratch arrays of the buffers have space for the
+ * points of a sequence
+ * @note The arrays are allocated in a single chunk whose content is not kept
+ */
+static void
+mvtbuffer_scratch(MVTBuffer *buf, int count)
+{
+  if (count <= buf->maxinsts)
+    return;
+  int n = buf->maxinsts = Max(count, 2 * buf->maxinsts);
+  if (buf->x)
+    pfree(buf->x);
+  buf->x = palloc((sizeof(double) * 3 + sizeof(TimestampTz) + sizeof(int) +
+    sizeof(bool)) * n);
+  buf->y = buf->x + n;
+  buf->dist = buf->y + n;
+  buf->t = (TimestampTz *) (buf->dist + n);
+  buf->stack = (int *) (buf->t + n);
+  buf->keep = (bool *) (buf->stack + n);
+  return;
+}
+
+/**
+ * @brief Append a vertex to the buffers
+ * @param[in,out] buf Buffers
+ * @param[in] x,y Coordinates of the vertex in tile coordinate space
+ * @param[in] t Timestamp of the vertex
+ */
+static inline void
+mvtbuffer_vertex(MVTBuffer *buf, int32_t x, int32_t y, TimestampTz t)
+{
+  buf->geoms[buf->ngeoms++] = mvt_zigzag(x - buf->cx);
+  buf->geoms[buf->ngeoms++] = mvt_zigzag(y - buf->cy);
+  buf->times[buf->ntimes++] = (t / 1000000) + DELTA_UNIX_POSTGRES_EPOCH;
+  buf->cx = x; buf->cy = y;
+  return;
+}
+
+/**
+ * @brief Start a line in the buffers
+ */
+static void
+mvtbuffer_line_start(MVTBuffer *buf, double x, double y, TimestampTz t)
+{
+  buf->lngeoms = buf->ngeoms;
+  buf->lntimes = buf->ntimes;
+  buf->lcx = buf->cx;
+  buf->lcy = buf->cy;
+  buf->geoms[buf->ngeoms++] = mvt_command(MVT_CMD_MOVETO, 1);
+  mvtbuffer_vertex(buf, (int32_t) rint(x), (int32_t) rint(y), t);
+  /* The number of vertices of the LineTo command is set at the end */
+  buf->lcmd = buf->ngeoms++;
+  buf->lnverts = 1;
+  return;
+}
+
+/**
+ * @brief Append a vertex to the current line in the buffers, the vertex is
+ * snapped to integer precision and skipped if it is equal to the previous one
+ */
+static void
+mvtbuffer_line_add(MVTBuffer *buf, double x, double y, TimestampTz t)
+{
+  int32_t ix = (int32_t) rint(x), iy = (int32_t) rint(y);
+  if (ix == buf->cx && iy == buf->cy)
+    return;
+  mvtbuffer_vertex(buf, ix, iy, t);
+  buf->lnverts++;
+  return;
+}
+
+/**
+ * @brief End the current line in the buffers
+ * @return True when the line has been kept, false when it collapses to a
+ * point, in which case it is removed from the buffers
+ */
+static bool
+mvtbuffer_line_end(MVTBuffer *buf)
+{
+  if (buf->lnverts < 2)
+  {
+    buf->ngeoms = buf->lngeoms;
+    buf->ntimes = buf->lntimes;
+    buf->cx = buf->lcx;
+    buf->cy = buf->lcy;
+    return false;
+  }
+  buf->geoms[buf->lcmd] = mvt_command(MVT_CMD_LINETO, buf->lnverts - 1);
+  return true;
+}
+
+/**
+ * @brief Remove the consecutive points of the scratch arrays that are within
+ * the resolution of the tile
+ * @return Number of points kept
+ * @note The function mirrors #tpointseq_remove_repeated_points with a
+ * minimum of 2 points
+ */
+static int
+mvtbuffer_remove_repeated(MVTBuffer *buf, int count)
+{
+  /* No-op on short inputs */
+  if (count <= 2)
+    return count;
+  double *x = buf->x, *y = buf->y;
+  TimestampTz *t = buf->t;
+  double tolsq = buf->res * buf->res;
+  double dsq = FLT_MAX;
+  int last = 0, npoints = 1;
+  for (int i = 1; i < count; i++)
+  {
+    bool last_point = (i == count - 1);
+    /* Don't drop points if we are running short of points */
+    if (count - i > 2 - npoints)
+    {
+      /* Only drop points that are within our tolerance */
+      dsq = (x[i] - x[last]) * (x[i] - x[last]) +
+        (y[i] - y[last]) * (y[i] - y[last]);
+      /* Allow any point but the last one to be dropped */
+      if (! last_point && dsq <= tolsq)
+        continue;
+      /* Keep the last point instead of the second-to-last one */
+      if (last_point && npoints > 1 && dsq <= tolsq)
+        npoints--;
+    }
+    /* Save the point */
+    x[npoints] = x[i]; y[npoints] = y[i]; t[npoints] = t[i];
+    last = npoints++;
+  }
+  return npoints;
+}
+
+/**
+ * @brief Simplify the points of the scratch arrays with the Douglas-Peucker
+ * algorithm using the spatial distance and the resolution of the tile
+ * @return Number of points kept
+ * @note The function mirrors #tsequence_simplify_dp and finds the splits
+ * with the distance kernels of #tpointcoords_findsplit
+ */
+static int
+mvtbuffer_simplify(MVTBuffer *buf, int count)
+{
+  /* Do not try to simplify really short things */
+  if (count < 3)
+    return count;
+  TPointCoords coords;
+  coords.count = count;
+  coords.hasz = false;
+  coords.x = buf->x;
+  coords.y = buf->y;
+  coords.z = NULL;
+  coords.t = buf->t;
+  coords.buf = buf->dist;
+  double tolsq = buf->res * buf->res;
+  int *stack = buf->stack;
+  bool *keep = buf->keep;
+  memset(keep, 0, sizeof(bool) * count);
+  keep[0] = true;
+  int sp = -1, i1 = 0;
+  stack[++sp] = count - 1;
+  do
+  {
+    int split = tpointcoords_findsplit(&coords, i1, stack[sp], false);
+    if (split > i1 && buf->dist[split] > tolsq)
+      stack[++sp] = split;
+    else
+    {
+      keep[stack[sp]] = true;
+      i1 = stack[sp--];
+    }
+  }
+  while (sp >= 0);
+  int npoints = 0;
+  for (int i = 0; i < count; i++)
+  {
+    if (! keep[i])
+      continue;
+    buf->x[npoints] = buf->x[i];
+    buf->y[npoints] = buf->y[i];
+    buf->t[npoints++] = buf->t[i];
+  }
+  return npoints;
+}
+
+/**
+ * @brief Remove the redundant points of the scratch arrays, i.e., the
+ * points that are collinear with their neighbours with respect to time
+ * @return Number of points kept
+ * @note The function mirrors #tinstarr_normalize for sequences with linear
+ * interpolation, which is applied by #tpoint_mvt when constructing the result
+ * of every stage
+ */
+static int
+mvtbuffer_normalize(MVTBuffer *buf, int count)
+{
+  if (count < 3)
+    return count;
+  double *x = buf->x, *y = buf->y;
+  TimestampTz *t = buf->t;
+  /* The last point kept is at position npoints - 1, the candidate at i2 */
+  int npoints = 1, i2 = 1;
+  for (int i = 2; i < count; i++)
+  {
+    int i1 = npoints - 1;
+    double ratio = (double) (t[i2] - t[i1]) / (double) (t[i] - t[i1]);
+    double px = x[i1] + (x[i] - x[i1]) * ratio;
+    double py = y[i1] + (y[i] - y[i1]) * ratio;
+    if (fabs(x[i2] - px) > MEOS_EPSILON || fabs(y[i2] - py) > MEOS_EPSILON)
+    {
+      x[npoints] = x[i2]; y[npoints] = y[i2]; t[npoints++] = t[i2];
+    }
+    i2 = i;
+  }
+  x[npoints] = x[i2]; y[npoints] = y[i2]; t[npoints++] = t[i2];
+  return npoints;
+}
+
+/**
+ * @brief Transform the points of the scratch arrays into tile coordinate
+ * space snapping them to integer precision
+ * @return Number of points kept
+ * @note As in #tpoint_mvt, the consecutive points that are equal after the
+ * snapping are kept, they are removed when appending the line
+ */
+static int
+mvtbuffer_snap(MVTBuffer *buf, int count)
+{
+  double *x = buf->x, *y = buf->y;
+  for (int i = 0; i < count; i++)
+  {
+    x[i] = buf->fx * x[i] + buf->xoff;
+    y[i] = buf->fy * y[i] + buf->yoff;
+  }
+  count = mvtbuffer_normalize(buf, count);
+  for (int i = 0; i < count; i++)
+  {
+    x[i] = rint(x[i]);
+    y[i] = rint(y[i]);
+  }
+  return mvtbuffer_normalize(buf, count);
+}
+
+/**
+ * @brief Append to the buffers the lines of a temporal point sequence with
+ * linear interpolation
+ * @return True when at least one line has been appended
+ * @note The clipping is done on every segment with the Liang-Barsky
+ * algorithm as in #tpointseq_linear_at_stbox_xyz, the timestamps of the
+ * points where the segment enters or exits the tile are interpolated. A new
+ * line is started every time the sequence reenters the tile.
+ */
+static bool
+mvtbuffer_line_append(MVTBuffer *buf, const TSequence *seq)
+{
+  mvtbuffer_scratch(buf, seq->count);
+  for (int i = 0; i < seq->count; i++)
+  {
+    const TInstant *inst = TSEQUENCE_INST_N(seq, i);
+    const POINT2D *pt = DATUM_POINT2D_P(tinstant_val(inst));
+    buf->x[i] = pt->x;
+    buf->y[i] = pt->y;
+    buf->t[i] = inst->t;
+  }
+  int count = mvtbuffer_remove_repeated(buf, seq->count);
+  count = mvtbuffer_normalize(buf, count);
+  count = mvtbuffer_simplify(buf, count);
+  count = mvtbuffer_normalize(buf, count);
+  count = mvtbuffer_snap(buf, count);
+  if (count < 2)
+    return false;
+
+  /* A segment produces at most two vertices */
+  mvtbuffer_reserve(buf, 6 * count, 2 * count);
+  double *x = buf->x, *y = buf->y;
+  TimestampTz *t = buf->t;
+  if (! buf->clip)
+  {
+    mvtbuffer_line_start(buf, x[0], y[0], t[0]);
+    for (int i = 1; i < count; i++)
+      mvtbuffer_line_add(buf, x[i], y[i], t[i]);
+    return mvtbuffer_line_end(buf);
+  }
+
+  bool result = false, inside = false;
+  for (int i = 1; i < count; i++)
+  {
+    double t0 = 0, t1 = 1;
+    double dx = x[i] - x[i - 1], dy = y[i] - y[i - 1];
+    if (clipt(-dx, x[i - 1] - buf->cmin, &t0, &t1) && /* left */
+        clipt(dx, buf->cmax - x[i - 1], &t0, &t1) && /* right */
+        clipt(-dy, y[i - 1] - buf->cmin, &t0, &t1) && /* bottom */
+        clipt(dy, buf->cmax - y[i - 1], &t0, &t1)) /* top */
+    {
+      double duration = (double) (t[i] - t[i - 1]);
+      if (! inside)
+      {
+        /* Enter the tile */
+        mvtbuffer_line_start(buf, x[i - 1] + t0 * dx, y[i - 1] + t0 * dy,
+          t[i - 1] + (TimestampTz) (duration * t0));
+        inside = true;
+      }
+      if (t1 < 1)
+      {
+        /* Exit the tile */
+        mvtbuffer_line_add(buf, x[i - 1] + t1 * dx, y[i - 1] + t1 * dy,
+          t[i - 1] + (TimestampTz) (duration * t1));
+        result |= mvtbuffer_line_end(buf);
+        inside = false;
+      }
+      else
+        mvtbuffer_line_add(buf, x[i], y[i], t[i]);
+    }
+    else if (inside)
+    {
+      result |= mvtbuffer_line_end(buf);
+      inside = false;
+    }
+  }
+  if (inside)
+    result |= mvtbuffer_line_end(buf);
+  return result;
+}
+
+/**
+ * @brief Append to the buffers the points of the instants of a temporal point
+ * @param[in,out] buf Buffers
+ * @param[in] instants Array of instants
+ * @param[in] count Number of instants
+ * @return Number of points appended
+ * @note Consecutive instants that are equal after the snapping to integer
+ * precision are appended once
+ */
+static int
+mvtbuffer_points_append(MVTBuffer *buf, const TInstant **instants, int count)
+{
+  int32_t px = 0, py = 0;
+  int result = 0;
+  for (int i = 0; i < count; i++)
+  {
+    const POINT2D *pt = DATUM_POINT2D_P(tinstant_val(instants[i]));
+    double x = rint(buf->fx * pt->x + buf->xoff);
+    double y = rint(buf->fy * pt->y + buf->yoff);
+    if (buf->clip && (x < buf->cmin || x > buf->cmax || y < buf->cmin ||
+        y > buf->cmax))
+      continue;
+    int32_t ix = (int32_t) x, iy = (int32_t) y;
+    if (result > 0 && ix == px && iy == py)
+      continue;
+    mvtbuffer_vertex(buf, ix, iy, instants[i]->t);
+    px = ix; py = iy;
+    result++;
+  }
+  return result;
+}
+
+/**
+ * @brief Append to the buffers the MVT geometry of a temporal point
+ * @return MVT geometry type of the result, 0 when the geometry is empty
+ * @details Sequences with linear interpolation are encoded as lines, the
+ * instants of all other temporal points are encoded as points, as done by
+ * #tpoint_decouple
+ * @note When the temporal point has parts encoded as points and as lines,
+ * as an MVT geometry cannot be a collection, the parts encoded as points are
+ * removed. Similarly, lines that collapse to a point after the snapping to
+ * integer precision are removed.
+ */
+static uint8_t
+mvtbuffer_append(MVTBuffer *buf, const Temporal *temp)
+{
+  /* The cursor is reset for every feature */
+  buf->cx = buf->cy = 0;
+  int nseqs = 0;
+  const TSequence **sequences = NULL;
+  if (temp->subtype == TSEQUENCE)
+  {
+    nseqs = 1;
+    sequences = palloc(sizeof(TSequence *));
+    sequences[0] = (const TSequence *) temp;
+  }
+  else if (temp->subtype == TSEQUENCESET)
+  {
+    nseqs = ((const TSequenceSet *) temp)->count;
+    sequences = tsequenceset_seqs((const TSequenceSet *) temp);
+  }
+
+  /* Encode the lines */
+  bool line = false;
+  for (int i = 0; sequences && i < nseqs; i++)
+  {
+    if (MEOS_FLAGS_LINEAR_INTERP(sequences[i]->flags) &&
+        sequences[i]->count > 1)
+      line |= mvtbuffer_line_append(buf, sequences[i]);
+  }
+  if (line)
+  {
+    pfree(sequences);
+    return MVT_LINESTRING;
+  }
+
+  /* Encode the points */
+  int ninsts = temporal_num_instants(temp);
+  mvtbuffer_reserve(buf, 1 + 2 * ninsts, ninsts);
+  int cmd = buf->ngeoms++;
+  int npoints = 0;
+  if (temp->subtype == TINSTANT)
+    npoints = mvtbuffer_points_append(buf, (const TInstant **) &temp, 1);
+  for (int i = 0; sequences && i < nseqs; i++)
+  {
+    const TSequence *seq = sequences[i];
+    if (MEOS_FLAGS_LINEAR_INTERP(seq->flags) && seq->count > 1)
+      continue;
+    const TInstant **instants = tsequence_insts(seq);
+    npoints += mvtbuffer_points_append(buf, instants, seq->count);
+    pfree(instants);
+  }
+  if (sequences)
+    pfree(sequences);
+  if (npoints == 0)
+  {
+    buf->ngeoms = cmd;
+    return 0;
+  }
+  buf->geoms[cmd] = mvt_command(MVT_CMD_MOVETO, npoints);
+  return MVT_POINT;
+}
+
+/**
+ * @ingroup meos_temporal_spatial_transf
+ * @brief Return an array of temporal points encoded as Mapbox Vector Tile
+ * geometries
+ * @param[in] temparr Array of temporal points
+ * @param[in] count Number of elements in the input array
+ * @param[in] bounds Bounds
+ * @param[in] extent Extent
+ * @param[in] buffer Buffer
+ * @param[in] clip_geom True when the geometries are clipped
+ * @param[out] geomarr Command streams of the geometries of all the temporal
+ * points
+ * @param[out] geomoffsets Array of @p count + 1 elements with the start of
+ * the command stream of every temporal point in @p geomarr
+ * @param[out] typearr Array of @p count elements with the MVT geometry type
+ * of every temporal point, i.e., 1 for points and 2 for lines, or 0 when the
+ * temporal point does not intersect the tile
+ * @param[out] timesarr Timestamps in Unix epoch of the vertices of all the
+ * temporal points
+ * @param[out] timesoffsets Array of @p count + 1 elements with the start of
+ * the timestamps of every temporal point in @p timesarr
+ * @details The stages of the transformation into tile coordinate space are
+ * those of #tpoint_AsMVTGeom applied in a single pass, including the removal
+ * of the collinear vertices after every stage. Away from the border of the
+ * tile, the vertices and the timestamps of a line are those returned by
+ * #tpoint_AsMVTGeom without the consecutive duplicates, which are not allowed
+ * in the LineTo commands of an MVT geometry. Contrary to #tpoint_AsMVTGeom,
+ * the clipping box includes its upper border, so the vertices may differ
+ * where the line crosses the border of the tile. When the geometries are
+ * clipped, the temporal points whose bounding box does not intersect the tile
+ * are skipped without reading their instants.
+ * @csqlfn #Tpointarr_AsMVTCommands()
+ */
+bool
+tpointarr_AsMVTCommands(const Temporal **temparr, int count,
+  const STBox *bounds, int32_t extent, int32_t buffer, bool clip_geom,
+  uint32_t **geomarr, int **geomoffsets, uint8_t **typearr, int64 **timesarr,
+  int **timesoffsets)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) temparr) ||
+      ! ensure_not_null((void *) bounds) ||
+      ! ensure_not_null((void *) geomarr) ||
+      ! ensure_not_null((void *) geomoffsets) ||
+      ! ensure_not_null((void *) typearr) ||
+      ! ensure_not_null((void *) timesarr) ||
+      ! ensure_not_null((void *) timesoffsets) ||
+      ! ensure_positive(count))
+    return false;
+  for (int i = 0; i < count; i++)
+  {
+    if (! ensure_not_null((void *) temparr[i]) ||
+        ! ensure_tgeo_type(temparr[i]->temptype) ||
+        ! ensure_not_geodetic(temparr[i]->flags))
+      return false;
+  }
+  double width = bounds->xmax - bounds->xmin;
+  double height = bounds->ymax - bounds->ymin;
+  if (width <= 0 || height <= 0)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "%s: Geometric bounds are too small", __func__);
+    return false;
+  }
+  if (extent <= 0)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "%s: Extent must be greater than 0", __func__);
+    return false;
+  }
+
+  /* Extent of the tile and its buffer enlarged by a pixel to account for the
+   * snapping to integer precision */
+  double resx = width / extent;
+  double resy = height / extent;
+  double xmin = bounds->xmin - (buffer + 1) * resx;
+  double xmax = bounds->xmax + (buffer + 1) * resx;
+  double ymin = bounds->ymin - (buffer + 1) * resy;
+  double ymax = bounds->ymax + (buffer + 1) * resy;
+
+  MVTBuffer buf;
+  memset(&buf, 0, sizeof(MVTBuffer));
+  /* Transformation into tile coordinate space as in #tpoint_mvt */
+  buf.fx = extent / width;
+  buf.fy = -(extent / height);
+  buf.xoff = -bounds->xmin * buf.fx;
+  buf.yoff = -bounds->ymax * buf.fy;
+  buf.res = (resx < resy ? resx : resy) / 2;
+  buf.cmin = -(double) buffer;
+  buf.cmax = (double) extent + (double) buffer;
+  buf.clip = clip_geom;
+  buf.maxgeoms = buf.maxtimes = 64;
+  buf.geoms = palloc(sizeof(uint32_t) * buf.maxgeoms);
+  buf.times = palloc(sizeof(int64) * buf.maxtimes);
+  mvtbuffer_scratch(&buf, 64);
+  int *geomoffs = palloc(sizeof(int) * (count + 1));
+  int *timesoffs = palloc(sizeof(int) * (count + 1));
+  uint8_t *types = palloc0(sizeof(uint8_t) * count);
+  for (int i = 0; i < count; i++)
+  {
+    geomoffs[i] = buf.ngeoms;
+    timesoffs[i] = buf.ntimes;
+    if (clip_geom)
+    {
+      STBox box;
+      temporal_set_bbox(temparr[i], &box);
+      if (box.xmax < xmin || box.xmin > xmax || box.ymax < ymin ||
+          box.ymin > ymax)
+        continue;
+    }
+    types[i] = mvtbuffer_append(&buf, temparr[i]);
+  }
+  geomoffs[count] = buf.ngeoms;
+  timesoffs[count] = buf.ntimes;
+  pfree(buf.x);
+
+  *geomarr = buf.geoms;
+  *geomoffsets = geomoffs;
+  *typearr = types;
+  *timesarr = buf.times;
+  *timesoffsets = timesoffs;
+  return true;
+}
+
 /*****************************************************************************
  * Length functions
  *****************************************************************************/
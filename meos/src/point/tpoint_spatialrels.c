@@ -48,13 +48,20 @@
 
 /* C */
 #include <assert.h>
+/* PostgreSQL */
+#include <utils/timestamp.h>
 /* MEOS */
 #include <meos.h>
 #include <meos_internal.h>
 #include "general/lifting.h"
+#include "general/temporal_tile.h"
+#include "general/tsequence.h"
 #include "point/pgis_types.h"
+#include "point/tpoint_boxops.h"
+#include "point/tpoint_restrfuncs.h"
 #include "point/tpoint_spatialfuncs.h"
 #include "point/tpoint_tempspatialrels.h"
+#include "point/tpoint_tile.h"
 
 #define INVERT_RESULT(result) (result < 0 ? -1 : (result > 0) ? 0 : 1)
 
@@ -286,6 +293,291 @@ spatialrel_tpoint_traj_geo(const Temporal *temp, const GSERIALIZED *gs,
   return result ? 1 : 0;
 }
 
+/**
+ * @brief Generic spatial relationship for a prepared geometry and the
+ * trajectory of a temporal point
+ * @param[in] pgeo Prepared geometry
+ * @param[in] temp Temporal point
+ * @param[in] rel Spatial relationship, where the prepared geometry is the
+ * first argument
+ * @return On error return -1
+ * @pre The prepared geometry is not geodetic and not empty
+ */
+static int
+spatialrel_prepgeo_tpoint_traj(const PreparedGeo *pgeo, const Temporal *temp,
+  spatialRel rel)
+{
+  GSERIALIZED *traj = tpoint_trajectory(temp);
+  bool result = prepgeo_spatialrel(pgeo, traj, rel);
+  pfree(traj);
+  return result ? 1 : 0;
+}
+
+/*****************************************************************************
+ * Ever spatial relationships evaluated segment by segment
+ *
+ * The ever intersects, contains, and dwithin relationships between a temporal
+ * point and a planar geometry are evaluated on the segments of the temporal
+ * point without constructing its trajectory. The sequences, blocks of
+ * segments, and segments whose bounding box does not overlap the one of the
+ * geometry, expanded by the distance for dwithin, are skipped and the
+ * evaluation stops at the first segment satisfying the relationship.
+ * Polygonal geometries are tested with their edge index while the other
+ * geometries are tested by computing the distance to the segment.
+ *****************************************************************************/
+
+/**
+ * @brief Structure for evaluating an ever spatial relationship between a
+ * temporal point and a geometry segment by segment
+ */
+typedef struct
+{
+  STBox box;          /**< 2D box of the geometry expanded by the distance */
+  double dist;        /**< Distance, 0 for intersects and contains */
+  bool interior;      /**< True if the interior of the geometry must be hit */
+  PolyIndex *idx;     /**< Edge index of a polygonal geometry, or NULL, kept
+                           by the prepared geometry */
+  LWGEOM *geom;       /**< Geometry when there is no edge index */
+  LWGEOM *segm;       /**< Segment reused across the calls */
+  LWGEOM *point;      /**< Point reused across the calls */
+  POINT2D *pts;       /**< Points referenced by the segment and the point */
+  double *fracs;      /**< Fractions of the current segment */
+  int maxfracs;       /**< Size of the array of fractions */
+} SegmRelState;
+
+/**
+ * @brief Initialize the structure for evaluating an ever spatial relationship
+ * segment by segment
+ * @param[in] pgeo Prepared geometry
+ * @param[in] dist Distance, 0 for intersects and contains
+ * @param[in] interior True for contains
+ * @param[out] state Structure
+ * @pre The geometry is planar, not empty, and if @p interior is true, it
+ * satisfies #geo_polygonal
+ */
+static void
+segmrel_init(PreparedGeo *pgeo, double dist, bool interior,
+  SegmRelState *state)
+{
+  const GSERIALIZED *gs = pgeo->gs;
+  memset(state, 0, sizeof(SegmRelState));
+  geo_set_stbox(gs, &state->box);
+  MEOS_FLAGS_SET_Z(state->box.flags, false);
+  state->box.xmin -= dist; state->box.xmax += dist;
+  state->box.ymin -= dist; state->box.ymax += dist;
+  state->dist = dist;
+  state->interior = interior;
+  if (dist == 0.0)
+    state->idx = prepgeo_polyindex(pgeo);
+  if (state->idx)
+  {
+    state->maxfracs = 64;
+    state->fracs = palloc(sizeof(double) * state->maxfracs);
+  }
+  else
+  {
+    state->geom = lwgeom_from_gserialized(gs);
+    state->pts = palloc0(sizeof(POINT2D) * 2);
+    state->segm = lwline_as_lwgeom(lwline_construct(SRID_UNKNOWN, NULL,
+      ptarray_construct_reference_data(0, 0, 2, (uint8_t *) state->pts)));
+    state->point = lwpoint_as_lwgeom(lwpoint_construct(SRID_UNKNOWN, NULL,
+      ptarray_construct_reference_data(0, 0, 1, (uint8_t *) state->pts)));
+  }
+  return;
+}
+
+/**
+ * @brief Free the structure for evaluating an ever spatial relationship
+ * segment by segment
+ */
+static void
+segmrel_free(SegmRelState *state)
+{
+  if (state->idx)
+    pfree(state->fracs);
+  else
+  {
+    /* The point arrays reference the points and do not own them */
+    lwgeom_free(state->segm); lwgeom_free(state->point);
+    lwgeom_free(state->geom);
+    pfree(state->pts);
+  }
+  return;
+}
+
+/**
+ * @brief Return true if the 2D bounding box of a temporal point overlaps the
+ * box of the geometry
+ */
+static bool
+segmrel_overlaps(const SegmRelState *state, const STBox *box)
+{
+  return ! (box->xmax < state->box.xmin || box->xmin > state->box.xmax ||
+    box->ymax < state->box.ymin || box->ymin > state->box.ymax);
+}
+
+/**
+ * @brief Return true if a segment satisfies the relationship with the
+ * geometry, a point is given as a segment with two equal points
+ */
+static bool
+segmrel_segm(SegmRelState *state, const POINT2D *p1, const POINT2D *p2)
+{
+  if (Max(p1->x, p2->x) < state->box.xmin ||
+      Min(p1->x, p2->x) > state->box.xmax ||
+      Max(p1->y, p2->y) < state->box.ymin ||
+      Min(p1->y, p2->y) > state->box.ymax)
+    return false;
+
+  bool point = (p1->x == p2->x && p1->y == p2->y);
+  if (! state->idx)
+  {
+    state->pts[0] = *p1;
+    state->pts[1] = *p2;
+    LWGEOM *geo = point ? state->point : state->segm;
+    double d = lwgeom_mindistance2d_tolerance(geo, state->geom, state->dist);
+    /* The distance computation may attach a bounding box to the geometry */
+    lwgeom_drop_bbox(geo);
+    return d <= state->dist;
+  }
+
+  if (point)
+  {
+    int loc = polyindex_locate(state->idx, p1->x, p1->y);
+    return state->interior ? (loc == 1) : (loc >= 0);
+  }
+  if (! state->interior && (polyindex_locate(state->idx, p1->x, p1->y) >= 0 ||
+      polyindex_locate(state->idx, p2->x, p2->y) >= 0))
+    return true;
+  int nfracs = polyindex_segm_fractions(state->idx, p1, p2, &state->fracs,
+    &state->maxfracs);
+  if (! state->interior)
+    /* Both end points are outside, any crossing intersects the geometry */
+    return nfracs > 2;
+  /* The segment must have a piece in the interior of the geometry */
+  for (int i = 0; i < nfracs - 1; i++)
+  {
+    double mid = (state->fracs[i] + state->fracs[i + 1]) / 2.0;
+    if (polyindex_locate(state->idx, p1->x + (p2->x - p1->x) * mid,
+        p1->y + (p2->y - p1->y) * mid) == 1)
+      return true;
+  }
+  return false;
+}
+
+/**
+ * @brief Return true if a temporal point sequence ever satisfies the
+ * relationship with the geometry
+ */
+static bool
+segmrel_tpointseq(SegmRelState *state, const TSequence *seq)
+{
+  if (! segmrel_overlaps(state, TSEQUENCE_BBOX_PTR(seq)))
+    return false;
+  const POINT2D *p1 = DATUM_POINT2D_P(tinstant_val(TSEQUENCE_INST_N(seq, 0)));
+  if (seq->count == 1 || ! MEOS_FLAGS_LINEAR_INTERP(seq->flags))
+  {
+    /* The trajectory is composed of the points of the instants */
+    for (int i = 0; i < seq->count; i++)
+    {
+      p1 = DATUM_POINT2D_P(tinstant_val(TSEQUENCE_INST_N(seq, i)));
+      if (segmrel_segm(state, p1, p1))
+        return true;
+    }
+    return false;
+  }
+  bool *blocks = tpointseq_segidx_search(seq, &state->box);
+  bool result = false;
+  for (int i = 1; i < seq->count; i++)
+  {
+    if (blocks && (i - 1) % SEGIDX_BLOCK_SIZE == 0 &&
+        ! blocks[(i - 1) / SEGIDX_BLOCK_SIZE])
+    {
+      /* None of the segments of the block overlaps the box, skip to the
+       * last instant of the block */
+      i = Min(i - 1 + SEGIDX_BLOCK_SIZE, seq->count - 1);
+      p1 = DATUM_POINT2D_P(tinstant_val(TSEQUENCE_INST_N(seq, i)));
+      continue;
+    }
+    const POINT2D *p2 = DATUM_POINT2D_P(tinstant_val(TSEQUENCE_INST_N(seq, i)));
+    if (segmrel_segm(state, p1, p2))
+    {
+      result = true;
+      break;
+    }
+    p1 = p2;
+  }
+  if (blocks)
+    pfree(blocks);
+  return result;
+}
+
+/**
+ * @brief Return 1 if a temporal point ever intersects, ever intersects the
+ * interior of, or is ever within a distance of a prepared geometry,
+ * 0 otherwise
+ * @param[in] temp Temporal point
+ * @param[in] pgeo Prepared geometry
+ * @param[in] dist Distance, 0 for intersects and contains
+ * @param[in] interior True for contains
+ * @pre The arguments are valid, the geometry is planar and not empty, and if
+ * @p interior is true, it satisfies #geo_polygonal. The Z dimension of the
+ * arguments, if any, is not taken into account.
+ */
+static int
+ever_spatialrel_tpoint_segm(const Temporal *temp, PreparedGeo *pgeo,
+  double dist, bool interior)
+{
+  SegmRelState state;
+  segmrel_init(pgeo, dist, interior, &state);
+  bool result = false;
+  assert(temptype_subtype(temp->subtype));
+  switch (temp->subtype)
+  {
+    case TINSTANT:
+    {
+      const POINT2D *p = DATUM_POINT2D_P(tinstant_val((TInstant *) temp));
+      result = segmrel_segm(&state, p, p);
+      break;
+    }
+    case TSEQUENCE:
+      result = segmrel_tpointseq(&state, (TSequence *) temp);
+      break;
+    default: /* TSEQUENCESET */
+    {
+      const TSequenceSet *ss = (const TSequenceSet *) temp;
+      if (! segmrel_overlaps(&state, TSEQUENCESET_BBOX_PTR(ss)))
+        break;
+      for (int i = 0; i < ss->count; i++)
+      {
+        if (segmrel_tpointseq(&state, TSEQUENCESET_SEQ_N(ss, i)))
+        {
+          result = true;
+          break;
+        }
+      }
+    }
+  }
+  segmrel_free(&state);
+  return result ? 1 : 0;
+}
+
+/**
+ * @brief Return 1 if a temporal point ever intersects, ever intersects the
+ * interior of, or is ever within a distance of a geometry, 0 otherwise
+ * @see #ever_spatialrel_tpoint_segm
+ */
+static int
+ever_spatialrel_tpoint_geo_segm(const Temporal *temp, const GSERIALIZED *gs,
+  double dist, bool interior)
+{
+  PreparedGeo pgeo;
+  prepared_geo_init(&pgeo, gs);
+  int result = ever_spatialrel_tpoint_segm(temp, &pgeo, dist, interior);
+  prepared_geo_reset(&pgeo);
+  return result;
+}
+
 /*****************************************************************************/
 
 /**
@@ -347,6 +639,9 @@ econtains_geo_tpoint(const GSERIALIZED *gs, const Temporal *temp)
   if (! ensure_valid_tpoint_geo(temp, gs) || gserialized_is_empty(gs) ||
       ! ensure_has_not_Z_gs(gs) || ! ensure_has_not_Z(temp->flags))
     return -1;
+  /* The trajectory intersects the interior of a polygonal geometry */
+  if (geo_polygonal(gs))
+    return ever_spatialrel_tpoint_geo_segm(temp, gs, 0.0, true);
   GSERIALIZED *traj = tpoint_trajectory(temp);
   bool result = geo_relate_pattern(gs, traj, "T********");
   pfree(traj);
@@ -378,6 +673,26 @@ acontains_geo_tpoint(const GSERIALIZED *gs, const Temporal *temp)
   return result ? 1 : 0;
 }
 
+/**
+ * @ingroup meos_temporal_spatial_rel_ever
+ * @brief Return 1 if a prepared geometry always contains a temporal point,
+ * 0 if not, and -1 on error or if the geometry is empty
+ * @param[in] pgeo Prepared geometry
+ * @param[in] temp Temporal point
+ * @see #acontains_geo_tpoint
+ */
+int
+acontains_prepgeo_tpoint(const PreparedGeo *pgeo, const Temporal *temp)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) pgeo) ||
+      ! ensure_valid_tpoint_geo(temp, pgeo->gs) ||
+      gserialized_is_empty(pgeo->gs) || ! ensure_has_not_Z_gs(pgeo->gs) ||
+      ! ensure_has_not_Z(temp->flags))
+    return -1;
+  return spatialrel_prepgeo_tpoint_traj(pgeo, temp, CONTAINS);
+}
+
 /*****************************************************************************
  * Ever/always disjoint (only always works for both geometry and geography)
  *****************************************************************************/
@@ -421,6 +736,42 @@ adisjoint_tpoint_geo(const Temporal *temp, const GSERIALIZED *gs)
   return INVERT_RESULT(result);
 }
 
+/**
+ * @ingroup meos_temporal_spatial_rel_ever
+ * @brief Return 1 if a temporal point and a prepared geometry are ever
+ * disjoint, 0 if not, and -1 on error or if the geometry is empty
+ * @param[in] temp Temporal point
+ * @param[in] pgeo Prepared geometry
+ * @see #edisjoint_tpoint_geo
+ */
+int
+edisjoint_tpoint_prepgeo(const Temporal *temp, const PreparedGeo *pgeo)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) temp) || ! ensure_not_null((void *) pgeo) ||
+      ! ensure_not_geodetic(temp->flags) ||
+      ! ensure_valid_tpoint_geo(temp, pgeo->gs) ||
+      gserialized_is_empty(pgeo->gs))
+    return -1;
+  int result = spatialrel_prepgeo_tpoint_traj(pgeo, temp, COVERS);
+  return INVERT_RESULT(result);
+}
+
+/**
+ * @ingroup meos_temporal_spatial_rel_ever
+ * @brief Return 1 if a temporal point and a prepared geometry are always
+ * disjoint, 0 if not, and -1 on error or if the geometry is empty
+ * @param[in] temp Temporal point
+ * @param[in] pgeo Prepared geometry
+ * @see #adisjoint_tpoint_geo
+ */
+int
+adisjoint_tpoint_prepgeo(const Temporal *temp, const PreparedGeo *pgeo)
+{
+  int result = eintersects_tpoint_prepgeo(temp, pgeo);
+  return INVERT_RESULT(result);
+}
+
 #if MEOS
 /**
  * @ingroup meos_temporal_spatial_rel_ever
@@ -468,6 +819,14 @@ adisjoint_tpoint_tpoint(const Temporal *temp1, const Temporal *temp2)
 int
 eintersects_tpoint_geo(const Temporal *temp, const GSERIALIZED *gs)
 {
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) temp) || ! ensure_not_null((void *) gs) ||
+      ! ensure_valid_tpoint_geo(temp, gs) || gserialized_is_empty(gs))
+    return -1;
+  /* Planar 2D intersection is evaluated segment by segment */
+  if (! MEOS_FLAGS_GET_GEODETIC(temp->flags) &&
+      ! (MEOS_FLAGS_GET_Z(temp->flags) && FLAGS_GET_Z(gs->gflags)))
+    return ever_spatialrel_tpoint_geo_segm(temp, gs, 0.0, false);
   datum_func2 func = get_intersects_fn_gs(temp->flags, gs->gflags);
   return spatialrel_tpoint_traj_geo(temp, gs, (Datum) NULL, (varfunc) func, 2,
     INVERT_NO);
@@ -491,6 +850,48 @@ aintersects_tpoint_geo(const Temporal *temp, const GSERIALIZED *gs)
   return INVERT_RESULT(result);
 }
 
+/**
+ * @ingroup meos_temporal_spatial_rel_ever
+ * @brief Return 1 if a prepared geometry and a temporal point ever intersect,
+ * 0 if not, and -1 on error or if the geometry is empty
+ * @param[in] temp Temporal point
+ * @param[in] pgeo Prepared geometry
+ * @note As for #eintersects_tpoint_geo, planar 2D intersection is evaluated
+ * segment by segment, with the edge index kept by the prepared geometry for
+ * polygonal geometries, which is faster than testing the trajectory with the
+ * GEOS prepared geometry. Geographies and 3D arguments fall back to
+ * #eintersects_tpoint_geo.
+ */
+int
+eintersects_tpoint_prepgeo(const Temporal *temp, const PreparedGeo *pgeo)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) temp) || ! ensure_not_null((void *) pgeo))
+    return -1;
+  if (! pgeo->prepgeom ||
+      (MEOS_FLAGS_GET_Z(temp->flags) && FLAGS_GET_Z(pgeo->gs->gflags)))
+    return eintersects_tpoint_geo(temp, pgeo->gs);
+  if (! ensure_valid_tpoint_geo(temp, pgeo->gs))
+    return -1;
+  /* The edge index is computed on demand in the prepared geometry */
+  return ever_spatialrel_tpoint_segm(temp, (PreparedGeo *) pgeo, 0.0, false);
+}
+
+/**
+ * @ingroup meos_temporal_spatial_rel_ever
+ * @brief Return 1 if a prepared geometry and a temporal point always
+ * intersect, 0 if not, and -1 on error or if the geometry is empty
+ * @param[in] temp Temporal point
+ * @param[in] pgeo Prepared geometry
+ * @see #aintersects_tpoint_geo
+ */
+int
+aintersects_tpoint_prepgeo(const Temporal *temp, const PreparedGeo *pgeo)
+{
+  int result = edisjoint_tpoint_prepgeo(temp, pgeo);
+  return INVERT_RESULT(result);
+}
+
 #if MEOS
 /**
  * @ingroup meos_temporal_spatial_rel_ever
@@ -619,8 +1020,14 @@ int
 edwithin_tpoint_geo(const Temporal *temp, const GSERIALIZED *gs, double dist)
 {
   /* Ensure validity of the arguments */
-  if (! ensure_not_negative_datum(Float8GetDatum(dist), T_FLOAT8))
+  if (! ensure_not_null((void *) temp) || ! ensure_not_null((void *) gs) ||
+      ! ensure_valid_tpoint_geo(temp, gs) || gserialized_is_empty(gs) ||
+      ! ensure_not_negative_datum(Float8GetDatum(dist), T_FLOAT8))
     return -1;
+  /* Planar 2D distance is evaluated segment by segment */
+  if (! MEOS_FLAGS_GET_GEODETIC(temp->flags) &&
+      ! (MEOS_FLAGS_GET_Z(temp->flags) && FLAGS_GET_Z(gs->gflags)))
+    return ever_spatialrel_tpoint_geo_segm(temp, gs, dist, false);
   datum_func3 func = get_dwithin_fn_gs(temp->flags, gs->gflags);
   return spatialrel_tpoint_traj_geo(temp, gs, Float8GetDatum(dist),
     (varfunc) func, 3, INVERT_NO);
@@ -697,6 +1104,38 @@ ea_dwithin_tpointseq_tpointseq_discstep(const TSequence *seq1,
   return ! ret_loop;
 }
 
+/**
+ * @brief Return true if two temporal point segments are ever within a
+ * distance
+ * @param[in] sv1,ev1 Start and end values of the first segment
+ * @param[in] sv2,ev2 Start and end values of the second segment
+ * @param[in] lower,upper Timestamps of the segments
+ * @param[in] lower_inc,upper_inc True if the bounds are inclusive
+ * @param[in] hasz True if the points have Z dimension
+ * @param[in] dist Distance
+ * @param[in] func DWithin function (2D or 3D)
+ * @note The end values are equal to the start ones for step interpolation
+ */
+static bool
+ea_dwithin_tpointsegm_tpointsegm(Datum sv1, Datum ev1, Datum sv2, Datum ev2,
+  TimestampTz lower, TimestampTz upper, bool lower_inc, bool upper_inc,
+  bool hasz, double dist, datum_func3 func)
+{
+  /* Both segments are constant */
+  if (datum_point_eq(sv1, ev1) && datum_point_eq(sv2, ev2))
+    return DatumGetBool(func(sv1, sv2, Float8GetDatum(dist)));
+
+  /* General case */
+  TimestampTz t1, t2;
+  /* Find the instants t1 and t2 (if any) during which the dwithin function
+   * is true */
+  int solutions = tdwithin_tpointsegm_tpointsegm(sv1, ev1, sv2, ev2,
+    lower, upper, dist, hasz, func, &t1, &t2);
+  return (solutions == 2 ||
+    (solutions == 1 && ((t1 != lower || lower_inc) &&
+      (t1 != upper || upper_inc))));
+}
+
 /**
  * @brief Return true if two temporal points are ever within a distance
  * @param[in] seq1,seq2 Temporal points
@@ -739,25 +1178,9 @@ ea_dwithin_tpointseq_tpointseq_cont(const TSequence *seq1,
     TimestampTz upper = end1->t;
     bool upper_inc = (i == seq1->count - 1) ? seq1->period.upper_inc : false;
 
-    /* Both segments are constant */
-    if (datum_point_eq(sv1, ev1) && datum_point_eq(sv2, ev2))
-    {
-      bool res = DatumGetBool(func(sv1, sv2, Float8GetDatum(dist)));
-      if ((ever && res) || (! ever && ! res))
-        return ret_loop;
-    }
-
-    /* General case */
-    TimestampTz t1, t2;
-    Datum sev1 = linear1 ? ev1 : sv1;
-    Datum sev2 = linear2 ? ev2 : sv2;
-    /* Find the instants t1 and t2 (if any) during which the dwithin function
-     * is true */
-    int solutions = tdwithin_tpointsegm_tpointsegm(sv1, sev1, sv2, sev2,
-      lower, upper, dist, hasz, func, &t1, &t2);
-    bool res = (solutions == 2 ||
-      (solutions == 1 && ((t1 != lower || lower_inc) &&
-        (t1 != upper || upper_inc))));
+    bool res = ea_dwithin_tpointsegm_tpointsegm(sv1, linear1 ? ev1 : sv1,
+      sv2, linear2 ? ev2 : sv2, lower, upper, lower_inc, upper_inc, hasz,
+      dist, func);
     if ((ever && res) || (! ever && ! res))
       return ret_loop;
 
@@ -800,6 +1223,169 @@ ea_dwithin_tpointseqset_tpointseqset(const TSequenceSet *ss1,
 
 /*****************************************************************************/
 
+/**
+ * @brief Return the value of a temporal point sequence at a timestamp located
+ * in the segment starting at the n-th instant
+ * @note The function creates a new value that must be freed
+ */
+static Datum
+tpointseq_value_at_segm(const TSequence *seq, int n, TimestampTz t)
+{
+  const TInstant *inst = TSEQUENCE_INST_N(seq, n);
+  if (inst->t == t || n == seq->count - 1)
+    return tinstant_value(inst);
+  return tsegment_value_at_timestamptz(inst, TSEQUENCE_INST_N(seq, n + 1),
+    MEOS_FLAGS_GET_INTERP(seq->flags), t);
+}
+
+/**
+ * @brief Return the number of the segment of a temporal point sequence
+ * containing a timestamp, that is, the last instant whose timestamp is less
+ * than or equal to it
+ * @pre The timestamp is contained in the time span of the sequence
+ */
+static int
+tpointseq_segm_n(const TSequence *seq, TimestampTz t)
+{
+  int first = 0, last = seq->count - 1;
+  while (first < last)
+  {
+    int middle = (first + last + 1) / 2;
+    if (TSEQUENCE_INST_N(seq, middle)->t <= t)
+      first = middle;
+    else
+      last = middle - 1;
+  }
+  return first;
+}
+
+/**
+ * @brief Return 1 if two temporal point sequences are ever/always within a
+ * distance, 0 if not, and -1 if they do not intersect in time
+ * @details The segments of the synchronized sequences are visited by
+ * advancing in both sequences at the same time without constructing the
+ * synchronized sequences. The function stops at the first segment that
+ * satisfies the relationship for the ever semantics or at the first segment
+ * that does not satisfy it for the always semantics.
+ * @param[in] seq1,seq2 Temporal points
+ * @param[in] dist Distance
+ * @param[in] func DWithin function (2D or 3D)
+ * @param[in] ever True for the ever semantics, false for the always semantics
+ * @pre The sequences are continuous
+ */
+static int
+ea_dwithin_tpointseq_tpointseq_walk(const TSequence *seq1,
+  const TSequence *seq2, double dist, datum_func3 func, bool ever)
+{
+  Span inter;
+  if (! inter_span_span(&seq1->period, &seq2->period, &inter))
+    return -1;
+
+  TimestampTz lower = DatumGetTimestampTz(inter.lower);
+  TimestampTz end = DatumGetTimestampTz(inter.upper);
+  int i = tpointseq_segm_n(seq1, lower);
+  int j = tpointseq_segm_n(seq2, lower);
+  Datum sv1 = tpointseq_value_at_segm(seq1, i, lower);
+  Datum sv2 = tpointseq_value_at_segm(seq2, j, lower);
+  bool res;
+  if (lower == end)
+  {
+    res = DatumGetBool(func(sv1, sv2, Float8GetDatum(dist)));
+    pfree(DatumGetPointer(sv1)); pfree(DatumGetPointer(sv2));
+    return res ? 1 : 0;
+  }
+
+  bool linear1 = MEOS_FLAGS_LINEAR_INTERP(seq1->flags);
+  bool linear2 = MEOS_FLAGS_LINEAR_INTERP(seq2->flags);
+  bool hasz = MEOS_FLAGS_GET_Z(seq1->flags);
+  bool lower_inc = inter.lower_inc;
+  bool upper_inc = false;
+  while (true)
+  {
+    /* The segment ends at the next instant of any of the sequences */
+    TimestampTz next1 = TSEQUENCE_INST_N(seq1, i + 1)->t;
+    TimestampTz next2 = TSEQUENCE_INST_N(seq2, j + 1)->t;
+    TimestampTz upper = Min(Min(next1, next2), end);
+    upper_inc = (upper == end) ? inter.upper_inc : false;
+    Datum ev1, ev2;
+    if (upper == next1)
+      ev1 = tinstant_value(TSEQUENCE_INST_N(seq1, ++i));
+    else
+      ev1 = tpointseq_value_at_segm(seq1, i, upper);
+    if (upper == next2)
+      ev2 = tinstant_value(TSEQUENCE_INST_N(seq2, ++j));
+    else
+      ev2 = tpointseq_value_at_segm(seq2, j, upper);
+    res = ea_dwithin_tpointsegm_tpointsegm(sv1, linear1 ? ev1 : sv1,
+      sv2, linear2 ? ev2 : sv2, lower, upper, lower_inc, upper_inc, hasz,
+      dist, func);
+    pfree(DatumGetPointer(sv1)); pfree(DatumGetPointer(sv2));
+    sv1 = ev1; sv2 = ev2;
+    if ((ever && res) || (! ever && ! res) || upper == end)
+      break;
+    lower = upper;
+    lower_inc = true;
+  }
+  /* With step interpolation the values at an inclusive upper bound are not
+   * covered by the last segment */
+  if (upper_inc && (ever != res) && (! linear1 || ! linear2))
+    res = DatumGetBool(func(sv1, sv2, Float8GetDatum(dist)));
+  pfree(DatumGetPointer(sv1)); pfree(DatumGetPointer(sv2));
+  return res ? 1 : 0;
+}
+
+/**
+ * @brief Return 1 if two continuous temporal points are ever/always within a
+ * distance, 0 if not, and -1 if they do not intersect in time
+ * @details The sequences of both temporal points are merged by their time
+ * spans and each pair of overlapping sequences is evaluated by
+ * #ea_dwithin_tpointseq_tpointseq_walk
+ * @param[in] temp1,temp2 Temporal points
+ * @param[in] dist Distance
+ * @param[in] ever True for the ever semantics, false for the always semantics
+ * @pre The temporal points are continuous sequences or sequence sets
+ */
+static int
+ea_dwithin_tpoint_tpoint_walk(const Temporal *temp1, const Temporal *temp2,
+  double dist, bool ever)
+{
+  datum_func3 func = get_dwithin_fn(temp1->flags, temp2->flags);
+  int count1 = (temp1->subtype == TSEQUENCE) ? 1 :
+    ((TSequenceSet *) temp1)->count;
+  int count2 = (temp2->subtype == TSEQUENCE) ? 1 :
+    ((TSequenceSet *) temp2)->count;
+  int result = -1;
+  int i = 0, j = 0;
+  while (i < count1 && j < count2)
+  {
+    const TSequence *seq1 = (temp1->subtype == TSEQUENCE) ?
+      (TSequence *) temp1 : TSEQUENCESET_SEQ_N((TSequenceSet *) temp1, i);
+    const TSequence *seq2 = (temp2->subtype == TSEQUENCE) ?
+      (TSequence *) temp2 : TSEQUENCESET_SEQ_N((TSequenceSet *) temp2, j);
+    int res = ea_dwithin_tpointseq_tpointseq_walk(seq1, seq2, dist, func,
+      ever);
+    if (res >= 0)
+    {
+      result = res;
+      if ((ever && res) || (! ever && ! res))
+        break;
+    }
+    int cmp = timestamptz_cmp_internal(DatumGetTimestampTz(seq1->period.upper),
+      DatumGetTimestampTz(seq2->period.upper));
+    if (cmp == 0)
+    {
+      i++; j++;
+    }
+    else if (cmp < 0)
+      i++;
+    else
+      j++;
+  }
+  return result;
+}
+
+/*****************************************************************************/
+
 /**
  * @brief Return 1 if two temporal points are ever within a distance,
  * 0 if not, -1 if the temporal points do not intersect on time
@@ -847,6 +1433,12 @@ ea_dwithin_tpoint_tpoint(const Temporal *temp1, const Temporal *temp2,
       ! ensure_not_negative_datum(Float8GetDatum(dist), T_FLOAT8))
     return -1;
 
+  /* Continuous temporal points are traversed without synchronizing them */
+  if (temp1->subtype != TINSTANT && temp2->subtype != TINSTANT &&
+      ! MEOS_FLAGS_DISCRETE_INTERP(temp1->flags) &&
+      ! MEOS_FLAGS_DISCRETE_INTERP(temp2->flags))
+    return ea_dwithin_tpoint_tpoint_walk(temp1, temp2, dist, ever);
+
   Temporal *sync1, *sync2;
   /* Return NULL if the temporal points do not intersect in time
    * The operation is synchronization without adding crossings */
@@ -895,4 +1487,530 @@ adwithin_tpoint_tpoint(const Temporal *temp1, const Temporal *temp2,
   return ea_dwithin_tpoint_tpoint(temp1, temp2, dist, ALWAYS);
 }
 
+/*****************************************************************************
+ * Batch evaluation of dwithin between arrays of temporal points
+ *
+ * The candidate pairs are found with a plane sweep over the time spans of the
+ * bounding boxes of the temporal points, the boxes of the first array being
+ * expanded by the distance. Only the pairs whose boxes overlap in time and in
+ * space are evaluated segment by segment.
+ *****************************************************************************/
+
+/**
+ * @brief Structure for sorting the temporal points of an array by the start
+ * of their time span
+ */
+typedef struct
+{
+  TimestampTz t;      /**< Start of the time span */
+  int i;              /**< Position in the array */
+} TpointSweepElem;
+
+/**
+ * @brief Comparator function for the elements of a plane sweep
+ */
+static int
+tpoint_sweep_cmp(const TpointSweepElem *l, const TpointSweepElem *r)
+{
+  int cmp = timestamptz_cmp_internal(l->t, r->t);
+  if (cmp != 0)
+    return cmp;
+  return (l->i < r->i) ? -1 : ((l->i > r->i) ? 1 : 0);
+}
+
+/**
+ * @brief Candidate pair of a plane sweep
+ */
+typedef struct
+{
+  int i;              /**< Position in the first array */
+  int j;              /**< Position in the second array */
+  bool close;         /**< True when the boxes also overlap in space */
+} TpointSweepPair;
+
+/**
+ * @brief Comparator function for the candidate pairs of a plane sweep
+ */
+static int
+tpoint_sweep_pair_cmp(const TpointSweepPair *l, const TpointSweepPair *r)
+{
+  if (l->i != r->i)
+    return (l->i < r->i) ? -1 : 1;
+  return (l->j < r->j) ? -1 : ((l->j > r->j) ? 1 : 0);
+}
+
+/**
+ * @brief Return true if the spatial dimensions of two boxes overlap
+ */
+static bool
+tpoint_sweep_overlaps(const STBox *box1, const STBox *box2)
+{
+  if (box1->xmax < box2->xmin || box1->xmin > box2->xmax ||
+      box1->ymax < box2->ymin || box1->ymin > box2->ymax)
+    return false;
+  if (MEOS_FLAGS_GET_Z(box1->flags) && MEOS_FLAGS_GET_Z(box2->flags) &&
+      (box1->zmax < box2->zmin || box1->zmin > box2->zmax))
+    return false;
+  return true;
+}
+
+/**
+ * @brief Ensure the validity of two arrays of temporal points for a batch
+ * dwithin
+ */
+bool
+ensure_valid_tpointarr_tpointarr(const Temporal **temparr1, int count1,
+  const Temporal **temparr2, int count2, double dist)
+{
+  if (! ensure_not_null((void *) temparr1) ||
+      ! ensure_not_null((void *) temparr2) || ! ensure_positive(count1) ||
+      ! ensure_positive(count2) ||
+      ! ensure_not_negative_datum(Float8GetDatum(dist), T_FLOAT8))
+    return false;
+  for (int i = 0; i < count1; i++)
+    if (! ensure_valid_tpoint_tpoint(temparr1[0], temparr1[i]))
+      return false;
+  for (int i = 0; i < count2; i++)
+    if (! ensure_valid_tpoint_tpoint(temparr1[0], temparr2[i]))
+      return false;
+  return true;
+}
+
+/**
+ * @brief Return the pairs of temporal points of two arrays whose bounding
+ * boxes overlap in time
+ * @param[in] temparr1,temparr2 Arrays of temporal points
+ * @param[in] count1,count2 Number of elements in the arrays
+ * @param[in] dist Distance
+ * @param[out] close Array stating for each pair whether the boxes, the first
+ * one expanded by the distance, also overlap in space
+ * @param[out] count Number of pairs
+ * @result Array of positions in the first and the second array sorted in
+ * ascending order, with two elements per pair
+ * @note Only the pairs found are stored, so that the size of the result does
+ * not depend on the product of the sizes of the arrays
+ */
+int *
+tpointarr_dwithin_pairs(const Temporal **temparr1, int count1,
+  const Temporal **temparr2, int count2, double dist, bool **close,
+  size_t *count)
+{
+  STBox *boxes1 = palloc(sizeof(STBox) * count1);
+  STBox *boxes2 = palloc(sizeof(STBox) * count2);
+  TpointSweepElem *elems1 = palloc(sizeof(TpointSweepElem) * count1);
+  TpointSweepElem *elems2 = palloc(sizeof(TpointSweepElem) * count2);
+  for (int i = 0; i < count1; i++)
+  {
+    tspatial_set_stbox(temparr1[i], &boxes1[i]);
+    boxes1[i].xmin -= dist; boxes1[i].xmax += dist;
+    boxes1[i].ymin -= dist; boxes1[i].ymax += dist;
+    boxes1[i].zmin -= dist; boxes1[i].zmax += dist;
+    elems1[i].t = DatumGetTimestampTz(boxes1[i].period.lower);
+    elems1[i].i = i;
+  }
+  for (int i = 0; i < count2; i++)
+  {
+    tspatial_set_stbox(temparr2[i], &boxes2[i]);
+    elems2[i].t = DatumGetTimestampTz(boxes2[i].period.lower);
+    elems2[i].i = i;
+  }
+  qsort(elems1, (size_t) count1, sizeof(TpointSweepElem),
+    (qsort_comparator) &tpoint_sweep_cmp);
+  qsort(elems2, (size_t) count2, sizeof(TpointSweepElem),
+    (qsort_comparator) &tpoint_sweep_cmp);
+
+  /* Sweep the start of the time spans keeping the boxes that are active,
+   * that is, whose time span has not ended yet */
+  int *active1 = palloc(sizeof(int) * count1);
+  int *active2 = palloc(sizeof(int) * count2);
+  int nactive1 = 0, nactive2 = 0;
+  size_t maxpairs = (size_t) Max(count1, count2), npairs = 0;
+  TpointSweepPair *cand = palloc(sizeof(TpointSweepPair) * maxpairs);
+  int i = 0, j = 0;
+  while (i < count1 || j < count2)
+  {
+    bool first = (j == count2) ||
+      (i < count1 && elems1[i].t <= elems2[j].t);
+    int k = first ? elems1[i++].i : elems2[j++].i;
+    const STBox *box = first ? &boxes1[k] : &boxes2[k];
+    TimestampTz t = DatumGetTimestampTz(box->period.lower);
+    const STBox *others = first ? boxes2 : boxes1;
+    int *active = first ? active2 : active1;
+    int nactive = first ? nactive2 : nactive1;
+    int m = 0;
+    for (int l = 0; l < nactive; l++)
+    {
+      const STBox *other = &others[active[l]];
+      /* Remove the boxes whose time span ended */
+      if (DatumGetTimestampTz(other->period.upper) < t)
+        continue;
+      active[m++] = active[l];
+      if (npairs == maxpairs)
+      {
+        maxpairs *= 2;
+        cand = repalloc(cand, sizeof(TpointSweepPair) * maxpairs);
+      }
+      cand[npairs].i = first ? k : active[l];
+      cand[npairs].j = first ? active[l] : k;
+      cand[npairs++].close = tpoint_sweep_overlaps(box, other);
+    }
+    if (first)
+    {
+      nactive2 = m;
+      active1[nactive1++] = k;
+    }
+    else
+    {
+      nactive1 = m;
+      active2[nactive2++] = k;
+    }
+  }
+  pfree(boxes1); pfree(boxes2); pfree(elems1); pfree(elems2);
+  pfree(active1); pfree(active2);
+
+  /* Sort the pairs and split them into the output arrays */
+  qsort(cand, npairs, sizeof(TpointSweepPair),
+    (qsort_comparator) &tpoint_sweep_pair_cmp);
+  int *result = palloc(sizeof(int) * 2 * Max(npairs, 1));
+  bool *resclose = palloc(sizeof(bool) * Max(npairs, 1));
+  for (size_t l = 0; l < npairs; l++)
+  {
+    result[2 * l] = cand[l].i;
+    result[2 * l + 1] = cand[l].j;
+    resclose[l] = cand[l].close;
+  }
+  pfree(cand);
+  *close = resclose;
+  *count = npairs;
+  return result;
+}
+
+/**
+ * @ingroup meos_temporal_spatial_rel_ever
+ * @brief Return the pairs of temporal points of two arrays that are ever
+ * within a distance
+ * @details The candidate pairs are found with a plane sweep over the bounding
+ * boxes of the temporal points. The pairs whose boxes, the first one expanded
+ * by the distance, do not overlap in space are never within the distance.
+ * @param[in] temparr1,temparr2 Arrays of temporal points
+ * @param[in] count1,count2 Number of elements in the arrays
+ * @param[in] dist Distance
+ * @param[out] count Number of pairs
+ * @return Array of positions in the first and the second array sorted in
+ * ascending order, with two elements per pair, which is empty when there is
+ * no pair. On error return @p NULL
+ */
+int *
+edwithin_tpointarr_tpointarr(const Temporal **temparr1, int count1,
+  const Temporal **temparr2, int count2, double dist, size_t *count)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) count))
+    return NULL;
+  *count = 0;
+  if (! ensure_valid_tpointarr_tpointarr(temparr1, count1, temparr2, count2,
+        dist))
+    return NULL;
+
+  bool *close;
+  size_t npairs;
+  int *pairs = tpointarr_dwithin_pairs(temparr1, count1, temparr2, count2,
+    dist, &close, &npairs);
+  /* Keep in place the pairs that are ever within the distance */
+  size_t nresult = 0;
+  for (size_t i = 0; i < npairs; i++)
+  {
+    if (! close[i] || ea_dwithin_tpoint_tpoint(temparr1[pairs[2 * i]],
+          temparr2[pairs[2 * i + 1]], dist, EVER) != 1)
+      continue;
+    pairs[2 * nresult] = pairs[2 * i];
+    pairs[2 * nresult++ + 1] = pairs[2 * i + 1];
+  }
+  pfree(close);
+  *count = nresult;
+  return pairs;
+}
+
+/**
+ * @ingroup meos_temporal_spatial_rel_ever
+ * @brief Return the temporal points of an array that are ever within a
+ * distance of a temporal point
+ * @param[in] temp Temporal point
+ * @param[in] temparr Array of temporal points
+ * @param[in] count Number of elements in the array
+ * @param[in] dist Distance
+ * @param[out] newcount Number of elements in the result
+ * @return Array of positions in the array sorted in ascending order, which
+ * is empty when there is no temporal point within the distance. On error
+ * return @p NULL
+ * @see #edwithin_tpointarr_tpointarr
+ */
+int *
+edwithin_tpoint_tpointarr(const Temporal *temp, const Temporal **temparr,
+  int count, double dist, size_t *newcount)
+{
+  int *pairs = edwithin_tpointarr_tpointarr(&temp, 1, temparr, count, dist,
+    newcount);
+  if (! pairs)
+    return NULL;
+  int *result = palloc(sizeof(int) * Max(*newcount, 1));
+  for (size_t i = 0; i < *newcount; i++)
+    result[i] = pairs[2 * i + 1];
+  pfree(pairs);
+  return result;
+}
+
+/*****************************************************************************
+ * Spatiotemporal join of arrays of temporal points
+ *****************************************************************************/
+
+/**
+ * @brief Element of a partition-based join, that is, a temporal point
+ * assigned to a tile of the grid
+ */
+typedef struct
+{
+  int64 tile;         /**< Number of the tile */
+  int i;              /**< Position in the array */
+  bool first;         /**< True when the element belongs to the first array */
+} TpointJoinElem;
+
+/**
+ * @brief Comparator function for the elements of a partition-based join
+ */
+static int
+tpoint_join_elem_cmp(const TpointJoinElem *l, const TpointJoinElem *r)
+{
+  if (l->tile != r->tile)
+    return (l->tile < r->tile) ? -1 : 1;
+  if (l->first != r->first)
+    return l->first ? -1 : 1;
+  return (l->i < r->i) ? -1 : ((l->i > r->i) ? 1 : 0);
+}
+
+/**
+ * @brief Comparator function for the pairs of a partition-based join
+ */
+static int
+tpoint_join_pair_cmp(const int *l, const int *r)
+{
+  if (l[0] != r[0])
+    return (l[0] < r[0]) ? -1 : 1;
+  return (l[1] < r[1]) ? -1 : ((l[1] > r[1]) ? 1 : 0);
+}
+
+/**
+ * @brief Return the coordinates of the tile of the grid containing a point
+ * of the space-time
+ */
+static void
+tpoint_join_tile_coords(double x, double y, TimestampTz t,
+  const STboxGridState *state, int *coords)
+{
+  coords[0] = (int) floor((x - state->box.xmin) / state->xsize);
+  coords[0] = Max(0, Min(coords[0], state->max_coords[0]));
+  coords[1] = (int) floor((y - state->box.ymin) / state->ysize);
+  coords[1] = Max(0, Min(coords[1], state->max_coords[1]));
+  coords[2] = 0;
+  if (state->hast)
+  {
+    coords[2] = (int) ((t - DatumGetTimestampTz(state->box.period.lower)) /
+      state->tunits);
+    coords[2] = Max(0, Min(coords[2], state->max_coords[2]));
+  }
+  return;
+}
+
+/**
+ * @brief Return the number of a tile from its coordinates
+ */
+static inline int64
+tpoint_join_tile_num(const int *coords, const STboxGridState *state)
+{
+  return ((int64) coords[2] * (state->max_coords[1] + 1) + coords[1]) *
+    (state->max_coords[0] + 1) + coords[0];
+}
+
+/**
+ * @brief Append to an array the tiles of the grid intersecting a box
+ */
+static void
+tpoint_join_assign(const STBox *box, int i, bool first,
+  const STboxGridState *state, TpointJoinElem **elems, int *nelems,
+  int *maxelems)
+{
+  int lower[3], upper[3];
+  tpoint_join_tile_coords(box->xmin, box->ymin,
+    DatumGetTimestampTz(box->period.lower), state, lower);
+  tpoint_join_tile_coords(box->xmax, box->ymax,
+    DatumGetTimestampTz(box->period.upper), state, upper);
+  int coords[3];
+  for (coords[2] = lower[2]; coords[2] <= upper[2]; coords[2]++)
+  {
+    for (coords[1] = lower[1]; coords[1] <= upper[1]; coords[1]++)
+    {
+      for (coords[0] = lower[0]; coords[0] <= upper[0]; coords[0]++)
+      {
+        if (*nelems == *maxelems)
+        {
+          *maxelems *= 2;
+          *elems = repalloc(*elems, sizeof(TpointJoinElem) * *maxelems);
+        }
+        (*elems)[*nelems].tile = tpoint_join_tile_num(coords, state);
+        (*elems)[*nelems].i = i;
+        (*elems)[(*nelems)++].first = first;
+      }
+    }
+  }
+  return;
+}
+
+/**
+ * @ingroup meos_temporal_spatial_rel_ever
+ * @brief Return the pairs of temporal points of two arrays that are ever
+ * within a distance
+ * @details Both arrays are partitioned with a space-time grid, where the
+ * bounding boxes of the temporal points of the first array are expanded by
+ * the distance. Within each tile, the pairs whose boxes overlap are only
+ * considered in the tile containing the lower corner of the intersection of
+ * the boxes, so that every pair is evaluated once, and the exact predicate
+ * is then computed with #edwithin_tpoint_tpoint.
+ * @param[in] temparr1,temparr2 Arrays of temporal points
+ * @param[in] count1,count2 Number of elements in the arrays
+ * @param[in] dist Distance
+ * @param[in] xsize,ysize Size of the tiles for the spatial dimensions
+ * @param[in] duration Size of the tiles for the time dimension, may be
+ * @p NULL for a spatial only grid
+ * @param[out] tdwithin Optional array of temporal Booleans stating for each
+ * pair when the temporal points are within the distance
+ * @param[out] count Number of pairs
+ * @return Array of positions in the first and the second array sorted in
+ * ascending order, with two elements per pair. On error return @p NULL
+ * @note The resulting array is @p NULL when there is no pair
+ * @note The exact predicate is evaluated in the calling thread. MEOS keeps
+ * its error number and error handler in process-wide variables and, in
+ * MobilityDB, allocates memory in the contexts of the PostgreSQL backend,
+ * so neither can be shared by several threads. The join can be parallelized
+ * by calling it on disjoint parts of the first array from several processes.
+ */
+int *
+tpointarr_dwithin_join(const Temporal **temparr1, int count1,
+  const Temporal **temparr2, int count2, double dist, double xsize,
+  double ysize, const Interval *duration, Temporal ***tdwithin,
+  size_t *count)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_valid_tpointarr_tpointarr(temparr1, count1, temparr2, count2,
+        dist) || ! ensure_not_null((void *) count) ||
+      ! ensure_not_geodetic(temparr1[0]->flags) ||
+      ! ensure_positive_datum(Float8GetDatum(xsize), T_FLOAT8) ||
+      ! ensure_positive_datum(Float8GetDatum(ysize), T_FLOAT8) ||
+      (duration && ! ensure_valid_duration(duration)))
+    return NULL;
+
+  /* Compute the boxes and the extent of the grid */
+  STBox *boxes1 = palloc(sizeof(STBox) * count1);
+  STBox *boxes2 = palloc(sizeof(STBox) * count2);
+  STBox extent;
+  for (int i = 0; i < count1; i++)
+  {
+    tspatial_set_stbox(temparr1[i], &boxes1[i]);
+    boxes1[i].xmin -= dist; boxes1[i].xmax += dist;
+    boxes1[i].ymin -= dist; boxes1[i].ymax += dist;
+    boxes1[i].zmin -= dist; boxes1[i].zmax += dist;
+    if (i == 0)
+      memcpy(&extent, &boxes1[i], sizeof(STBox));
+    else
+      stbox_expand(&boxes1[i], &extent);
+  }
+  for (int i = 0; i < count2; i++)
+  {
+    tspatial_set_stbox(temparr2[i], &boxes2[i]);
+    stbox_expand(&boxes2[i], &extent);
+  }
+  POINT3DZ sorigin;
+  memset(&sorigin, 0, sizeof(POINT3DZ));
+  int64 tunits = duration ? interval_units(duration) : 0;
+  MEOS_FLAGS_SET_Z(extent.flags, false);
+  STboxGridState *state = stbox_tile_state_make(NULL, &extent, xsize, ysize,
+    0, tunits, sorigin, 0, true);
+
+  /* Assign the boxes to the tiles and sort them by tile */
+  int maxelems = count1 + count2, nelems = 0;
+  TpointJoinElem *elems = palloc(sizeof(TpointJoinElem) * maxelems);
+  for (int i = 0; i < count1; i++)
+    tpoint_join_assign(&boxes1[i], i, true, state, &elems, &nelems,
+      &maxelems);
+  for (int i = 0; i < count2; i++)
+    tpoint_join_assign(&boxes2[i], i, false, state, &elems, &nelems,
+      &maxelems);
+  qsort(elems, (size_t) nelems, sizeof(TpointJoinElem),
+    (qsort_comparator) &tpoint_join_elem_cmp);
+
+  /* Evaluate the pairs of each tile */
+  size_t maxpairs = 64, npairs = 0;
+  int *result = palloc(sizeof(int) * 2 * maxpairs);
+  int start = 0;
+  while (start < nelems)
+  {
+    int end = start, mid = start;
+    while (end < nelems && elems[end].tile == elems[start].tile)
+    {
+      if (elems[end].first)
+        mid = end + 1;
+      end++;
+    }
+    for (int k = start; k < mid; k++)
+    {
+      const STBox *box1 = &boxes1[elems[k].i];
+      for (int l = mid; l < end; l++)
+      {
+        const STBox *box2 = &boxes2[elems[l].i];
+        if (! tpoint_sweep_overlaps(box1, box2) ||
+            ! overlaps_span_span(&box1->period, &box2->period))
+          continue;
+        /* Reference point: lower corner of the intersection of the boxes */
+        int coords[3];
+        tpoint_join_tile_coords(Max(box1->xmin, box2->xmin),
+          Max(box1->ymin, box2->ymin),
+          Max(DatumGetTimestampTz(box1->period.lower),
+            DatumGetTimestampTz(box2->period.lower)), state, coords);
+        if (tpoint_join_tile_num(coords, state) != elems[start].tile)
+          continue;
+        if (ea_dwithin_tpoint_tpoint(temparr1[elems[k].i],
+              temparr2[elems[l].i], dist, EVER) != 1)
+          continue;
+        if (npairs == maxpairs)
+        {
+          maxpairs *= 2;
+          result = repalloc(result, sizeof(int) * 2 * maxpairs);
+        }
+        result[2 * npairs] = elems[k].i;
+        result[2 * npairs++ + 1] = elems[l].i;
+      }
+    }
+    start = end;
+  }
+  pfree(boxes1); pfree(boxes2); pfree(elems); pfree(state);
+
+  *count = npairs;
+  if (npairs == 0)
+  {
+    pfree(result);
+    if (tdwithin)
+      *tdwithin = NULL;
+    return NULL;
+  }
+  qsort(result, npairs, sizeof(int) * 2,
+    (qsort_comparator) &tpoint_join_pair_cmp);
+  if (tdwithin)
+  {
+    *tdwithin = palloc(sizeof(Temporal *) * npairs);
+    for (size_t i = 0; i < npairs; i++)
+      (*tdwithin)[i] = tdwithin_tpoint_tpoint(temparr1[result[2 * i]],
+        temparr2[result[2 * i + 1]], dist, false, false);
+  }
+  return result;
+}
+
 /*****************************************************************************/
@@ -178,78 +178,30 @@ tinterrel_tpointseq_discstep_geom(const TSequence *seq, Datum geom,
 }
 
 /**
- * @brief Evaluates tintersects/tdisjoint for a temporal point and a geometry
+ * @brief Return the array of temporal Boolean sequences of tintersects or
+ * tdisjoint for a temporal point sequence from the periods at which it
+ * intersects a geometry
  * @param[in] seq Temporal point
- * @param[in] geom Geometry
- * @param[in] box Bounding box of the geometry
+ * @param[in] periods Ordered array of disjoint periods, may be NULL
+ * @param[in] npers Number of periods
  * @param[in] tinter True when computing tintersects, false for tdisjoint
  * @param[out] count Number of elements in the resulting array
- * @pre The temporal point is simple, that is, non self-intersecting
+ * @note The array of periods is freed by the function
  */
 static TSequence **
-tinterrel_tpointseq_simple_geom(const TSequence *seq, Datum geom,
-  const STBox *box, bool tinter, int *count)
+tinterrel_tpointseq_periods(const TSequence *seq, Span *periods, int npers,
+  bool tinter, int *count)
 {
-  /* The temporal sequence has at least 2 instants since
-   * (1) the instantaneous full sequence test is done in the calling function
-   * (2) the simple components of a non self-intersecting sequence have at least
-   *     two instants */
-  assert(seq->count > 1);
   TSequence **result;
   /* Result depends on whether we are computing tintersects or tdisjoint */
   Datum datum_yes = tinter ? BoolGetDatum(true) : BoolGetDatum(false);
   Datum datum_no = tinter ? BoolGetDatum(false) : BoolGetDatum(true);
-
-  /* Bounding box test */
-  STBox *box1 = TSEQUENCE_BBOX_PTR(seq);
-  if (! overlaps_stbox_stbox(box1, box))
-  {
-    result = palloc(sizeof(TSequence *));
-    result[0] = tsequence_from_base_tstzspan(datum_no, T_TBOOL, &seq->period,
-      STEP);
-    *count = 1;
-    return result;
-  }
-
-  Datum traj = PointerGetDatum(tpointseq_trajectory(seq));
-  Datum inter = geom_intersection2d(traj, geom);
-  GSERIALIZED *gsinter = DatumGetGserializedP(inter);
-  if (gserialized_is_empty(gsinter))
-  {
-    result = palloc(sizeof(TSequence *));
-    result[0] = tsequence_from_base_tstzspan(datum_no, T_TBOOL, &seq->period,
-      STEP);
-    *count = 1;
-    pfree(DatumGetPointer(inter));
-    return result;
-  }
-
-  const TInstant *start = TSEQUENCE_INST_N(seq, 0);
-  const TInstant *end = TSEQUENCE_INST_N(seq, seq->count - 1);
-  /* If the trajectory is a point the result is true due to the
-   * non-empty intersection test above */
-  if (seq->count == 2 &&
-    datum_point_eq(tinstant_val(start), tinstant_val(end)))
-  {
-    result = palloc(sizeof(TSequence *));
-    result[0] = tsequence_from_base_tstzspan(datum_yes, T_TBOOL, &seq->period,
-      STEP);
-    *count = 1;
-    pfree(DatumGetPointer(inter));
-    PG_FREE_IF_COPY_P(gsinter, DatumGetPointer(inter));
-    return result;
-  }
-
-  /* Get the periods at which the temporal point intersects the geometry */
-  int npers;
-  Span *periods = tpointseq_interperiods(seq, gsinter, &npers);
   if (npers == 0)
   {
     result = palloc(sizeof(TSequence *));
     result[0] = tsequence_from_base_tstzspan(datum_no, T_TBOOL, &seq->period,
       STEP);
     *count = 1;
-    pfree(gsinter);
     return result;
   }
   SpanSet *ss;
@@ -282,22 +234,56 @@ tinterrel_tpointseq_simple_geom(const TSequence *seq, Datum geom,
   return result;
 }
 
+/**
+ * @brief Evaluates tintersects/tdisjoint for a temporal point and a geometry
+ * @param[in] seq Temporal point
+ * @param[in] geom Geometry
+ * @param[in] box Bounding box of the geometry
+ * @param[in] tiles Tiles of the geometry, may be NULL
+ * @param[in] tinter True when computing tintersects, false for tdisjoint
+ * @param[out] count Number of elements in the resulting array
+ * @pre The temporal point is simple, that is, non self-intersecting
+ */
+static TSequence **
+tinterrel_tpointseq_simple_geom(const TSequence *seq, Datum geom,
+  const STBox *box, GeoTiles *tiles, bool tinter, int *count)
+{
+  /* The temporal sequence has at least 2 instants since
+   * (1) the instantaneous full sequence test is done in the calling function
+   * (2) the simple components of a non self-intersecting sequence have at least
+   *     two instants */
+  assert(seq->count > 1);
+  /* Get the periods at which the temporal point intersects the geometry */
+  int npers = 0;
+  Span *periods = NULL;
+  /* Bounding box test */
+  if (overlaps_stbox_stbox(TSEQUENCE_BBOX_PTR(seq), box))
+    periods = tpointseq_geom_interperiods(seq, DatumGetGserializedP(geom),
+      tiles, &npers);
+  return tinterrel_tpointseq_periods(seq, periods, npers, tinter, count);
+}
+
 /**
  * @brief Evaluates tintersects/tdisjoint for a temporal point and a geometry
  * (iterator function)
- * @details The function splits the temporal point in an array of fragments
+ * @details For polygonal geometries, the periods at which the temporal point
+ * intersects the geometry are computed by #tpointseq_polygon_periods.
+ * Otherwise, the function splits the temporal point in an array of fragments
  * that are simple (that is, not self-intersecting) and loops for each
  * fragment.
  * @param[in] seq Temporal point
  * @param[in] geom Geometry
  * @param[in] box Bounding box of the geometry
+ * @param[in] pgeo Prepared geometry keeping the structures shared by the
+ * sequences of a temporal point
  * @param[in] tinter True when computing tintersects, false for tdisjoint
  * @param[in] func PostGIS function to be used for instantaneous sequences
  * @param[out] count Number of elements in the output array
  */
 static TSequence **
 tinterrel_tpointcontseq_geom_iter(const TSequence *seq, Datum geom,
-  const STBox *box, bool tinter, datum_func2 func, int *count)
+  const STBox *box, PreparedGeo *pgeo, bool tinter, datum_func2 func,
+  int *count)
 {
   /* Instantaneous sequence */
   if (seq->count == 1)
@@ -310,6 +296,19 @@ tinterrel_tpointcontseq_geom_iter(const TSequence *seq, Datum geom,
     return result;
   }
 
+  /* Polygonal geometries are handled without splitting the temporal point
+   * into simple fragments */
+  PolyIndex *idx = MEOS_FLAGS_LINEAR_INTERP(seq->flags) ?
+    prepgeo_polyindex(pgeo) : NULL;
+  if (idx)
+  {
+    int npers = 0;
+    Span *periods = NULL;
+    if (overlaps_stbox_stbox(TSEQUENCE_BBOX_PTR(seq), box))
+      periods = tpointseq_polygon_periods(seq, idx, &npers);
+    return tinterrel_tpointseq_periods(seq, periods, npers, tinter, count);
+  }
+
   /* Split the temporal point in an array of non self-intersecting temporal
    * points */
   int nsimple;
@@ -318,10 +317,12 @@ tinterrel_tpointcontseq_geom_iter(const TSequence *seq, Datum geom,
   /* palloc0 used to initialize the counters to 0 */
   int *countseqs = palloc0(sizeof(int) * nsimple);
   int totalcount = 0;
+  /* Geometries with many vertices are intersected tile by tile */
+  GeoTiles *tiles = prepgeo_tiles(pgeo);
   for (int i = 0; i < nsimple; i++)
   {
     sequences[i] = tinterrel_tpointseq_simple_geom(simpleseqs[i], geom, box,
-      tinter, &countseqs[i]);
+      tiles, tinter, &countseqs[i]);
     totalcount += countseqs[i];
   }
   *count = totalcount;
@@ -336,18 +337,19 @@ tinterrel_tpointcontseq_geom_iter(const TSequence *seq, Datum geom,
  * @param[in] seq Temporal point
  * @param[in] geom Geometry
  * @param[in] box Bounding box of the geometry
+ * @param[in] pgeo Prepared geometry
  * @param[in] func PostGIS function to be used for instantaneous sequences
  * @param[in] tinter True when computing tintersects, false for tdisjoint
  */
 TSequenceSet *
 tinterrel_tpointcontseq_geom(const TSequence *seq, Datum geom,
-  const STBox *box, bool tinter, datum_func2 func)
+  const STBox *box, PreparedGeo *pgeo, bool tinter, datum_func2 func)
 {
   /* Split the temporal point in an array of non self-intersecting
    * temporal points */
   int count;
   TSequence **sequences = tinterrel_tpointcontseq_geom_iter(seq, geom, box,
-    tinter, func, &count);
+    pgeo, tinter, func, &count);
   /* We are sure that count > 0 since the geometry is not empty */
   return tsequenceset_make_free(sequences, count, NORMALIZE);
 }
@@ -357,17 +359,18 @@ tinterrel_tpointcontseq_geom(const TSequence *seq, Datum geom,
  * @param[in] ss Temporal point
  * @param[in] geom Geometry
  * @param[in] box Bounding box of the geometry
+ * @param[in] pgeo Prepared geometry
  * @param[in] tinter True when computing tintersects, false for tdisjoint
  * @param[in] func PostGIS function to be used for instantaneous sequences
  */
 TSequenceSet *
 tinterrel_tpointseqset_geom(const TSequenceSet *ss, Datum geom,
-  const STBox *box, bool tinter, datum_func2 func)
+  const STBox *box, PreparedGeo *pgeo, bool tinter, datum_func2 func)
 {
   /* Singleton sequence set */
   if (ss->count == 1)
     return tinterrel_tpointcontseq_geom(TSEQUENCESET_SEQ_N(ss, 0), geom, box,
-      tinter, func);
+      pgeo, tinter, func);
 
   int totalcount;
   TSequence **allseqs;
@@ -390,7 +393,8 @@ tinterrel_tpointseqset_geom(const TSequenceSet *ss, Datum geom,
     for (int i = 0; i < ss->count; i++)
     {
       sequences[i] = tinterrel_tpointcontseq_geom_iter(
-        TSEQUENCESET_SEQ_N(ss, i), geom, box, tinter, func, &countseqs[i]);
+        TSEQUENCESET_SEQ_N(ss, i), geom, box, pgeo, tinter, func,
+        &countseqs[i]);
       totalcount += countseqs[i];
     }
     allseqs = tseqarr2_to_tseqarr(sequences, countseqs, ss->count, totalcount);
@@ -399,9 +403,14 @@ tinterrel_tpointseqset_geom(const TSequenceSet *ss, Datum geom,
 }
 
 /**
- * @brief Evaluates tintersects/tdisjoint for a temporal point and a geometry
+ * @brief Evaluates tintersects/tdisjoint for a temporal point and a prepared
+ * geometry
+ * @details The structures of the prepared geometry computed on demand, such
+ * as the edge index of a polygonal geometry, are shared by all the sequences
+ * of the temporal point and by the successive calls with the same prepared
+ * geometry.
  * @param[in] temp Temporal point
- * @param[in] gs Geometry
+ * @param[in] pgeo Prepared geometry
  * @param[in] tinter True when computing tintersects, false for tdisjoint
  * @param[in] restr True if the atValue function is applied to the result
  * @param[in] atvalue Value to be used for the atValue function
@@ -409,9 +418,10 @@ tinterrel_tpointseqset_geom(const TSequenceSet *ss, Datum geom,
  * provided by PostGIS
  */
 Temporal *
-tinterrel_tpoint_geo(const Temporal *temp, const GSERIALIZED *gs, bool tinter,
-  bool restr, bool atvalue)
+tinterrel_tpoint_prepgeo(const Temporal *temp, PreparedGeo *pgeo,
+  bool tinter, bool restr, bool atvalue)
 {
+  const GSERIALIZED *gs = pgeo->gs;
   /* Ensure validity of the arguments */
   if (! ensure_valid_tpoint_geo(temp, gs) || gserialized_is_empty(gs) ||
       ! ensure_has_not_Z_gs(gs) || ! ensure_has_not_Z(temp->flags))
@@ -451,11 +461,11 @@ tinterrel_tpoint_geo(const Temporal *temp, const GSERIALIZED *gs, bool tinter,
         (Temporal *) tinterrel_tpointseq_discstep_geom((TSequence *) temp,
           PointerGetDatum(gs), tinter, func) :
         (Temporal *) tinterrel_tpointcontseq_geom((TSequence *) temp,
-          PointerGetDatum(gs), &box2, tinter, func);
+          PointerGetDatum(gs), &box2, pgeo, tinter, func);
       break;
     default: /* TSEQUENCESET */
       result = (Temporal *) tinterrel_tpointseqset_geom((TSequenceSet *) temp,
-        PointerGetDatum(gs), &box2, tinter, func);
+        PointerGetDatum(gs), &box2, pgeo, tinter, func);
   }
   /* Restrict the result to the Boolean value in the third argument if any */
   if (result != NULL && restr)
@@ -467,6 +477,30 @@ tinterrel_tpoint_geo(const Temporal *temp, const GSERIALIZED *gs, bool tinter,
   return result;
 }
 
+/**
+ * @brief Evaluates tintersects/tdisjoint for a temporal point and a geometry
+ * @param[in] temp Temporal point
+ * @param[in] gs Geometry
+ * @param[in] tinter True when computing tintersects, false for tdisjoint
+ * @param[in] restr True if the atValue function is applied to the result
+ * @param[in] atvalue Value to be used for the atValue function
+ */
+Temporal *
+tinterrel_tpoint_geo(const Temporal *temp, const GSERIALIZED *gs, bool tinter,
+  bool restr, bool atvalue)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) gs))
+    return NULL;
+  /* The structures computed for the geometry are shared by the sequences */
+  PreparedGeo pgeo;
+  prepared_geo_init(&pgeo, gs);
+  Temporal *result = tinterrel_tpoint_prepgeo(temp, &pgeo, tinter, restr,
+    atvalue);
+  prepared_geo_reset(&pgeo);
+  return result;
+}
+
 #if MEOS
 /**
  * @ingroup meos_temporal_spatial_rel_temp
@@ -1409,4 +1443,151 @@ tdwithin_tpoint_tpoint(const Temporal *temp1, const Temporal *temp2,
   return result;
 }
 
+/**
+ * @brief Return a temporal Boolean that is false when both temporal points
+ * are defined, or @p NULL if they do not intersect in time
+ * @details This is the result of #tdwithin_tpoint_tpoint for two temporal
+ * points whose bounding boxes are farther apart than the distance, which is
+ * obtained without computing the distance between their segments. Discrete
+ * temporal points are synchronized instead, which does not add instants.
+ */
+static Temporal *
+tdwithin_tpoint_tpoint_false(const Temporal *temp1, const Temporal *temp2)
+{
+  if (temp1->subtype == TINSTANT || temp2->subtype == TINSTANT ||
+      MEOS_FLAGS_DISCRETE_INTERP(temp1->flags) ||
+      MEOS_FLAGS_DISCRETE_INTERP(temp2->flags))
+  {
+    Temporal *sync1, *sync2;
+    if (! intersection_temporal_temporal(temp1, temp2, SYNCHRONIZE_NOCROSS,
+        &sync1, &sync2))
+      return NULL;
+    Temporal *result = temporal_from_base_temp(BoolGetDatum(false), T_TBOOL,
+      sync1);
+    pfree(sync1); pfree(sync2);
+    return result;
+  }
+
+  /* Both temporal points are continuous */
+  SpanSet *ss1 = temporal_time(temp1);
+  SpanSet *ss2 = temporal_time(temp2);
+  SpanSet *inter = intersection_spanset_spanset(ss1, ss2);
+  pfree(ss1); pfree(ss2);
+  if (! inter)
+    return NULL;
+  Temporal *result = (inter->count == 1) ?
+    (Temporal *) tsequence_from_base_tstzspan(BoolGetDatum(false), T_TBOOL,
+      SPANSET_SP_N(inter, 0), STEP) :
+    (Temporal *) tsequenceset_from_base_tstzspanset(BoolGetDatum(false),
+      T_TBOOL, inter, STEP);
+  pfree(inter);
+  return result;
+}
+
+/**
+ * @ingroup meos_temporal_spatial_rel_temp
+ * @brief Return for the pairs of temporal points of two arrays that intersect
+ * in time a temporal Boolean that states whether they are within a distance
+ * @details The candidate pairs are found with a plane sweep over the bounding
+ * boxes of the temporal points. The pairs whose boxes, the first one expanded
+ * by the distance, do not overlap in space are never within the distance and
+ * their result is built without computing any distance.
+ * @param[in] temparr1,temparr2 Arrays of temporal points
+ * @param[in] count1,count2 Number of elements in the arrays
+ * @param[in] dist Distance
+ * @param[in] restr True when the result is restricted to a value
+ * @param[in] atvalue Value to restrict
+ * @param[out] pairs Array of positions in the first and the second array
+ * sorted in ascending order, with two elements per pair
+ * @param[out] count Number of pairs
+ * @return Array of temporal Booleans, one per pair, which is empty when there
+ * is no pair. On error return @p NULL
+ * @note The array of pairs is @p NULL when there is no pair
+ */
+Temporal **
+tdwithin_tpointarr_tpointarr(const Temporal **temparr1, int count1,
+  const Temporal **temparr2, int count2, double dist, bool restr,
+  bool atvalue, int **pairs, size_t *count)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) pairs) || ! ensure_not_null((void *) count))
+    return NULL;
+  *pairs = NULL;
+  *count = 0;
+  if (! ensure_valid_tpointarr_tpointarr(temparr1, count1, temparr2, count2,
+        dist))
+    return NULL;
+
+  bool *close;
+  size_t npairs;
+  int *cand = tpointarr_dwithin_pairs(temparr1, count1, temparr2, count2,
+    dist, &close, &npairs);
+  Temporal **result = palloc(sizeof(Temporal *) * Max(npairs, 1));
+  size_t nresult = 0;
+  for (size_t i = 0; i < npairs; i++)
+  {
+    /* The pairs that are far apart have no true value */
+    if (! close[i] && restr && atvalue)
+      continue;
+    Temporal *tdwithin = close[i] ?
+      tdwithin_tpoint_tpoint(temparr1[cand[2 * i]], temparr2[cand[2 * i + 1]],
+        dist, restr, atvalue) :
+      tdwithin_tpoint_tpoint_false(temparr1[cand[2 * i]],
+        temparr2[cand[2 * i + 1]]);
+    /* The pairs that do not intersect in time have no result */
+    if (! tdwithin)
+      continue;
+    cand[2 * nresult] = cand[2 * i];
+    cand[2 * nresult + 1] = cand[2 * i + 1];
+    result[nresult++] = tdwithin;
+  }
+  pfree(close);
+  *count = nresult;
+  if (nresult == 0)
+  {
+    pfree(cand);
+    return result;
+  }
+  *pairs = cand;
+  return result;
+}
+
+/**
+ * @ingroup meos_temporal_spatial_rel_temp
+ * @brief Return for the temporal points of an array that intersect in time a
+ * temporal point a temporal Boolean that states whether they are within a
+ * distance
+ * @param[in] temp Temporal point
+ * @param[in] temparr Array of temporal points
+ * @param[in] count Number of elements in the array
+ * @param[in] dist Distance
+ * @param[in] restr True when the result is restricted to a value
+ * @param[in] atvalue Value to restrict
+ * @param[out] pos Array of positions in the array sorted in ascending order,
+ * which is @p NULL when there is no element
+ * @param[out] newcount Number of elements in the result
+ * @return Array of temporal Booleans, which is empty when there is no
+ * element. On error return @p NULL
+ * @see #tdwithin_tpointarr_tpointarr
+ */
+Temporal **
+tdwithin_tpoint_tpointarr(const Temporal *temp, const Temporal **temparr,
+  int count, double dist, bool restr, bool atvalue, int **pos,
+  size_t *newcount)
+{
+  int *pairs;
+  if (! ensure_not_null((void *) pos))
+    return NULL;
+  *pos = NULL;
+  Temporal **result = tdwithin_tpointarr_tpointarr(&temp, 1, temparr, count,
+    dist, restr, atvalue, &pairs, newcount);
+  if (! result || *newcount == 0)
+    return result;
+  *pos = palloc(sizeof(int) * *newcount);
+  for (size_t i = 0; i < *newcount; i++)
+    (*pos)[i] = pairs[2 * i + 1];
+  pfree(pairs);
+  return result;
+}
+
 /*****************************************************************************/
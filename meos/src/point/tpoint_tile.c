@@ -44,237 +44,77 @@
 #include <meos.h>
 #include <meos_internal.h>
 #include "general/temporal.h"
+#include "general/temporal_restrict.h"
 #include "general/temporal_tile.h"
+#include "general/type_util.h"
 #include "point/stbox.h"
 #include "point/tpoint_spatialfuncs.h"
 #include "point/tpoint_tile.h"
 
 /*****************************************************************************
- * Bit Matrix implementation based on
- * https://www.pvladov.com/2012/05/bit-matrix-in-c-sharp.html
+ * N-dimensional version of the fast voxel traversal algorithm
+ * collecting all the tiles connecting the two given tiles.
+ *
+ * Amanatides, John, and Andrew Woo.
+ * "A fast voxel traversal algorithm for ray tracing."
+ * Eurographics. Vol. 87. No. 3. 1987.
  *****************************************************************************/
 
 /**
- * @brief Create a bit matrix
- */
-BitMatrix *
-bitmatrix_make(int *count, int ndims)
-{
-  /* Calculate the needed number of bits and bytes */
-  int i, bitCount = 1;
-  for (i = 0; i < ndims; i++)
-    bitCount *= count[i];
-  int byteCount = bitCount >> 3;
-  if (bitCount % 8 != 0)
-    byteCount++;
-  /* Allocate the needed number of bytes taking into account that there is
-   * already one byte allocated in the struct */
-  size_t size = sizeof(BitMatrix) + byteCount - 1;
-  /* palloc0 to set all bits to 0 */
-  BitMatrix *result = palloc0(size);
-  /* Fill the structure */
-  result->ndims = ndims;
-  for (i = 0; i < ndims; i++)
-    result->count[i] = count[i];
-  return result;
-}
-
-/**
- * @brief Get the value of the bit in the bit matrix
- */
-static bool
-bitmatrix_get(const BitMatrix *bm, int *coords)
-{
-  int i, j;
-  for (i = 0; i < bm->ndims; i++)
-    assert(coords[i] <= bm->count[i]);
-  int pos = 0;
-  for (i = 0; i < bm->ndims; i++)
-  {
-    int offset = coords[i];
-    for (j = i + 1; j < bm->ndims; j++)
-    {
-      offset *= bm->count[j];
-    }
-    pos += offset;
-  }
-  int index = pos % 8;
-  pos >>= 3;
-  return (bm->byte[pos] & (((uint8_t)1) << index)) != 0;
-}
-
-/**
- * @brief Set the value of the bit in the bit matrix
+ * @brief Append a segment traversing a tile to the sweep structure
  */
 static void
-bitmatrix_set_cell(BitMatrix *bm, int *coords, bool value)
-{
-  int i, j, pos = 0;
-  for (i = 0; i < bm->ndims; i++)
-    assert(coords[i] <= bm->count[i]);
-  for (i = 0; i < bm->ndims - 1; i++)
-  {
-    int offset = coords[i];
-    for (j = i + 1; j < bm->ndims; j++)
-      offset *= bm->count[j];
-    pos += offset;
-  }
-  pos += coords[bm->ndims - 1];
-  int index = pos % 8;
-  pos >>= 3;
-  bm->byte[pos] &= (unsigned char)(~(1 << index));
-  if (value)
-    bm->byte[pos] |= (uint8_t)(1 << index);
-  return;
-}
-
-#ifdef DEBUG_BUILD
-/**
- * @brief Print a 2D bit matrix
- * @note This function is only used for debugging purposes
- */
-void
-bitmatrix_print2D(const BitMatrix *bm, int *coords)
+tilesweep_add(TileSweep *sweep, int64 tile, int seqno, int segno)
 {
-  int i, j;
-  int dim = bm->ndims - 2;
-  /* Print the 2D matrix */
-  if (bm->count[dim + 1] / 10 > 0)
-  {
-    printf("\n      ");
-    for (j = 0; j < bm->count[dim + 1] / 10; j++)
-    {
-      printf("         %1d", j + 1);
-    }
-  }
-  printf("\n     ");
-  for (j = 0; j < bm->count[dim + 1]; j++)
-  {
-    printf("%1d", j % 10);
-  }
-  printf("\n-----");
-  for (j = 0; j < bm->count[dim + 1]; j++)
-    printf("-");
-  printf("\n");
-  for (i = 0; i < bm->count[dim + 0]; i++)
-  {
-    if (i / 10 > 0 && i % 10 == 0)
-      printf("%1d", i / 10);
-    else
-      printf(" ");
-    printf("%1d | ", i % 10);
-    coords[dim + 0] = i;
-    for (j = 0; j < bm->count[dim + 1]; j++)
-    {
-      coords[dim + 1] = j;
-      if (bitmatrix_get(bm, coords))
-        printf("1");
-      else
-        printf(".");
-    }
-    printf("\n");
-  }
-  printf("-----");
-  for (j = 0; j < bm->count[dim + 1]; j++)
-    printf("-");
-  if (bm->count[dim + 1] / 10 > 0)
+  if (sweep->count == sweep->size)
   {
-    printf("\n      ");
-    for (j = 0; j < bm->count[dim + 1] / 10; j++)
-    {
-      printf("         %1d", j + 1);
-    }
+    sweep->size *= 2;
+    sweep->segms = repalloc(sweep->segms, sizeof(TileSegm) * sweep->size);
   }
-  printf("\n     ");
-  for (j = 0; j < bm->count[dim + 1]; j++)
-    printf("%1d", j % 10);
-  printf("\n");
+  TileSegm *segm = &sweep->segms[sweep->count++];
+  segm->tile = tile;
+  segm->seqno = seqno;
+  segm->segno = segno;
   return;
 }
 
 /**
- * @brief Print the bit matrix
- * @note This function is only used for debugging purposes
+ * @brief Collect in the array of segments of the grid state a tile traversed
+ * by a segment of a temporal point
+ * @param[in] state Grid definition
+ * @param[in] coords Coordinates of the tile
+ * @param[in] seqno,segno Number of the sequence and of the segment
  */
-void
-bitmatrix_print(const BitMatrix *bm)
+static void
+tile_visit(STboxGridState *state, int *coords, int seqno, int segno)
 {
-  int i, j, k, l, coords[MAXDIMS];
-  memset(&coords, 0, sizeof(coords));
-  int totalcount = 1;
-  for (i = 0; i < bm->ndims; i++)
-    totalcount *= bm->count[i];
-  int count = 0;
-  for (i = 0; i < bm->count[0]; i++)
+  /* Compute the number of the tile in the order in which the grid is
+   * iterated, tiles outside of the grid are not considered */
+  int ndims = 2 + (state->hasz ? 1 : 0) + (state->hast ? 1 : 0);
+  int tile = 0;
+  for (int i = ndims - 1; i >= 0; i--)
   {
-    coords[0] = i;
-    for (j = 0; j < bm->count[1]; j++)
-    {
-      coords[1] = j;
-      if (bm->ndims >= 3)
-      {
-        for (k = 0; k < bm->count[2]; k++)
-        {
-          coords[2] = k;
-          if (bm->ndims >= 4)
-          {
-            for (l = 0; l < bm->count[3]; l++)
-            {
-              coords[3] = l;
-              if (bitmatrix_get(bm, coords))
-              {
-                printf("%d %d %d %d: %c\n", i, j, k, l, '1');
-                count++;
-              }
-            }
-          }
-          else
-          {
-            if (bitmatrix_get(bm, coords))
-            {
-              printf("%d %d %d: %c\n", i, j, k, '1');
-              count++;
-            }
-          }
-        }
-      }
-      else
-      {
-        if (bitmatrix_get(bm, coords))
-        {
-          printf("%d %d: %c\n", i, j, '1');
-          count++;
-        }
-      }
-    }
+    if (coords[i] < 0 || coords[i] >= state->max_coords[i])
+      return;
+    tile = tile * state->max_coords[i] + coords[i];
   }
-  printf("Total tiles: %d, Tiles set: %d\n", totalcount, count);
+  tilesweep_add(state->sweep, tile, seqno, segno);
   return;
 }
-#endif /* DEBUG_BUILD */
-
-/*****************************************************************************
- * N-dimensional version of the fast voxel traversal algorithm
- * setting in the bit array all the tiles connecting the two given tiles.
- *
- * Amanatides, John, and Andrew Woo.
- * "A fast voxel traversal algorithm for ray tracing."
- * Eurographics. Vol. 87. No. 3. 1987.
- *****************************************************************************/
 
 /**
- * @brief Set in the bit matrix the bits of the tiles connecting with a line
- * two input tiles
+ * @brief Mark the tiles connecting with a line two input tiles
  * @param[in] coords1, coords2 Coordinates of the input tiles
  * @param[in] eps1, eps2 Relative position of the points in the input tiles
  * @param[in] ndims Number of dimensions of the grid. It is either 2 (for 2D),
  * 3 (for 3D or 2D+T) or 4 (3D+T)
- * @param[out] bm Bit matrix
+ * @param[in] state Grid definition
+ * @param[in] seqno,segno Number of the sequence and of the segment
  * @result Number of tiles set
  */
 static int
-fastvoxel_bm(int *coords1, double *eps1, int *coords2, double *eps2,
-  int ndims, BitMatrix *bm)
+fastvoxel(int *coords1, double *eps1, int *coords2, double *eps2,
+  int ndims, STboxGridState *state, int seqno, int segno)
 {
   int i, k, coords[MAXDIMS], next[MAXDIMS], result = 0;
   double length, tMax[MAXDIMS], tDelta[MAXDIMS];
@@ -285,14 +125,14 @@ fastvoxel_bm(int *coords1, double *eps1, int *coords2, double *eps2,
   /* Shortcut function if the segment covers only 1 or 2 cells */
   if (k == 0)
   {
-    bitmatrix_set_cell(bm, coords1, true);
+    tile_visit(state, coords1, seqno, segno);
     result++;
     return result;
   }
   else if (k == 1)
   {
-    bitmatrix_set_cell(bm, coords1, true);
-    bitmatrix_set_cell(bm, coords2, true);
+    tile_visit(state, coords1, seqno, segno);
+    tile_visit(state, coords2, seqno, segno);
     result += 2;
     return result;
   }
@@ -325,9 +165,9 @@ fastvoxel_bm(int *coords1, double *eps1, int *coords2, double *eps2,
       tMax[i] = DBL_MAX;
     }
   }
-  /* Set the starting bitmap cell */
+  /* Collect the starting tile */
   memcpy(coords, coords1, sizeof(int) * ndims);
-  bitmatrix_set_cell(bm, coords, true);
+  tile_visit(state, coords, seqno, segno);
   result++;
   for (i = 0; i < k; ++i)
   {
@@ -341,8 +181,8 @@ fastvoxel_bm(int *coords1, double *eps1, int *coords2, double *eps2,
     /* Progress to the next cell in that dimension */
     tMax[idx] += tDelta[idx];
     coords[idx] += next[idx];
-    /* Set the bitmap cell */
-    bitmatrix_set_cell(bm, coords, true);
+    /* Collect the tile */
+    tile_visit(state, coords, seqno, segno);
     result++;
   }
   assert(memcmp(coords, coords2, sizeof(int) * ndims) == 0);
@@ -578,24 +418,31 @@ stbox_tile_state_get(STboxGridState *state, STBox *box)
 {
   if (! state || state->done)
     return false;
-  /* Get the box of the current tile.
-   * If there is a bit matrix for speeding up the computation, the while loop
-     finds the next tile that is set in the matrix, if any */
-  if (state->bm != NULL)
-  {
-    while (! bitmatrix_get(state->bm, state->coords))
-    {
-      stbox_tile_state_next(state);
-      if (state->done)
-        return false;
-    }
-  }
+  /* Get the box of the current tile */
   stbox_tile_set(state->x, state->y, state->z, state->t, state->xsize,
     state->ysize, state->zsize, state->tunits, state->hasz, state->hast,
     state->box.srid, box);
   return true;
 }
 
+/**
+ * @brief Free the state of a multidimensional grid
+ * @param[in] state State to free
+ */
+void
+stbox_tile_state_free(STboxGridState *state)
+{
+  if (state->sweep)
+  {
+    pfree(state->sweep->segms);
+    if (state->sweep->lower)
+      pfree(state->sweep->lower);
+    pfree(state->sweep);
+  }
+  pfree(state);
+  return;
+}
+
 #if MEOS
 /**
  * @ingroup meos_temporal_analytics_tile
@@ -691,8 +538,7 @@ stbox_tile_list(const STBox *bounds, double xsize, double ysize, double zsize,
     stbox_tile_state_next(state);
   }
   *count = count1;
-  if (state->bm) pfree(state->bm);
-  pfree(state);
+  stbox_tile_state_free(state);
   return result;
 }
 #endif /* MEOS */
@@ -850,43 +696,62 @@ tpointinst_get_coords_eps(const TInstant *inst, bool hasz, bool hast,
 }
 
 /**
- * @brief Set the bit corresponding to the tiles intersecting a temporal point
- * sequence
+ * @brief Collect the tiles intersecting a temporal point
+ * sequence with discrete or step interpolation
  * @param[in] seq Temporal point
+ * @param[in] seqno Number of the sequence
  * @param[in] hasz Whether the tile has Z dimension
  * @param[in] hast Whether the tile has T dimension
  * @param[in] state Grid definition
- * @param[out] bm Bit matrix
+ * @note The value of a segment with step interpolation is kept until the
+ * next instant, which may be located in a later time tile. The last instant
+ * of such a sequence is assigned to its last segment.
  */
 static int
-tpointseq_disc_set_tiles(const TSequence *seq, bool hasz, bool hast,
-  const STboxGridState *state, BitMatrix *bm)
+tpointseq_discstep_set_tiles(const TSequence *seq, int seqno, bool hasz,
+  bool hast, STboxGridState *state)
 {
+  bool step = (MEOS_FLAGS_GET_INTERP(seq->flags) == STEP);
+  int tdim = hasz ? 3 : 2;
   /* Transform the point into tile coordinates */
-  int coords[MAXDIMS], result = 0;
+  int coords[MAXDIMS], next[MAXDIMS], result = 0;
   memset(coords, 0, sizeof(coords));
+  memset(next, 0, sizeof(next));
   for (int i = 0; i < seq->count; i++)
   {
     tpointinst_get_coords_eps(TSEQUENCE_INST_N(seq, i), hasz, hast, state,
       coords, NULL);
-    bitmatrix_set_cell(bm, coords, true);
+    int segno = (step && i > 0 && i == seq->count - 1) ? i - 1 : i;
+    tile_visit(state, coords, seqno, segno);
     result++;
+    if (step && hast && i < seq->count - 1)
+    {
+      tpointinst_get_coords_eps(TSEQUENCE_INST_N(seq, i + 1), hasz, hast,
+        state, next, NULL);
+      int last = next[tdim];
+      for (int j = coords[tdim] + 1; j <= last; j++)
+      {
+        coords[tdim] = j;
+        tile_visit(state, coords, seqno, segno);
+        result++;
+      }
+    }
   }
   return result;
 }
 
 /**
- * @brief Set the bit corresponding to the tiles intersecting the temporal
- * point sequence
+ * @brief Collect the tiles intersecting the temporal
+ * point sequence with linear interpolation
  * @param[in] seq Temporal point
+ * @param[in] seqno Number of the sequence
  * @param[in] hasz Whether the tile has Z dimension
  * @param[in] hast Whether the tile has T dimension
  * @param[in] state Grid definition
- * @param[out] bm Bit matrix
  */
 static int
-tpointseq_cont_set_tiles(const TSequence *seq, bool hasz, bool hast,
-  const STboxGridState *state, BitMatrix *bm)
+tpointseq_cont_set_tiles(const TSequence *seq, int seqno, bool hasz,
+  bool hast, STboxGridState *state)
 {
   int ndims = 2 + (hasz ? 1 : 0) + (hast ? 1 : 0);
   int coords1[MAXDIMS], coords2[MAXDIMS], result = 0;
@@ -895,11 +760,18 @@ tpointseq_cont_set_tiles(const TSequence *seq, bool hasz, bool hast,
   memset(coords2, 0, sizeof(coords2));
   tpointinst_get_coords_eps(TSEQUENCE_INST_N(seq, 0), hasz, hast, state,
     coords1, eps1);
+  /* Instantaneous sequence */
+  if (seq->count == 1)
+  {
+    tile_visit(state, coords1, seqno, 0);
+    return 1;
+  }
   for (int i = 1; i < seq->count; i++)
   {
     tpointinst_get_coords_eps(TSEQUENCE_INST_N(seq, i), hasz, hast, state,
       coords2, eps2);
-    result += fastvoxel_bm(coords1, eps1, coords2, eps2, ndims, bm);
+    result += fastvoxel(coords1, eps1, coords2, eps2, ndims, state, seqno,
+      i - 1);
     memcpy(coords1, coords2, sizeof(coords1));
     memcpy(eps1, eps2, sizeof(eps1));
   }
@@ -907,63 +779,262 @@ tpointseq_cont_set_tiles(const TSequence *seq, bool hasz, bool hast,
 }
 
 /**
- * @brief Set the bit corresponding to the tiles intersecting the temporal
+ * @brief Collect the tiles intersecting the temporal
  * point sequence
  * @param[in] seq Temporal point
+ * @param[in] seqno Number of the sequence
  * @param[in] hasz Whether the tile has Z dimension
  * @param[in] hast Whether the tile has T dimension
  * @param[in] state Grid definition
- * @param[out] bm Bit matrix
  */
 static int
-tpointseq_set_tiles(const TSequence *seq, bool hasz, bool hast,
-  const STboxGridState *state, BitMatrix *bm)
+tpointseq_set_tiles(const TSequence *seq, int seqno, bool hasz, bool hast,
+  STboxGridState *state)
 {
   return MEOS_FLAGS_LINEAR_INTERP(seq->flags) ?
-    tpointseq_cont_set_tiles((TSequence *) seq, hasz, hast, state, bm) :
-    tpointseq_disc_set_tiles((TSequence *) seq, hasz, hast, state, bm);
+    tpointseq_cont_set_tiles(seq, seqno, hasz, hast, state) :
+    tpointseq_discstep_set_tiles(seq, seqno, hasz, hast, state);
 }
 
 /**
- * @brief Set the bit corresponding to the tiles intersecting a temporal point
+ * @brief Collect the tiles intersecting a temporal point
  * sequence set
  * @param[in] ss Temporal point
  * @param[in] hasz Whether the tile has Z dimension
  * @param[in] hast Whether the tile has T dimension
  * @param[in] state Grid definition
- * @param[out] bm Bit matrix
  */
 static int
 tpointseqset_set_tiles(const TSequenceSet *ss, bool hasz, bool hast,
-  const STboxGridState *state, BitMatrix *bm)
+  STboxGridState *state)
 {
   int result = 0;
   for (int i = 0; i < ss->count; i++)
-    result += tpointseq_set_tiles(TSEQUENCESET_SEQ_N(ss, i), hasz, hast, state,
-      bm);
+    result += tpointseq_set_tiles(TSEQUENCESET_SEQ_N(ss, i), i, hasz, hast,
+      state);
   return result;
 }
 
 /**
- * @brief Set the bit corresponding to the tiles intersecting a temporal point
+ * @brief Collect the tiles intersecting a temporal point
  * @param[in] temp Temporal point
  * @param[in] state Grid definition
- * @param[out] bm Bit matrix
  * @result Number of tiles set
  */
 int
-tpoint_set_tiles(const Temporal *temp, const STboxGridState *state,
-  BitMatrix *bm)
+tpoint_set_tiles(const Temporal *temp, STboxGridState *state)
 {
-  /* The usage of bitmatrix is disallowed for instantaneous temporal values */
+  /* The sweep is disallowed for instantaneous temporal values */
   assert(temporal_num_instants(temp) > 1);
   bool hasz = MEOS_FLAGS_GET_Z(state->box.flags);
   bool hast = (state->tunits > 0);
   assert(temp->subtype == TSEQUENCE || temp->subtype == TSEQUENCESET);
   if (temp->subtype == TSEQUENCE)
-    return tpointseq_set_tiles((TSequence *) temp, hasz, hast, state, bm);
+    return tpointseq_set_tiles((TSequence *) temp, 0, hasz, hast, state);
   else
-    return tpointseqset_set_tiles((TSequenceSet *) temp, hasz, hast, state, bm);
+    return tpointseqset_set_tiles((TSequenceSet *) temp, hasz, hast, state);
+}
+
+/*****************************************************************************
+ * Single-pass split of a temporal point
+ *
+ * Instead of restricting the whole temporal point to every tile of the grid,
+ * the tiles traversed by each segment of the temporal point are computed with
+ * the voxel traversal above and the pairs (tile, segment) are sorted by tile.
+ * The fragment of a tile is then obtained by restricting to the tile only the
+ * runs of consecutive segments traversing it, each run being extended with
+ * one segment at each side so that its bounds are located outside of the
+ * tile. The cost is thus proportional to the number of tiles traversed by
+ * each segment rather than to the number of tiles times the number of
+ * instants.
+ *****************************************************************************/
+
+/**
+ * @brief Comparator function for segments traversing a tile
+ */
+static int
+tilesegm_cmp(const TileSegm *l, const TileSegm *r)
+{
+  if (l->tile != r->tile)
+    return (l->tile < r->tile) ? -1 : 1;
+  if (l->seqno != r->seqno)
+    return (l->seqno < r->seqno) ? -1 : 1;
+  if (l->segno != r->segno)
+    return (l->segno < r->segno) ? -1 : 1;
+  return 0;
+}
+
+/**
+ * @brief Sort the segments of a sweep structure by tile and remove the
+ * duplicates
+ * @result Number of distinct tiles
+ */
+static int
+tilesweep_sort(TileSweep *sweep)
+{
+  qsort(sweep->segms, (size_t) sweep->count, sizeof(TileSegm),
+    (qsort_comparator) &tilesegm_cmp);
+  int count = 0, result = 0;
+  for (int i = 0; i < sweep->count; i++)
+  {
+    if (count > 0 && tilesegm_cmp(&sweep->segms[i],
+        &sweep->segms[count - 1]) == 0)
+      continue;
+    if (count == 0 || sweep->segms[i].tile != sweep->segms[count - 1].tile)
+      result++;
+    sweep->segms[count++] = sweep->segms[i];
+  }
+  sweep->count = count;
+  return result;
+}
+
+/**
+ * @brief Collect in the state the segments of a temporal point sorted by the
+ * tiles they traverse
+ * @param[in] temp Temporal point
+ * @param[in] state Grid definition
+ * @result Number of distinct tiles traversed by the temporal point
+ */
+static int
+tpoint_sweep_make(const Temporal *temp, STboxGridState *state)
+{
+  TileSweep *sweep = palloc0(sizeof(TileSweep));
+  sweep->size = Max(64, 2 * temporal_num_instants(temp));
+  sweep->segms = palloc(sizeof(TileSegm) * sweep->size);
+  state->sweep = sweep;
+  tpoint_set_tiles(temp, state);
+  int result = tilesweep_sort(sweep);
+
+  /* Compute the minimum values of the tiles in the spatial dimensions in the
+   * same way as when iterating the grid */
+  int nx = state->max_coords[0], ny = state->max_coords[1];
+  int nz = state->hasz ? state->max_coords[2] : 0;
+  sweep->lower = palloc(sizeof(double) * (nx + ny + nz));
+  double value = state->box.xmin;
+  for (int i = 0; i < nx; i++, value += state->xsize)
+    sweep->lower[i] = value;
+  value = state->box.ymin;
+  for (int i = 0; i < ny; i++, value += state->ysize)
+    sweep->lower[nx + i] = value;
+  value = state->box.zmin;
+  for (int i = 0; i < nz; i++, value += state->zsize)
+    sweep->lower[nx + ny + i] = value;
+  return result;
+}
+
+/**
+ * @brief Get the box of a tile from its number
+ */
+static void
+tpoint_sweep_tile_box(const STboxGridState *state, int tile, STBox *box)
+{
+  int ndims = 2 + (state->hasz ? 1 : 0) + (state->hast ? 1 : 0);
+  int coords[MAXDIMS];
+  for (int i = 0; i < ndims; i++)
+  {
+    coords[i] = tile % state->max_coords[i];
+    tile /= state->max_coords[i];
+  }
+  const double *lower = state->sweep->lower;
+  int nx = state->max_coords[0], ny = state->max_coords[1];
+  double z = state->hasz ? lower[nx + ny + coords[2]] : 0;
+  TimestampTz t = state->hast ?
+    DatumGetTimestampTz(state->box.period.lower) +
+      coords[ndims - 1] * state->tunits : 0;
+  stbox_tile_set(lower[coords[0]], lower[nx + coords[1]], z, t, state->xsize,
+    state->ysize, state->zsize, state->tunits, state->hasz, state->hast,
+    state->box.srid, box);
+  return;
+}
+
+/**
+ * @brief Return the fragment of a temporal point in a tile from the segments
+ * traversing the tile
+ * @param[in] temp Temporal point
+ * @param[in] segms Segments traversing the tile, sorted by sequence and
+ * segment number
+ * @param[in] count Number of segments
+ * @param[in] box Tile
+ */
+static Temporal *
+tpoint_sweep_tile(const Temporal *temp, const TileSegm *segms, int count,
+  const STBox *box)
+{
+  interpType interp = MEOS_FLAGS_GET_INTERP(temp->flags);
+  if (interp == DISCRETE)
+  {
+    /* Restrict the instants located in the tile */
+    const TSequence *seq = (const TSequence *) temp;
+    const TInstant **instants = palloc(sizeof(TInstant *) * count);
+    for (int i = 0; i < count; i++)
+      instants[i] = TSEQUENCE_INST_N(seq, segms[i].segno);
+    TSequence *sub = tsequence_make(instants, count, true, true, DISCRETE,
+      NORMALIZE_NO);
+    pfree(instants);
+    Temporal *result = tpoint_restrict_stbox((Temporal *) sub, box,
+      BORDER_EXC, REST_AT);
+    pfree(sub);
+    return result;
+  }
+
+  /* Restrict the runs of consecutive segments traversing the tile */
+  TSequenceSet **seqsets = palloc(sizeof(TSequenceSet *) * count);
+  int nseqsets = 0, totalseqs = 0;
+  int i = 0;
+  while (i < count)
+  {
+    int seqno = segms[i].seqno;
+    const TSequence *seq = (temp->subtype == TSEQUENCE) ?
+      (const TSequence *) temp :
+      TSEQUENCESET_SEQ_N((const TSequenceSet *) temp, seqno);
+    int nsegs = Max(seq->count - 1, 1);
+    int start = Max(segms[i].segno - 1, 0);
+    int end = Min(segms[i].segno + 1, nsegs - 1);
+    i++;
+    /* Merge the runs whose extension share an instant */
+    while (i < count && segms[i].seqno == seqno && segms[i].segno <= end + 2)
+    {
+      end = Min(segms[i].segno + 1, nsegs - 1);
+      i++;
+    }
+    TSequence *sub = (TSequence *) seq;
+    if (seq->count > 1 && (start > 0 || end < nsegs - 1))
+    {
+      const TInstant **instants = palloc(sizeof(TInstant *) *
+        (end - start + 2));
+      for (int j = start; j <= end + 1; j++)
+        instants[j - start] = TSEQUENCE_INST_N(seq, j);
+      sub = tsequence_make(instants, end - start + 2,
+        (start == 0) ? seq->period.lower_inc : true,
+        (end == nsegs - 1) ? seq->period.upper_inc : true, interp,
+        NORMALIZE_NO);
+      pfree(instants);
+    }
+    /* We can safely cast since the sequence is continuous */
+    TSequenceSet *res = (TSequenceSet *) tpoint_restrict_stbox(
+      (Temporal *) sub, box, BORDER_EXC, REST_AT);
+    if (sub != seq)
+      pfree(sub);
+    if (res)
+    {
+      seqsets[nseqsets++] = res;
+      totalseqs += res->count;
+    }
+  }
+  if (nseqsets == 0)
+  {
+    pfree(seqsets);
+    return NULL;
+  }
+  if (nseqsets == 1)
+  {
+    Temporal *result = (Temporal *) seqsets[0];
+    pfree(seqsets);
+    return result;
+  }
+  TSequenceSet *result = tseqsetarr_to_tseqset(seqsets, nseqsets, totalseqs);
+  pfree_array((void **) seqsets, nseqsets);
+  return (Temporal *) result;
 }
 
 /*****************************************************************************/
@@ -975,19 +1046,24 @@ tpoint_set_tiles(const Temporal *temp, const STboxGridState *state,
  * @param[in] duration Duration
  * @param[in] sorigin Origin for the space dimension
  * @param[in] torigin Origin for the time dimension
- * @param[in] bitmatrix True when using a bitmatrix to speed up the computation
+ * @param[in] bitmatrix True when the tiles traversed by the temporal point
+ * are computed beforehand to speed up the computation. The name of the
+ * parameter is kept for compatibility, no bit matrix is used.
  * @param[in] border_inc True when the box contains the upper border, otherwise
  * the upper border is assumed as outside of the box.
  * @param[out] ntiles Number of tiles
+ * @note When @p bitmatrix is true, the segments of the temporal point are
+ * sorted by the tiles they traverse so that the temporal point is split in a
+ * single pass by #tpoint_space_time_split_next
  */
 STboxGridState *
 tpoint_space_time_split_init(const Temporal *temp, float xsize, float ysize,
   float zsize, const Interval *duration, const GSERIALIZED *sorigin,
   TimestampTz torigin, bool bitmatrix, bool border_inc, int *ntiles)
 {
-  /* Disable the usage of bitmatrix for instantaneous temporal values */
+  /* Disable the sweep for instantaneous temporal values */
   if (temporal_num_instants(temp) == 1)
-      bitmatrix = false;
+    bitmatrix = false;
   /* Set bounding box */
   STBox bounds;
   temporal_set_bbox(temp, &bounds);
@@ -1039,19 +1115,62 @@ tpoint_space_time_split_init(const Temporal *temp, float xsize, float ysize,
   /* Create function state */
   STboxGridState *state = stbox_tile_state_make(temp, &bounds, xsize, ysize,
     zsize, tunits, pt, torigin, border_inc);
-  int ndims = 2 + (hasz ? 1 : 0) + (state->tunits ? 1 : 0);
-  /* If a bit matrix is used to speed up the process */
+  /* If the tiles traversed by the temporal point are used to speed up the
+   * process, collect the segments of the temporal point sorted by tile */
   if (bitmatrix)
-  {
-    /* Create the bit matrix and set the tiles traversed by the temporal point */
-    state->bm = bitmatrix_make(state->max_coords, ndims);
-    *ntiles = tpoint_set_tiles(temp, state, state->bm);
-  }
+    *ntiles = tpoint_sweep_make(temp, state);
   else
     *ntiles = state->ntiles;
   return state;
 }
 
+/**
+ * @brief Return the next fragment of a temporal point split according to a
+ * space and possibly a time grid, or NULL when all the tiles have been
+ * processed
+ * @param[in] state Grid definition
+ * @param[out] box Tile of the fragment
+ */
+Temporal *
+tpoint_space_time_split_next(STboxGridState *state, STBox *box)
+{
+  TileSweep *sweep = state->sweep;
+  if (sweep)
+  {
+    /* Loop since the restriction to a tile traversed by the temporal point
+     * may be NULL, e.g., when it only touches its upper border */
+    while (sweep->i < sweep->count)
+    {
+      int first = sweep->i, last = first + 1;
+      int64 tile = sweep->segms[first].tile;
+      while (last < sweep->count && sweep->segms[last].tile == tile)
+        last++;
+      sweep->i = last;
+      tpoint_sweep_tile_box(state, (int) tile, box);
+      Temporal *result = tpoint_sweep_tile(state->temp, &sweep->segms[first],
+        last - first, box);
+      if (result)
+        return result;
+    }
+    return NULL;
+  }
+
+  /* We need to loop since atStbox may be NULL */
+  while (! state->done)
+  {
+    /* Get current tile (if any) and advance state */
+    if (! stbox_tile_state_get(state, box))
+      return NULL;
+    stbox_tile_state_next(state);
+    /* Restrict the temporal point to the box */
+    Temporal *result = tpoint_restrict_stbox(state->temp, box, BORDER_EXC,
+      REST_AT);
+    if (result)
+      return result;
+  }
+  return NULL;
+}
+
 #if MEOS
 /**
  * @ingroup meos_temporal_analytics_tile
@@ -1060,7 +1179,9 @@ tpoint_space_time_split_init(const Temporal *temp, float xsize, float ysize,
  * @param[in] temp Temporal point
  * @param[in] xsize,ysize,zsize Size of the corresponding dimension
  * @param[in] sorigin Origin for the space dimension
- * @param[in] bitmatrix True when using a bitmatrix to speed up the computation
+ * @param[in] bitmatrix True when the tiles traversed by the temporal point
+ * are computed beforehand to speed up the computation. The name of the
+ * parameter is kept for compatibility, no bit matrix is used.
  * @param[in] border_inc True when the box contains the upper border, otherwise
  * the upper border is assumed as outside of the box.
  * @param[out] space_buckets Array of space buckets
@@ -1084,7 +1205,9 @@ tpoint_space_split(const Temporal *temp, float xsize, float ysize, float zsize,
  * @param[in] duration Duration
  * @param[in] sorigin Origin for the space dimension
  * @param[in] torigin Origin for the time dimension
- * @param[in] bitmatrix True when using a bitmatrix to speed up the computation
+ * @param[in] bitmatrix True when the tiles traversed by the temporal point
+ * are computed beforehand to speed up the computation. The name of the
+ * parameter is kept for compatibility, no bit matrix is used.
  * @param[in] border_inc True when the box contains the upper border, otherwise
  * the upper border is assumed as outside of the box.
  * @param[out] space_buckets Array of space buckets
@@ -1114,38 +1237,10 @@ tpoint_space_time_split(const Temporal *temp, float xsize, float ysize, float zs
   Temporal **result = palloc(sizeof(Temporal *) * ntiles);
   bool hasz = MEOS_FLAGS_GET_Z(state->temp->flags);
   int i = 0;
-  /* We need to loop since atStbox may be NULL */
-  while (true)
+  STBox box;
+  Temporal *atstbox;
+  while ((atstbox = tpoint_space_time_split_next(state, &box)) != NULL)
   {
-    /* Stop when we have used up all the grid tiles */
-    if (state->done)
-    {
-      if (state->bm)
-        pfree(state->bm);
-      pfree(state);
-      break;
-    }
-
-    /* Get current tile (if any) and advance state
-     * It is necessary to test if we found a tile since the previous tile
-     * may be the last one set in the associated bit matrix */
-    STBox box;
-    bool found = stbox_tile_state_get(state, &box);
-    if (! found)
-    {
-      if (state->bm)
-        pfree(state->bm);
-      pfree(state);
-      break;
-    }
-    stbox_tile_state_next(state);
-
-    /* Restrict the temporal point to the box */
-    Temporal *atstbox = tpoint_restrict_stbox(state->temp, &box, BORDER_EXC,
-      REST_AT);
-    if (atstbox == NULL)
-      continue;
-
     /* Construct value of the result */
     spaces[i] = geopoint_make(box.xmin, box.ymin, box.zmin, hasz, false,
       box.srid);
@@ -1153,6 +1248,7 @@ tpoint_space_time_split(const Temporal *temp, float xsize, float ysize, float zs
       times[i] = DatumGetTimestampTz(box.period.lower);
     result[i++] = atstbox;
   }
+  stbox_tile_state_free(state);
   *count = i;
   if (space_buckets)
     *space_buckets = spaces;
@@ -1162,4 +1258,955 @@ tpoint_space_time_split(const Temporal *temp, float xsize, float ysize, float zs
 }
 #endif /* MEOS */
 
+/*****************************************************************************
+ * Aggregation of arrays of temporal points by tiles
+ *****************************************************************************/
+
+/**
+ * @brief Fragment of a temporal point in a tile, used for aggregating an
+ * array of temporal points by tiles
+ */
+typedef struct
+{
+  int64 tile;         /**< Number of the tile in the grid of the extent */
+  int64 duration;     /**< Duration of the fragment in microseconds */
+  double distance;    /**< Distance traversed by the fragment */
+  STBox box;          /**< Tile */
+} TileFrag;
+
+/**
+ * @brief Comparator function for the fragments of temporal points in tiles
+ */
+static int
+tilefrag_cmp(const TileFrag *l, const TileFrag *r)
+{
+  return (l->tile < r->tile) ? -1 : ((l->tile > r->tile) ? 1 : 0);
+}
+
+/**
+ * @brief Return the duration in microseconds of a temporal point without
+ * taking into account the gaps, or 0 for discrete interpolation
+ */
+static int64
+tpoint_duration_usecs(const Temporal *temp)
+{
+  if (temp->subtype == TINSTANT || MEOS_FLAGS_DISCRETE_INTERP(temp->flags))
+    return 0;
+  if (temp->subtype == TSEQUENCE)
+    return DatumGetTimestampTz(((TSequence *) temp)->period.upper) -
+      DatumGetTimestampTz(((TSequence *) temp)->period.lower);
+  const TSequenceSet *ss = (const TSequenceSet *) temp;
+  int64 result = 0;
+  for (int i = 0; i < ss->count; i++)
+  {
+    const TSequence *seq = TSEQUENCESET_SEQ_N(ss, i);
+    result += DatumGetTimestampTz(seq->period.upper) -
+      DatumGetTimestampTz(seq->period.lower);
+  }
+  return result;
+}
+
+/**
+ * @brief Return the number of a tile in the grid of the extent
+ * @param[in] box Tile
+ * @param[in] state Grid of the extent
+ */
+static int64
+tile_agg_num(const STBox *box, const STboxGridState *state)
+{
+  int64 x = (int64) lround((box->xmin - state->box.xmin) / state->xsize);
+  int64 y = (int64) lround((box->ymin - state->box.ymin) / state->ysize);
+  int64 t = 0;
+  if (state->hast)
+    t = (DatumGetTimestampTz(box->period.lower) -
+      DatumGetTimestampTz(state->box.period.lower)) / state->tunits;
+  return (t * (state->max_coords[1] + 1) + y) * (state->max_coords[0] + 1) +
+    x;
+}
+
+/**
+ * @ingroup meos_temporal_analytics_tile
+ * @brief Return the aggregate values of an array of temporal points split
+ * according to a space and possibly a time grid
+ * @details Each temporal point is split in a single pass by the tiles it
+ * traverses, and the partial aggregates of its fragments are sorted by tile
+ * and merged at the end. For every tile traversed by at least one temporal
+ * point, the result contains the number of temporal points traversing it,
+ * the total duration and distance of their fragments, and the average speed
+ * in units per second, that is, the total distance divided by the total
+ * duration.
+ * @param[in] temparr Array of temporal points
+ * @param[in] count Number of elements in the array
+ * @param[in] xsize,ysize Size of the spatial dimensions
+ * @param[in] duration Size of the time dimension, may be @p NULL for a
+ * spatial only grid
+ * @param[in] sorigin Origin for the space dimension
+ * @param[in] torigin Origin for the time dimension
+ * @param[out] ntiles Number of elements in the output array
+ * @return Array of aggregate values sorted by tile, where the tiles of the
+ * same time bucket are consecutive. On error return @p NULL
+ * @note The temporal points of the array are assumed to be distinct objects.
+ * Only the X and Y dimensions are tiled for temporal points with Z dimension.
+ * The tiles containing the upper bounds of the extent are included, so that a
+ * fragment reduced to an instant on the upper border of a tile is counted in
+ * the next tile with a zero duration and distance.
+ * @note The temporal points are processed in the calling thread rather than
+ * by a pool of workers with partial grids, for the reason given in
+ * #tpointarr_dwithin_join. Sorting the partial aggregates keeps the memory
+ * proportional to the number of tiles traversed.
+ * @csqlfn #Tpointarr_tile_agg()
+ */
+TileAgg *
+tpointarr_tile_agg(const Temporal **temparr, int count, double xsize,
+  double ysize, const Interval *duration, const GSERIALIZED *sorigin,
+  TimestampTz torigin, int *ntiles)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) temparr) || ! ensure_positive(count) ||
+      ! ensure_not_null((void *) sorigin) || ! ensure_not_null((void *) ntiles))
+    return NULL;
+  for (int i = 0; i < count; i++)
+    if (! ensure_valid_tpoint_tpoint(temparr[0], temparr[i]))
+      return NULL;
+  if (! ensure_positive_datum(Float8GetDatum(xsize), T_FLOAT8) ||
+      ! ensure_positive_datum(Float8GetDatum(ysize), T_FLOAT8) ||
+      ! ensure_not_empty(sorigin) || ! ensure_point_type(sorigin) ||
+      ! ensure_same_geodetic(temparr[0]->flags, sorigin->gflags) ||
+      (duration && ! ensure_valid_duration(duration)))
+    return NULL;
+  int32 gs_srid = gserialized_get_srid(sorigin);
+  if (gs_srid != SRID_UNKNOWN &&
+      ! ensure_same_srid(tpoint_srid(temparr[0]), gs_srid))
+    return NULL;
+
+  POINT3DZ pt;
+  memset(&pt, 0, sizeof(POINT3DZ));
+  const POINT2D *p2d = GSERIALIZED_POINT2D_P(sorigin);
+  pt.x = p2d->x;
+  pt.y = p2d->y;
+  int64 tunits = duration ? interval_units(duration) : 0;
+
+  /* Compute the grid of the extent for numbering the tiles */
+  STBox extent, bounds;
+  for (int i = 0; i < count; i++)
+  {
+    tspatial_set_stbox(temparr[i], &bounds);
+    if (i == 0)
+      memcpy(&extent, &bounds, sizeof(STBox));
+    else
+      stbox_expand(&bounds, &extent);
+  }
+  if (! tunits)
+    MEOS_FLAGS_SET_T(extent.flags, false);
+  STboxGridState *grid = stbox_tile_state_make(NULL, &extent, xsize, ysize,
+    0, tunits, pt, torigin, true);
+
+  /* Split each temporal point and collect the partial aggregates */
+  int maxfrags = 64, nfrags = 0;
+  TileFrag *frags = palloc(sizeof(TileFrag) * maxfrags);
+  for (int i = 0; i < count; i++)
+  {
+    tspatial_set_stbox(temparr[i], &bounds);
+    if (! tunits)
+      MEOS_FLAGS_SET_T(bounds.flags, false);
+    STboxGridState *state = stbox_tile_state_make(temparr[i], &bounds, xsize,
+      ysize, 0, tunits, pt, torigin, true);
+    if (temporal_num_instants(temparr[i]) > 1)
+      tpoint_sweep_make(temparr[i], state);
+    STBox box;
+    Temporal *frag;
+    while ((frag = tpoint_space_time_split_next(state, &box)) != NULL)
+    {
+      if (nfrags == maxfrags)
+      {
+        maxfrags *= 2;
+        frags = repalloc(frags, sizeof(TileFrag) * maxfrags);
+      }
+      frags[nfrags].tile = tile_agg_num(&box, grid);
+      frags[nfrags].duration = tpoint_duration_usecs(frag);
+      frags[nfrags].distance = tpoint_length(frag);
+      frags[nfrags++].box = box;
+      pfree(frag);
+    }
+    stbox_tile_state_free(state);
+  }
+  stbox_tile_state_free(grid);
+
+  /* Merge the partial aggregates of each tile */
+  qsort(frags, (size_t) nfrags, sizeof(TileFrag),
+    (qsort_comparator) &tilefrag_cmp);
+  TileAgg *result = palloc0(sizeof(TileAgg) * Max(nfrags, 1));
+  int k = 0, start = 0;
+  while (start < nfrags)
+  {
+    int64 usecs = 0;
+    double distance = 0.0;
+    int end = start;
+    while (end < nfrags && frags[end].tile == frags[start].tile)
+    {
+      usecs += frags[end].duration;
+      distance += frags[end].distance;
+      end++;
+    }
+    result[k].box = frags[start].box;
+    result[k].count = end - start;
+    Interval *interv = minus_timestamptz_timestamptz((TimestampTz) usecs, 0);
+    result[k].duration = *interv;
+    pfree(interv);
+    result[k].distance = distance;
+    result[k++].speed = usecs ? distance / ((double) usecs / USECS_PER_SEC) :
+      0.0;
+    start = end;
+  }
+  pfree(frags);
+  *ntiles = k;
+  return result;
+}
+
+/*****************************************************************************/
+
+/*****************************************************************************
+ * Quadtree grids
+ *
+ * A quadtree grid recursively divides a root box into four quadrants. The
+ * cells of a level are encoded as 64-bit integers composed of the level in
+ * the 5 most significant bits (after the sign bit) and the Morton code of
+ * the column and row of the cell, so that the cells of a level sort in
+ * Z-order and the identifier of the parent cell is obtained by shifting.
+ *****************************************************************************/
+
+/**
+ * @brief Return the Morton code of a column and a row
+ */
+static uint64
+morton_encode(uint32 x, uint32 y)
+{
+  uint64 result = 0;
+  for (int i = 0; i < QUADCELL_MAX_LEVEL; i++)
+  {
+    result |= (uint64) ((x >> i) & 1) << (2 * i);
+    result |= (uint64) ((y >> i) & 1) << (2 * i + 1);
+  }
+  return result;
+}
+
+/**
+ * @brief Return the column and the row of a Morton code
+ */
+static void
+morton_decode(uint64 code, uint32 *x, uint32 *y)
+{
+  *x = *y = 0;
+  for (int i = 0; i < QUADCELL_MAX_LEVEL; i++)
+  {
+    *x |= (uint32) ((code >> (2 * i)) & 1) << i;
+    *y |= (uint32) ((code >> (2 * i + 1)) & 1) << i;
+  }
+  return;
+}
+
+/**
+ * @brief Return the identifier of a quadtree cell from its level, column,
+ * and row
+ */
+static inline int64
+quadcell_make(int level, uint32 x, uint32 y)
+{
+  return (int64) (((uint64) level << QUADCELL_LEVEL_SHIFT) |
+    morton_encode(x, y));
+}
+
+/**
+ * @brief Return true if the level of a quadtree cell is valid, otherwise
+ * raise an error
+ */
+static bool
+ensure_valid_quadcell_level(int level)
+{
+  if (level < 0 || level > QUADCELL_MAX_LEVEL)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "The level of a quadtree cell must be between 0 and %d",
+      QUADCELL_MAX_LEVEL);
+    return false;
+  }
+  return true;
+}
+
+/**
+ * @brief Return true if a box can be used as the root of a quadtree grid,
+ * otherwise raise an error
+ */
+static bool
+ensure_valid_quadcell_bounds(const STBox *bounds)
+{
+  if (! ensure_not_null((void *) bounds) || ! ensure_has_X_stbox(bounds) ||
+      ! ensure_not_geodetic(bounds->flags))
+    return false;
+  if (bounds->xmin >= bounds->xmax || bounds->ymin >= bounds->ymax)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "The bounds of a quadtree grid must have a positive width and height");
+    return false;
+  }
+  return true;
+}
+
+/**
+ * @ingroup meos_temporal_analytics_tile
+ * @brief Return the identifier of the quadtree cell of a level containing a
+ * point
+ * @param[in] gs Point
+ * @param[in] bounds Root of the quadtree, whose upper borders are excluded
+ * @param[in] level Level of the cell
+ * @return On error return -1
+ */
+int64
+geo_quadcell(const GSERIALIZED *gs, const STBox *bounds, int level)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) gs) || ! ensure_not_empty(gs) ||
+      ! ensure_point_type(gs) || ! ensure_valid_quadcell_bounds(bounds) ||
+      ! ensure_valid_quadcell_level(level) ||
+      ! ensure_same_srid_stbox_gs(bounds, gs))
+    return -1;
+
+  const POINT2D *p = GSERIALIZED_POINT2D_P(gs);
+  if (p->x < bounds->xmin || p->x >= bounds->xmax ||
+      p->y < bounds->ymin || p->y >= bounds->ymax)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "The point must be located in the bounds of the quadtree grid");
+    return -1;
+  }
+  uint32 n = (uint32) 1 << level;
+  uint32 x = (uint32) ((p->x - bounds->xmin) / (bounds->xmax - bounds->xmin) *
+    n);
+  uint32 y = (uint32) ((p->y - bounds->ymin) / (bounds->ymax - bounds->ymin) *
+    n);
+  return quadcell_make(level, Min(x, n - 1), Min(y, n - 1));
+}
+
+/**
+ * @ingroup meos_temporal_analytics_tile
+ * @brief Return the box of a quadtree cell
+ * @param[in] cell Identifier of the cell
+ * @param[in] bounds Root of the quadtree
+ * @return On error return @p NULL
+ */
+STBox *
+quadcell_stbox(int64 cell, const STBox *bounds)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_valid_quadcell_bounds(bounds) ||
+      ! ensure_not_negative(cell >> QUADCELL_LEVEL_SHIFT) ||
+      ! ensure_valid_quadcell_level((int) (cell >> QUADCELL_LEVEL_SHIFT)))
+    return NULL;
+
+  int level = (int) (cell >> QUADCELL_LEVEL_SHIFT);
+  uint32 x, y;
+  morton_decode((uint64) cell & QUADCELL_CODE_MASK, &x, &y);
+  uint32 n = (uint32) 1 << level;
+  if (x >= n || y >= n)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "Invalid identifier of a quadtree cell: " INT64_FORMAT, cell);
+    return NULL;
+  }
+  double xsize = (bounds->xmax - bounds->xmin) / n;
+  double ysize = (bounds->ymax - bounds->ymin) / n;
+  return stbox_make(true, false, false, bounds->srid,
+    bounds->xmin + x * xsize, bounds->xmin + (x + 1) * xsize,
+    bounds->ymin + y * ysize, bounds->ymin + (y + 1) * ysize, 0, 0, NULL);
+}
+
+/**
+ * @ingroup meos_temporal_analytics_tile
+ * @brief Return the identifier of the ancestor of a quadtree cell at a level
+ * @param[in] cell Identifier of the cell
+ * @param[in] level Level of the ancestor, which must not be greater than the
+ * level of the cell
+ * @return On error return -1
+ */
+int64
+quadcell_parent(int64 cell, int level)
+{
+  int cell_level = (int) (cell >> QUADCELL_LEVEL_SHIFT);
+  /* Ensure validity of the arguments */
+  if (! ensure_not_negative(cell_level) ||
+      ! ensure_valid_quadcell_level(cell_level) ||
+      ! ensure_valid_quadcell_level(level))
+    return -1;
+  if (level > cell_level)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "The level of the parent must not be greater than the one of the cell");
+    return -1;
+  }
+  uint64 code = ((uint64) cell & QUADCELL_CODE_MASK) >>
+    (2 * (cell_level - level));
+  return (int64) (((uint64) level << QUADCELL_LEVEL_SHIFT) | code);
+}
+
+/**
+ * @ingroup meos_temporal_analytics_tile
+ * @brief Return the fragments of a temporal point split according to the
+ * cells of a level of a quadtree grid
+ * @details The cells of a level form a regular grid aligned with the root,
+ * the temporal point is thus split in a single pass with the same traversal
+ * as #tpoint_space_split.
+ * @param[in] temp Temporal point
+ * @param[in] bounds Root of the quadtree, whose upper borders are excluded
+ * @param[in] level Level of the cells
+ * @param[out] cells Array of cell identifiers
+ * @param[out] count Number of elements in the output arrays
+ * @return On error return @p NULL
+ */
+Temporal **
+tpoint_quad_split(const Temporal *temp, const STBox *bounds, int level,
+  int64 **cells, int *count)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) temp) || ! ensure_not_null((void *) cells) ||
+      ! ensure_not_null((void *) count) ||
+      ! ensure_tgeo_type(temp->temptype) ||
+      ! ensure_valid_quadcell_bounds(bounds) ||
+      ! ensure_valid_quadcell_level(level) ||
+      ! ensure_same_srid(tpoint_srid(temp), bounds->srid))
+    return NULL;
+  STBox box;
+  tspatial_set_stbox(temp, &box);
+  if (box.xmin < bounds->xmin || box.xmax >= bounds->xmax ||
+      box.ymin < bounds->ymin || box.ymax >= bounds->ymax)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "The temporal point must be located in the bounds of the quadtree grid");
+    return NULL;
+  }
+
+  /* Split the temporal point with the grid of the level */
+  uint32 n = (uint32) 1 << level;
+  double xsize = (bounds->xmax - bounds->xmin) / n;
+  double ysize = (bounds->ymax - bounds->ymin) / n;
+  POINT3DZ pt;
+  memset(&pt, 0, sizeof(POINT3DZ));
+  pt.x = bounds->xmin;
+  pt.y = bounds->ymin;
+  MEOS_FLAGS_SET_T(box.flags, false);
+  STboxGridState *state = stbox_tile_state_make(temp, &box, xsize, ysize, 0,
+    0, pt, 0, true);
+  int ntiles = state->ntiles;
+  if (temporal_num_instants(temp) > 1)
+    ntiles = tpoint_sweep_make(temp, state);
+  Temporal **result = palloc(sizeof(Temporal *) * ntiles);
+  int64 *ids = palloc(sizeof(int64) * ntiles);
+  int i = 0;
+  STBox tile;
+  Temporal *frag;
+  while ((frag = tpoint_space_time_split_next(state, &tile)) != NULL)
+  {
+    /* The lower corner of the tile is located at a multiple of the size */
+    double x = floor((tile.xmin - bounds->xmin) / xsize + 0.5);
+    double y = floor((tile.ymin - bounds->ymin) / ysize + 0.5);
+    ids[i] = quadcell_make(level, (uint32) x, (uint32) y);
+    result[i++] = frag;
+  }
+  stbox_tile_state_free(state);
+  *cells = ids;
+  *count = i;
+  return result;
+}
+
+/*****************************************************************************
+ * Hexagonal grids
+ *
+ * The hexagons are flat-topped and have a given circumradius. They are
+ * identified by their axial coordinates (q, r) with respect to the origin of
+ * the grid, encoded as a 64-bit integer with q in the 32 most significant
+ * bits and r in the 32 least significant bits. A hexagon is the intersection
+ * of three slabs of width twice its apothem orthogonal to the normals of its
+ * edges. As the tiles of spaceSplit, the hexagons are half-open: a hexagon
+ * excludes the three edges shared with the neighbours in #HEXCELL_NEIGHBORS
+ * and contains the three opposite ones, so that every point belongs to a
+ * single hexagon. The hexagons traversed by a segment are found by walking
+ * along the segment from the edge through which it leaves a hexagon to the
+ * neighbour across this edge.
+ *****************************************************************************/
+
+/** Unit normals of three edges of a flat-topped hexagon */
+static const double HEXCELL_NORMALS[3][2] =
+  {{0.8660254037844386, 0.5}, {0.0, 1.0}, {-0.8660254037844386, 0.5}};
+
+/** Axial offsets of the neighbours across the edges in #HEXCELL_NORMALS */
+static const int32 HEXCELL_NEIGHBORS[3][2] = {{1, 0}, {0, 1}, {-1, 1}};
+
+/**
+ * @brief Return the identifier of a hexagon from its axial coordinates
+ */
+static inline int64
+hexcell_make(int32 q, int32 r)
+{
+  return (int64) (((uint64) (uint32) q << 32) | (uint32) r);
+}
+
+/**
+ * @brief Return the axial coordinates of a hexagon from its identifier
+ */
+static inline void
+hexcell_coords(int64 cell, int32 *q, int32 *r)
+{
+  *q = (int32) ((uint64) cell >> 32);
+  *r = (int32) ((uint64) cell & 0xFFFFFFFF);
+  return;
+}
+
+/**
+ * @brief Return the center of a hexagon from its axial coordinates
+ */
+static void
+hexcell_center(int32 q, int32 r, double size, const POINT2D *origin,
+  POINT2D *center)
+{
+  center->x = origin->x + size * 1.5 * q;
+  center->y = origin->y + size * sqrt(3.0) * (r + q / 2.0);
+  return;
+}
+
+/**
+ * @brief Return the axial coordinates of the hexagon containing a point
+ */
+static void
+hexcell_point(double x, double y, double size, const POINT2D *origin,
+  int32 *q, int32 *r)
+{
+  double dx = x - origin->x, dy = y - origin->y;
+  /* Fractional cube coordinates */
+  double fq = (2.0 / 3.0 * dx) / size;
+  double fr = (-1.0 / 3.0 * dx + sqrt(3.0) / 3.0 * dy) / size;
+  double fs = - fq - fr;
+  /* Round to the nearest hexagon */
+  double rq = round(fq), rr = round(fr), rs = round(fs);
+  double q_diff = fabs(rq - fq), r_diff = fabs(rr - fr),
+    s_diff = fabs(rs - fs);
+  if (q_diff > r_diff && q_diff > s_diff)
+    rq = - rr - rs;
+  else if (r_diff > s_diff)
+    rr = - rq - rs;
+  *q = (int32) rq;
+  *r = (int32) rr;
+
+  /* Move the points located on an excluded edge to the neighbour. At most
+   * two moves are needed for a point located on a vertex. */
+  double apothem = size * sqrt(3.0) / 2.0;
+  for (int i = 0; i < 2; i++)
+  {
+    POINT2D center;
+    hexcell_center(*q, *r, size, origin, &center);
+    int k;
+    for (k = 0; k < 3; k++)
+    {
+      double dist = HEXCELL_NORMALS[k][0] * (x - center.x) +
+        HEXCELL_NORMALS[k][1] * (y - center.y);
+      if (dist >= apothem || dist < - apothem)
+      {
+        int sign = (dist > 0) ? 1 : -1;
+        *q += sign * HEXCELL_NEIGHBORS[k][0];
+        *r += sign * HEXCELL_NEIGHBORS[k][1];
+        break;
+      }
+    }
+    if (k == 3)
+      break;
+  }
+  return;
+}
+
+/**
+ * @brief Return the polygon of a hexagon from its axial coordinates
+ */
+static GSERIALIZED *
+hexcell_poly(int32 q, int32 r, double size, const POINT2D *origin,
+  int32 srid)
+{
+  POINT2D center;
+  hexcell_center(q, r, size, origin, &center);
+  POINTARRAY *pa = ptarray_construct_empty(LW_FALSE, LW_FALSE, 7);
+  POINT4D pt;
+  memset(&pt, 0, sizeof(POINT4D));
+  for (int i = 0; i <= 6; i++)
+  {
+    double angle = M_PI / 3.0 * (i % 6);
+    pt.x = center.x + size * cos(angle);
+    pt.y = center.y + size * sin(angle);
+    ptarray_append_point(pa, &pt, LW_TRUE);
+  }
+  LWPOLY *poly = lwpoly_construct(srid, NULL, 1, &pa);
+  GSERIALIZED *result = geo_serialize((LWGEOM *) poly);
+  lwpoly_free(poly);
+  return result;
+}
+
+/**
+ * @brief Append a time span of a temporal point in a hexagon to the sweep
+ * structure
+ */
+static void
+hexsweep_add(HexSweep *sweep, int64 cell, int seqno, TimestampTz lower,
+  TimestampTz upper, bool lower_inc, bool upper_inc)
+{
+  if (sweep->count == sweep->size)
+  {
+    sweep->size *= 2;
+    sweep->pieces = repalloc(sweep->pieces, sizeof(HexPiece) * sweep->size);
+  }
+  HexPiece *piece = &sweep->pieces[sweep->count++];
+  piece->cell = cell;
+  piece->seqno = seqno;
+  span_set(TimestampTzGetDatum(lower), TimestampTzGetDatum(upper), lower_inc,
+    upper_inc, T_TIMESTAMPTZ, T_TSTZSPAN, &piece->period);
+  return;
+}
+
+/**
+ * @brief Close the current time span of the sweep structure at the timestamp
+ * at which the temporal point leaves the current hexagon
+ * @param[in] sweep Sweep structure
+ * @param[in] t Timestamp
+ * @param[in] upper_inc True when the position at the timestamp belongs to the
+ * current hexagon
+ * @param[in] seqno Number of the sequence
+ * @param[in] cell Identifier of the next hexagon
+ */
+static void
+hexsweep_leave(HexSweep *sweep, TimestampTz t, bool upper_inc, int seqno,
+  int64 cell)
+{
+  /* Rounding the timestamps may yield a time span of zero duration, in which
+   * case the timestamp is given to the next hexagon unless it is already
+   * assigned to a previous one */
+  t = Max(t, sweep->lower);
+  bool lower_inc = sweep->lower_inc;
+  if (t > sweep->lower || (lower_inc && upper_inc))
+    hexsweep_add(sweep, sweep->cell, seqno, sweep->lower, t, lower_inc,
+      upper_inc);
+  sweep->lower_inc = (t > sweep->lower) ? ! upper_inc :
+    lower_inc && ! upper_inc;
+  sweep->lower = t;
+  sweep->cell = cell;
+  return;
+}
+
+/**
+ * @brief Walk along a segment of a temporal point with linear interpolation
+ * through the hexagons it traverses, starting from the current hexagon of the
+ * sweep structure
+ */
+static void
+hexsweep_segm(HexSweep *sweep, const TInstant *inst1, const TInstant *inst2,
+  double size, const POINT2D *origin, int seqno)
+{
+  const POINT2D *p1 = DATUM_POINT2D_P(tinstant_val(inst1));
+  const POINT2D *p2 = DATUM_POINT2D_P(tinstant_val(inst2));
+  double dx = p2->x - p1->x, dy = p2->y - p1->y;
+  double apothem = size * sqrt(3.0) / 2.0;
+  /* Bound the number of hexagons to guard against rounding errors */
+  int maxcells = 2 * (int) ceil(sqrt(dx * dx + dy * dy) / apothem) + 4;
+  double ratio = 0.0;
+  for (int i = 0; i < maxcells; i++)
+  {
+    int32 q, r;
+    hexcell_coords(sweep->cell, &q, &r);
+    POINT2D center;
+    hexcell_center(q, r, size, origin, &center);
+    /* Find the edge through which the segment leaves the hexagon */
+    double exit = DBL_MAX;
+    int32 nextq = q, nextr = r;
+    bool upper_inc = false;
+    for (int k = 0; k < 3; k++)
+    {
+      double dist = HEXCELL_NORMALS[k][0] * (p1->x - center.x) +
+        HEXCELL_NORMALS[k][1] * (p1->y - center.y);
+      double speed = HEXCELL_NORMALS[k][0] * dx + HEXCELL_NORMALS[k][1] * dy;
+      int sign = 1;
+      double frac = 0.0;
+      if (speed == 0)
+      {
+        /* A segment running along an excluded edge belongs to the
+         * neighbour */
+        if (dist < apothem)
+          continue;
+      }
+      else
+      {
+        sign = (speed > 0) ? 1 : -1;
+        frac = (sign * apothem - dist) / speed;
+      }
+      if (frac < exit)
+      {
+        exit = frac;
+        nextq = q + sign * HEXCELL_NEIGHBORS[k][0];
+        nextr = r + sign * HEXCELL_NEIGHBORS[k][1];
+        /* Only the edges opposite to the neighbours are included */
+        upper_inc = (sign < 0);
+      }
+    }
+    if (exit > 1.0)
+      return;
+    ratio = Max(ratio, exit);
+    TimestampTz t = inst1->t +
+      (TimestampTz) ((double) (inst2->t - inst1->t) * ratio);
+    hexsweep_leave(sweep, t, upper_inc, seqno, hexcell_make(nextq, nextr));
+  }
+  return;
+}
+
+/**
+ * @brief Append to the sweep structure the time spans of a temporal point
+ * sequence with continuous interpolation in the hexagons it traverses
+ */
+static void
+tpointseq_hexsweep(const TSequence *seq, int seqno, double size,
+  const POINT2D *origin, HexSweep *sweep)
+{
+  interpType interp = MEOS_FLAGS_GET_INTERP(seq->flags);
+  const TInstant *inst1 = TSEQUENCE_INST_N(seq, 0);
+  const POINT2D *p = DATUM_POINT2D_P(tinstant_val(inst1));
+  int32 q, r;
+  hexcell_point(p->x, p->y, size, origin, &q, &r);
+  sweep->cell = hexcell_make(q, r);
+  sweep->lower = inst1->t;
+  sweep->lower_inc = true;
+  for (int i = 1; i < seq->count; i++)
+  {
+    const TInstant *inst2 = TSEQUENCE_INST_N(seq, i);
+    if (interp == LINEAR)
+      hexsweep_segm(sweep, inst1, inst2, size, origin, seqno);
+    else
+    {
+      /* The position of a step sequence only changes at the instants */
+      p = DATUM_POINT2D_P(tinstant_val(inst2));
+      hexcell_point(p->x, p->y, size, origin, &q, &r);
+      int64 cell = hexcell_make(q, r);
+      if (cell != sweep->cell)
+        hexsweep_leave(sweep, inst2->t, false, seqno, cell);
+    }
+    inst1 = inst2;
+  }
+  /* Close the last time span, the bounds of the sequence are taken into
+   * account when restricting the sequence to the time spans */
+  hexsweep_leave(sweep, inst1->t, true, seqno, sweep->cell);
+  return;
+}
+
+/**
+ * @brief Comparator function for the time spans of a temporal point in the
+ * hexagons of a hexagonal grid
+ */
+static int
+hexpiece_cmp(const HexPiece *l, const HexPiece *r)
+{
+  if (l->cell != r->cell)
+    return (l->cell < r->cell) ? -1 : 1;
+  if (l->seqno != r->seqno)
+    return (l->seqno < r->seqno) ? -1 : 1;
+  return timestamptz_cmp_internal(DatumGetTimestampTz(l->period.lower),
+    DatumGetTimestampTz(r->period.lower));
+}
+
+/**
+ * @brief Return true if the arguments of a hexagonal grid are valid,
+ * otherwise raise an error
+ */
+static bool
+ensure_valid_hexcell_grid(double size, const GSERIALIZED *sorigin)
+{
+  if (! ensure_not_null((void *) sorigin) ||
+      ! ensure_positive_datum(Float8GetDatum(size), T_FLOAT8) ||
+      ! ensure_not_empty(sorigin) || ! ensure_point_type(sorigin) ||
+      ! ensure_not_geodetic(sorigin->gflags))
+    return false;
+  return true;
+}
+
+/**
+ * @ingroup meos_temporal_analytics_tile
+ * @brief Return the identifier of the hexagon of a hexagonal grid containing
+ * a point
+ * @param[in] gs Point
+ * @param[in] size Circumradius of the hexagons
+ * @param[in] sorigin Center of the hexagon (0, 0)
+ * @return On error return -1
+ */
+int64
+geo_hexcell(const GSERIALIZED *gs, double size, const GSERIALIZED *sorigin)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) gs) || ! ensure_not_empty(gs) ||
+      ! ensure_point_type(gs) || ! ensure_valid_hexcell_grid(size, sorigin))
+    return -1;
+  int32 gs_srid = gserialized_get_srid(sorigin);
+  if (gs_srid != SRID_UNKNOWN &&
+      ! ensure_same_srid(gserialized_get_srid(gs), gs_srid))
+    return -1;
+
+  const POINT2D *p = GSERIALIZED_POINT2D_P(gs);
+  int32 q, r;
+  hexcell_point(p->x, p->y, size, GSERIALIZED_POINT2D_P(sorigin), &q, &r);
+  return hexcell_make(q, r);
+}
+
+/**
+ * @ingroup meos_temporal_analytics_tile
+ * @brief Return the polygon of a hexagon of a hexagonal grid
+ * @param[in] cell Identifier of the hexagon
+ * @param[in] size Circumradius of the hexagons
+ * @param[in] sorigin Center of the hexagon (0, 0)
+ * @return On error return @p NULL
+ */
+GSERIALIZED *
+hexcell_geo(int64 cell, double size, const GSERIALIZED *sorigin)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_valid_hexcell_grid(size, sorigin))
+    return NULL;
+  int32 q, r;
+  hexcell_coords(cell, &q, &r);
+  return hexcell_poly(q, r, size, GSERIALIZED_POINT2D_P(sorigin),
+    gserialized_get_srid(sorigin));
+}
+
+/**
+ * @ingroup meos_temporal_analytics_tile
+ * @brief Return the fragments of a temporal point split according to a
+ * hexagonal grid
+ * @details The time spans during which the temporal point stays in each
+ * hexagon are computed by walking along its segments from one hexagon to the
+ * next, and the fragment of each hexagon is obtained by restricting the
+ * temporal point to these time spans.
+ * @param[in] temp Temporal point
+ * @param[in] size Circumradius of the hexagons
+ * @param[in] sorigin Center of the hexagon (0, 0)
+ * @param[out] cells Array of hexagon identifiers
+ * @param[out] count Number of elements in the output arrays
+ * @return On error return @p NULL
+ * @note As for #tpoint_space_split, the hexagons are half-open and thus the
+ * fragments of adjacent hexagons do not share the instants located on their
+ * common border
+ */
+Temporal **
+tpoint_hex_split(const Temporal *temp, double size, const GSERIALIZED *sorigin,
+  int64 **cells, int *count)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) temp) || ! ensure_not_null((void *) cells) ||
+      ! ensure_not_null((void *) count) ||
+      ! ensure_tgeo_type(temp->temptype) ||
+      ! ensure_not_geodetic(temp->flags) ||
+      ! ensure_valid_hexcell_grid(size, sorigin))
+    return NULL;
+  int32 gs_srid = gserialized_get_srid(sorigin);
+  if (gs_srid != SRID_UNKNOWN && ! ensure_same_srid(tpoint_srid(temp), gs_srid))
+    return NULL;
+  const POINT2D *origin = GSERIALIZED_POINT2D_P(sorigin);
+
+  /* Instantaneous temporal point */
+  if (temp->subtype == TINSTANT)
+  {
+    const POINT2D *p = DATUM_POINT2D_P(tinstant_val((TInstant *) temp));
+    int32 q, r;
+    hexcell_point(p->x, p->y, size, origin, &q, &r);
+    *cells = palloc(sizeof(int64));
+    **cells = hexcell_make(q, r);
+    *count = 1;
+    Temporal **result = palloc(sizeof(Temporal *));
+    result[0] = temporal_cp(temp);
+    return result;
+  }
+
+  /* Collect the time spans of the temporal point sorted by hexagon */
+  interpType interp = MEOS_FLAGS_GET_INTERP(temp->flags);
+  HexSweep sweep;
+  memset(&sweep, 0, sizeof(HexSweep));
+  sweep.size = Max(64, 2 * temporal_num_instants(temp));
+  sweep.pieces = palloc(sizeof(HexPiece) * sweep.size);
+  if (interp == DISCRETE)
+  {
+    const TSequence *seq = (const TSequence *) temp;
+    for (int i = 0; i < seq->count; i++)
+    {
+      const TInstant *inst = TSEQUENCE_INST_N(seq, i);
+      const POINT2D *p = DATUM_POINT2D_P(tinstant_val(inst));
+      int32 q, r;
+      hexcell_point(p->x, p->y, size, origin, &q, &r);
+      hexsweep_add(&sweep, hexcell_make(q, r), i, inst->t, inst->t, true,
+        true);
+    }
+  }
+  else if (temp->subtype == TSEQUENCE)
+    tpointseq_hexsweep((TSequence *) temp, 0, size, origin, &sweep);
+  else /* TSEQUENCESET */
+  {
+    const TSequenceSet *ss = (const TSequenceSet *) temp;
+    for (int i = 0; i < ss->count; i++)
+      tpointseq_hexsweep(TSEQUENCESET_SEQ_N(ss, i), i, size, origin, &sweep);
+  }
+  qsort(sweep.pieces, (size_t) sweep.count, sizeof(HexPiece),
+    (qsort_comparator) &hexpiece_cmp);
+
+  /* Restrict the temporal point to the time spans of each hexagon */
+  Temporal **result = palloc(sizeof(Temporal *) * sweep.count);
+  int64 *ids = palloc(sizeof(int64) * sweep.count);
+  const TInstant **instants = palloc(sizeof(TInstant *) * sweep.count);
+  TSequence **sequences = palloc(sizeof(TSequence *) * sweep.count);
+  int i = 0, first = 0;
+  while (first < sweep.count)
+  {
+    int last = first + 1;
+    int64 cell = sweep.pieces[first].cell;
+    while (last < sweep.count && sweep.pieces[last].cell == cell)
+      last++;
+    Temporal *frag = NULL;
+    if (interp == DISCRETE)
+    {
+      for (int j = first; j < last; j++)
+        instants[j - first] = TSEQUENCE_INST_N((const TSequence *) temp,
+          sweep.pieces[j].seqno);
+      frag = (Temporal *) tsequence_make(instants, last - first, true, true,
+        DISCRETE, NORMALIZE_NO);
+    }
+    else
+    {
+      int nseqs = 0;
+      for (int j = first; j < last; j++)
+      {
+        const TSequence *seq = (temp->subtype == TSEQUENCE) ?
+          (const TSequence *) temp :
+          TSEQUENCESET_SEQ_N((const TSequenceSet *) temp,
+            sweep.pieces[j].seqno);
+        TSequence *sub = tcontseq_at_tstzspan(seq, &sweep.pieces[j].period);
+        if (sub)
+          sequences[nseqs++] = sub;
+      }
+      if (nseqs > 0)
+      {
+        frag = (Temporal *) tsequenceset_make((const TSequence **) sequences,
+          nseqs, NORMALIZE);
+        for (int j = 0; j < nseqs; j++)
+          pfree(sequences[j]);
+      }
+    }
+    if (frag)
+    {
+      ids[i] = cell;
+      result[i++] = frag;
+    }
+    first = last;
+  }
+  pfree(instants); pfree(sequences);
+  pfree(sweep.pieces);
+  *cells = ids;
+  *count = i;
+  return result;
+}
+
 /*****************************************************************************/
@@ -76,6 +76,7 @@
 
 #define STATISTIC_KIND_ND 102
 #define STATISTIC_KIND_2D 103
+#define STATISTIC_KIND_NDT 12
 #define STATISTIC_SLOT_ND 0
 #define STATISTIC_SLOT_2D 1
 
@@ -96,9 +97,16 @@
 extern ND_STATS *pg_nd_stats_from_tuple(HeapTuple stats_tuple, int mode);
 extern ND_STATS *pg_get_nd_stats(const Oid tableid, AttrNumber att_num,
   int mode, bool only_parent);
+extern ND_STATS *pg_ndt_stats_from_tuple(HeapTuple stats_tuple,
+  TimestampTz *torigin);
+extern ND_STATS *pg_get_ndt_stats(const Oid tableid, AttrNumber att_num,
+  TimestampTz *torigin);
+extern void nd_stats_shift_time(ND_STATS *nd_stats, double shift);
 
 extern float8 geo_sel(VariableStatData *vardata, const STBox *box,
   meosOper oper);
+extern float8 geo_time_sel(VariableStatData *vardata, const STBox *box,
+  meosOper oper);
 extern float8 geo_joinsel(const ND_STATS *s1, const ND_STATS *s2);
 
 /*****************************************************************************/
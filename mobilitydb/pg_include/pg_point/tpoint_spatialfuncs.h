@@ -37,6 +37,8 @@
 /* PostgreSQL */
 #include <postgres.h>
 #include <fmgr.h>
+/* MEOS */
+#include <meos.h>
 
 
 /*****************************************************************************/
@@ -45,6 +47,22 @@
 extern FunctionCallInfo fetch_fcinfo(void);
 extern void store_fcinfo(FunctionCallInfo fcinfo);
 
+/* Cache of the prepared geometry argument of a function */
+extern PreparedGeo *prepgeo_cache_get(FunctionCallInfo fcinfo,
+  const GSERIALIZED *gs);
+
+/**
+ * @brief Structure storing the state of the functions returning the pairs of
+ * temporal points of two arrays that satisfy a relationship
+ */
+typedef struct
+{
+  size_t i;             /**< Current pair */
+  size_t count;         /**< Number of pairs */
+  int *pairs;           /**< Positions in the arrays, two per pair */
+  Temporal **temps;     /**< Optional temporal value of every pair */
+} TpointPairsState;
+
 /*****************************************************************************/
 
 #endif /* __PG_TPOINT_SPATIALFUNCS_H__ */
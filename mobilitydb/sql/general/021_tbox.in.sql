@@ -54,6 +54,10 @@ CREATE FUNCTION tbox_send(tbox)
   RETURNS bytea
   AS 'MODULE_PATHNAME', 'Tbox_send'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tbox_analyze(internal)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'Tbox_analyze'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
 CREATE TYPE tbox (
   internallength = 56,
@@ -62,7 +66,8 @@ CREATE TYPE tbox (
   receive = tbox_recv,
   send = tbox_send,
   storage = plain,
-  alignment = double
+  alignment = double,
+  analyze = tbox_analyze
 );
 
 -- Input/output in WKB and HexWKB format
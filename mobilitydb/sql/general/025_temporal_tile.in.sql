@@ -223,4 +223,66 @@ CREATE FUNCTION valueTimeSplit(tfloat, size float, duration interval,
 
 /*****************************************************************************/
 
+CREATE TYPE number_time_interval AS (
+  number float,
+  time timestamptz,
+  duration interval
+);
+
+CREATE FUNCTION valueTimeHistogram(tfloat, size float, duration interval,
+    vorigin float DEFAULT 0.0, torigin timestamptz DEFAULT '2000-01-03')
+  RETURNS SETOF number_time_interval
+  AS 'MODULE_PATHNAME', 'Tfloat_value_time_histogram'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE STRICT;
+
+/*****************************************************************************/
+
+CREATE TYPE time_float AS (
+  time timestamptz,
+  value float
+);
+
+CREATE FUNCTION timeSplitIntegral(tint, size interval,
+    origin timestamptz DEFAULT '2000-01-03')
+  RETURNS SETOF time_float
+  AS 'MODULE_PATHNAME', 'Tnumber_time_split_integral'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE STRICT;
+CREATE FUNCTION timeSplitIntegral(tfloat, size interval,
+    origin timestamptz DEFAULT '2000-01-03')
+  RETURNS SETOF time_float
+  AS 'MODULE_PATHNAME', 'Tnumber_time_split_integral'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE STRICT;
+CREATE FUNCTION timeSplitTwAvg(tint, size interval,
+    origin timestamptz DEFAULT '2000-01-03')
+  RETURNS SETOF time_float
+  AS 'MODULE_PATHNAME', 'Tnumber_time_split_twavg'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE STRICT;
+CREATE FUNCTION timeSplitTwAvg(tfloat, size interval,
+    origin timestamptz DEFAULT '2000-01-03')
+  RETURNS SETOF time_float
+  AS 'MODULE_PATHNAME', 'Tnumber_time_split_twavg'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE STRICT;
+CREATE FUNCTION timeSplitMin(tint, size interval,
+    origin timestamptz DEFAULT '2000-01-03')
+  RETURNS SETOF time_float
+  AS 'MODULE_PATHNAME', 'Tnumber_time_split_min'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE STRICT;
+CREATE FUNCTION timeSplitMin(tfloat, size interval,
+    origin timestamptz DEFAULT '2000-01-03')
+  RETURNS SETOF time_float
+  AS 'MODULE_PATHNAME', 'Tnumber_time_split_min'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE STRICT;
+CREATE FUNCTION timeSplitMax(tint, size interval,
+    origin timestamptz DEFAULT '2000-01-03')
+  RETURNS SETOF time_float
+  AS 'MODULE_PATHNAME', 'Tnumber_time_split_max'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE STRICT;
+CREATE FUNCTION timeSplitMax(tfloat, size interval,
+    origin timestamptz DEFAULT '2000-01-03')
+  RETURNS SETOF time_float
+  AS 'MODULE_PATHNAME', 'Tnumber_time_split_max'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE STRICT;
+
+/*****************************************************************************/
+
 
@@ -40,6 +40,11 @@
  * Index Support Functions
  *****************************************************************************/
 
+CREATE FUNCTION tbool_supportfn(internal)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'Tbool_supportfn'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
 CREATE FUNCTION tnumber_supportfn(internal)
   RETURNS internal
   AS 'MODULE_PATHNAME', 'Tnumber_supportfn'
@@ -52,6 +57,7 @@ CREATE FUNCTION tnumber_supportfn(internal)
 CREATE FUNCTION ever_eq(boolean, tbool)
   RETURNS boolean
   AS 'MODULE_PATHNAME', 'Ever_eq_base_temporal'
+  SUPPORT tbool_supportfn
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 CREATE FUNCTION ever_eq(integer, tint)
   RETURNS boolean
@@ -96,6 +102,7 @@ CREATE OPERATOR ?= (
 CREATE FUNCTION ever_eq(tbool, boolean)
   RETURNS boolean
   AS 'MODULE_PATHNAME', 'Ever_eq_temporal_base'
+  SUPPORT tbool_supportfn
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 CREATE FUNCTION ever_eq(tint, integer)
   RETURNS boolean
@@ -226,6 +233,7 @@ CREATE OPERATOR ?<> (
 CREATE FUNCTION always_eq(boolean, tbool)
   RETURNS boolean
   AS 'MODULE_PATHNAME', 'Always_eq_base_temporal'
+  SUPPORT tbool_supportfn
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 CREATE FUNCTION always_eq(integer, tint)
   RETURNS boolean
@@ -270,6 +278,7 @@ CREATE OPERATOR %= (
 CREATE FUNCTION always_eq(tbool, boolean)
   RETURNS boolean
   AS 'MODULE_PATHNAME', 'Always_eq_temporal_base'
+  SUPPORT tbool_supportfn
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 CREATE FUNCTION always_eq(tint, integer)
   RETURNS boolean
@@ -54,6 +54,10 @@ CREATE FUNCTION stbox_send(stbox)
   RETURNS bytea
   AS 'MODULE_PATHNAME', 'Stbox_send'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION stbox_analyze(internal)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'Stbox_analyze'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
 CREATE TYPE stbox (
   internallength = 80,
@@ -62,7 +66,8 @@ CREATE TYPE stbox (
   receive = stbox_recv,
   send = stbox_send,
   storage = plain,
-  alignment = double
+  alignment = double,
+  analyze = stbox_analyze
 );
 
 -- Input/output in WKB and HexWKB format
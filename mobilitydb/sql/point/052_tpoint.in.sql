@@ -886,6 +886,17 @@ CREATE FUNCTION timeSplit(tgeogpoint, bucket_width interval,
   AS 'MODULE_PATHNAME', 'Temporal_time_split'
   LANGUAGE C IMMUTABLE PARALLEL SAFE STRICT;
 
+CREATE FUNCTION timeSplitLength(tgeompoint, bucket_width interval,
+    origin timestamptz DEFAULT '2000-01-03')
+  RETURNS setof time_float
+  AS 'MODULE_PATHNAME', 'Tpoint_time_split_length'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE STRICT;
+CREATE FUNCTION timeSplitLength(tgeogpoint, bucket_width interval,
+    origin timestamptz DEFAULT '2000-01-03')
+  RETURNS setof time_float
+  AS 'MODULE_PATHNAME', 'Tpoint_time_split_length'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE STRICT;
+
 /******************************************************************************
  * Comparison functions and B-tree indexing
  ******************************************************************************/
@@ -119,6 +119,8 @@ CREATE TYPE point_tpoint AS (
   tpoint tgeompoint
 );
 
+-- The bitmatrix argument states whether the temporal point is split in a
+-- single pass over the tiles it traverses, no bit matrix is used
 CREATE FUNCTION spaceSplit(tgeompoint, xsize float, ysize float, zsize float,
     sorigin geometry DEFAULT 'Point(0 0 0)', bitmatrix boolean DEFAULT TRUE,
     borderInc boolean DEFAULT TRUE)
@@ -166,4 +168,67 @@ CREATE FUNCTION spaceTimeSplit(tgeompoint, xsize float, ysize float, interval,
   AS 'SELECT @extschema@.spaceTimeSplit($1, $2, $3, $2, $4, $5, $6, $7)'
   LANGUAGE SQL IMMUTABLE PARALLEL SAFE STRICT;
 
+CREATE TYPE tile_agg AS (
+  tile stbox,
+  count integer,
+  duration interval,
+  distance float,
+  speed float
+);
+
+-- The function is not STRICT since the duration may be NULL
+CREATE FUNCTION tileAgg(tgeompoint[], xsize float, ysize float,
+    duration interval DEFAULT NULL, sorigin geometry DEFAULT 'Point(0 0 0)',
+    torigin timestamptz DEFAULT '2000-01-03')
+  RETURNS SETOF tile_agg
+  AS 'MODULE_PATHNAME', 'Tpointarr_tile_agg'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+
+/*****************************************************************************/
+
+/******************************************************************************
+ * Quadtree and hexagonal grids
+ ******************************************************************************/
+
+CREATE FUNCTION quadCell(point geometry, bounds stbox, level integer)
+  RETURNS bigint
+  AS 'MODULE_PATHNAME', 'Geo_quadcell'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION quadCellBox(cell bigint, bounds stbox)
+  RETURNS stbox
+  AS 'MODULE_PATHNAME', 'Quadcell_stbox'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION quadCellParent(cell bigint, level integer)
+  RETURNS bigint
+  AS 'MODULE_PATHNAME', 'Quadcell_parent'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE FUNCTION hexCell(point geometry, size float,
+    sorigin geometry DEFAULT 'Point(0 0)')
+  RETURNS bigint
+  AS 'MODULE_PATHNAME', 'Geo_hexcell'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION hexCellGeom(cell bigint, size float,
+    sorigin geometry DEFAULT 'Point(0 0)')
+  RETURNS geometry
+  AS 'MODULE_PATHNAME', 'Hexcell_geo'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE TYPE cell_tpoint AS (
+  cell bigint,
+  tpoint tgeompoint
+);
+
+CREATE FUNCTION quadSplit(tgeompoint, bounds stbox, level integer)
+  RETURNS SETOF cell_tpoint
+  AS 'MODULE_PATHNAME', 'Tpoint_quad_split'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE STRICT;
+-- As for the other split functions, the cells are half-open, so that the
+-- fragments of adjacent hexagons do not share the instants on their border
+CREATE FUNCTION hexSplit(tgeompoint, size float,
+    sorigin geometry DEFAULT 'Point(0 0)')
+  RETURNS SETOF cell_tpoint
+  AS 'MODULE_PATHNAME', 'Tpoint_hex_split'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE STRICT;
+
 /*****************************************************************************/
@@ -159,11 +159,22 @@ CREATE FUNCTION nearestApproachDistance(tgeompoint, tgeompoint)
   AS 'MODULE_PATHNAME', 'NAD_tpoint_tpoint'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
-CREATE FUNCTION nearestApproachDistance(geography, tgeogpoint)
+CREATE FUNCTION nearestApproachDistance(geography, tgeogpoint,
+    use_spheroid boolean DEFAULT true)
   RETURNS float
   AS 'MODULE_PATHNAME', 'NAD_geo_tpoint'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
-CREATE FUNCTION nearestApproachDistance(tgeogpoint, geography)
+CREATE FUNCTION nearestApproachDistance(tgeogpoint, geography,
+    use_spheroid boolean DEFAULT true)
+  RETURNS float
+  AS 'MODULE_PATHNAME', 'NAD_tpoint_geo'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+-- The operators need functions with exactly two arguments
+CREATE FUNCTION tpoint_nad(geography, tgeogpoint)
+  RETURNS float
+  AS 'MODULE_PATHNAME', 'NAD_geo_tpoint'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tpoint_nad(tgeogpoint, geography)
   RETURNS float
   AS 'MODULE_PATHNAME', 'NAD_tpoint_geo'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
@@ -231,12 +242,12 @@ CREATE OPERATOR |=| (
 
 CREATE OPERATOR |=| (
   LEFTARG = geography, RIGHTARG = tgeogpoint,
-  PROCEDURE = nearestApproachDistance,
+  PROCEDURE = tpoint_nad,
   COMMUTATOR = '|=|'
 );
 CREATE OPERATOR |=| (
   LEFTARG = tgeogpoint, RIGHTARG = geography,
-  PROCEDURE = nearestApproachDistance,
+  PROCEDURE = tpoint_nad,
   COMMUTATOR = '|=|'
 );
 CREATE OPERATOR |=| (
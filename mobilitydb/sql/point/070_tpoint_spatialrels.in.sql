@@ -338,4 +338,24 @@ CREATE FUNCTION aDwithin(tgeogpoint, tgeogpoint, dist float)
   SUPPORT tpoint_supportfn
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
+/*****************************************************************************
+ * eDwithin for arrays of temporal points
+ *****************************************************************************/
+
+CREATE TYPE index_pair AS (
+  index1 integer,
+  index2 integer
+);
+
+CREATE FUNCTION eDwithinPairs(tgeompoint[], tgeompoint[], dist float)
+  RETURNS SETOF index_pair
+  AS 'MODULE_PATHNAME', 'Edwithin_tpointarr_tpointarr'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE FUNCTION dwithinJoin(tgeompoint[], tgeompoint[], dist float,
+    xsize float, ysize float, duration interval DEFAULT NULL)
+  RETURNS SETOF index_pair
+  AS 'MODULE_PATHNAME', 'Tpointarr_dwithin_join'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+
 /*****************************************************************************/
@@ -122,4 +122,16 @@ CREATE FUNCTION tDwithin(tgeompoint, tgeompoint, dist float,
   AS 'MODULE_PATHNAME', 'Tdwithin_tpoint_tpoint'
   LANGUAGE C IMMUTABLE  PARALLEL SAFE;
 
+CREATE TYPE index_pair_tbool AS (
+  index1 integer,
+  index2 integer,
+  tdwithin tbool
+);
+
+CREATE FUNCTION tDwithinPairs(tgeompoint[], tgeompoint[], dist float,
+    atvalue bool DEFAULT NULL)
+  RETURNS SETOF index_pair_tbool
+  AS 'MODULE_PATHNAME', 'Tdwithin_tpointarr_tpointarr'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+
 /*****************************************************************************/
@@ -130,6 +130,64 @@ RETURNS tgeompoint
 AS 'MODULE_PATHNAME', 'Temporal_simplify_dp'
 LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
+CREATE FUNCTION maxInstantsSimplify(tfloat, integer, boolean DEFAULT TRUE)
+RETURNS tfloat
+AS 'MODULE_PATHNAME', 'Temporal_simplify_max_insts'
+LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION maxInstantsSimplify(tgeompoint, integer, boolean DEFAULT TRUE)
+RETURNS tgeompoint
+AS 'MODULE_PATHNAME', 'Temporal_simplify_max_insts'
+LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE FUNCTION visvalingamWhyattSimplify(tfloat, integer)
+RETURNS tfloat
+AS 'MODULE_PATHNAME', 'Temporal_simplify_vw'
+LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION visvalingamWhyattSimplify(tgeompoint, integer)
+RETURNS tgeompoint
+AS 'MODULE_PATHNAME', 'Temporal_simplify_vw'
+LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE FUNCTION openingWindowSimplify(tfloat, float, integer DEFAULT 64)
+RETURNS tfloat
+AS 'MODULE_PATHNAME', 'Temporal_simplify_opening_window'
+LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION openingWindowSimplify(tgeompoint, float, integer DEFAULT 64,
+  boolean DEFAULT TRUE)
+RETURNS tgeompoint
+AS 'MODULE_PATHNAME', 'Temporal_simplify_opening_window'
+LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE FUNCTION squishESimplify(tfloat, float, integer DEFAULT 64)
+RETURNS tfloat
+AS 'MODULE_PATHNAME', 'Temporal_simplify_squishe'
+LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION squishESimplify(tgeompoint, float, integer DEFAULT 64,
+  boolean DEFAULT TRUE)
+RETURNS tgeompoint
+AS 'MODULE_PATHNAME', 'Temporal_simplify_squishe'
+LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE FUNCTION douglasPeuckerPyramid(tfloat, float, integer,
+  boolean DEFAULT TRUE)
+RETURNS tfloat[]
+AS 'MODULE_PATHNAME', 'Temporal_simplify_dp_pyramid'
+LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION douglasPeuckerPyramid(tgeompoint, float, integer,
+  boolean DEFAULT TRUE)
+RETURNS tgeompoint[]
+AS 'MODULE_PATHNAME', 'Temporal_simplify_dp_pyramid'
+LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE FUNCTION pyramidLevel(tfloat[], float, float)
+RETURNS tfloat
+AS 'MODULE_PATHNAME', 'Temporalarr_pyramid_level'
+LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION pyramidLevel(tgeompoint[], float, float)
+RETURNS tgeompoint
+AS 'MODULE_PATHNAME', 'Temporalarr_pyramid_level'
+LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
 CREATE TYPE geom_times AS (
   geom geometry,
   times bigint[]
@@ -141,5 +199,23 @@ CREATE FUNCTION asMVTGeom(tpoint tgeompoint, bounds stbox,
 RETURNS geom_times
 AS 'MODULE_PATHNAME','Tpoint_AsMVTGeom'
 LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION asMVTGeom(pyramid tgeompoint[], dist float, bounds stbox,
+  extent int4 DEFAULT 4096, buffer int4 DEFAULT 256, clip bool DEFAULT TRUE)
+RETURNS geom_times
+AS 'MODULE_PATHNAME','Tpointarr_AsMVTGeom'
+LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE TYPE mvt_commands AS (
+  id integer,
+  geomtype integer,
+  geom integer[],
+  times bigint[]
+);
+
+CREATE FUNCTION asMVTCommands(tgeompoint[], bounds stbox,
+  extent int4 DEFAULT 4096, buffer int4 DEFAULT 256, clip bool DEFAULT TRUE)
+RETURNS SETOF mvt_commands
+AS 'MODULE_PATHNAME','Tpointarr_AsMVTCommands'
+LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
 /*****************************************************************************/
@@ -1314,7 +1314,7 @@ span_joinsel_hist(VariableStatData *vardata1, VariableStatData *vardata2,
       bounds_hist, InvalidOid,  // TODO
       ATTSTATSSLOT_VALUES);
     /* Check that it's a histogram, not just a dummy entry */
-    if (hslot1.nvalues < 2)
+    if (have_hist1 && hslot1.nvalues < 2)
     {
       free_attstatsslot(&hslot1);
       return -1.0;
@@ -1327,7 +1327,7 @@ span_joinsel_hist(VariableStatData *vardata1, VariableStatData *vardata2,
       bounds_hist, InvalidOid, // TODO
       ATTSTATSSLOT_VALUES);
     /* Check that it's a histogram, not just a dummy entry */
-    if (hslot2.nvalues < 2)
+    if (have_hist2 && hslot2.nvalues < 2)
     {
       free_attstatsslot(&hslot1); free_attstatsslot(&hslot2);
       return -1.0;
@@ -1380,7 +1380,7 @@ span_joinsel_hist(VariableStatData *vardata1, VariableStatData *vardata2,
     memset(&lslot, 0, sizeof(lslot));
 
     if (!(HeapTupleIsValid(vardata2->statsTuple) &&
-        get_attstatsslot(&lslot, vardata1->statsTuple,
+        get_attstatsslot(&lslot, vardata2->statsTuple,
           lengths_hist, InvalidOid, // TODO
           ATTSTATSSLOT_VALUES)))
     {
@@ -1420,6 +1420,9 @@ span_joinsel(PlannerInfo *root, bool value, meosOper oper, List *args,
 
   /* Estimate join selectivity */
   Selectivity selec = span_joinsel_hist(&vardata1, &vardata2, value, oper);
+  /* Use the default estimate if the histograms cannot be used */
+  if (selec < 0.0)
+    selec = span_joinsel_default(oper);
 
   ReleaseVariableStats(vardata1);
   ReleaseVariableStats(vardata2);
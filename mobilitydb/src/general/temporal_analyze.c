@@ -61,6 +61,9 @@
  * that is, tbool and ttext, no statistics are collected for the value
  * dimension and the statistics for the temporal dimension are stored in slots
  * 1 and 2.
+ *
+ * The same statistics are collected for `tbox` columns, where the statistics
+ * of a dimension are only collected if the boxes have this dimension.
  */
 
 #include "pg_general/temporal_analyze.h"
@@ -74,6 +77,7 @@
 /* MEOS */
 #include <meos.h>
 #include <meos_internal.h>
+#include "general/tbox.h"
 #include "general/temporal.h"
 /* MobilityDB */
 #include "pg_general/meos_catalog.h"
@@ -224,6 +228,128 @@ temporal_compute_stats(VacAttrStats *stats, AnalyzeAttrFetchFunc fetchfunc,
   return;
 }
 
+/*****************************************************************************
+ * Statistics functions for temporal boxes
+ *****************************************************************************/
+
+/**
+ * @brief Compute statistics for temporal box columns
+ * @details The histograms of the value and time spans of the boxes enable
+ * the estimation of the selectivity of the joins between temporal box
+ * columns and temporal number columns
+ * @param[in] stats Structure storing statistics information
+ * @param[in] fetchfunc Fetch function
+ * @param[in] samplerows Number of sample rows
+ * @param[in] totalrows Total number of rows
+ */
+static void
+tbox_compute_stats(VacAttrStats *stats, AnalyzeAttrFetchFunc fetchfunc,
+  int samplerows, double totalrows __attribute__((unused)))
+{
+  int null_cnt = 0, non_null_cnt = 0, value_cnt = 0, time_cnt = 0;
+  int slot_idx = 0;
+
+  SpanBound *value_lowers = palloc(sizeof(SpanBound) * samplerows);
+  SpanBound *value_uppers = palloc(sizeof(SpanBound) * samplerows);
+  float8 *value_lengths = palloc(sizeof(float8) * samplerows);
+  SpanBound *time_lowers = palloc(sizeof(SpanBound) * samplerows);
+  SpanBound *time_uppers = palloc(sizeof(SpanBound) * samplerows);
+  float8 *time_lengths = palloc(sizeof(float8) * samplerows);
+
+  /* Loop over the sample boxes */
+  for (int i = 0; i < samplerows; i++)
+  {
+    /* Give backend a chance of interrupting us */
+    vacuum_delay_point();
+
+    bool isnull;
+    Datum value = fetchfunc(stats, i, &isnull);
+    if (isnull)
+    {
+      /* Box is null, just count that */
+      null_cnt++;
+      continue;
+    }
+
+    /* Remember bounds and length for further usage in histograms */
+    const TBox *box = DatumGetTboxP(value);
+    SpanBound lower, upper;
+    if (MEOS_FLAGS_GET_X(box->flags))
+    {
+      span_deserialize(&box->span, &lower, &upper);
+      value_lowers[value_cnt] = lower;
+      value_uppers[value_cnt] = upper;
+      value_lengths[value_cnt++] = distance_value_value(upper.val, lower.val,
+        upper.basetype);
+    }
+    if (MEOS_FLAGS_GET_T(box->flags))
+    {
+      span_deserialize(&box->period, &lower, &upper);
+      time_lowers[time_cnt] = lower;
+      time_uppers[time_cnt] = upper;
+      time_lengths[time_cnt++] = distance_value_value(upper.val, lower.val,
+        T_TIMESTAMPTZ);
+    }
+
+    /* Increment non null count */
+    non_null_cnt++;
+  }
+
+  /* We can only compute real stats if we found some non-null values. */
+  if (non_null_cnt > 0)
+  {
+    stats->stats_valid = true;
+    /* Do the simple null-frac and width stats */
+    stats->stanullfrac = (float4) null_cnt / (float4) samplerows;
+    stats->stawidth = (int) sizeof(TBox);
+
+    /* Estimate that non-null values are unique */
+    stats->stadistinct = (float4) (-1.0 * (1.0 - stats->stanullfrac));
+
+    /* The last argument determines the slot for number/time statistics */
+    if (value_cnt > 0)
+      span_compute_stats_generic(stats, value_cnt, &slot_idx, value_lowers,
+        value_uppers, value_lengths, true);
+    if (time_cnt > 0)
+      span_compute_stats_generic(stats, time_cnt, &slot_idx, time_lowers,
+        time_uppers, time_lengths, false);
+  }
+  else if (null_cnt > 0)
+  {
+    /* We found only nulls; assume the column is entirely null */
+    stats->stats_valid = true;
+    stats->stanullfrac = 1.0;
+    stats->stawidth = 0;       /* unknown */
+    stats->stadistinct = 0.0;  /* unknown */
+  }
+
+  pfree(value_lowers); pfree(value_uppers); pfree(value_lengths);
+  pfree(time_lowers); pfree(time_uppers); pfree(time_lengths);
+  return;
+}
+
+PGDLLEXPORT Datum Tbox_analyze(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tbox_analyze);
+/**
+ * @brief Compute the statistics for temporal box columns
+ */
+Datum
+Tbox_analyze(PG_FUNCTION_ARGS)
+{
+  VacAttrStats *stats = (VacAttrStats *) PG_GETARG_POINTER(0);
+
+  /*
+   * Call the standard typanalyze function. It may fail to find needed
+   * operators, in which case we also can't do anything, so just fail.
+   */
+  if (! std_typanalyze(stats))
+    PG_RETURN_BOOL(false);
+
+  /* Set the callback function to compute statistics. */
+  stats->compute_stats = &tbox_compute_stats;
+  PG_RETURN_BOOL(true);
+}
+
 /*****************************************************************************
  * Statistics functions for temporal types
  *****************************************************************************/
@@ -706,6 +706,14 @@ temporal_sel(PlannerInfo *root, Oid operid, List *args, int varRelid,
 
     assert(MEOS_FLAGS_GET_X(box.flags) || MEOS_FLAGS_GET_T(box.flags));
 
+    /* Use the joint space-time histogram when the box has both dimensions */
+    selec = geo_time_sel(&vardata, &box, oper);
+    if (selec >= 0.0)
+    {
+      ReleaseVariableStats(vardata);
+      return selec;
+    }
+
     /* Enable the multiplication of the selectivity of the spatial and time
      * dimensions since either may be missing */
     selec = 1.0;
@@ -841,7 +849,7 @@ tnumber_joinsel_components(meosOper oper, meosType oprleft,
     *value = false;
     *time = true;
   }
-  else if (tnumber_type(arg) && (oper == OVERLAPS_OP ||
+  else if ((tnumber_type(arg) || arg == T_TBOX) && (oper == OVERLAPS_OP ||
     oper == CONTAINS_OP || oper == CONTAINED_OP ||
     oper == SAME_OP || oper == ADJACENT_OP))
   {
@@ -889,7 +897,7 @@ tpoint_joinsel_components(meosOper oper, meosType oprleft,
     *space = false;
     *time = true;
   }
-  else if (tspatial_type(arg) && (oper == OVERLAPS_OP ||
+  else if ((tspatial_type(arg) || arg == T_STBOX) && (oper == OVERLAPS_OP ||
     oper == CONTAINS_OP || oper == CONTAINED_OP ||
     oper == SAME_OP || oper == ADJACENT_OP))
   {
@@ -968,6 +976,27 @@ temporal_joinsel(PlannerInfo *root, Oid operid, List *args, JoinType jointype,
    * Multiply the components of the join selectivity estimation
    */
   Selectivity selec = 1.0;
+  if (space && time && oper != SAME_OP && list_length(args) == 2)
+  {
+    /* Use the joint space-time histograms when available on both sides */
+    Oid relid1 = rt_fetch(var1->varno, root->parse->rtable)->relid;
+    Oid relid2 = rt_fetch(var2->varno, root->parse->rtable)->relid;
+    TimestampTz torigin1, torigin2;
+    ND_STATS *stats1 = pg_get_ndt_stats(relid1, var1->varattno, &torigin1);
+    ND_STATS *stats2 = pg_get_ndt_stats(relid2, var2->varattno, &torigin2);
+    if (stats1 && stats2 && stats1->ndims == stats2->ndims)
+    {
+      /* Express the time dimension of both histograms from the same origin */
+      nd_stats_shift_time(stats2,
+        (double) (torigin2 - torigin1) / USECS_PER_SEC);
+      selec *= geo_joinsel(stats1, stats2);
+      space = time = false;
+    }
+    if (stats1)
+      pfree(stats1);
+    if (stats2)
+      pfree(stats2);
+  }
   if (value)
   {
     /*
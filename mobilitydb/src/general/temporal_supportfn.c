@@ -184,6 +184,30 @@ static const IndexableFunction TNPointIndexableFunctions[] = {
 };
 #endif /* NPOINT */
 
+/*
+ * Temporal relationships whose result compared with true using an ever or
+ * always comparison is equivalent to the ever or always relationship. The
+ * latter have an index support function and do not need to compute the
+ * temporal Boolean.
+ */
+typedef struct
+{
+  const char *tfn_name;  /* Name of the temporal relationship */
+  const char *efn_name;  /* Name of the ever relationship */
+  const char *afn_name;  /* Name of the always relationship */
+  uint8_t nargs;         /* Number of arguments without the atvalue one */
+} TempRelFunction;
+
+static const TempRelFunction TempRelFunctions[] =
+{
+  {"tcontains", "econtains", "acontains", 2},
+  {"tdisjoint", "edisjoint", "adisjoint", 2},
+  {"tintersects", "eintersects", "aintersects", 2},
+  {"ttouches", "etouches", "atouches", 2},
+  {"tdwithin", "edwithin", "adwithin", 3},
+  {NULL, NULL, NULL, 0}
+};
+
 static int16
 temporal_get_strategy_by_type(meosType temptype, uint16_t index)
 {
@@ -212,7 +236,7 @@ func_needs_index(Oid funcid, const IndexableFunction *idxfns,
   IndexableFunction *result)
 {
   const char *fn_name = get_func_name(funcid);
-  do
+  while (idxfns->fn_name)
   {
     if (strcmp(idxfns->fn_name, fn_name) == 0)
     {
@@ -221,11 +245,133 @@ func_needs_index(Oid funcid, const IndexableFunction *idxfns,
     }
     idxfns++;
   }
-  while (idxfns->fn_name);
-
   return false;
 }
 
+/**
+ * @brief Rewrite an ever/always comparison with true of the result of a
+ * temporal relationship into the corresponding ever/always relationship
+ * @details For example, the expressions
+ * @code
+ * tIntersects(trip, geo) ?= true
+ * tDwithin(trip1, trip2, 10) %= true
+ * @endcode
+ * are rewritten, respectively, into
+ * @code
+ * eIntersects(trip, geo)
+ * aDwithin(trip1, trip2, 10)
+ * @endcode
+ * which can then be answered with an index. When the temporal relationship
+ * is restricted to a time value as in
+ * @code
+ * atTime(tDwithin(trip1, trip2, 10), tstzspan '[2001-01-01, 2001-01-02]') ?= true
+ * @endcode
+ * the comparison is kept but it is preceded by the ever relationship of the
+ * unrestricted arguments, that is,
+ * @code
+ * eDwithin(trip1, trip2, 10) AND
+ * atTime(tDwithin(trip1, trip2, 10), tstzspan '[2001-01-01, 2001-01-02]') ?= true
+ * @endcode
+ * since the restricted relationship is ever or always true only if the
+ * ever relationship is true, so that the index is used as a filter.
+ * @note Comparisons of the nearest approach distance with a value such as
+ * `nad(trip, geo) < d` use the float comparison operators of PostgreSQL,
+ * which have no support function, and thus are not rewritten. The
+ * equivalent condition `eDwithin(trip, geo, d)` must be used instead.
+ * @return The rewritten expression or NULL if it cannot be rewritten
+ */
+static Node *
+temprel_simplify(FuncExpr *fcall)
+{
+  const char *fn_name = get_func_name(fcall->funcid);
+  bool ever;
+  if (strcmp(fn_name, "ever_eq") == 0)
+    ever = true;
+  else if (strcmp(fn_name, "always_eq") == 0)
+    ever = false;
+  else
+    return NULL;
+  if (list_length(fcall->args) != 2)
+    return NULL;
+
+  /* Find the temporal relationship and the Boolean constant in any order */
+  Node *arg1 = linitial(fcall->args);
+  Node *arg2 = lsecond(fcall->args);
+  FuncExpr *relexpr;
+  Const *boolconst;
+  if (IsA(arg1, FuncExpr) && IsA(arg2, Const))
+  {
+    relexpr = (FuncExpr *) arg1;
+    boolconst = (Const *) arg2;
+  }
+  else if (IsA(arg1, Const) && IsA(arg2, FuncExpr))
+  {
+    boolconst = (Const *) arg1;
+    relexpr = (FuncExpr *) arg2;
+  }
+  else
+    return NULL;
+  if (boolconst->constisnull || exprType((Node *) boolconst) != BOOLOID ||
+      ! DatumGetBool(boolconst->constvalue))
+    return NULL;
+
+  /* Is the temporal relationship restricted to a time value? */
+  const char *relname = get_func_name(relexpr->funcid);
+  bool attime = false;
+  if (strcmp(relname, "attime") == 0)
+  {
+    if (list_length(relexpr->args) != 2 ||
+        ! IsA(linitial(relexpr->args), FuncExpr))
+      return NULL;
+    relexpr = (FuncExpr *) linitial(relexpr->args);
+    relname = get_func_name(relexpr->funcid);
+    attime = true;
+  }
+
+  /* Is the function one of the temporal relationships we can rewrite? */
+  const TempRelFunction *rel = TempRelFunctions;
+  while (rel->tfn_name && strcmp(rel->tfn_name, relname) != 0)
+    rel++;
+  if (! rel->tfn_name)
+    return NULL;
+
+  /* The optional atvalue argument, filled with its default value by the
+   * planner, must be NULL since otherwise the result is restricted */
+  int nargs = list_length(relexpr->args);
+  if (nargs == rel->nargs + 1)
+  {
+    Node *atvalue = llast(relexpr->args);
+    if (! IsA(atvalue, Const) || ! ((Const *) atvalue)->constisnull)
+      return NULL;
+  }
+  else if (nargs != rel->nargs)
+    return NULL;
+
+  /* Look up the ever/always relationship in the namespace of the temporal
+   * relationship with the same argument types, if any */
+  Oid argtypes[3];
+  List *args = NIL;
+  for (int i = 0; i < rel->nargs; i++)
+  {
+    Node *arg = (Node *) list_nth(relexpr->args, i);
+    argtypes[i] = exprType(arg);
+    args = lappend(args, arg);
+  }
+  char *nspname = get_namespace_name(get_func_namespace(relexpr->funcid));
+  char *funcname = pstrdup((ever || attime) ? rel->efn_name : rel->afn_name);
+  List *nspfunc = list_make2(makeString(nspname), makeString(funcname));
+  Oid funcoid = LookupFuncName(nspfunc, rel->nargs, argtypes, true);
+  if (funcoid == InvalidOid)
+    return NULL;
+
+  Expr *result = (Expr *) makeFuncExpr(funcoid, BOOLOID, args, InvalidOid,
+    InvalidOid, COERCE_EXPLICIT_CALL);
+  /* The ever relationship only filters the comparison of the restriction */
+  if (attime)
+    result = make_andclause(list_make2(result, fcall));
+  return (Node *) result;
+}
+
 /**
  * @brief We only add index enhancements for indexes that support range-based
  * searches like the && operator), so only implementations based on GIST
@@ -367,13 +513,26 @@ Temporal_supportfn(FunctionCallInfo fcinfo, TemporalFamily tempfamily)
   Node *ret = NULL;
   Oid leftoid, rightoid, operid;
 
-  /* Return estimated selectivity */
   assert (tempfamily == TEMPORALTYPE || tempfamily == TNUMBERTYPE ||
     tempfamily == TPOINTTYPE
 #if NPOINT
     || tempfamily == TNPOINTTYPE
 #endif /* NPOINT */
     );
+
+  /* Rewrite ever/always comparisons of temporal relationships */
+  if (IsA(rawreq, SupportRequestSimplify))
+  {
+    SupportRequestSimplify *req = (SupportRequestSimplify *) rawreq;
+    ret = temprel_simplify(req->fcall);
+    PG_RETURN_POINTER(ret);
+  }
+
+  /* Temporal Booleans only support the rewriting above */
+  if (tempfamily == TEMPORALTYPE)
+    PG_RETURN_POINTER(ret);
+
+  /* Return estimated selectivity */
   if (IsA(rawreq, SupportRequestSelectivity))
   {
     SupportRequestSelectivity *req = (SupportRequestSelectivity *) rawreq;
@@ -619,6 +778,17 @@ Temporal_supportfn(FunctionCallInfo fcinfo, TemporalFamily tempfamily)
   PG_RETURN_POINTER(ret);
 }
 
+PGDLLEXPORT Datum Tbool_supportfn(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tbool_supportfn);
+/**
+ * @brief Support function for temporal Booleans
+ */
+Datum
+Tbool_supportfn(PG_FUNCTION_ARGS)
+{
+  return Temporal_supportfn(fcinfo, TEMPORALTYPE);
+}
+
 PGDLLEXPORT Datum Tnumber_supportfn(PG_FUNCTION_ARGS);
 PG_FUNCTION_INFO_V1(Tnumber_supportfn);
 /**
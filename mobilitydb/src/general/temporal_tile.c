@@ -39,6 +39,7 @@
 
 /* C */
 #include <assert.h>
+#include <math.h>
 /* PostgreSQL */
 #include <postgres.h>
 #include <funcapi.h>
@@ -50,6 +51,7 @@
 #include "general/temporal.h"
 /* MobilityDB */
 #include "pg_general/meos_catalog.h"
+#include "pg_general/skiplist.h" /* For store_fcinfo */
 
 /*****************************************************************************
  * Number bucket functions
@@ -537,4 +539,270 @@ Tnumber_value_time_split(PG_FUNCTION_ARGS)
   return Temporal_value_time_split_ext(fcinfo, true, true);
 }
 
+/*****************************************************************************
+ * Time-bucketed aggregates
+ *****************************************************************************/
+
+/**
+ * @brief Function computing an aggregate of each time bucket of a temporal
+ * value
+ */
+typedef double *(*time_split_agg_fn)(const Temporal *, const Interval *,
+  TimestampTz, TimestampTz **, int *);
+
+/**
+ * @brief Structure to represent the state of the time-bucketed aggregates
+ */
+typedef struct
+{
+  int i;                /**< Number of the current bucket */
+  int count;            /**< Number of buckets */
+  TimestampTz *buckets; /**< Lower bounds of the buckets */
+  double *values;       /**< Aggregate values of the buckets */
+} TimeSplitAggState;
+
+/**
+ * @brief Return an aggregate of each time bucket of a temporal value
+ */
+static Datum
+Temporal_time_split_agg(FunctionCallInfo fcinfo, time_split_agg_fn func)
+{
+  FuncCallContext *funcctx;
+  TimeSplitAggState *state;
+  bool isnull[2] = {0,0}; /* needed to say no value is null */
+  Datum tuple_arr[2]; /* used to construct the composite return value */
+  HeapTuple tuple;
+  Datum result; /* the actual composite return value */
+
+  /* If the function is being called for the first time */
+  if (SRF_IS_FIRSTCALL())
+  {
+    /* Initialize the FuncCallContext */
+    funcctx = SRF_FIRSTCALL_INIT();
+    /* Switch to memory context appropriate for multiple function calls */
+    MemoryContext oldcontext =
+      MemoryContextSwitchTo(funcctx->multi_call_memory_ctx);
+
+    /* Get input parameters */
+    Temporal *temp = PG_GETARG_TEMPORAL_P(0);
+    Interval *duration = PG_GETARG_INTERVAL_P(1);
+    TimestampTz torigin = PG_GETARG_TIMESTAMPTZ(2);
+    /* Store fcinfo into a global variable for temporal geography points */
+    if (temp->temptype == T_TGEOGPOINT)
+      store_fcinfo(fcinfo);
+    /* Create function state */
+    state = palloc0(sizeof(TimeSplitAggState));
+    state->values = func(temp, duration, torigin, &state->buckets,
+      &state->count);
+    funcctx->user_fctx = state;
+    /* Build a tuple description for the function output */
+    get_call_result_type(fcinfo, 0, &funcctx->tuple_desc);
+    BlessTupleDesc(funcctx->tuple_desc);
+    MemoryContextSwitchTo(oldcontext);
+    PG_FREE_IF_COPY(temp, 0);
+  }
+
+  /* Stuff done on every call of the function */
+  funcctx = SRF_PERCALL_SETUP();
+  /* Get state */
+  state = funcctx->user_fctx;
+  /* Stop when we've output all the buckets */
+  if (state->i >= state->count)
+  {
+    /* Switch to memory context appropriate for multiple function calls */
+    MemoryContext oldcontext =
+      MemoryContextSwitchTo(funcctx->multi_call_memory_ctx);
+    if (state->values)
+    {
+      pfree(state->buckets);
+      pfree(state->values);
+    }
+    pfree(state);
+    MemoryContextSwitchTo(oldcontext);
+    SRF_RETURN_DONE(funcctx);
+  }
+
+  /* Store bucket and value */
+  tuple_arr[0] = TimestampTzGetDatum(state->buckets[state->i]);
+  tuple_arr[1] = Float8GetDatum(state->values[state->i]);
+  /* Advance state */
+  state->i++;
+  /* Form tuple and return */
+  tuple = heap_form_tuple(funcctx->tuple_desc, tuple_arr, isnull);
+  result = HeapTupleGetDatum(tuple);
+  SRF_RETURN_NEXT(funcctx, result);
+}
+
+PGDLLEXPORT Datum Tnumber_time_split_integral(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tnumber_time_split_integral);
+/**
+ * @ingroup mobilitydb_temporal_analytics_tile
+ * @brief Return the integral of each time bucket of a temporal number
+ * @sqlfn timeSplitIntegral()
+ */
+Datum
+Tnumber_time_split_integral(PG_FUNCTION_ARGS)
+{
+  return Temporal_time_split_agg(fcinfo, &tnumber_time_split_integral);
+}
+
+PGDLLEXPORT Datum Tnumber_time_split_twavg(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tnumber_time_split_twavg);
+/**
+ * @ingroup mobilitydb_temporal_analytics_tile
+ * @brief Return the time-weighted average of each time bucket of a temporal
+ * number
+ * @sqlfn timeSplitTwAvg()
+ */
+Datum
+Tnumber_time_split_twavg(PG_FUNCTION_ARGS)
+{
+  return Temporal_time_split_agg(fcinfo, &tnumber_time_split_twavg);
+}
+
+PGDLLEXPORT Datum Tnumber_time_split_min(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tnumber_time_split_min);
+/**
+ * @ingroup mobilitydb_temporal_analytics_tile
+ * @brief Return the minimum value of each time bucket of a temporal number
+ * @sqlfn timeSplitMin()
+ */
+Datum
+Tnumber_time_split_min(PG_FUNCTION_ARGS)
+{
+  return Temporal_time_split_agg(fcinfo, &tnumber_time_split_min);
+}
+
+PGDLLEXPORT Datum Tnumber_time_split_max(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tnumber_time_split_max);
+/**
+ * @ingroup mobilitydb_temporal_analytics_tile
+ * @brief Return the maximum value of each time bucket of a temporal number
+ * @sqlfn timeSplitMax()
+ */
+Datum
+Tnumber_time_split_max(PG_FUNCTION_ARGS)
+{
+  return Temporal_time_split_agg(fcinfo, &tnumber_time_split_max);
+}
+
+PGDLLEXPORT Datum Tpoint_time_split_length(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tpoint_time_split_length);
+/**
+ * @ingroup mobilitydb_temporal_analytics_tile
+ * @brief Return the length traversed in each time bucket of a temporal point
+ * @sqlfn timeSplitLength()
+ */
+Datum
+Tpoint_time_split_length(PG_FUNCTION_ARGS)
+{
+  return Temporal_time_split_agg(fcinfo, &tpoint_time_split_length);
+}
+
+/*****************************************************************************
+ * Value and time histogram function for temporal floats
+ *****************************************************************************/
+
+/**
+ * @brief Structure to represent the state of the value and time histogram
+ */
+typedef struct
+{
+  int i;                  /**< Number of the current cell */
+  int value_count;        /**< Number of value buckets */
+  int time_count;         /**< Number of time buckets */
+  double value_start;     /**< Lower bound of the first value bucket */
+  double size;            /**< Size of the value buckets */
+  TimestampTz time_start; /**< Lower bound of the first time bucket */
+  int64 tunits;           /**< Size of the time buckets */
+  double *durations;      /**< Durations of the cells */
+} ValueTimeHistogramState;
+
+PGDLLEXPORT Datum Tfloat_value_time_histogram(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tfloat_value_time_histogram);
+/**
+ * @ingroup mobilitydb_temporal_analytics_tile
+ * @brief Return the duration of a temporal float in each cell of a grid of
+ * value and time buckets
+ * @note Only the cells with a non-zero duration are returned
+ * @sqlfn valueTimeHistogram()
+ */
+Datum
+Tfloat_value_time_histogram(PG_FUNCTION_ARGS)
+{
+  FuncCallContext *funcctx;
+  ValueTimeHistogramState *state;
+  bool isnull[3] = {0,0,0}; /* needed to say no value is null */
+  Datum tuple_arr[3]; /* used to construct the composite return value */
+  HeapTuple tuple;
+  Datum result; /* the actual composite return value */
+
+  /* If the function is being called for the first time */
+  if (SRF_IS_FIRSTCALL())
+  {
+    /* Initialize the FuncCallContext */
+    funcctx = SRF_FIRSTCALL_INIT();
+    /* Switch to memory context appropriate for multiple function calls */
+    MemoryContext oldcontext =
+      MemoryContextSwitchTo(funcctx->multi_call_memory_ctx);
+
+    /* Get input parameters */
+    Temporal *temp = PG_GETARG_TEMPORAL_P(0);
+    Datum size = PG_GETARG_DATUM(1);
+    Interval *duration = PG_GETARG_INTERVAL_P(2);
+    Datum vorigin = PG_GETARG_DATUM(3);
+    TimestampTz torigin = PG_GETARG_TIMESTAMPTZ(4);
+    /* Create function state */
+    state = palloc0(sizeof(ValueTimeHistogramState));
+    Datum value_start;
+    state->durations = tnumber_value_time_histogram(temp, size, duration,
+      vorigin, torigin, &value_start, &state->time_start, &state->value_count,
+      &state->time_count);
+    state->value_start = DatumGetFloat8(value_start);
+    state->size = DatumGetFloat8(size);
+    state->tunits = interval_units(duration);
+    funcctx->user_fctx = state;
+    /* Build a tuple description for the function output */
+    get_call_result_type(fcinfo, 0, &funcctx->tuple_desc);
+    BlessTupleDesc(funcctx->tuple_desc);
+    MemoryContextSwitchTo(oldcontext);
+    PG_FREE_IF_COPY(temp, 0);
+  }
+
+  /* Stuff done on every call of the function */
+  funcctx = SRF_PERCALL_SETUP();
+  /* Get state */
+  state = funcctx->user_fctx;
+  /* Skip the empty cells */
+  int ncells = state->value_count * state->time_count;
+  while (state->i < ncells && state->durations[state->i] <= 0)
+    state->i++;
+  /* Stop when we've output all the cells */
+  if (state->i >= ncells)
+  {
+    /* Switch to memory context appropriate for multiple function calls */
+    MemoryContext oldcontext =
+      MemoryContextSwitchTo(funcctx->multi_call_memory_ctx);
+    pfree(state->durations);
+    pfree(state);
+    MemoryContextSwitchTo(oldcontext);
+    SRF_RETURN_DONE(funcctx);
+  }
+
+  /* Store value bucket, time bucket, and duration */
+  int vbucket = state->i / state->time_count;
+  int tbucket = state->i % state->time_count;
+  TimestampTz lower = state->time_start + tbucket * state->tunits;
+  tuple_arr[0] = Float8GetDatum(state->value_start + vbucket * state->size);
+  tuple_arr[1] = TimestampTzGetDatum(lower);
+  tuple_arr[2] = PointerGetDatum(minus_timestamptz_timestamptz(
+    lower + (TimestampTz) round(state->durations[state->i]), lower));
+  /* Advance state */
+  state->i++;
+  /* Form tuple and return */
+  tuple = heap_form_tuple(funcctx->tuple_desc, tuple_arr, isnull);
+  result = HeapTupleGetDatum(tuple);
+  SRF_RETURN_NEXT(funcctx, result);
+}
+
 /*****************************************************************************/
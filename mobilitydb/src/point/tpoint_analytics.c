@@ -37,6 +37,7 @@
 #include "general/temporal.h"
 /* MobilityDB */
 #include "pg_general/temporal.h"
+#include "pg_general/type_util.h"
 
 /*****************************************************************************/
 
@@ -118,4 +119,148 @@ Temporal_simplify_dp(PG_FUNCTION_ARGS)
   PG_RETURN_TEMPORAL_P(result);
 }
 
+PGDLLEXPORT Datum Temporal_simplify_max_insts(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Temporal_simplify_max_insts);
+/**
+ * @ingroup mobilitydb_temporal_analytics_simplify
+ * @brief Return a temporal sequence (set) float or point simplified to a
+ * given number of instants using a top-down Douglas-Peucker line
+ * simplification algorithm
+ * @sqlfn maxInstantsSimplify()
+ */
+Datum
+Temporal_simplify_max_insts(PG_FUNCTION_ARGS)
+{
+  Temporal *temp = PG_GETARG_TEMPORAL_P(0);
+  int npts = PG_GETARG_INT32(1);
+  bool syncdist = true;
+  if (PG_NARGS() > 2 && ! PG_ARGISNULL(2))
+    syncdist = PG_GETARG_BOOL(2);
+  Temporal *result = temporal_simplify_max_insts(temp, npts, syncdist);
+  PG_FREE_IF_COPY(temp, 0);
+  PG_RETURN_TEMPORAL_P(result);
+}
+
+PGDLLEXPORT Datum Temporal_simplify_vw(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Temporal_simplify_vw);
+/**
+ * @ingroup mobilitydb_temporal_analytics_simplify
+ * @brief Return a temporal sequence (set) float or point simplified to a
+ * given number of instants using the Visvalingam-Whyatt line simplification
+ * algorithm
+ * @sqlfn visvalingamWhyattSimplify()
+ */
+Datum
+Temporal_simplify_vw(PG_FUNCTION_ARGS)
+{
+  Temporal *temp = PG_GETARG_TEMPORAL_P(0);
+  int npts = PG_GETARG_INT32(1);
+  Temporal *result = temporal_simplify_vw(temp, npts);
+  PG_FREE_IF_COPY(temp, 0);
+  PG_RETURN_TEMPORAL_P(result);
+}
+
+/**
+ * @brief Return a temporal sequence (set) float or point simplified using an
+ * online simplifier
+ */
+static Datum
+Temporal_simplify_online(FunctionCallInfo fcinfo, bool squishe)
+{
+  Temporal *temp = PG_GETARG_TEMPORAL_P(0);
+  double dist = PG_GETARG_FLOAT8(1);
+  int maxpts = PG_GETARG_INT32(2);
+  bool syncdist = true;
+  if (PG_NARGS() > 3 && ! PG_ARGISNULL(3))
+    syncdist = PG_GETARG_BOOL(3);
+  Temporal *result = temporal_simplify_online(temp, dist, syncdist, maxpts,
+    squishe);
+  PG_FREE_IF_COPY(temp, 0);
+  PG_RETURN_TEMPORAL_P(result);
+}
+
+PGDLLEXPORT Datum Temporal_simplify_opening_window(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Temporal_simplify_opening_window);
+/**
+ * @ingroup mobilitydb_temporal_analytics_simplify
+ * @brief Return a temporal sequence (set) float or point simplified using the
+ * opening window method of the online simplifier
+ * @sqlfn openingWindowSimplify()
+ */
+Datum
+Temporal_simplify_opening_window(PG_FUNCTION_ARGS)
+{
+  return Temporal_simplify_online(fcinfo, false);
+}
+
+PGDLLEXPORT Datum Temporal_simplify_squishe(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Temporal_simplify_squishe);
+/**
+ * @ingroup mobilitydb_temporal_analytics_simplify
+ * @brief Return a temporal sequence (set) float or point simplified using the
+ * SQUISH-E method of the online simplifier
+ * @sqlfn squishESimplify()
+ */
+Datum
+Temporal_simplify_squishe(PG_FUNCTION_ARGS)
+{
+  return Temporal_simplify_online(fcinfo, true);
+}
+
+/*****************************************************************************/
+
+PGDLLEXPORT Datum Temporal_simplify_dp_pyramid(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Temporal_simplify_dp_pyramid);
+/**
+ * @ingroup mobilitydb_temporal_analytics_simplify
+ * @brief Return a level-of-detail pyramid of a temporal sequence (set) float
+ * or point simplified using a Douglas-Peucker line simplification algorithm
+ * @sqlfn douglasPeuckerPyramid()
+ */
+Datum
+Temporal_simplify_dp_pyramid(PG_FUNCTION_ARGS)
+{
+  Temporal *temp = PG_GETARG_TEMPORAL_P(0);
+  double dist = PG_GETARG_FLOAT8(1);
+  int nlevels = PG_GETARG_INT32(2);
+  bool syncdist = true;
+  if (PG_NARGS() > 3 && ! PG_ARGISNULL(3))
+    syncdist = PG_GETARG_BOOL(3);
+  Temporal **levels = temporal_simplify_dp_pyramid(temp, dist, nlevels,
+    syncdist);
+  PG_FREE_IF_COPY(temp, 0);
+  ArrayType *result = temparr_to_array(levels, nlevels, FREE_ALL);
+  PG_RETURN_ARRAYTYPE_P(result);
+}
+
+PGDLLEXPORT Datum Temporalarr_pyramid_level(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Temporalarr_pyramid_level);
+/**
+ * @ingroup mobilitydb_temporal_analytics_simplify
+ * @brief Return the level of a level-of-detail pyramid of a temporal float or
+ * point to use for a tolerance
+ * @sqlfn pyramidLevel()
+ */
+Datum
+Temporalarr_pyramid_level(PG_FUNCTION_ARGS)
+{
+  ArrayType *array = PG_GETARG_ARRAYTYPE_P(0);
+  /* Return NULL on empty array */
+  int count = ArrayGetNItems(ARR_NDIM(array), ARR_DIMS(array));
+  if (count == 0)
+  {
+    PG_FREE_IF_COPY(array, 0);
+    PG_RETURN_NULL();
+  }
+  double dist = PG_GETARG_FLOAT8(1);
+  double tolerance = PG_GETARG_FLOAT8(2);
+
+  Temporal **levels = temparr_extract(array, &count);
+  Temporal *result = temporal_copy(levels[temporal_pyramid_level(dist, count,
+    tolerance)]);
+  pfree(levels);
+  PG_FREE_IF_COPY(array, 0);
+  PG_RETURN_TEMPORAL_P(result);
+}
+
 /*****************************************************************************/
@@ -50,6 +50,19 @@
  *
  * For the time dimension, the statistics collected in Slots 3 and 4 depend on
  * the subtype. Please refer to file temporal_analyze.c for more information.
+ *
+ * For temporal points, the first free slot after those
+ * - `stakind` contains the type of statistics which is `STATISTIC_KIND_NDT`.
+ * - `stanumbers` stores the joint histogram of occurrence of features over the
+ *   spatial dimensions and the time dimension, the latter being the last one.
+ *   This enables the estimation of the selectivity of spatiotemporal boxes
+ *   without assuming that space and time are independent.
+ * - `stavalues` stores a single timestamptz, the origin of the time
+ *   dimension. Since the histogram is made of `float4` values, the time
+ *   dimension is expressed in seconds after this origin rather than after
+ *   the PostgreSQL epoch, which would only keep a resolution of about two
+ *   minutes for current timestamps. The resolution is thus relative to the
+ *   time span of the sample, e.g., about a second for a span of six months.
  */
 
 #include "pg_point/tpoint_analyze.h"
@@ -60,6 +73,7 @@
 #include <math.h>
 /* PostgreSQL */
 #include <postgres.h>
+#include <utils/timestamp.h>
 #if POSTGRESQL_VERSION_NUMBER >= 160000
   #include "varatt.h"
 #endif
@@ -68,6 +82,7 @@
 #include <meos_internal.h>
 #include "general/set.h"
 #include "general/temporal.h"
+#include "point/stbox.h"
 /* MobilityDB */
 #include "pg_general/meos_catalog.h"
 #include "pg_general/span_analyze.h"
@@ -89,6 +104,7 @@
  */
 #define STATISTIC_KIND_ND 102
 #define STATISTIC_KIND_2D 103
+#define STATISTIC_KIND_NDT 12
 #define STATISTIC_SLOT_ND 0
 #define STATISTIC_SLOT_2D 1
 
@@ -512,6 +528,14 @@ gbox_ndims(const GBOX* gbox)
  * We will populate an n-d histogram using the provided
  * sample rows. The selectivity estimators (sel and j_oinsel)
  * can then use the histogram
+ *
+ * This changes wrt the original PostGIS function. When the mode is 3, the
+ * time dimension of the temporal points, expressed in seconds after the
+ * lower bound of the first sample box, is added after the spatial dimensions
+ * and the histogram is stored in the first free slot with the kind
+ * `STATISTIC_KIND_NDT`, together with the origin of the time dimension.
+ * Since the estimators expect the time dimension to be the last one, no
+ * joint histogram is built when the sample mixes 2D and 3D boxes.
  */
 void
 gserialized_compute_stats(VacAttrStats *stats, AnalyzeAttrFetchFunc fetchfunc,
@@ -548,6 +572,8 @@ gserialized_compute_stats(VacAttrStats *stats, AnalyzeAttrFetchFunc fetchfunc,
 
   int stats_slot;            /* What slot is this data going into? (2D vs ND) */
   int stats_kind;            /* And this is what? (2D vs ND) */
+  TimestampTz torigin = 0;   /* Origin of the time dimension in mode 3 */
+  int space_ndims = 0;       /* Spatial dimensionality of the sample in mode 3 */
 
   /* Initialize sum and stddev */
   nd_box_init(&sum);
@@ -599,8 +625,15 @@ gserialized_compute_stats(VacAttrStats *stats, AnalyzeAttrFetchFunc fetchfunc,
      * a temporal point while the original function gets a geometry.
      */
     meosType type = oid_type(stats->attrtypid);
-    assert(spatialset_type(type) || tspatial_type(type));
-    if (spatialset_type(type))
+    assert(spatialset_type(type) || type == T_STBOX || tspatial_type(type));
+    if (type == T_STBOX)
+    {
+      /* Get the spatiotemporal box, skipping those without space dimension */
+      box = *DatumGetSTboxP(datum);
+      if (! MEOS_FLAGS_GET_X(box.flags))
+        continue;
+    }
+    else if (spatialset_type(type))
     {
       /* Get bounding box from spatial set */
       Set *set = DatumGetSetP(datum);
@@ -625,6 +658,9 @@ gserialized_compute_stats(VacAttrStats *stats, AnalyzeAttrFetchFunc fetchfunc,
     /* If we're in 2D mode, zero out the higher dimensions for "safety" */
     if (mode == 2)
       gbox.zmin = gbox.zmax = gbox.mmin = gbox.mmax = 0.0;
+    /* In space-time mode skip the boxes without time dimension */
+    else if (mode == 3 && ! MEOS_FLAGS_GET_T(box.flags))
+      continue;
 
     /* Check bounds for validity (finite and not NaN) */
     if (! gbox_is_valid(&gbox))
@@ -632,16 +668,45 @@ gserialized_compute_stats(VacAttrStats *stats, AnalyzeAttrFetchFunc fetchfunc,
       continue;
     }
 
+    /*
+     * In space-time mode the time dimension follows the spatial dimensions,
+     * which must then be the same for all the boxes of the sample. A sample
+     * mixing dimensionalities does not get a joint histogram
+     */
+    if (mode == 3)
+    {
+      if (! space_ndims)
+        space_ndims = gbox_ndims(&gbox);
+      else if (gbox_ndims(&gbox) != space_ndims)
+      {
+        for (i = 0; i < notnull_cnt; i++)
+          pfree((void *) sample_boxes[i]);
+        pfree(sample_boxes);
+        return;
+      }
+    }
+
     /*
      * In N-D mode, set the ndims to the maximum dimensionality found
      * in the sample. Otherwise, leave at ndims == 2.
      */
     if (mode != 2)
-      ndims = Max(gbox_ndims(&gbox), ndims);
+      ndims = Max(gbox_ndims(&gbox) + (mode == 3 ? 1 : 0), ndims);
 
     /* Convert gbox to n-d box */
     nd_box = palloc(sizeof(ND_BOX));
     nd_box_from_gbox(&gbox, nd_box);
+    if (mode == 3)
+    {
+      /* The time dimension follows the spatial dimensions */
+      d = space_ndims;
+      if (! notnull_cnt)
+        torigin = DatumGetTimestampTz(box.period.lower);
+      nd_box->min[d] = (float4) ((double)
+        (DatumGetTimestampTz(box.period.lower) - torigin) / USECS_PER_SEC);
+      nd_box->max[d] = (float4) ((double)
+        (DatumGetTimestampTz(box.period.upper) - torigin) / USECS_PER_SEC);
+    }
 
     /* Cache n-d bounding box */
     sample_boxes[notnull_cnt] = nd_box;
@@ -921,6 +986,13 @@ gserialized_compute_stats(VacAttrStats *stats, AnalyzeAttrFetchFunc fetchfunc,
       pfree((void *) sample_boxes[i]);
   pfree(sample_boxes);
 
+  /* The joint histogram is optional, do not invalidate the other stats */
+  if (! histogram_features && mode == 3)
+  {
+    pfree(nd_stats);
+    return;
+  }
+
   /* Error out if we got no sample information */
   if (! histogram_features)
   {
@@ -939,6 +1011,21 @@ gserialized_compute_stats(VacAttrStats *stats, AnalyzeAttrFetchFunc fetchfunc,
     stats_slot = STATISTIC_SLOT_2D;
     stats_kind = STATISTIC_KIND_2D;
   }
+  else if (mode == 3)
+  {
+    /* Use the first slot not taken by the spatial and temporal statistics */
+    for (stats_slot = 0; stats_slot < STATISTIC_NUM_SLOTS; stats_slot++)
+    {
+      if (stats->stakind[stats_slot] == 0)
+        break;
+    }
+    if (stats_slot == STATISTIC_NUM_SLOTS)
+    {
+      pfree(nd_stats);
+      return;
+    }
+    stats_kind = STATISTIC_KIND_NDT;
+  }
   else
   {
     stats_slot = STATISTIC_SLOT_ND;
@@ -950,6 +1037,20 @@ gserialized_compute_stats(VacAttrStats *stats, AnalyzeAttrFetchFunc fetchfunc,
   stats->staop[stats_slot] = InvalidOid;
   stats->stanumbers[stats_slot] = (float4 *) nd_stats;
   stats->numnumbers[stats_slot] = (int) (nd_stats_size / sizeof(float4));
+  if (mode == 3)
+  {
+    /* Store the origin of the time dimension */
+    old_context = MemoryContextSwitchTo(stats->anl_context);
+    Datum *origin_values = palloc(sizeof(Datum));
+    MemoryContextSwitchTo(old_context);
+    origin_values[0] = TimestampTzGetDatum(torigin);
+    stats->stavalues[stats_slot] = origin_values;
+    stats->numvalues[stats_slot] = 1;
+    stats->statypid[stats_slot] = type_oid(T_TIMESTAMPTZ);
+    stats->statyplen[stats_slot] = sizeof(TimestampTz);
+    stats->statypbyval[stats_slot] = FLOAT8PASSBYVAL;
+    stats->statypalign[stats_slot] = 'd';
+  }
   stats->stanullfrac = (float4) null_cnt / sample_rows;
   stats->stawidth = (int32) (total_width / notnull_cnt);
   stats->stadistinct = -1.0f;
@@ -1034,6 +1135,110 @@ spatialset_compute_stats(VacAttrStats *stats, AnalyzeAttrFetchFunc fetchfunc,
   return;
 }
 
+/*****************************************************************************
+ * Statistics for spatiotemporal boxes
+ *****************************************************************************/
+
+/**
+ * @brief Compute the statistics for spatiotemporal box columns (callback
+ * function)
+ * @details The same statistics as for temporal points are collected, where
+ * the statistics of a dimension are only collected if the boxes have this
+ * dimension
+ */
+static void
+stbox_compute_stats(VacAttrStats *stats, AnalyzeAttrFetchFunc fetchfunc,
+  int sample_rows, double total_rows)
+{
+  int notnull_cnt = 0;      /* # not null rows in the sample */
+  int null_cnt = 0;         /* # null rows in the sample */
+  int time_cnt = 0;         /* # rows with time dimension in the sample */
+  int slot_idx = 2;         /* Starting slot for storing temporal statistics */
+  bool space = false;       /* Whether some box has space dimension */
+
+  SpanBound *time_lowers = palloc(sizeof(SpanBound) * sample_rows);
+  SpanBound *time_uppers = palloc(sizeof(SpanBound) * sample_rows);
+  float8 *time_lengths = palloc(sizeof(float8) * sample_rows);
+
+  /* First scan for obtaining the number of nulls and not nulls and the
+   * temporal extents */
+  for (int i = 0; i < sample_rows; i++)
+  {
+    /* Get value and determine whether is null */
+    bool is_null;
+    Datum value = fetchfunc(stats, i, &is_null);
+    /* Skip all NULLs. */
+    if (is_null)
+    {
+      null_cnt++;
+      continue;
+    }
+
+    /* Remember time bounds and length for further usage in histograms */
+    const STBox *box = DatumGetSTboxP(value);
+    if (MEOS_FLAGS_GET_X(box->flags))
+      space = true;
+    if (MEOS_FLAGS_GET_T(box->flags))
+    {
+      SpanBound tstzspan_lower, tstzspan_upper;
+      span_deserialize(&box->period, &tstzspan_lower, &tstzspan_upper);
+      time_lowers[time_cnt] = tstzspan_lower;
+      time_uppers[time_cnt] = tstzspan_upper;
+      time_lengths[time_cnt++] = distance_value_value(tstzspan_upper.val,
+        tstzspan_lower.val, T_TIMESTAMPTZ);
+    }
+
+    /* Increment our "good feature" count */
+    notnull_cnt++;
+
+    /* Give backend a chance of interrupting us */
+    vacuum_delay_point();
+  }
+
+  /* We can only compute real stats if we found some non-null values. */
+  if (notnull_cnt > 0)
+  {
+    stats->stats_valid = true;
+    /* Do the simple null-frac and width stats */
+    stats->stanullfrac = (float4) null_cnt / (float4) sample_rows;
+    stats->stawidth = (int) sizeof(STBox);
+
+    /* Estimate that non-null values are unique */
+    stats->stadistinct = (float4) (-1.0 * (1.0 - stats->stanullfrac));
+
+    /* Compute statistics for spatial dimension */
+    if (space)
+    {
+      /* 2D Mode */
+      gserialized_compute_stats(stats, fetchfunc, sample_rows, total_rows, 2);
+      /* ND Mode */
+      gserialized_compute_stats(stats, fetchfunc, sample_rows, total_rows, 0);
+    }
+
+    /* Last argument is false to compute statistics for time dimension */
+    if (time_cnt > 0)
+      span_compute_stats_generic(stats, time_cnt, &slot_idx, time_lowers,
+        time_uppers, time_lengths, false);
+
+    /* Compute joint statistics for the spatial and time dimensions */
+    if (space && time_cnt > 0)
+      gserialized_compute_stats(stats, fetchfunc, sample_rows, total_rows, 3);
+  }
+  else if (null_cnt > 0)
+  {
+    /* We found only nulls; assume the column is entirely null */
+    stats->stats_valid = true;
+    stats->stanullfrac = 1.0;
+    stats->stawidth = 0;       /* unknown */
+    stats->stadistinct = 0.0;  /* unknown */
+  }
+
+  pfree(time_lowers);
+  pfree(time_uppers);
+  pfree(time_lengths);
+  return;
+}
+
 /*****************************************************************************
  * Statistics for temporal points
  *****************************************************************************/
@@ -1119,6 +1324,9 @@ tpoint_compute_stats(VacAttrStats *stats, AnalyzeAttrFetchFunc fetchfunc,
     /* Last argument is false to compute statistics for time dimension */
     span_compute_stats_generic(stats, notnull_cnt, &slot_idx, time_lowers,
       time_uppers, time_lengths, false);
+
+    /* Compute joint statistics for the spatial and time dimensions */
+    gserialized_compute_stats(stats, fetchfunc, sample_rows, total_rows, 3);
   }
   else if (null_cnt > 0)
   {
@@ -1163,6 +1371,29 @@ Spatialset_analyze(PG_FUNCTION_ARGS)
   PG_RETURN_BOOL(true);
 }
 
+PGDLLEXPORT Datum Stbox_analyze(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Stbox_analyze);
+/**
+ * @brief Compute the statistics for spatiotemporal box columns
+ */
+Datum
+Stbox_analyze(PG_FUNCTION_ARGS)
+{
+  VacAttrStats *stats = (VacAttrStats *) PG_GETARG_POINTER(0);
+
+  /*
+   * Call the standard typanalyze function. It may fail to find needed
+   * operators, in which case we also can't do anything, so just fail.
+   */
+  if (! std_typanalyze(stats))
+    PG_RETURN_BOOL(false);
+
+  /* Set the callback function to compute statistics. */
+  stats->compute_stats = stbox_compute_stats;
+
+  PG_RETURN_BOOL(true);
+}
+
 PGDLLEXPORT Datum Tpoint_analyze(PG_FUNCTION_ARGS);
 PG_FUNCTION_INFO_V1(Tpoint_analyze);
 /**
@@ -40,6 +40,7 @@
 /* MEOS */
 #include <meos.h>
 #include "general/temporal.h"
+#include "point/pgis_types.h"
 #include "point/stbox.h"
 /* MobilityDB */
 #include "pg_point/postgis.h"
@@ -132,7 +133,10 @@ NAI_geo_tpoint(PG_FUNCTION_ARGS)
 {
   GSERIALIZED *gs = PG_GETARG_GSERIALIZED_P(0);
   Temporal *temp = PG_GETARG_TEMPORAL_P(1);
-  TInstant *result = nai_tpoint_geo(temp, gs);
+  PreparedGeo *pgeo = FLAGS_GET_GEODETIC(gs->gflags) ?
+    prepgeo_cache_get(fcinfo, gs) : NULL;
+  TInstant *result = pgeo ? nai_tpoint_prepgeo(temp, pgeo) :
+    nai_tpoint_geo(temp, gs);
   PG_FREE_IF_COPY(gs, 0);
   PG_FREE_IF_COPY(temp, 1);
   if (! result)
@@ -153,7 +157,10 @@ NAI_tpoint_geo(PG_FUNCTION_ARGS)
 {
   GSERIALIZED *gs = PG_GETARG_GSERIALIZED_P(1);
   Temporal *temp = PG_GETARG_TEMPORAL_P(0);
-  TInstant *result = nai_tpoint_geo(temp, gs);
+  PreparedGeo *pgeo = FLAGS_GET_GEODETIC(gs->gflags) ?
+    prepgeo_cache_get(fcinfo, gs) : NULL;
+  TInstant *result = pgeo ? nai_tpoint_prepgeo(temp, pgeo) :
+    nai_tpoint_geo(temp, gs);
   PG_FREE_IF_COPY(temp, 0);
   PG_FREE_IF_COPY(gs, 1);
   if (! result)
@@ -186,6 +193,36 @@ NAI_tpoint_tpoint(PG_FUNCTION_ARGS)
  * These functions are only available for geometries
  *****************************************************************************/
 
+/**
+ * @brief Return the prepared geography used for computing the nearest
+ * approach distance, or NULL if the distance is computed without it
+ * @details A geography repeated in consecutive calls is taken from the cache
+ * of the function. Since the distance on the sphere is only computed by the
+ * prepared functions, a geography is prepared for the single call when the
+ * sphere is requested and the cache does not have it yet.
+ * @param[in] fcinfo Catalog information about the external function
+ * @param[in] gs Geometry/geography
+ * @param[out] tofree True when the caller must free the result
+ */
+static PreparedGeo *
+nad_prepgeo(FunctionCallInfo fcinfo, const GSERIALIZED *gs, bool *tofree)
+{
+  *tofree = false;
+  if (! FLAGS_GET_GEODETIC(gs->gflags))
+    return NULL;
+  bool use_spheroid = (PG_NARGS() > 2) ? PG_GETARG_BOOL(2) : true;
+  PreparedGeo *result = prepgeo_cache_get(fcinfo, gs);
+  if (! result && ! use_spheroid)
+  {
+    result = geog_prepare(gs, false);
+    *tofree = true;
+  }
+  /* The option may change between calls with the same geography */
+  if (result)
+    result->use_spheroid = use_spheroid;
+  return result;
+}
+
 PGDLLEXPORT Datum NAD_geo_tpoint(PG_FUNCTION_ARGS);
 PG_FUNCTION_INFO_V1(NAD_geo_tpoint);
 /**
@@ -200,7 +237,12 @@ NAD_geo_tpoint(PG_FUNCTION_ARGS)
 {
   GSERIALIZED *gs = PG_GETARG_GSERIALIZED_P(0);
   Temporal *temp = PG_GETARG_TEMPORAL_P(1);
-  double result = nad_tpoint_geo(temp, gs);
+  bool tofree;
+  PreparedGeo *pgeo = nad_prepgeo(fcinfo, gs, &tofree);
+  double result = pgeo ? nad_tpoint_prepgeo(temp, pgeo) :
+    nad_tpoint_geo(temp, gs);
+  if (tofree)
+    prepared_geo_free(pgeo);
   PG_FREE_IF_COPY(gs, 0);
   PG_FREE_IF_COPY(temp, 1);
   if (result < 0)
@@ -222,7 +264,12 @@ NAD_tpoint_geo(PG_FUNCTION_ARGS)
 {
   Temporal *temp = PG_GETARG_TEMPORAL_P(0);
   GSERIALIZED *gs = PG_GETARG_GSERIALIZED_P(1);
-  double result = nad_tpoint_geo(temp, gs);
+  bool tofree;
+  PreparedGeo *pgeo = nad_prepgeo(fcinfo, gs, &tofree);
+  double result = pgeo ? nad_tpoint_prepgeo(temp, pgeo) :
+    nad_tpoint_geo(temp, gs);
+  if (tofree)
+    prepared_geo_free(pgeo);
   PG_FREE_IF_COPY(temp, 0);
   PG_FREE_IF_COPY(gs, 1);
   if (result < 0)
@@ -40,6 +40,7 @@
 #include <postgres.h>
 #include <utils/lsyscache.h>
 #include <utils/syscache.h>
+#include <utils/timestamp.h>
 /* MEOS */
 #include <meos.h>
 #include <meos_internal.h>
@@ -677,6 +678,114 @@ geo_sel(VariableStatData *vardata, const STBox *box, meosOper oper)
   return selec;
 }
 
+/**
+ * @brief Return an estimate of the selectivity of a spatiotemporal search box
+ * by looking at the joint space-time histogram in the statistics
+ *
+ * Contrary to the product of the spatial and temporal selectivities, the
+ * joint histogram accounts for the correlation between the location and the
+ * time of the features, e.g., when vehicles move through different regions
+ * at different times of the day. Only the bounding box operators are
+ * considered since these are the only ones supported by the histogram.
+ * @return The selectivity or -1 if it cannot be estimated from the joint
+ * histogram, in which case the spatial and temporal dimensions must be
+ * estimated separately
+ */
+Selectivity
+geo_time_sel(VariableStatData *vardata, const STBox *box, meosOper oper)
+{
+  ND_STATS *nd_stats;
+  ND_BOX nd_box;
+  ND_IBOX nd_ibox;
+  int at[ND_DIMS];
+  double cell_size[ND_DIMS];
+  double min[ND_DIMS];
+  double total_count = 0.0;
+  int d, ndims, tdim;
+  TimestampTz torigin;
+  Selectivity selec;
+
+  if (! (oper == OVERLAPS_OP || oper == CONTAINS_OP ||
+      oper == CONTAINED_OP || oper == SAME_OP) ||
+      ! MEOS_FLAGS_GET_X(box->flags) || ! MEOS_FLAGS_GET_T(box->flags) ||
+      ! HeapTupleIsValid(vardata->statsTuple))
+    return -1;
+
+  /* Get the joint statistics, which are only collected for temporal points */
+  nd_stats = pg_ndt_stats_from_tuple(vardata->statsTuple, &torigin);
+  if (! nd_stats)
+    return -1;
+
+  /* The time dimension is the last one of the histogram */
+  ndims = (int) roundf(nd_stats->ndims);
+  tdim = ndims - 1;
+  if (tdim != ((MEOS_FLAGS_GET_Z(box->flags) ||
+      MEOS_FLAGS_GET_GEODETIC(box->flags)) ? 3 : 2))
+  {
+    pfree(nd_stats);
+    return -1;
+  }
+
+  /* Initialize nd_box with the spatial and time dimensions of the box */
+  nd_box_from_stbox(box, &nd_box);
+  nd_box.min[tdim] = (float4) ((double)
+    (DatumGetTimestampTz(box->period.lower) - torigin) / USECS_PER_SEC);
+  nd_box.max[tdim] = (float4) ((double)
+    (DatumGetTimestampTz(box->period.upper) - torigin) / USECS_PER_SEC);
+
+  /* Full histogram extent is disjoint from or contained in the box? */
+  if (! nd_box_intersects(&(nd_stats->extent), &nd_box, ndims))
+  {
+    pfree(nd_stats);
+    return 0.0;
+  }
+  if (nd_box_contains(&nd_box, &(nd_stats->extent), ndims))
+  {
+    pfree(nd_stats);
+    return 1.0;
+  }
+
+  /* Calculate the overlap of the box on the histogram */
+  if (! nd_box_overlap(nd_stats, &nd_box, &nd_ibox))
+  {
+    pfree(nd_stats);
+    return FALLBACK_ND_SEL;
+  }
+
+  /* Work out some measurements of the histogram and initialize the counter */
+  memset(at, 0, sizeof(int) * ND_DIMS);
+  for (d = 0; d < ndims; d++)
+  {
+    min[d] = nd_stats->extent.min[d];
+    cell_size[d] = (nd_stats->extent.max[d] - min[d]) / nd_stats->size[d];
+    at[d] = nd_ibox.min[d];
+  }
+
+  /* Move through all the overlap values and sum them */
+  do
+  {
+    ND_BOX nd_cell;
+    memset(&nd_cell, 0, sizeof(ND_BOX));
+    /* We have to pro-rate partially overlapped cells. */
+    for (d = 0; d < ndims; d++)
+    {
+      nd_cell.min[d] = (float4) (min[d] + (at[d]+0) * cell_size[d]);
+      nd_cell.max[d] = (float4) (min[d] + (at[d]+1) * cell_size[d]);
+    }
+    total_count += nd_stats->value[nd_stats_value_index(nd_stats, at)] *
+      nd_box_ratio_overlaps(&nd_box, &nd_cell, ndims);
+  }
+  while (nd_increment(&nd_ibox, ndims, at));
+
+  /* Scale by the number of features in our histogram to get the proportion */
+  selec = total_count / nd_stats->histogram_features;
+  pfree(nd_stats);
+
+  /* Prevent rounding overflows */
+  CLAMP_PROBABILITY(selec);
+  return selec;
+}
+
 /*****************************************************************************
  * Join selectivity
  *****************************************************************************/
@@ -736,6 +845,80 @@ pg_get_nd_stats(const Oid tableid, AttrNumber att_num, int mode, bool only_paren
   return nd_stats;
 }
 
+/**
+ * @brief Get the joint space-time statistics from the tuple
+ * @param[in] stats_tuple Statistics tuple
+ * @param[out] torigin Origin of the time dimension of the histogram
+ */
+ND_STATS *
+pg_ndt_stats_from_tuple(HeapTuple stats_tuple, TimestampTz *torigin)
+{
+  AttStatsSlot sslot;
+  ND_STATS *nd_stats;
+
+  if (! get_attstatsslot(&sslot, stats_tuple, STATISTIC_KIND_NDT, InvalidOid,
+      ATTSTATSSLOT_NUMBERS | ATTSTATSSLOT_VALUES))
+    return NULL;
+  if (sslot.nvalues != 1)
+  {
+    free_attstatsslot(&sslot);
+    return NULL;
+  }
+
+  /* Clone the stats here so we can release the attstatsslot immediately */
+  nd_stats = palloc(sizeof(float4) * sslot.nnumbers);
+  memcpy(nd_stats, sslot.numbers, sizeof(float4) * sslot.nnumbers);
+  *torigin = DatumGetTimestampTz(sslot.values[0]);
+  free_attstatsslot(&sslot);
+  return nd_stats;
+}
+
+/**
+ * @brief Pull the joint space-time statistics object from the PgSQL system
+ * catalogs
+ * @param[in] tableid Table identifier
+ * @param[in] att_num Attribute number
+ * @param[out] torigin Origin of the time dimension of the histogram
+ */
+ND_STATS *
+pg_get_ndt_stats(const Oid tableid, AttrNumber att_num, TimestampTz *torigin)
+{
+  HeapTuple stats_tuple;
+  ND_STATS *nd_stats = NULL;
+
+  /* First pull the stats tuple for the whole tree and fall back to the
+   * stats of the main table */
+  stats_tuple = SearchSysCache3(STATRELATTINH, ObjectIdGetDatum(tableid),
+    Int16GetDatum(att_num), BoolGetDatum(true));
+  if (! stats_tuple)
+    stats_tuple = SearchSysCache3(STATRELATTINH, ObjectIdGetDatum(tableid),
+      Int16GetDatum(att_num), BoolGetDatum(false));
+  if (stats_tuple)
+  {
+    nd_stats = pg_ndt_stats_from_tuple(stats_tuple, torigin);
+    ReleaseSysCache(stats_tuple);
+  }
+  return nd_stats;
+}
+
+/**
+ * @brief Shift the time dimension of a joint space-time histogram
+ * @details The time dimension of the histograms is expressed in seconds after
+ * the origin stored with the statistics. Before comparing the histograms of
+ * two columns, the time dimension of one of them is shifted so that both
+ * are expressed with respect to the same origin.
+ * @param[inout] nd_stats Histogram
+ * @param[in] shift Number of seconds to add to the time dimension
+ */
+void
+nd_stats_shift_time(ND_STATS *nd_stats, double shift)
+{
+  int tdim = (int) roundf(nd_stats->ndims) - 1;
+  nd_stats->extent.min[tdim] = (float4) (nd_stats->extent.min[tdim] + shift);
+  nd_stats->extent.max[tdim] = (float4) (nd_stats->extent.max[tdim] + shift);
+  return;
+}
+
 /**
 * Given two statistics histograms, what is the selectivity
 * of a join driven by the && operator?
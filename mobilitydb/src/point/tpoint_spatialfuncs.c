@@ -53,6 +53,7 @@
 #include "pg_general/temporal.h"
 #include "pg_general/type_util.h"
 #include "pg_point/postgis.h"
+#include "pg_point/tpoint_spatialfuncs.h"
 
 /*****************************************************************************
  * Trajectory function
@@ -269,6 +270,33 @@ Tpoint_tfloat_to_geomeas(PG_FUNCTION_ARGS)
  * Mapbox Vector Tile functions for temporal points.
  *****************************************************************************/
 
+/**
+ * @brief Return the geometry and the timestamps of a temporal point
+ * transformed to the Mapbox Vector Tile representation as a composite value
+ */
+static Datum
+geom_times_tuple(FunctionCallInfo fcinfo, GSERIALIZED *geom, int64 *times,
+  int count)
+{
+  ArrayType *timesarr = int64arr_to_array(times, count);
+  /* Build a tuple description for the function output */
+  TupleDesc resultTupleDesc;
+  get_call_result_type(fcinfo, NULL, &resultTupleDesc);
+  BlessTupleDesc(resultTupleDesc);
+
+  /* Construct the result */
+  HeapTuple resultTuple;
+  bool result_is_null[2] = {0,0}; /* needed to say no value is null */
+  Datum result_values[2]; /* used to construct the composite return value */
+  /* Store geometry */
+  result_values[0] = PointerGetDatum(geom);
+  /* Store timestamp array */
+  result_values[1] = PointerGetDatum(timesarr);
+  /* Form tuple and return */
+  resultTuple = heap_form_tuple(resultTupleDesc, result_values, result_is_null);
+  return HeapTupleGetDatum(resultTuple);
+}
+
 PGDLLEXPORT Datum Tpoint_AsMVTGeom(PG_FUNCTION_ARGS);
 PG_FUNCTION_INFO_V1(Tpoint_AsMVTGeom);
 /**
@@ -297,29 +325,153 @@ Tpoint_AsMVTGeom(PG_FUNCTION_ARGS)
     PG_RETURN_NULL();
   }
 
-  ArrayType *timesarr = int64arr_to_array(times, count);
-  /* Build a tuple description for the function output */
-  TupleDesc resultTupleDesc;
-  get_call_result_type(fcinfo, NULL, &resultTupleDesc);
-  BlessTupleDesc(resultTupleDesc);
+  Datum result = geom_times_tuple(fcinfo, geom, times, count);
+  PG_FREE_IF_COPY(temp, 0);
+  PG_RETURN_DATUM(result);
+}
 
-  /* Construct the result */
-  HeapTuple resultTuple;
-  bool result_is_null[2] = {0,0}; /* needed to say no value is null */
-  Datum result_values[2]; /* used to construct the composite return value */
-  Datum result; /* the actual composite return value */
-  /* Store geometry */
-  result_values[0] = PointerGetDatum(geom);
-  /* Store timestamp array */
-  result_values[1] = PointerGetDatum(timesarr);
-  /* Form tuple and return */
-  resultTuple = heap_form_tuple(resultTupleDesc, result_values, result_is_null);
-  result = HeapTupleGetDatum(resultTuple);
+PGDLLEXPORT Datum Tpointarr_AsMVTGeom(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tpointarr_AsMVTGeom);
+/**
+ * @ingroup mobilitydb_temporal_spatial_transf
+ * @brief Return a temporal point transformed to the Mapbox Vector Tile
+ * representation using a level-of-detail pyramid of the temporal point
+ * @sqlfn asMVTGeom()
+ */
+Datum
+Tpointarr_AsMVTGeom(PG_FUNCTION_ARGS)
+{
+  ArrayType *array = PG_GETARG_ARRAYTYPE_P(0);
+  /* Return NULL on empty array */
+  int nlevels = ArrayGetNItems(ARR_NDIM(array), ARR_DIMS(array));
+  if (nlevels == 0)
+  {
+    PG_FREE_IF_COPY(array, 0);
+    PG_RETURN_NULL();
+  }
+  double dist = PG_GETARG_FLOAT8(1);
+  STBox *bounds = PG_GETARG_STBOX_P(2);
+  int32_t extent = PG_GETARG_INT32(3);
+  int32_t buffer = PG_GETARG_INT32(4);
+  bool clip_geom = PG_GETARG_BOOL(5);
 
-  PG_FREE_IF_COPY(temp, 0);
+  Temporal **levels = temparr_extract(array, &nlevels);
+  GSERIALIZED *geom;
+  int64 *times; /* Timestamps are returned in Unix time */
+  int count;
+  bool found = tpointarr_AsMVTGeom((const Temporal **) levels, nlevels, dist,
+    bounds, extent, buffer, clip_geom, &geom, &times, &count);
+  pfree(levels);
+  if (! found)
+  {
+    PG_FREE_IF_COPY(array, 0);
+    PG_RETURN_NULL();
+  }
+
+  Datum result = geom_times_tuple(fcinfo, geom, times, count);
+  PG_FREE_IF_COPY(array, 0);
   PG_RETURN_DATUM(result);
 }
 
+/**
+ * @brief Structure storing the state of the encoding of an array of temporal
+ * points as Mapbox Vector Tile geometries
+ */
+typedef struct
+{
+  int i;                /**< Current temporal point */
+  int count;            /**< Number of temporal points */
+  uint32_t *geoms;      /**< Command streams of the geometries */
+  int *geomoffsets;     /**< Start of every command stream */
+  uint8_t *types;       /**< Geometry types */
+  int64 *times;         /**< Timestamps of the vertices */
+  int *timesoffsets;    /**< Start of the timestamps of every point */
+} MVTCommandsState;
+
+PGDLLEXPORT Datum Tpointarr_AsMVTCommands(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tpointarr_AsMVTCommands);
+/**
+ * @ingroup mobilitydb_temporal_spatial_transf
+ * @brief Return an array of temporal points encoded as Mapbox Vector Tile
+ * geometries
+ * @sqlfn asMVTCommands()
+ */
+Datum
+Tpointarr_AsMVTCommands(PG_FUNCTION_ARGS)
+{
+  FuncCallContext *funcctx;
+  MVTCommandsState *state;
+
+  /* If the function is being called for the first time */
+  if (SRF_IS_FIRSTCALL())
+  {
+    /* Initialize the FuncCallContext */
+    funcctx = SRF_FIRSTCALL_INIT();
+    /* Switch to memory context appropriate for multiple function calls */
+    MemoryContext oldcontext =
+      MemoryContextSwitchTo(funcctx->multi_call_memory_ctx);
+
+    /* Get input parameters */
+    ArrayType *array = PG_GETARG_ARRAYTYPE_P(0);
+    STBox *bounds = PG_GETARG_STBOX_P(1);
+    int32_t extent = PG_GETARG_INT32(2);
+    int32_t buffer = PG_GETARG_INT32(3);
+    bool clip_geom = PG_GETARG_BOOL(4);
+
+    /* Create function state */
+    state = palloc0(sizeof(MVTCommandsState));
+    int count = ArrayGetNItems(ARR_NDIM(array), ARR_DIMS(array));
+    if (count > 0)
+    {
+      Temporal **temparr = temparr_extract(array, &count);
+      tpointarr_AsMVTCommands((const Temporal **) temparr, count, bounds,
+        extent, buffer, clip_geom, &state->geoms, &state->geomoffsets,
+        &state->types, &state->times, &state->timesoffsets);
+      state->count = count;
+      pfree(temparr);
+    }
+    funcctx->user_fctx = state;
+    /* Build a tuple description for the function output */
+    get_call_result_type(fcinfo, 0, &funcctx->tuple_desc);
+    BlessTupleDesc(funcctx->tuple_desc);
+    MemoryContextSwitchTo(oldcontext);
+  }
+
+  /* Stuff done on every call of the function */
+  funcctx = SRF_PERCALL_SETUP();
+  /* Get state */
+  state = funcctx->user_fctx;
+  /* Skip the temporal points that do not intersect the tile */
+  while (state->i < state->count && state->types[state->i] == 0)
+    state->i++;
+  /* Stop when we've used up all temporal points */
+  if (state->i == state->count)
+    SRF_RETURN_DONE(funcctx);
+
+  /* Build the command stream and the timestamps of the current point */
+  int i = state->i;
+  int ngeoms = state->geomoffsets[i + 1] - state->geomoffsets[i];
+  Datum *geoms = palloc(sizeof(Datum) * ngeoms);
+  for (int j = 0; j < ngeoms; j++)
+    geoms[j] = Int32GetDatum((int32) state->geoms[state->geomoffsets[i] + j]);
+  bool isnull[4] = {0,0,0,0}; /* needed to say no value is null */
+  Datum tuple_arr[4]; /* used to construct the composite return value */
+  /* The identifier is the position of the temporal point in the array */
+  tuple_arr[0] = Int32GetDatum(i + 1);
+  tuple_arr[1] = Int32GetDatum(state->types[i]);
+  tuple_arr[2] = PointerGetDatum(datumarr_to_array(geoms, ngeoms, T_INT4));
+  tuple_arr[3] = PointerGetDatum(int64arr_to_array(
+    &state->times[state->timesoffsets[i]],
+    state->timesoffsets[i + 1] - state->timesoffsets[i]));
+  pfree(geoms);
+  /* Advance state */
+  state->i++;
+  /* Form tuple and return */
+  HeapTuple tuple = heap_form_tuple(funcctx->tuple_desc, tuple_arr, isnull);
+  Datum result = HeapTupleGetDatum(tuple);
+  SRF_RETURN_NEXT(funcctx, result);
+}
+
 /*****************************************************************************
  * Functions for extracting coordinates
  *****************************************************************************/
@@ -696,8 +848,10 @@ Tpoint_restrict_geom_time(FunctionCallInfo fcinfo, bool atfunc, bool resttime)
     zspan = PG_GETARG_SPAN_P(2);
     period = PG_GETARG_SPAN_P(3);
   }
-  Temporal *result = tpoint_restrict_geom_time(temp, geo, zspan, period,
-    atfunc);
+  PreparedGeo *pgeo = prepgeo_cache_get(fcinfo, geo);
+  Temporal *result = pgeo ?
+    tpoint_restrict_prepgeo_time(temp, pgeo, zspan, period, atfunc) :
+    tpoint_restrict_geom_time(temp, geo, zspan, period, atfunc);
   PG_FREE_IF_COPY(temp, 0);
   PG_FREE_IF_COPY(geo, 1);
   if (! result)
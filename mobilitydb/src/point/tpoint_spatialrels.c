@@ -48,15 +48,102 @@
 
 #include "point/tpoint_spatialrels.h"
 
+/* PostgreSQL */
+#include <funcapi.h>
+#include <utils/timestamp.h>
 /* MEOS */
 #include <meos.h>
 #include <meos_internal.h>
 #include "general/temporal.h" /* For varfunc */
+#include "point/tpoint_restrfuncs.h"
 #include "point/tpoint_spatialfuncs.h"
 /* MobilityDB */
+#include "pg_general/type_util.h"
 #include "pg_point/postgis.h"
 #include "pg_point/tpoint_spatialfuncs.h"
 
+/*****************************************************************************
+ * Prepared geometry cache
+ *****************************************************************************/
+
+/**
+ * @brief Structure kept in the @p fn_extra field of the spatial relationships,
+ * the restriction functions, and the nearest approach functions for caching
+ * the prepared version of the geometry argument
+ * @details As in PostGIS, the geometry is only prepared when the same value
+ * is received in two consecutive calls, which is the case when a few zones
+ * are tested against many temporal points. The edge index of a polygonal
+ * geometry and the tiles of a geometry with many vertices are computed at the
+ * same time so that they are allocated in the memory context of the function.
+ */
+typedef struct
+{
+  MemoryContextCallback callback; /**< Frees the GEOS objects on reset */
+  GSERIALIZED *gs;                /**< Copy of the last geometry received */
+  int count;                      /**< Number of consecutive calls with it */
+  PreparedGeo *pgeo;              /**< Prepared geometry, NULL if not yet */
+} PrepGeoCache;
+
+/**
+ * @brief Free the prepared geometry kept in the cache
+ * @note Called when the memory context of the function is reset since the
+ * GEOS objects are not allocated with @p palloc
+ */
+static void
+prepgeo_cache_free(void *arg)
+{
+  PrepGeoCache *cache = (PrepGeoCache *) arg;
+  if (cache->pgeo)
+    prepared_geo_free(cache->pgeo);
+  cache->pgeo = NULL;
+  return;
+}
+
+/**
+ * @brief Return the prepared version of a geometry argument from the cache of
+ * the function, or NULL if the geometry has not been seen twice in a row
+ * @param[in] fcinfo Catalog information about the external function
+ * @param[in] gs Geometry
+ */
+PreparedGeo *
+prepgeo_cache_get(FunctionCallInfo fcinfo, const GSERIALIZED *gs)
+{
+  MemoryContext mcxt = fcinfo->flinfo->fn_mcxt;
+  PrepGeoCache *cache = (PrepGeoCache *) fcinfo->flinfo->fn_extra;
+  if (! cache)
+  {
+    cache = MemoryContextAllocZero(mcxt, sizeof(PrepGeoCache));
+    cache->callback.func = &prepgeo_cache_free;
+    cache->callback.arg = (void *) cache;
+    MemoryContextRegisterResetCallback(mcxt, &cache->callback);
+    fcinfo->flinfo->fn_extra = cache;
+  }
+
+  size_t size = VARSIZE(gs);
+  if (cache->gs && VARSIZE(cache->gs) == size &&
+      memcmp(cache->gs, gs, size) == 0)
+  {
+    if (! cache->pgeo && ++cache->count >= 2)
+    {
+      MemoryContext oldcxt = MemoryContextSwitchTo(mcxt);
+      cache->pgeo = geo_prepare(cache->gs);
+      prepgeo_polyindex(cache->pgeo);
+      prepgeo_tiles(cache->pgeo);
+      MemoryContextSwitchTo(oldcxt);
+    }
+    return cache->pgeo;
+  }
+
+  /* A different geometry, keep a copy of it and start counting again */
+  prepgeo_cache_free(cache);
+  if (cache->gs)
+    pfree(cache->gs);
+  cache->gs = MemoryContextAlloc(mcxt, size);
+  memcpy(cache->gs, gs, size);
+  cache->count = 1;
+  return NULL;
+}
+
 /*****************************************************************************
  * Generic ever/always spatial relationship functions
  *****************************************************************************/
@@ -99,8 +186,15 @@ EAcontains_geo_tpoint(FunctionCallInfo fcinfo, bool ever)
 {
   GSERIALIZED *gs = PG_GETARG_GSERIALIZED_P(0);
   Temporal *temp = PG_GETARG_TEMPORAL_P(1);
-  int result = ever ? econtains_geo_tpoint(gs, temp) :
-    acontains_geo_tpoint(gs, temp);
+  int result;
+  if (ever)
+    result = econtains_geo_tpoint(gs, temp);
+  else
+  {
+    PreparedGeo *pgeo = prepgeo_cache_get(fcinfo, gs);
+    result = pgeo ? acontains_prepgeo_tpoint(pgeo, temp) :
+      acontains_geo_tpoint(gs, temp);
+  }
   PG_FREE_IF_COPY(gs, 0);
   PG_FREE_IF_COPY(temp, 1);
   if (result < 0)
@@ -148,8 +242,14 @@ EAdisjoint_geo_tpoint(FunctionCallInfo fcinfo, bool ever)
 {
   GSERIALIZED *gs = PG_GETARG_GSERIALIZED_P(0);
   Temporal *temp = PG_GETARG_TEMPORAL_P(1);
-  int result = ever ? edisjoint_tpoint_geo(temp, gs) :
-    adisjoint_tpoint_geo(temp, gs);
+  PreparedGeo *pgeo = prepgeo_cache_get(fcinfo, gs);
+  int result;
+  if (pgeo)
+    result = ever ? edisjoint_tpoint_prepgeo(temp, pgeo) :
+      adisjoint_tpoint_prepgeo(temp, pgeo);
+  else
+    result = ever ? edisjoint_tpoint_geo(temp, gs) :
+      adisjoint_tpoint_geo(temp, gs);
   PG_FREE_IF_COPY(temp, 1);
   PG_FREE_IF_COPY(gs, 0);
   if (result < 0)
@@ -195,8 +295,14 @@ EAdisjoint_tpoint_geo(FunctionCallInfo fcinfo, bool ever)
 {
   Temporal *temp = PG_GETARG_TEMPORAL_P(0);
   GSERIALIZED *gs = PG_GETARG_GSERIALIZED_P(1);
-  int result = ever ? edisjoint_tpoint_geo(temp, gs) :
-    adisjoint_tpoint_geo(temp, gs);
+  PreparedGeo *pgeo = prepgeo_cache_get(fcinfo, gs);
+  int result;
+  if (pgeo)
+    result = ever ? edisjoint_tpoint_prepgeo(temp, pgeo) :
+      adisjoint_tpoint_prepgeo(temp, pgeo);
+  else
+    result = ever ? edisjoint_tpoint_geo(temp, gs) :
+      adisjoint_tpoint_geo(temp, gs);
   PG_FREE_IF_COPY(temp, 0);
   PG_FREE_IF_COPY(gs, 1);
   if (result < 0)
@@ -274,8 +380,14 @@ EAintersects_geo_tpoint(FunctionCallInfo fcinfo, bool ever)
 {
   GSERIALIZED *gs = PG_GETARG_GSERIALIZED_P(0);
   Temporal *temp = PG_GETARG_TEMPORAL_P(1);
-  int result = ever ?
-    eintersects_tpoint_geo(temp, gs) : aintersects_tpoint_geo(temp, gs);
+  PreparedGeo *pgeo = prepgeo_cache_get(fcinfo, gs);
+  int result;
+  if (pgeo)
+    result = ever ? eintersects_tpoint_prepgeo(temp, pgeo) :
+      aintersects_tpoint_prepgeo(temp, pgeo);
+  else
+    result = ever ?
+      eintersects_tpoint_geo(temp, gs) : aintersects_tpoint_geo(temp, gs);
   PG_FREE_IF_COPY(gs, 0);
   PG_FREE_IF_COPY(temp, 1);
   if (result < 0)
@@ -321,8 +433,14 @@ EAintersects_tpoint_geo(FunctionCallInfo fcinfo, bool ever)
 {
   Temporal *temp = PG_GETARG_TEMPORAL_P(0);
   GSERIALIZED *gs = PG_GETARG_GSERIALIZED_P(1);
-  int result = ever ?
-    eintersects_tpoint_geo(temp, gs) : aintersects_tpoint_geo(temp, gs);
+  PreparedGeo *pgeo = prepgeo_cache_get(fcinfo, gs);
+  int result;
+  if (pgeo)
+    result = ever ? eintersects_tpoint_prepgeo(temp, pgeo) :
+      aintersects_tpoint_prepgeo(temp, pgeo);
+  else
+    result = ever ?
+      eintersects_tpoint_geo(temp, gs) : aintersects_tpoint_geo(temp, gs);
   PG_FREE_IF_COPY(temp, 0);
   PG_FREE_IF_COPY(gs, 1);
   if (result < 0)
@@ -627,4 +745,148 @@ Adwithin_tpoint_tpoint(PG_FUNCTION_ARGS)
   return EAdwithin_tpoint_tpoint(fcinfo, ALWAYS);
 }
 
+/*****************************************************************************
+ * Ever dwithin for arrays of temporal points
+ *****************************************************************************/
+
+PGDLLEXPORT Datum Edwithin_tpointarr_tpointarr(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Edwithin_tpointarr_tpointarr);
+/**
+ * @ingroup mobilitydb_temporal_spatial_rel
+ * @brief Return the pairs of temporal points of two arrays that are ever
+ * within a distance
+ * @sqlfn eDwithinPairs()
+ */
+Datum
+Edwithin_tpointarr_tpointarr(PG_FUNCTION_ARGS)
+{
+  FuncCallContext *funcctx;
+  TpointPairsState *state;
+
+  /* If the function is being called for the first time */
+  if (SRF_IS_FIRSTCALL())
+  {
+    /* Initialize the FuncCallContext */
+    funcctx = SRF_FIRSTCALL_INIT();
+    /* Switch to memory context appropriate for multiple function calls */
+    MemoryContext oldcontext =
+      MemoryContextSwitchTo(funcctx->multi_call_memory_ctx);
+
+    /* Get input parameters */
+    ArrayType *array1 = PG_GETARG_ARRAYTYPE_P(0);
+    ArrayType *array2 = PG_GETARG_ARRAYTYPE_P(1);
+    double dist = PG_GETARG_FLOAT8(2);
+
+    /* Create function state */
+    state = palloc0(sizeof(TpointPairsState));
+    int count1 = ArrayGetNItems(ARR_NDIM(array1), ARR_DIMS(array1));
+    int count2 = ArrayGetNItems(ARR_NDIM(array2), ARR_DIMS(array2));
+    if (count1 > 0 && count2 > 0)
+    {
+      Temporal **temparr1 = temparr_extract(array1, &count1);
+      Temporal **temparr2 = temparr_extract(array2, &count2);
+      state->pairs = edwithin_tpointarr_tpointarr((const Temporal **) temparr1,
+        count1, (const Temporal **) temparr2, count2, dist, &state->count);
+      pfree(temparr1); pfree(temparr2);
+    }
+    funcctx->user_fctx = state;
+    /* Build a tuple description for the function output */
+    get_call_result_type(fcinfo, 0, &funcctx->tuple_desc);
+    BlessTupleDesc(funcctx->tuple_desc);
+    MemoryContextSwitchTo(oldcontext);
+  }
+
+  /* Stuff done on every call of the function */
+  funcctx = SRF_PERCALL_SETUP();
+  /* Get state */
+  state = funcctx->user_fctx;
+  /* Stop when we've used up all pairs */
+  if (state->i == state->count)
+    SRF_RETURN_DONE(funcctx);
+
+  /* Form tuple and return, the positions start at 1 as in SQL arrays */
+  bool isnull[2] = {0,0}; /* needed to say no value is null */
+  Datum tuple_arr[2]; /* used to construct the composite return value */
+  tuple_arr[0] = Int32GetDatum(state->pairs[2 * state->i] + 1);
+  tuple_arr[1] = Int32GetDatum(state->pairs[2 * state->i + 1] + 1);
+  state->i++;
+  HeapTuple tuple = heap_form_tuple(funcctx->tuple_desc, tuple_arr, isnull);
+  Datum result = HeapTupleGetDatum(tuple);
+  SRF_RETURN_NEXT(funcctx, result);
+}
+
+PGDLLEXPORT Datum Tpointarr_dwithin_join(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tpointarr_dwithin_join);
+/**
+ * @ingroup mobilitydb_temporal_spatial_rel
+ * @brief Return the pairs of temporal points of two arrays that are ever
+ * within a distance using a partition-based join
+ * @sqlfn dwithinJoin()
+ */
+Datum
+Tpointarr_dwithin_join(PG_FUNCTION_ARGS)
+{
+  FuncCallContext *funcctx;
+  TpointPairsState *state;
+
+  /* If the function is being called for the first time */
+  if (SRF_IS_FIRSTCALL())
+  {
+    /* Initialize the FuncCallContext */
+    funcctx = SRF_FIRSTCALL_INIT();
+    /* Switch to memory context appropriate for multiple function calls */
+    MemoryContext oldcontext =
+      MemoryContextSwitchTo(funcctx->multi_call_memory_ctx);
+
+    /* Create function state */
+    state = palloc0(sizeof(TpointPairsState));
+    if (! PG_ARGISNULL(0) && ! PG_ARGISNULL(1) && ! PG_ARGISNULL(2) &&
+        ! PG_ARGISNULL(3) && ! PG_ARGISNULL(4))
+    {
+      /* Get input parameters */
+      ArrayType *array1 = PG_GETARG_ARRAYTYPE_P(0);
+      ArrayType *array2 = PG_GETARG_ARRAYTYPE_P(1);
+      double dist = PG_GETARG_FLOAT8(2);
+      double xsize = PG_GETARG_FLOAT8(3);
+      double ysize = PG_GETARG_FLOAT8(4);
+      Interval *duration = (PG_NARGS() > 5 && ! PG_ARGISNULL(5)) ?
+        PG_GETARG_INTERVAL_P(5) : NULL;
+      int count1 = ArrayGetNItems(ARR_NDIM(array1), ARR_DIMS(array1));
+      int count2 = ArrayGetNItems(ARR_NDIM(array2), ARR_DIMS(array2));
+      if (count1 > 0 && count2 > 0)
+      {
+        Temporal **temparr1 = temparr_extract(array1, &count1);
+        Temporal **temparr2 = temparr_extract(array2, &count2);
+        state->pairs = tpointarr_dwithin_join((const Temporal **) temparr1,
+          count1, (const Temporal **) temparr2, count2, dist, xsize, ysize,
+          duration, NULL, &state->count);
+        pfree(temparr1); pfree(temparr2);
+      }
+    }
+    funcctx->user_fctx = state;
+    /* Build a tuple description for the function output */
+    get_call_result_type(fcinfo, 0, &funcctx->tuple_desc);
+    BlessTupleDesc(funcctx->tuple_desc);
+    MemoryContextSwitchTo(oldcontext);
+  }
+
+  /* Stuff done on every call of the function */
+  funcctx = SRF_PERCALL_SETUP();
+  /* Get state */
+  state = funcctx->user_fctx;
+  /* Stop when we've used up all pairs */
+  if (state->i == state->count)
+    SRF_RETURN_DONE(funcctx);
+
+  /* Form tuple and return, the positions start at 1 as in SQL arrays */
+  bool isnull[2] = {0,0}; /* needed to say no value is null */
+  Datum tuple_arr[2]; /* used to construct the composite return value */
+  tuple_arr[0] = Int32GetDatum(state->pairs[2 * state->i] + 1);
+  tuple_arr[1] = Int32GetDatum(state->pairs[2 * state->i + 1] + 1);
+  state->i++;
+  HeapTuple tuple = heap_form_tuple(funcctx->tuple_desc, tuple_arr, isnull);
+  Datum result = HeapTupleGetDatum(tuple);
+  SRF_RETURN_NEXT(funcctx, result);
+}
+
 /*****************************************************************************/
@@ -44,11 +44,14 @@
 
 #include "point/tpoint_tempspatialrels.h"
 
+/* PostgreSQL */
+#include <funcapi.h>
 /* PostGIS */
 #include <liblwgeom.h>
 /* MEOS */
 #include <meos.h>
 /* MobilityDB */
+#include "pg_general/type_util.h"
 #include "pg_point/postgis.h"
 #include "pg_point/tpoint_spatialfuncs.h"
 
@@ -76,7 +79,10 @@ Tinterrel_geo_tpoint(FunctionCallInfo fcinfo, bool tinter)
     restr = true;
   }
   /* Result depends on whether we are computing tintersects or tdisjoint */
-  Temporal *result = tinterrel_tpoint_geo(temp, gs, tinter, restr, atvalue);
+  PreparedGeo *pgeo = prepgeo_cache_get(fcinfo, gs);
+  Temporal *result = pgeo ?
+    tinterrel_tpoint_prepgeo(temp, pgeo, tinter, restr, atvalue) :
+    tinterrel_tpoint_geo(temp, gs, tinter, restr, atvalue);
   PG_FREE_IF_COPY(gs, 0);
   PG_FREE_IF_COPY(temp, 1);
   if (! result)
@@ -103,7 +109,10 @@ Tinterrel_tpoint_geo(FunctionCallInfo fcinfo, bool tinter)
     restr = true;
   }
   /* Result depends on whether we are computing tintersects or tdisjoint */
-  Temporal *result = tinterrel_tpoint_geo(temp, gs, tinter, restr, atvalue);
+  PreparedGeo *pgeo = prepgeo_cache_get(fcinfo, gs);
+  Temporal *result = pgeo ?
+    tinterrel_tpoint_prepgeo(temp, pgeo, tinter, restr, atvalue) :
+    tinterrel_tpoint_geo(temp, gs, tinter, restr, atvalue);
   PG_FREE_IF_COPY(temp, 0);
   PG_FREE_IF_COPY(gs, 1);
   if (! result)
@@ -431,4 +440,81 @@ Tdwithin_tpoint_tpoint(PG_FUNCTION_ARGS)
   PG_RETURN_TEMPORAL_P(result);
 }
 
+PGDLLEXPORT Datum Tdwithin_tpointarr_tpointarr(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tdwithin_tpointarr_tpointarr);
+/**
+ * @ingroup mobilitydb_temporal_spatial_rel_temp
+ * @brief Return for the pairs of temporal points of two arrays that intersect
+ * in time a temporal boolean that states whether they are within a distance
+ * @sqlfn tDwithinPairs()
+ */
+Datum
+Tdwithin_tpointarr_tpointarr(PG_FUNCTION_ARGS)
+{
+  FuncCallContext *funcctx;
+  TpointPairsState *state;
+
+  /* If the function is being called for the first time */
+  if (SRF_IS_FIRSTCALL())
+  {
+    /* Initialize the FuncCallContext */
+    funcctx = SRF_FIRSTCALL_INIT();
+    /* Switch to memory context appropriate for multiple function calls */
+    MemoryContext oldcontext =
+      MemoryContextSwitchTo(funcctx->multi_call_memory_ctx);
+
+    /* Create function state */
+    state = palloc0(sizeof(TpointPairsState));
+    if (! PG_ARGISNULL(0) && ! PG_ARGISNULL(1) && ! PG_ARGISNULL(2))
+    {
+      /* Get input parameters */
+      ArrayType *array1 = PG_GETARG_ARRAYTYPE_P(0);
+      ArrayType *array2 = PG_GETARG_ARRAYTYPE_P(1);
+      double dist = PG_GETARG_FLOAT8(2);
+      bool restr = false;
+      bool atvalue = false;
+      if (PG_NARGS() > 3 && ! PG_ARGISNULL(3))
+      {
+        atvalue = PG_GETARG_BOOL(3);
+        restr = true;
+      }
+      int count1 = ArrayGetNItems(ARR_NDIM(array1), ARR_DIMS(array1));
+      int count2 = ArrayGetNItems(ARR_NDIM(array2), ARR_DIMS(array2));
+      if (count1 > 0 && count2 > 0)
+      {
+        Temporal **temparr1 = temparr_extract(array1, &count1);
+        Temporal **temparr2 = temparr_extract(array2, &count2);
+        state->temps = tdwithin_tpointarr_tpointarr(
+          (const Temporal **) temparr1, count1, (const Temporal **) temparr2,
+          count2, dist, restr, atvalue, &state->pairs, &state->count);
+        pfree(temparr1); pfree(temparr2);
+      }
+    }
+    funcctx->user_fctx = state;
+    /* Build a tuple description for the function output */
+    get_call_result_type(fcinfo, 0, &funcctx->tuple_desc);
+    BlessTupleDesc(funcctx->tuple_desc);
+    MemoryContextSwitchTo(oldcontext);
+  }
+
+  /* Stuff done on every call of the function */
+  funcctx = SRF_PERCALL_SETUP();
+  /* Get state */
+  state = funcctx->user_fctx;
+  /* Stop when we've used up all pairs */
+  if (state->i == state->count)
+    SRF_RETURN_DONE(funcctx);
+
+  /* Form tuple and return, the positions start at 1 as in SQL arrays */
+  bool isnull[3] = {0,0,0}; /* needed to say no value is null */
+  Datum tuple_arr[3]; /* used to construct the composite return value */
+  tuple_arr[0] = Int32GetDatum(state->pairs[2 * state->i] + 1);
+  tuple_arr[1] = Int32GetDatum(state->pairs[2 * state->i + 1] + 1);
+  tuple_arr[2] = PointerGetDatum(state->temps[state->i]);
+  state->i++;
+  HeapTuple tuple = heap_form_tuple(funcctx->tuple_desc, tuple_arr, isnull);
+  Datum result = HeapTupleGetDatum(tuple);
+  SRF_RETURN_NEXT(funcctx, result);
+}
+
 /*****************************************************************************/
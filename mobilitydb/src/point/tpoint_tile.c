@@ -48,6 +48,7 @@
 #include "point/tpoint_spatialfuncs.h"
 #include "point/tpoint_tile.h"
 /* MobilityDB */
+#include "pg_general/type_util.h"
 #include "pg_point/postgis.h"
 
 /*****************************************************************************/
@@ -287,58 +288,30 @@ Tpoint_space_time_split_ext(FunctionCallInfo fcinfo, bool timesplit)
   funcctx = SRF_PERCALL_SETUP();
   /* Get state */
   state = funcctx->user_fctx;
-  /* We need to loop since atStbox may be NULL */
-  while (true)
+  /* Get the next fragment of the temporal point and its tile, if any */
+  STBox box;
+  Temporal *atstbox = tpoint_space_time_split_next(state, &box);
+  if (! atstbox)
   {
-    /* Stop when we have used up all the grid tiles */
-    if (state->done)
-    {
-      /* Switch to memory context appropriate for multiple function calls */
-      MemoryContext oldcontext =
-        MemoryContextSwitchTo(funcctx->multi_call_memory_ctx);
-      if (state->bm)
-         pfree(state->bm);
-      pfree(state);
-      MemoryContextSwitchTo(oldcontext);
-      SRF_RETURN_DONE(funcctx);
-    }
-
-    /* Get current tile (if any) and advance state
-     * It is necessary to test if we found a tile since the previous tile
-     * may be the last one set in the associated bit matrix */
-    STBox box;
-    bool found = stbox_tile_state_get(state, &box);
-    if (! found)
-    {
-      /* Switch to memory context appropriate for multiple function calls */
-      MemoryContext oldcontext =
-        MemoryContextSwitchTo(funcctx->multi_call_memory_ctx);
-      if (state->bm)
-        pfree(state->bm);
-      pfree(state);
-      MemoryContextSwitchTo(oldcontext);
-      SRF_RETURN_DONE(funcctx);
-    }
-    stbox_tile_state_next(state);
-
-    /* Restrict the temporal point to the box */
-    Temporal *atstbox = tpoint_restrict_stbox(state->temp, &box, BORDER_EXC,
-      REST_AT);
-    if (atstbox == NULL)
-      continue;
-
-    /* Form tuple and return */
-    int i = 0;
-    hasz = MEOS_FLAGS_GET_Z(state->temp->flags);
-    tuple_arr[i++] = PointerGetDatum(geopoint_make(box.xmin, box.ymin,
-      box.zmin, hasz, false, box.srid));
-    if (timesplit)
-      tuple_arr[i++] = box.period.lower;
-    tuple_arr[i++] = PointerGetDatum(atstbox);
-    tuple = heap_form_tuple(funcctx->tuple_desc, tuple_arr, isnull);
-    result = HeapTupleGetDatum(tuple);
-    SRF_RETURN_NEXT(funcctx, result);
+    /* Switch to memory context appropriate for multiple function calls */
+    MemoryContext oldcontext =
+      MemoryContextSwitchTo(funcctx->multi_call_memory_ctx);
+    stbox_tile_state_free(state);
+    MemoryContextSwitchTo(oldcontext);
+    SRF_RETURN_DONE(funcctx);
   }
+
+  /* Form tuple and return */
+  int i = 0;
+  hasz = MEOS_FLAGS_GET_Z(state->temp->flags);
+  tuple_arr[i++] = PointerGetDatum(geopoint_make(box.xmin, box.ymin,
+    box.zmin, hasz, false, box.srid));
+  if (timesplit)
+    tuple_arr[i++] = box.period.lower;
+  tuple_arr[i++] = PointerGetDatum(atstbox);
+  tuple = heap_form_tuple(funcctx->tuple_desc, tuple_arr, isnull);
+  result = HeapTupleGetDatum(tuple);
+  SRF_RETURN_NEXT(funcctx, result);
 }
 
 PGDLLEXPORT Datum Tpoint_space_split(PG_FUNCTION_ARGS);
@@ -367,4 +340,296 @@ Tpoint_space_time_split(PG_FUNCTION_ARGS)
   return Tpoint_space_time_split_ext(fcinfo, true);
 }
 
+/*****************************************************************************
+ * Aggregation by tiles
+ *****************************************************************************/
+
+/**
+ * @brief Struct for storing the state of the aggregation of an array of
+ * temporal points by tiles
+ */
+typedef struct
+{
+  int i;               /**< Number of the current tile */
+  int count;           /**< Number of tiles */
+  TileAgg *tiles;      /**< Aggregate values of the tiles */
+} TileAggState;
+
+PGDLLEXPORT Datum Tpointarr_tile_agg(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tpointarr_tile_agg);
+/**
+ * @ingroup mobilitydb_temporal_analytics_tile
+ * @brief Return the aggregate values of an array of temporal points split
+ * with respect to a spatial and possibly a temporal grid
+ * @sqlfn tileAgg()
+ */
+Datum
+Tpointarr_tile_agg(PG_FUNCTION_ARGS)
+{
+  FuncCallContext *funcctx;
+  TileAggState *state;
+
+  /* If the function is being called for the first time */
+  if (SRF_IS_FIRSTCALL())
+  {
+    /* Initialize the FuncCallContext */
+    funcctx = SRF_FIRSTCALL_INIT();
+    /* Switch to memory context appropriate for multiple function calls */
+    MemoryContext oldcontext =
+      MemoryContextSwitchTo(funcctx->multi_call_memory_ctx);
+
+    /* Create function state, the time dimension is optional */
+    state = palloc0(sizeof(TileAggState));
+    if (! PG_ARGISNULL(0) && ! PG_ARGISNULL(1) && ! PG_ARGISNULL(2) &&
+        ! PG_ARGISNULL(4) && ! PG_ARGISNULL(5))
+    {
+      /* Get input parameters */
+      ArrayType *array = PG_GETARG_ARRAYTYPE_P(0);
+      double xsize = PG_GETARG_FLOAT8(1);
+      double ysize = PG_GETARG_FLOAT8(2);
+      Interval *duration = PG_ARGISNULL(3) ? NULL : PG_GETARG_INTERVAL_P(3);
+      GSERIALIZED *sorigin = PG_GETARG_GSERIALIZED_P(4);
+      TimestampTz torigin = PG_GETARG_TIMESTAMPTZ(5);
+      int count = ArrayGetNItems(ARR_NDIM(array), ARR_DIMS(array));
+      if (count > 0)
+      {
+        Temporal **temparr = temparr_extract(array, &count);
+        state->tiles = tpointarr_tile_agg((const Temporal **) temparr, count,
+          xsize, ysize, duration, sorigin, torigin, &state->count);
+        pfree(temparr);
+      }
+    }
+    funcctx->user_fctx = state;
+    /* Build a tuple description for the function output */
+    get_call_result_type(fcinfo, 0, &funcctx->tuple_desc);
+    BlessTupleDesc(funcctx->tuple_desc);
+    MemoryContextSwitchTo(oldcontext);
+  }
+
+  /* Stuff done on every call of the function */
+  funcctx = SRF_PERCALL_SETUP();
+  /* Get state */
+  state = funcctx->user_fctx;
+  /* Stop when we've output all the tiles */
+  if (state->i == state->count)
+    SRF_RETURN_DONE(funcctx);
+
+  /* Form tuple and return */
+  TileAgg *tile = &state->tiles[state->i++];
+  bool isnull[5] = {0,0,0,0,0}; /* needed to say no value is null */
+  Datum tuple_arr[5]; /* used to construct the composite return value */
+  tuple_arr[0] = PointerGetDatum(&tile->box);
+  tuple_arr[1] = Int32GetDatum(tile->count);
+  tuple_arr[2] = PointerGetDatum(&tile->duration);
+  tuple_arr[3] = Float8GetDatum(tile->distance);
+  tuple_arr[4] = Float8GetDatum(tile->speed);
+  HeapTuple tuple = heap_form_tuple(funcctx->tuple_desc, tuple_arr, isnull);
+  Datum result = HeapTupleGetDatum(tuple);
+  SRF_RETURN_NEXT(funcctx, result);
+}
+
+/*****************************************************************************
+ * Quadtree and hexagonal grids
+ *****************************************************************************/
+
+PGDLLEXPORT Datum Geo_quadcell(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Geo_quadcell);
+/**
+ * @ingroup mobilitydb_temporal_analytics_tile
+ * @brief Return the identifier of the quadtree cell of a level containing a
+ * point
+ * @sqlfn quadCell()
+ */
+Datum
+Geo_quadcell(PG_FUNCTION_ARGS)
+{
+  GSERIALIZED *gs = PG_GETARG_GSERIALIZED_P(0);
+  STBox *bounds = PG_GETARG_STBOX_P(1);
+  int level = PG_GETARG_INT32(2);
+  int64 result = geo_quadcell(gs, bounds, level);
+  PG_FREE_IF_COPY(gs, 0);
+  PG_RETURN_INT64(result);
+}
+
+PGDLLEXPORT Datum Quadcell_stbox(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Quadcell_stbox);
+/**
+ * @ingroup mobilitydb_temporal_analytics_tile
+ * @brief Return the box of a quadtree cell
+ * @sqlfn quadCellBox()
+ */
+Datum
+Quadcell_stbox(PG_FUNCTION_ARGS)
+{
+  int64 cell = PG_GETARG_INT64(0);
+  STBox *bounds = PG_GETARG_STBOX_P(1);
+  PG_RETURN_STBOX_P(quadcell_stbox(cell, bounds));
+}
+
+PGDLLEXPORT Datum Quadcell_parent(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Quadcell_parent);
+/**
+ * @ingroup mobilitydb_temporal_analytics_tile
+ * @brief Return the identifier of the ancestor of a quadtree cell at a level
+ * @sqlfn quadCellParent()
+ */
+Datum
+Quadcell_parent(PG_FUNCTION_ARGS)
+{
+  int64 cell = PG_GETARG_INT64(0);
+  int level = PG_GETARG_INT32(1);
+  PG_RETURN_INT64(quadcell_parent(cell, level));
+}
+
+PGDLLEXPORT Datum Geo_hexcell(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Geo_hexcell);
+/**
+ * @ingroup mobilitydb_temporal_analytics_tile
+ * @brief Return the identifier of the hexagon of a hexagonal grid containing
+ * a point
+ * @sqlfn hexCell()
+ */
+Datum
+Geo_hexcell(PG_FUNCTION_ARGS)
+{
+  GSERIALIZED *gs = PG_GETARG_GSERIALIZED_P(0);
+  double size = PG_GETARG_FLOAT8(1);
+  GSERIALIZED *sorigin = PG_GETARG_GSERIALIZED_P(2);
+  int64 result = geo_hexcell(gs, size, sorigin);
+  PG_FREE_IF_COPY(gs, 0);
+  PG_FREE_IF_COPY(sorigin, 2);
+  PG_RETURN_INT64(result);
+}
+
+PGDLLEXPORT Datum Hexcell_geo(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Hexcell_geo);
+/**
+ * @ingroup mobilitydb_temporal_analytics_tile
+ * @brief Return the polygon of a hexagon of a hexagonal grid
+ * @sqlfn hexCellGeom()
+ */
+Datum
+Hexcell_geo(PG_FUNCTION_ARGS)
+{
+  int64 cell = PG_GETARG_INT64(0);
+  double size = PG_GETARG_FLOAT8(1);
+  GSERIALIZED *sorigin = PG_GETARG_GSERIALIZED_P(2);
+  GSERIALIZED *result = hexcell_geo(cell, size, sorigin);
+  PG_FREE_IF_COPY(sorigin, 2);
+  PG_RETURN_GSERIALIZED_P(result);
+}
+
+/**
+ * @brief Split a temporal point with respect to a quadtree or a hexagonal
+ * grid
+ */
+Datum
+Tpoint_cell_split_ext(FunctionCallInfo fcinfo, bool hexagonal)
+{
+  FuncCallContext *funcctx;
+  ValueTimeSplitState *state;
+  bool isnull[2] = {0,0}; /* needed to say no value is null */
+  Datum tuple_arr[2]; /* used to construct the composite return value */
+  HeapTuple tuple;
+  Datum result; /* the actual composite return value */
+
+  /* If the function is being called for the first time */
+  if (SRF_IS_FIRSTCALL())
+  {
+    /* Initialize the FuncCallContext */
+    funcctx = SRF_FIRSTCALL_INIT();
+    /* Switch to memory context appropriate for multiple function calls */
+    MemoryContext oldcontext =
+      MemoryContextSwitchTo(funcctx->multi_call_memory_ctx);
+
+    /* Get input parameters and split the temporal point */
+    Temporal *temp = PG_GETARG_TEMPORAL_P(0);
+    int64 *cells;
+    int count;
+    Temporal **fragments;
+    if (hexagonal)
+      fragments = tpoint_hex_split(temp, PG_GETARG_FLOAT8(1),
+        PG_GETARG_GSERIALIZED_P(2), &cells, &count);
+    else
+      fragments = tpoint_quad_split(temp, PG_GETARG_STBOX_P(1),
+        PG_GETARG_INT32(2), &cells, &count);
+
+    /* Create function state, the identifiers of the cells are stored as
+     * the values of the buckets */
+    state = NULL;
+    if (count > 0)
+    {
+      Datum *values = palloc(sizeof(Datum) * count);
+      for (int i = 0; i < count; i++)
+        values[i] = Int64GetDatum(cells[i]);
+      pfree(cells);
+      state = value_time_split_state_make(0, 0, values, NULL, fragments,
+        count);
+    }
+    funcctx->user_fctx = state;
+    /* Build a tuple description for the function output */
+    get_call_result_type(fcinfo, 0, &funcctx->tuple_desc);
+    BlessTupleDesc(funcctx->tuple_desc);
+    MemoryContextSwitchTo(oldcontext);
+  }
+
+  /* Stuff done on every call of the function */
+  funcctx = SRF_PERCALL_SETUP();
+  /* Get state */
+  state = funcctx->user_fctx;
+  /* Stop when we've output all the fragments */
+  if (! state)
+    SRF_RETURN_DONE(funcctx);
+  if (state->done)
+  {
+    /* Switch to memory context appropriate for multiple function calls */
+    MemoryContext oldcontext =
+      MemoryContextSwitchTo(funcctx->multi_call_memory_ctx);
+    pfree(state->value_buckets);
+    pfree(state->fragments);
+    pfree(state);
+    MemoryContextSwitchTo(oldcontext);
+    SRF_RETURN_DONE(funcctx);
+  }
+
+  /* Store cell and fragment */
+  tuple_arr[0] = state->value_buckets[state->i];
+  tuple_arr[1] = PointerGetDatum(state->fragments[state->i]);
+  /* Advance state */
+  value_time_split_state_next(state);
+  /* Form tuple and return */
+  tuple = heap_form_tuple(funcctx->tuple_desc, tuple_arr, isnull);
+  result = HeapTupleGetDatum(tuple);
+  SRF_RETURN_NEXT(funcctx, result);
+}
+
+PGDLLEXPORT Datum Tpoint_quad_split(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tpoint_quad_split);
+/**
+ * @ingroup mobilitydb_temporal_analytics_tile
+ * @brief Return a temporal point split with respect to the cells of a level
+ * of a quadtree grid
+ * @sqlfn quadSplit()
+ */
+Datum
+Tpoint_quad_split(PG_FUNCTION_ARGS)
+{
+  return Tpoint_cell_split_ext(fcinfo, false);
+}
+
+PGDLLEXPORT Datum Tpoint_hex_split(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tpoint_hex_split);
+/**
+ * @ingroup mobilitydb_temporal_analytics_tile
+ * @brief Return a temporal point split with respect to a hexagonal grid
+ * @note The hexagons are half-open, so that the instants located on the
+ * common border of adjacent hexagons belong to a single fragment
+ * @sqlfn hexSplit()
+ */
+Datum
+Tpoint_hex_split(PG_FUNCTION_ARGS)
+{
+  return Tpoint_cell_split_ext(fcinfo, true);
+}
+
 /*****************************************************************************/
@@ -1509,6 +1509,21 @@ SELECT shiftScaleTime(ttext '{[AAA@2000-01-01, BBB@2000-01-02, AAA@2000-01-03],[
 SELECT scaleTime(tfloat '1@2000-01-01', '0');
 SELECT scaleTime(tfloat '1@2000-01-01', '-1 day');
 
+-------------------------------------------------------------------------------
+-- Granularity modification with tprecision and tsample
+-------------------------------------------------------------------------------
+
+SELECT tprecision(tfloat '[1@2000-01-01, 3@2000-01-01 12:00, 1@2000-01-02, 5@2000-01-02 12:00]', '1 day');
+SELECT tprecision(tfloat 'Interp=Step;[1@2000-01-01, 3@2000-01-01 12:00, 1@2000-01-02, 5@2000-01-02 12:00]', '1 day');
+SELECT tprecision(tfloat '[0@2000-01-01 12:00, 4@2000-01-02 12:00]', '1 day');
+
+-- Sequences with an exclusive lower bound are sampled at their interior instants
+SELECT tsample(tint '(1@2000-01-01, 2@2000-01-02, 3@2000-01-03]', '1 day');
+SELECT tsample(tfloat '(1@2000-01-01, 2@2000-01-02, 3@2000-01-03]', '1 day');
+SELECT tsample(tfloat 'Interp=Step;(1@2000-01-01, 2@2000-01-02, 3@2000-01-03]', '1 day');
+SELECT tsample(tfloat '{[1@2000-01-01, 2@2000-01-02), [3@2000-01-02 12:00, 5@2000-01-03, 1@2000-01-04]}', '1 day');
+SELECT tsample(tfloat '{[1@2000-01-01, 2@2000-01-02), [3@2000-01-02 12:00, 5@2000-01-03, 1@2000-01-04]}', '1 day', interp := 'linear');
+
 -------------------------------------------------------------------------------
 -- Restriction functions
 -------------------------------------------------------------------------------
@@ -2260,6 +2275,7 @@ SELECT deleteTime(tfloat '[3@2000-01-03]', tstzspanset '{[2000-01-01,2000-01-02]
 SELECT deleteTime(tfloat '[3@2000-01-03, 4@2000-01-04]', tstzspanset '{[2000-01-01,2000-01-02], [2000-01-05,2000-01-06]}');
 SELECT deleteTime(tfloat '[1@2000-01-01, 2@2000-01-02]', tstzspanset '{[2000-01-01,2000-01-02], [2000-01-05,2000-01-06]}');
 SELECT deleteTime(tfloat '[1@2000-01-01, 4@2000-01-04]', tstzspanset '{[2000-01-01,2000-01-02], [2000-01-05,2000-01-06]}');
+SELECT tbox(deleteTime(tfloat '[1@2000-01-01, 5@2000-01-02, 2@2000-01-03, 3@2000-01-04]', tstzspan '[2000-01-03, 2000-01-03]')) = tbox(tfloat '[1@2000-01-01, 5@2000-01-02, 3@2000-01-04]');
 
 -------------------------------------------------------------------------------
 --  Value Aggregate Functions
@@ -488,6 +488,32 @@ SELECT MAX(numInstants(tsample(ti, '15 minutes', interp := 'linear'))) FROM tbl_
 SELECT MAX(numInstants(tsample(seq, '15 minutes', interp := 'linear'))) FROM tbl_tfloat_seq;
 SELECT MAX(numInstants(tsample(ss, '15 minutes', interp := 'linear'))) FROM tbl_tfloat_seqset;
 
+-- The temporal floats give the same result as the generic code of the other types
+SELECT COUNT(*) FROM tbl_tint_seq
+WHERE tsample(seq::tfloat, '1 minute') <> tsample(seq, '1 minute')::tfloat;
+SELECT COUNT(*) FROM tbl_tint_seq
+WHERE tsample(seq::tfloat, '15 minutes', interp := 'step') <> tsample(seq, '15 minutes', interp := 'step')::tfloat;
+SELECT COUNT(*) FROM tbl_tint_seqset
+WHERE tsample(ss::tfloat, '1 minute') <> tsample(ss, '1 minute')::tfloat;
+SELECT COUNT(*) FROM tbl_tint_seqset
+WHERE tsample(ss::tfloat, '15 minutes', interp := 'step') <> tsample(ss, '15 minutes', interp := 'step')::tfloat;
+
+-- All the instants are aligned with the buckets
+SELECT COUNT(*) FROM tbl_tfloat_seq
+WHERE tsample(seq, '1 minute') <> atTime(seq, set(ARRAY(SELECT generate_series(
+  date_trunc('minute', startTimestamp(seq)), endTimestamp(seq), interval '1 minute'))));
+SELECT COUNT(*) FROM tbl_tfloat_seqset
+WHERE tsample(ss, '1 minute') <> atTime(ss, set(ARRAY(SELECT generate_series(
+  date_trunc('minute', startTimestamp(ss)), endTimestamp(ss), interval '1 minute')))) AND
+  NOT EXISTS(SELECT 1 FROM unnest(sequences(ss)) s WHERE numInstants(s) = 1);
+
+SELECT COUNT(*) FROM tbl_tfloat_seq, unnest(instants(tprecision(seq, '15 minutes'))) inst
+WHERE abs(getValue(inst) - twAvg(atTime(seq, span(getTimestamp(inst),
+  getTimestamp(inst) + interval '15 minutes')))) > 1e-6;
+SELECT COUNT(*) FROM tbl_tint_seq, unnest(instants(tprecision(seq::tfloat, '15 minutes'))) inst
+WHERE abs(getValue(inst) - twAvg(atTime(seq::tfloat, span(getTimestamp(inst),
+  getTimestamp(inst) + interval '15 minutes')))) > 1e-6;
+
 -------------------------------------------------------------------------------
 -- stop function
 
@@ -138,3 +138,35 @@ SELECT valueTimeSplit(tfloat '{[1.5@2000-01-01, 2.5@2000-01-02, 1.5@2000-01-03],
 SELECT valueTimeSplit(tfloat 'Interp=Step;{[1.5@2000-01-01, 2.5@2000-01-02, 1.5@2000-01-03],[3.5@2000-01-04, 3.5@2000-01-05]}', 0.5, '1 week');
 
 -------------------------------------------------------------------------------
+-- Time-bucketed aggregates
+-------------------------------------------------------------------------------
+
+SELECT timeSplitIntegral(tint '1@2000-01-01', '1 day');
+SELECT timeSplitIntegral(tfloat '[1.5@2000-01-01, 2.5@2000-01-02, 1.5@2000-01-03]', '1 day');
+SELECT timeSplitIntegral(tfloat 'Interp=Step;[1.5@2000-01-01, 2.5@2000-01-02, 1.5@2000-01-03]', '1 day');
+SELECT timeSplitIntegral(tfloat '{[1.5@2000-01-01, 2.5@2000-01-02, 1.5@2000-01-03],[3.5@2000-01-04, 3.5@2000-01-05]}', '1 day');
+SELECT timeSplitTwAvg(tfloat '{1.5@2000-01-01, 2.5@2000-01-02, 1.5@2000-01-03}', '1 week');
+SELECT timeSplitTwAvg(tfloat '{[1.5@2000-01-01, 2.5@2000-01-02, 1.5@2000-01-03],[3.5@2000-01-04, 3.5@2000-01-05]}', '1 week');
+SELECT timeSplitTwAvg(tint '{[1@2000-01-01], [3@2000-01-02]}', '1 week');
+SELECT timeSplitMin(tfloat 'Interp=Step;[1.5@2000-01-01, 2.5@2000-01-02, 1.5@2000-01-03]', '1 day');
+SELECT timeSplitMax(tint '[1@2000-01-01, 2@2000-01-02, 1@2000-01-03]', '1 day');
+
+/* Errors */
+SELECT timeSplitIntegral(tfloat '1.5@2000-01-01', '0 days');
+
+-------------------------------------------------------------------------------
+-- valueTimeHistogram
+-------------------------------------------------------------------------------
+
+SELECT valueTimeHistogram(tfloat '[1@2000-01-01, 3@2000-01-03]', 1, '1 day');
+SELECT valueTimeHistogram(tfloat '[1@2000-01-01, 3@2000-01-03]', 0.5, '1 day');
+SELECT valueTimeHistogram(tfloat '[0@2000-01-01, 4@2000-01-02]', 1, '12 hours');
+SELECT valueTimeHistogram(tfloat 'Interp=Step;[1@2000-01-01, 2@2000-01-02, 2@2000-01-03]', 1, '1 day');
+SELECT valueTimeHistogram(tfloat '{[1@2000-01-01, 1@2000-01-01 06:00:00],[1@2000-01-01 12:00:00, 1@2000-01-01 18:00:00]}', 1, '1 day');
+SELECT COUNT(*) FROM valueTimeHistogram(tfloat '{1@2000-01-01, 2@2000-01-02}', 1, '1 day');
+
+/* Errors */
+SELECT valueTimeHistogram(tfloat '[1@2000-01-01, 3@2000-01-03]', 0, '1 day');
+SELECT valueTimeHistogram(tfloat '[1@2000-01-01, 3@2000-01-03]', 1, '0 days');
+
+-------------------------------------------------------------------------------
@@ -112,6 +112,44 @@ temp2 AS (
   FROM temp1 GROUP BY k, temp )
 SELECT k FROM temp2 WHERE temp <> tmerge ORDER BY k;
 
+-- The time-bucketed aggregates are those of the timeSplit fragments
+WITH agg AS (
+  SELECT k, (i).time, (i).value AS integral, (a).value AS twavg,
+    (mi).value AS minvalue, (ma).value AS maxvalue
+  FROM (SELECT k, timeSplitIntegral(temp, '5 min') AS i,
+    timeSplitTwAvg(temp, '5 min') AS a, timeSplitMin(temp, '5 min') AS mi,
+    timeSplitMax(temp, '5 min') AS ma FROM tbl_tint) t ),
+split AS (
+  SELECT k, (sp).time, integral((sp).temp) AS integral,
+    twAvg((sp).temp) AS twavg, minValue((sp).temp) AS minvalue,
+    maxValue((sp).temp) AS maxvalue
+  FROM (SELECT k, timeSplit(temp, '5 min') AS sp FROM tbl_tint) t )
+SELECT COUNT(*) FROM agg FULL OUTER JOIN split
+  ON agg.k = split.k AND agg.time = split.time
+WHERE agg.k IS NULL OR split.k IS NULL OR
+  abs(agg.integral - split.integral) > 1e-6 * greatest(1, abs(split.integral)) OR
+  abs(agg.twavg - split.twavg) > 1e-6 OR
+  abs(agg.minvalue - split.minvalue) > 1e-6 OR
+  abs(agg.maxvalue - split.maxvalue) > 1e-6;
+WITH agg AS (
+  SELECT k, (i).time, (i).value AS integral, (a).value AS twavg,
+    (mi).value AS minvalue, (ma).value AS maxvalue
+  FROM (SELECT k, timeSplitIntegral(temp, '5 min') AS i,
+    timeSplitTwAvg(temp, '5 min') AS a, timeSplitMin(temp, '5 min') AS mi,
+    timeSplitMax(temp, '5 min') AS ma FROM tbl_tfloat) t ),
+split AS (
+  SELECT k, (sp).time, integral((sp).temp) AS integral,
+    twAvg((sp).temp) AS twavg, minValue((sp).temp) AS minvalue,
+    maxValue((sp).temp) AS maxvalue
+  FROM (SELECT k, timeSplit(temp, '5 min') AS sp FROM tbl_tfloat) t )
+SELECT COUNT(*) FROM agg FULL OUTER JOIN split
+  ON agg.k = split.k AND agg.time = split.time
+WHERE agg.k IS NULL OR split.k IS NULL OR
+  abs(agg.integral - split.integral) > 1e-6 * greatest(1, abs(split.integral)) OR
+  abs(agg.twavg - split.twavg) > 1e-6 OR
+  abs(agg.minvalue - split.minvalue) > 1e-6 OR
+  abs(agg.maxvalue - split.maxvalue) > 1e-6;
+
 -------------------------------------------------------------------------------
 -- valueTimeSplit
 -------------------------------------------------------------------------------
@@ -131,3 +169,31 @@ temp2 AS (
 SELECT k FROM temp2 WHERE temp <> tmerge ORDER BY k;
 
 -------------------------------------------------------------------------------
+-- valueTimeHistogram
+-------------------------------------------------------------------------------
+
+-- The durations are the sums of the durations of the valueTimeSplit fragments
+WITH hist AS (
+  SELECT k, (h).number, (h).time, (h).duration
+  FROM (SELECT k, valueTimeHistogram(temp, 2.5, '2 days') AS h FROM tbl_tfloat) t ),
+split AS (
+  SELECT k, (sp).number, (sp).time, SUM(duration((sp).tnumber)) AS duration
+  FROM (SELECT k, valueTimeSplit(temp, 2.5, '2 days') AS sp FROM tbl_tfloat) t
+  GROUP BY 1, 2, 3 )
+SELECT COUNT(*) FROM hist FULL OUTER JOIN split
+  ON hist.k = split.k AND hist.number = split.number AND hist.time = split.time
+WHERE abs(extract(epoch FROM COALESCE(hist.duration, '0') -
+  COALESCE(split.duration, '0'))) > 1e-3;
+WITH hist AS (
+  SELECT k, (h).number, (h).time, (h).duration
+  FROM (SELECT k, valueTimeHistogram(temp, 2.5, '2 days', 1.5, '2001-06-01') AS h FROM tbl_tfloat) t ),
+split AS (
+  SELECT k, (sp).number, (sp).time, SUM(duration((sp).tnumber)) AS duration
+  FROM (SELECT k, valueTimeSplit(temp, 2.5, '2 days', 1.5, '2001-06-01') AS sp FROM tbl_tfloat) t
+  GROUP BY 1, 2, 3 )
+SELECT COUNT(*) FROM hist FULL OUTER JOIN split
+  ON hist.k = split.k AND hist.number = split.number AND hist.time = split.time
+WHERE abs(extract(epoch FROM COALESCE(hist.duration, '0') -
+  COALESCE(split.duration, '0'))) > 1e-3;
+
+-------------------------------------------------------------------------------
@@ -945,3 +945,44 @@ SELECT COUNT(*) FROM tbl_tbool WHERE tstzspan '[2001-01-01, 2001-06-01]' <<# tem
 SELECT COUNT(*) FROM tbl_ttext WHERE tstzspan '[2001-01-01, 2001-06-01]' <<# temp;
 
 -------------------------------------------------------------------------------
+
+-------------------------------------------------------------------------------
+-- Join selectivity for temporal box columns
+-------------------------------------------------------------------------------
+
+-- The boxes of tbl_tbox_diag overlap the boxes whose lower bounds are at
+-- most 10 units or days away, that is, 1990 of the 10000 pairs of boxes
+CREATE TABLE tbl_tbox_diag AS
+SELECT k, tbox(span(k, k + 10, true, true),
+  span(timestamptz '2001-01-01' + k * interval '1 day',
+    timestamptz '2001-01-11' + k * interval '1 day', true, true)) AS b
+FROM generate_series(0, 99) AS k;
+-- Boxes disjoint in time from the ones of tbl_tbox_diag
+CREATE TABLE tbl_tbox_disj AS
+SELECT k, tbox(span(k, k + 10, true, true),
+  span(timestamptz '2011-01-01' + k * interval '1 day',
+    timestamptz '2011-01-11' + k * interval '1 day', true, true)) AS b
+FROM generate_series(0, 99) AS k;
+-- Boxes covering in time all the ones of tbl_tbox_diag
+CREATE TABLE tbl_tbox_cover AS
+SELECT k, tbox(span(k, k + 10, true, true),
+  span(timestamptz '2000-01-01' + k * interval '1 hour',
+    timestamptz '2002-01-01' + k * interval '1 hour', true, true)) AS b
+FROM generate_series(0, 99) AS k;
+analyze tbl_tbox_diag;
+analyze tbl_tbox_disj;
+analyze tbl_tbox_cover;
+
+SELECT COUNT(*) FROM tbl_tbox_diag t1, tbl_tbox_diag t2 WHERE t1.b && t2.b;
+SELECT _mobdb_span_joinsel('tbl_tbox_diag'::regclass, 'b', 'tbl_tbox_diag'::regclass, 'b', '&&(tstzspan,tstzspan)'::regoperator) BETWEEN 0.1 AND 0.4;
+SELECT _mobdb_span_joinsel('tbl_tbox_diag'::regclass, 'b', 'tbl_tbox_diag'::regclass, 'b', '&&(intspan,intspan)'::regoperator) BETWEEN 0.1 AND 0.4;
+SELECT COUNT(*) FROM tbl_tbox_diag t1, tbl_tbox_disj t2 WHERE t1.b::tstzspan && t2.b::tstzspan;
+SELECT _mobdb_span_joinsel('tbl_tbox_diag'::regclass, 'b', 'tbl_tbox_disj'::regclass, 'b', '&&(tstzspan,tstzspan)'::regoperator) < 0.01;
+SELECT COUNT(*) FROM tbl_tbox_cover t1, tbl_tbox_diag t2 WHERE t1.b::tstzspan @> t2.b::tstzspan;
+SELECT _mobdb_span_joinsel('tbl_tbox_cover'::regclass, 'b', 'tbl_tbox_diag'::regclass, 'b', '@>(tstzspan,tstzspan)'::regoperator) > 0.9;
+
+DROP TABLE tbl_tbox_diag;
+DROP TABLE tbl_tbox_disj;
+DROP TABLE tbl_tbox_cover;
+
+-------------------------------------------------------------------------------
@@ -1248,6 +1248,15 @@ SELECT asText(deleteTime(tgeogpoint 'Point(1.5 1.5)@2000-01-01', tstzspanset '{[
 SELECT asText(deleteTime(tgeogpoint '{Point(1.5 1.5)@2000-01-01, Point(2.5 2.5)@2000-01-02, Point(1.5 1.5)@2000-01-03}', tstzspanset '{[2000-01-01,2000-01-02]}'));
 SELECT asText(deleteTime(tgeogpoint '[Point(1.5 1.5)@2000-01-01, Point(2.5 2.5)@2000-01-02, Point(1.5 1.5)@2000-01-03]', tstzspanset '{[2000-01-01,2000-01-02]}'));
 SELECT asText(deleteTime(tgeogpoint '{[Point(1.5 1.5)@2000-01-01, Point(2.5 2.5)@2000-01-02, Point(1.5 1.5)@2000-01-03],[Point(3.5 3.5)@2000-01-04, Point(3.5 3.5)@2000-01-05]}', tstzspanset '{[2000-01-01,2000-01-02]}'));
+SELECT stbox(deleteTime(tgeompoint '[Point(1 1)@2000-01-01, Point(5 5)@2000-01-02, Point(2 3)@2000-01-03, Point(3 3)@2000-01-04]', tstzspan '[2000-01-04, 2000-01-04]')) = stbox(tgeompoint '[Point(1 1)@2000-01-01, Point(5 5)@2000-01-02, Point(2 3)@2000-01-03)');
+WITH temp(k, inst) AS (
+  SELECT k, tgeompoint(ST_Point(k, k % 2), timestamptz '2000-01-01' + k * interval '1 minute')
+  FROM generate_series(0, 1999) AS k ),
+temp1(seq1, seq2) AS (
+  SELECT deleteTime(tgeompointSeq(array_agg(inst ORDER BY k)), tstzspan '[2000-01-01, 2000-01-01 00:10:00]'),
+    tgeompointSeq(array_agg(inst ORDER BY k) FILTER (WHERE k > 10))
+  FROM temp )
+SELECT stbox(seq1) = stbox(seq2), memSize(seq1) = memSize(seq2) FROM temp1;
 
 -------------------------------------------------------------------------------
 -- Comparison functions and B-tree indexing
@@ -819,6 +819,10 @@ SELECT asText(atGeometry(tgeompoint '{[Point(1 1)@2000-01-01, Point(2 2)@2000-01
 SELECT asText(atGeometry(tgeompoint '[Point(0 3)@2000-01-01, Point(1 1)@2000-01-02, Point(3 2)@2000-01-03, Point(0 3)@2000-01-04]', geometry 'Polygon((0 0,0 2,2 2,2 0,0 0))'));
 SELECT astext(atGeometry(tgeompoint '[Point(0 0)@2000-01-01, Point(3 3)@2000-01-02, Point(0 3)@2000-01-03, Point(
 3 0)@2000-01-04]', 'Polygon((1 1,2 1,2 2,1 2,1 1))'));
+SELECT asText(atGeometry(tgeompoint '[Point(0 1)@2000-01-01, Point(4 1)@2000-01-05]', geometry 'Polygon((0 0,0 2,4 2,4 0,0 0),(1 0.5,1 1.5,3 1.5,3 0.5,1 0.5))'));
+SELECT asText(atGeometry(tgeompoint '[Point(0 1)@2000-01-01, Point(4 1)@2000-01-05]', geometry 'MultiPolygon(((0 0,0 2,1 2,1 0,0 0)),((3 0,3 2,4 2,4 0,3 0)))'));
+SELECT asText(atGeometry(tgeompoint '[Point(3 1)@2000-01-01, Point(1 3)@2000-01-03]', geometry 'Polygon((0 0,0 2,2 2,2 0,0 0))'));
+SELECT asText(atGeometry(tgeompoint '[Point(50 -1)@2000-01-01, Point(50 1)@2000-01-03]', ST_MakeLine(ARRAY(SELECT ST_Point(i / 50.0, (i % 2) / 100.0) FROM generate_series(0, 5000) AS i))));
 SELECT asText(atGeometry(tgeompoint 'Interp=Step;[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03]', geometry 'Linestring(0 0,3 3)'));
 SELECT asText(atGeometry(tgeompoint 'Interp=Step;{[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03],[Point(3 3)@2000-01-04, Point(3 3)@2000-01-05]}', geometry 'Linestring(0 0,3 3)'));
 SELECT asText(atGeometry(tgeompoint 'Interp=Step;[Point(0 3)@2000-01-01, Point(1 1)@2000-01-02, Point(3 2)@2000-01-03, Point(0 3)@2000-01-04]', geometry 'Polygon((0 0,0 2,2 2,2 0,0 0))'));
@@ -1013,6 +1017,16 @@ WITH temp(trip, box) AS (
     Point(3 1 3)@2000-01-05]', stbox 'STBox Z((2 0 0),(4 2 2))' )
 SELECT trip = merge(atStbox(trip, box), minusStbox(trip,box))
 FROM temp;
+WITH temp(trip, box) AS (
+  SELECT tgeompointSeq(array_agg(tgeompoint(ST_Point(i, i % 2),
+    timestamptz '2000-01-01' + i * interval '1 minute') ORDER BY i)),
+    stbox 'STBox X((100 0),(110 1))'
+  FROM generate_series(1, 2000) i )
+SELECT atStbox(trip, box) = atStbox(atTime(trip,
+  tstzspan '[2000-01-01 01:30, 2000-01-01 02:00]'), box) AND
+  atGeometry(trip, box::geometry) = atGeometry(atTime(trip,
+  tstzspan '[2000-01-01 01:30, 2000-01-01 02:00]'), box::geometry)
+FROM temp;
 
 --------------------------------------------------------
 
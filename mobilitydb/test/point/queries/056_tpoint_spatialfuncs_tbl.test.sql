@@ -186,6 +186,23 @@ SELECT COUNT(*) FROM tbl_tgeompoint t1, tbl_geometry t2 WHERE t1.k % 2 = 0 AND t
 SELECT COUNT(*) FROM tbl_tgeompoint t1, tbl_stbox t2 WHERE temp != merge(atStbox(temp, b), minusStbox(temp, b));
 SELECT COUNT(*) FROM tbl_tgeogpoint3d t1, tbl_geodstbox3d t2 WHERE temp != merge(atStbox(temp, b), minusStbox(temp, b));
 
+-- Prepared geometry shared by all the rows compared with a geometry that
+-- alternates between two serializations and is thus never prepared
+SELECT COUNT(*) FROM tbl_tgeompoint_seqset,
+  (SELECT geometry 'Polygon((20 20,20 80,50 50,80 80,80 20,20 20))' AS g) t
+  WHERE atGeometry(ts, g) IS DISTINCT FROM
+    atGeometry(ts, CASE WHEN k % 2 = 0 THEN g ELSE ST_DropBBox(g) END);
+SELECT COUNT(*) FROM tbl_tgeompoint_seqset,
+  (SELECT geometry 'Polygon((20 20,20 80,50 50,80 80,80 20,20 20))' AS g) t
+  WHERE minusGeometry(ts, g) IS DISTINCT FROM
+    minusGeometry(ts, CASE WHEN k % 2 = 0 THEN g ELSE ST_DropBBox(g) END);
+
+-- Geometry with many vertices intersected tile by tile
+SELECT COUNT(*) FROM tbl_tgeompoint_seqset,
+  (SELECT ST_MakeLine(ARRAY(SELECT ST_Point(i / 50.0, 50 + 40 * sin(i / 100.0))
+    FROM generate_series(0, 5000) AS i)) AS g) t
+  WHERE ts != merge(atGeometry(ts, g), minusGeometry(ts, g));
+
 -------------------------------------------------------------------------------
 
 -- set parallel_tuple_cost=100;
@@ -0,0 +1,128 @@
+-------------------------------------------------------------------------------
+--
+-- This MobilityDB code is provided under The PostgreSQL License.
+-- Copyright (c) 2016-2024, Université libre de Bruxelles and MobilityDB
+-- contributors
+--
+-- MobilityDB includes portions of PostGIS version 3 source code released
+-- under the GNU General Public License (GPLv2 or later).
+-- Copyright (c) 2001-2024, PostGIS contributors
+--
+-- Permission to use, copy, modify, and distribute this software and its
+-- documentation for any purpose, without fee, and without a written
+-- agreement is hereby granted, provided that the above copyright notice and
+-- this paragraph and the following two paragraphs appear in all copies.
+--
+-- IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+-- DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+-- LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+-- EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+-- OF SUCH DAMAGE.
+--
+-- UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+-- INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+-- AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+-- AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+-- PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+--
+-------------------------------------------------------------------------------
+
+-------------------------------------------------------------------------------
+-- Joint space-time statistics
+-------------------------------------------------------------------------------
+-- The points move along the diagonal at one unit per second in 2020, when the
+-- number of seconds since the PostgreSQL epoch cannot be represented in a
+-- float4 with a resolution of one second
+
+CREATE TABLE tbl_tgeompoint_diag AS
+SELECT k, tgeompoint(ST_Point(k, k), timestamptz '2020-01-01 00:00:00+00' + k * interval '1 second') AS temp
+FROM generate_series(0, 999) AS k;
+-- Same values inserted in reverse order so that the time origin of the
+-- statistics differs from the one of the previous table
+CREATE TABLE tbl_tgeompoint_diag_rev AS
+SELECT * FROM tbl_tgeompoint_diag ORDER BY k DESC;
+ANALYZE tbl_tgeompoint_diag;
+ANALYZE tbl_tgeompoint_diag_rev;
+
+CREATE FUNCTION plan_rows(query text)
+RETURNS bigint AS $$
+DECLARE
+  J json;
+BEGIN
+  EXECUTE 'EXPLAIN (FORMAT JSON) ' || query INTO J;
+  RETURN (J->0->'Plan'->>'Plan Rows')::bigint;
+END;
+$$ LANGUAGE plpgsql;
+
+-- Location and time are correlated
+SELECT COUNT(*) FROM tbl_tgeompoint_diag WHERE temp && stbox 'STBOX XT(((100,100),(199,199)),[2020-01-01 00:01:40+00,2020-01-01 00:03:19+00])';
+SELECT plan_rows('SELECT * FROM tbl_tgeompoint_diag WHERE temp && stbox ''STBOX XT(((100,100),(199,199)),[2020-01-01 00:01:40+00,2020-01-01 00:03:19+00])''') BETWEEN 50 AND 200;
+-- Location and time are anti-correlated
+SELECT COUNT(*) FROM tbl_tgeompoint_diag WHERE temp && stbox 'STBOX XT(((100,100),(199,199)),[2020-01-01 00:13:20+00,2020-01-01 00:14:59+00])';
+SELECT plan_rows('SELECT * FROM tbl_tgeompoint_diag WHERE temp && stbox ''STBOX XT(((100,100),(199,199)),[2020-01-01 00:13:20+00,2020-01-01 00:14:59+00])''') < 5;
+-- Join of histograms with different time origins
+SELECT COUNT(*) FROM tbl_tgeompoint_diag t1, tbl_tgeompoint_diag_rev t2 WHERE t1.temp && t2.temp;
+SELECT plan_rows('SELECT * FROM tbl_tgeompoint_diag t1, tbl_tgeompoint_diag_rev t2 WHERE t1.temp && t2.temp') >= 500;
+
+DROP FUNCTION plan_rows;
+DROP TABLE tbl_tgeompoint_diag;
+DROP TABLE tbl_tgeompoint_diag_rev;
+
+-------------------------------------------------------------------------------
+
+-------------------------------------------------------------------------------
+-- Join selectivity for spatiotemporal box columns
+-------------------------------------------------------------------------------
+-- The boxes of tbl_stbox_diag overlap the boxes whose lower bounds are at
+-- most 10 units or days away, that is, 1990 of the 10000 pairs of boxes
+
+CREATE TABLE tbl_stbox_diag AS
+SELECT k, stbox(ST_MakeEnvelope(k, k, k + 10, k + 10),
+  span(timestamptz '2001-01-01' + k * interval '1 day',
+    timestamptz '2001-01-11' + k * interval '1 day', true, true)) AS b
+FROM generate_series(0, 99) AS k;
+-- Boxes disjoint in time from the ones of tbl_stbox_diag
+CREATE TABLE tbl_stbox_disj AS
+SELECT k, stbox(ST_MakeEnvelope(k, k, k + 10, k + 10),
+  span(timestamptz '2011-01-01' + k * interval '1 day',
+    timestamptz '2011-01-11' + k * interval '1 day', true, true)) AS b
+FROM generate_series(0, 99) AS k;
+ANALYZE tbl_stbox_diag;
+ANALYZE tbl_stbox_disj;
+
+CREATE FUNCTION plan_rows(query text)
+RETURNS bigint AS $$
+DECLARE
+  J json;
+BEGIN
+  EXECUTE 'EXPLAIN (FORMAT JSON) ' || query INTO J;
+  RETURN (J->0->'Plan'->>'Plan Rows')::bigint;
+END;
+$$ LANGUAGE plpgsql;
+
+SELECT COUNT(*) FROM tbl_stbox_diag t1, tbl_stbox_diag t2 WHERE t1.b && t2.b;
+SELECT plan_rows('SELECT * FROM tbl_stbox_diag t1, tbl_stbox_diag t2 WHERE t1.b && t2.b') BETWEEN 500 AND 8000;
+SELECT COUNT(*) FROM tbl_stbox_diag t1, tbl_stbox_disj t2 WHERE t1.b && t2.b;
+SELECT plan_rows('SELECT * FROM tbl_stbox_diag t1, tbl_stbox_disj t2 WHERE t1.b && t2.b') < 10;
+
+DROP FUNCTION plan_rows;
+DROP TABLE tbl_stbox_diag;
+DROP TABLE tbl_stbox_disj;
+
+-- A sample mixing 2D and 3D points does not get a joint histogram since the
+-- time dimension would not be at the same position for all the boxes
+
+CREATE TABLE tbl_tgeompoint_mixed AS
+SELECT k, CASE WHEN k % 2 = 0
+  THEN tgeompoint(ST_Point(k, k), timestamptz '2020-01-01 00:00:00+00' + k * interval '1 second')
+  ELSE tgeompoint(ST_MakePoint(k, k, k), timestamptz '2020-01-01 00:00:00+00' + k * interval '1 second') END AS temp
+FROM generate_series(0, 999) AS k;
+ANALYZE tbl_tgeompoint_mixed;
+
+SELECT COUNT(*) FROM pg_statistic WHERE starelid = 'tbl_tgeompoint_mixed'::regclass AND
+  12 IN (stakind1, stakind2, stakind3, stakind4, stakind5);
+SELECT COUNT(*) FROM tbl_tgeompoint_mixed WHERE temp && stbox 'STBOX XT(((100,100),(199,199)),[2020-01-01 00:01:40+00,2020-01-01 00:03:19+00])';
+
+DROP TABLE tbl_tgeompoint_mixed;
+
+-------------------------------------------------------------------------------
@@ -179,7 +179,83 @@ FROM (SELECT spaceTimeSplit(tgeompoint 'Interp=Step;[Point(1 1 1)@2000-01-01, Po
 SELECT ST_AsText((sp).point) AS point, (sp).time, astext((sp).tpoint) AS tpoint
 FROM (SELECT spaceTimeSplit(tgeompoint 'Interp=Step;{[Point(1 1 1)@2000-01-01, Point(2 2 2)@2000-01-02, Point(1 1 1)@2000-01-03],[Point(3 3 3)@2000-01-04, Point(3 3 3)@2000-01-05]}', 2.0, interval '2 days', 'Point(0.5 0.5 0.5)', '2000-01-15') AS sp) t;
 
+-- Step segments spanning several time tiles
+SELECT ST_AsText((sp).point) AS point, (sp).time, astext((sp).tpoint) AS tpoint
+FROM (SELECT spaceTimeSplit(tgeompoint 'Interp=Step;[Point(1 1)@2000-01-01, Point(5 5)@2000-01-05, Point(1 1)@2000-01-06]', 2.0, interval '1 day') AS sp) t;
+-- Instantaneous sequences in a sequence set
+SELECT ST_AsText((sp).point) AS point, (sp).time, astext((sp).tpoint) AS tpoint
+FROM (SELECT spaceTimeSplit(tgeompoint '{[Point(1 1)@2000-01-01, Point(1.5 1.5)@2000-01-02],[Point(5 5)@2000-01-03 12:00:00],[Point(1 1)@2000-01-05, Point(1.5 1.5)@2000-01-06]}', 2.0, interval '2 days') AS sp) t;
 /* Errors */
 SELECT spaceTimeSplit(tgeompoint 'SRID=5676;Point(1 1 1)@2000-01-01', 2.0, interval '2 days', 'SRID=3812;Point(0.5 0.5 0.5)');
 
 -------------------------------------------------------------------------------
+
+-------------------------------------------------------------------------------
+-- Aggregation by tiles
+-------------------------------------------------------------------------------
+
+-- The last fragment of the third temporal point is an instant on the upper
+-- border of its tile, it is counted in the next tile
+SELECT (ta).tile, (ta).count, (ta).duration, (ta).distance,
+  round(((ta).speed * 86400)::numeric, 6) AS speed
+FROM (SELECT tileAgg(ARRAY[tgeompoint '[Point(1 1)@2000-01-01, Point(3 1)@2000-01-03]',
+  '[Point(1 1.5)@2000-01-01, Point(1 1.5)@2000-01-02]', '[Point(3 3)@2000-01-01, Point(4 3)@2000-01-02]'], 2.0, 2.0) AS ta) t;
+SELECT (ta).tile, (ta).count, (ta).duration, (ta).distance,
+  round(((ta).speed * 86400)::numeric, 6) AS speed
+FROM (SELECT tileAgg(ARRAY[tgeompoint '[Point(1 1)@2000-01-01, Point(3 1)@2000-01-03]',
+  '[Point(1 1.5)@2000-01-01, Point(1 1.5)@2000-01-02]', '[Point(3 3)@2000-01-01, Point(4 3)@2000-01-02]'], 2.0, 2.0, interval '1 day') AS ta) t;
+SELECT COUNT(*) FROM (SELECT tileAgg('{}'::tgeompoint[], 2.0, 2.0)) t;
+
+-------------------------------------------------------------------------------
+-- Quadtree and hexagonal grids
+-------------------------------------------------------------------------------
+
+SELECT quadCell(geometry 'Point(3 5)', stbox 'STBOX X((0,0),(8,8))', 2);
+SELECT quadCellParent(quadCell(geometry 'Point(3 5)', stbox 'STBOX X((0,0),(8,8))', 2), 1);
+SELECT quadCellBox(576460752303423497, stbox 'STBOX X((0,0),(8,8))');
+SELECT (sp).cell, astext((sp).tpoint) AS tpoint
+FROM (SELECT quadSplit(tgeompoint '[Point(1 1)@2000-01-01, Point(5 1)@2000-01-05]', stbox 'STBOX X((0,0),(8,8))', 1) AS sp) t;
+/* Errors */
+SELECT quadCell(geometry 'Point(9 9)', stbox 'STBOX X((0,0),(8,8))', 2);
+SELECT quadCellParent(576460752303423497, 3);
+
+SELECT hexCell(geometry 'Point(1.5 0.9)', 1.0);
+SELECT hexCell(geometry 'Point(-1.5 -0.9)', 1.0);
+SELECT ST_Contains(hexCellGeom(hexCell(geometry 'Point(1.5 0.9)', 1.0), 1.0), geometry 'Point(1.5 0.9)');
+SELECT round(ST_Area(hexCellGeom(0, 2.0))::numeric, 6);
+SELECT (sp).cell, astext((sp).tpoint) AS tpoint
+FROM (SELECT hexSplit(tgeompoint '{Point(0 0)@2000-01-01, Point(3 0)@2000-01-02, Point(0.1 0)@2000-01-03}', 1.0) AS sp) t;
+SELECT (sp).cell, ST_AsText(trajectory(round((sp).tpoint, 6))) AS traj,
+  date_trunc('second', startTimestamp((sp).tpoint)) AS tstart,
+  date_trunc('second', endTimestamp((sp).tpoint)) AS tend
+FROM (SELECT hexSplit(tgeompoint '[Point(0 0.2)@2000-01-01, Point(10 0.2)@2000-01-11]', 1.0) AS sp) t;
+-- The instant on the common border of adjacent hexagons belongs to one fragment
+SELECT (sp).cell, lowerInc(getTime((sp).tpoint)), upperInc(getTime((sp).tpoint))
+FROM (SELECT hexSplit(tgeompoint '[Point(0 0.2)@2000-01-01, Point(10 0.2)@2000-01-11]', 1.0) AS sp) t;
+-- Segments passing through vertices and running along edges
+WITH temps(k, temp) AS (
+  VALUES (1, tgeompoint '[Point(-3 0)@2000-01-01, Point(3 0)@2000-01-07]'),
+    (2, tgeompoint '[Point(0 0)@2000-01-01, Point(3 1.7320508075688772)@2000-01-04, Point(-2 0.8660254037844386)@2000-01-09]'),
+    (3, tgeompoint 'Interp=Step;[Point(1 0)@2000-01-01, Point(0.5 0)@2000-01-02, Point(1 0)@2000-01-03]') ),
+frags AS (
+  SELECT k, (sp).cell, (sp).tpoint AS frag
+  FROM (SELECT k, hexSplit(temp, 1.0) AS sp FROM temps) t )
+SELECT COUNT(*) FROM frags f1, frags f2
+WHERE f1.k = f2.k AND f1.cell < f2.cell AND getTime(f1.frag) && getTime(f2.frag);
+WITH temps(k, temp) AS (
+  VALUES (1, tgeompoint '[Point(-3 0)@2000-01-01, Point(3 0)@2000-01-07]'),
+    (2, tgeompoint '[Point(0 0)@2000-01-01, Point(3 1.7320508075688772)@2000-01-04, Point(-2 0.8660254037844386)@2000-01-09]'),
+    (3, tgeompoint 'Interp=Step;[Point(1 0)@2000-01-01, Point(0.5 0)@2000-01-02, Point(1 0)@2000-01-03]') )
+SELECT COUNT(*) FROM temps
+WHERE duration(temp) <> (SELECT SUM(duration((sp).tpoint))
+  FROM (SELECT hexSplit(temp, 1.0) AS sp) t);
+
+-------------------------------------------------------------------------------
+-- Time-bucketed length
+-------------------------------------------------------------------------------
+
+SELECT timeSplitLength(tgeompoint '[Point(0 0)@2000-01-01, Point(2 0)@2000-01-03]', '1 day');
+SELECT timeSplitLength(tgeompoint '{[Point(0 0)@2000-01-01, Point(3 4)@2000-01-01 12:00:00],[Point(3 4)@2000-01-03, Point(3 7)@2000-01-03 12:00:00]}', '1 day');
+SELECT timeSplitLength(tgeompoint 'Interp=Step;[Point(0 0)@2000-01-01, Point(2 0)@2000-01-03]', '1 day');
+
+-------------------------------------------------------------------------------
@@ -63,4 +63,86 @@ SELECT extent(tile(g, t, 2.5, interval '2 days', geometry 'Point(10 10 10)', '20
 
 -------------------------------------------------------------------------------
 
+-------------------------------------------------------------------------------
+-- Space-time split with and without the tiles traversed by the temporal point
+-------------------------------------------------------------------------------
+
+WITH t1 AS (
+  SELECT k, ST_AsText((sp).point) AS point, (sp).time, asText((sp).tpoint) AS tpoint
+  FROM (SELECT k, spaceTimeSplit(seq, 10.0, interval '30 days', bitmatrix := true) AS sp FROM tbl_tgeompoint_step_seq) t),
+t2 AS (
+  SELECT k, ST_AsText((sp).point) AS point, (sp).time, asText((sp).tpoint) AS tpoint
+  FROM (SELECT k, spaceTimeSplit(seq, 10.0, interval '30 days', bitmatrix := false) AS sp FROM tbl_tgeompoint_step_seq) t)
+SELECT COUNT(*) FROM ((SELECT * FROM t1 EXCEPT SELECT * FROM t2) UNION
+  (SELECT * FROM t2 EXCEPT SELECT * FROM t1)) t;
+WITH t1 AS (
+  SELECT k, ST_AsText((sp).point) AS point, (sp).time, asText((sp).tpoint) AS tpoint
+  FROM (SELECT k, spaceTimeSplit(ss, 10.0, interval '30 days', bitmatrix := true) AS sp FROM tbl_tgeompoint_step_seqset) t),
+t2 AS (
+  SELECT k, ST_AsText((sp).point) AS point, (sp).time, asText((sp).tpoint) AS tpoint
+  FROM (SELECT k, spaceTimeSplit(ss, 10.0, interval '30 days', bitmatrix := false) AS sp FROM tbl_tgeompoint_step_seqset) t)
+SELECT COUNT(*) FROM ((SELECT * FROM t1 EXCEPT SELECT * FROM t2) UNION
+  (SELECT * FROM t2 EXCEPT SELECT * FROM t1)) t;
+WITH t1 AS (
+  SELECT k, ST_AsText((sp).point) AS point, (sp).time, asText((sp).tpoint) AS tpoint
+  FROM (SELECT k, spaceTimeSplit(ss, 10.0, interval '30 days', bitmatrix := true) AS sp FROM tbl_tgeompoint_seqset) t),
+t2 AS (
+  SELECT k, ST_AsText((sp).point) AS point, (sp).time, asText((sp).tpoint) AS tpoint
+  FROM (SELECT k, spaceTimeSplit(ss, 10.0, interval '30 days', bitmatrix := false) AS sp FROM tbl_tgeompoint_seqset) t)
+SELECT COUNT(*) FROM ((SELECT * FROM t1 EXCEPT SELECT * FROM t2) UNION
+  (SELECT * FROM t2 EXCEPT SELECT * FROM t1)) t;
+
+-- Compare the aggregation by tiles with the split of each temporal point
+WITH agg AS (
+  SELECT Xmin((ta).tile) AS x, Ymin((ta).tile) AS y, NULL::timestamptz AS t, (ta).count,
+    (ta).duration, (ta).distance
+  FROM (SELECT tileAgg(array_agg(temp), 10.0, 10.0) AS ta FROM tbl_tgeompoint) t),
+split AS (
+  SELECT ST_X((sp).point) AS x, ST_Y((sp).point) AS y, NULL::timestamptz AS t, COUNT(*) AS count,
+    SUM(duration((sp).tpoint)) AS duration, SUM(length((sp).tpoint)) AS distance
+  FROM (SELECT spaceSplit(temp, 10.0, 10.0) AS sp FROM tbl_tgeompoint) t
+  GROUP BY 1, 2, 3)
+SELECT COUNT(*) FROM agg FULL OUTER JOIN split
+  ON agg.x = split.x AND agg.y = split.y AND agg.t IS NOT DISTINCT FROM split.t
+WHERE agg.count IS DISTINCT FROM split.count OR
+  agg.duration IS DISTINCT FROM split.duration OR
+  NOT abs(agg.distance - split.distance) < 1e-6;
+WITH agg AS (
+  SELECT Xmin((ta).tile) AS x, Ymin((ta).tile) AS y, Tmin((ta).tile) AS t, (ta).count,
+    (ta).duration, (ta).distance
+  FROM (SELECT tileAgg(array_agg(temp), 10.0, 10.0, interval '30 days') AS ta FROM tbl_tgeompoint) t),
+split AS (
+  SELECT ST_X((sp).point) AS x, ST_Y((sp).point) AS y, (sp).time AS t, COUNT(*) AS count,
+    SUM(duration((sp).tpoint)) AS duration, SUM(length((sp).tpoint)) AS distance
+  FROM (SELECT spaceTimeSplit(temp, 10.0, 10.0, interval '30 days') AS sp FROM tbl_tgeompoint) t
+  GROUP BY 1, 2, 3)
+SELECT COUNT(*) FROM agg FULL OUTER JOIN split
+  ON agg.x = split.x AND agg.y = split.y AND agg.t IS NOT DISTINCT FROM split.t
+WHERE agg.count IS DISTINCT FROM split.count OR
+  agg.duration IS DISTINCT FROM split.duration OR
+  NOT abs(agg.distance - split.distance) < 1e-6;
+
+-- The length of each time bucket is the one of the timeSplit fragment
+WITH agg AS (
+  SELECT k, (ts).time, (ts).value AS length
+  FROM (SELECT k, timeSplitLength(temp, '5 min') AS ts FROM tbl_tgeompoint) t ),
+split AS (
+  SELECT k, (sp).time, length((sp).temp) AS length
+  FROM (SELECT k, timeSplit(temp, '5 min') AS sp FROM tbl_tgeompoint) t )
+SELECT COUNT(*) FROM agg FULL OUTER JOIN split
+  ON agg.k = split.k AND agg.time = split.time
+WHERE agg.k IS NULL OR split.k IS NULL OR
+  abs(agg.length - split.length) > 1e-6;
+WITH agg AS (
+  SELECT k, (ts).time, (ts).value AS length
+  FROM (SELECT k, timeSplitLength(temp, '5 min') AS ts FROM tbl_tgeompoint3D) t ),
+split AS (
+  SELECT k, (sp).time, length((sp).temp) AS length
+  FROM (SELECT k, timeSplit(temp, '5 min') AS sp FROM tbl_tgeompoint3D) t )
+SELECT COUNT(*) FROM agg FULL OUTER JOIN split
+  ON agg.k = split.k AND agg.time = split.time
+WHERE agg.k IS NULL OR split.k IS NULL OR
+  abs(agg.length - split.length) > 1e-6;
+
+-------------------------------------------------------------------------------
 
@@ -819,4 +819,26 @@ SELECT shortestLine(tgeompoint 'Point(1 1)@2000-01-01', tgeompoint 'Point(1 1 1)
 SELECT shortestLine(geography 'Linestring(90 0 0,0 90 100)', tgeogpoint 'Point(-90 0 100)@2000-01-01');
 SELECT shortestLine(tgeogpoint 'Point(-90 0 100)@2000-01-01', geography 'Linestring(90 0 0,0 90 100)');
 
+-- Long sequences
+SELECT round(NearestApproachDistance(tgeompointSeq(array_agg(tgeompoint(ST_Point(i, 0), timestamptz '2000-01-01' + i * interval '1 minute') ORDER BY i)), geometry 'Point(100.5 5)')::numeric, 6) FROM generate_series(1, 200) i;
+SELECT asText(NearestApproachInstant(tgeompointSeq(array_agg(tgeompoint(ST_Point(i, 0), timestamptz '2000-01-01' + i * interval '1 minute') ORDER BY i)), geometry 'Point(100.5 5)')) FROM generate_series(1, 200) i;
+SELECT ST_AsText(shortestLine(tgeompointSeq(array_agg(tgeompoint(ST_Point(i, 0), timestamptz '2000-01-01' + i * interval '1 minute') ORDER BY i)), geometry 'Point(100.5 5)')) FROM generate_series(1, 200) i;
+
+-- Long sequence going around the geometry before getting closer to it in a
+-- later block of segments
+WITH seq AS (SELECT tgeompointSeq(array_agg(tgeompoint(CASE WHEN i <= 64
+    THEN ST_Point(50 + 10 * cos(2 * pi() * i / 64), 50 + 10 * sin(2 * pi() * i / 64))
+    ELSE ST_Point(i - 11, 50) END,
+    timestamptz '2000-01-01' + i * interval '1 minute') ORDER BY i)) AS temp
+  FROM generate_series(0, 130) i)
+SELECT round(NearestApproachDistance(temp, geometry 'Point(50 50)')::numeric, 6),
+  round(ST_Distance(trajectory(temp), geometry 'Point(50 50)')::numeric, 6)
+FROM seq;
+WITH seq AS (SELECT tgeompointSeq(array_agg(tgeompoint(CASE WHEN i <= 64
+    THEN ST_Point(50 + 10 * cos(2 * pi() * i / 64), 50 + 10 * sin(2 * pi() * i / 64))
+    ELSE ST_Point(i - 11, 50) END,
+    timestamptz '2000-01-01' + i * interval '1 minute') ORDER BY i)) AS temp
+  FROM generate_series(0, 130) i)
+SELECT asText(NearestApproachInstant(temp, geometry 'Point(50 50)')) FROM seq;
+
 --------------------------------------------------------
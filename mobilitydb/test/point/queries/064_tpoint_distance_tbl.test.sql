@@ -166,6 +166,84 @@ SELECT COUNT(*) FROM tbl_tgeogpoint3D t1,
 ( SELECT * FROM tbl_tgeogpoint3D LIMIT 10 ) t2
 WHERE shortestLine(t1.temp, t2.temp) IS NOT NULL;
 
+-- Nearest approach distance on coordinate arrays compared with the
+-- minimum of the temporal distance
+SELECT COUNT(*) FROM tbl_tgeompoint t1, tbl_tgeompoint t2
+WHERE abs((t1.temp |=| t2.temp) - minValue(t1.temp <-> t2.temp)) > 1e-6;
+SELECT COUNT(*) FROM tbl_tgeompoint3D t1, tbl_tgeompoint3D t2
+WHERE abs((t1.temp |=| t2.temp) - minValue(t1.temp <-> t2.temp)) > 1e-6;
+
+-- Nearest approach instant on coordinate arrays compared with the nearest
+-- approach distance
+SELECT COUNT(*) FROM tbl_tgeompoint t1, tbl_tgeompoint t2
+WHERE abs(valueAtTimestamp(t1.temp <-> t2.temp,
+  getTimestamp(nearestApproachInstant(t1.temp, t2.temp))) -
+  (t1.temp |=| t2.temp)) > 1e-6;
+SELECT COUNT(*) FROM tbl_tgeompoint3D t1, tbl_tgeompoint3D t2
+WHERE abs(valueAtTimestamp(t1.temp <-> t2.temp,
+  getTimestamp(nearestApproachInstant(t1.temp, t2.temp))) -
+  (t1.temp |=| t2.temp)) > 1e-6;
+
+-- Prepared geographies, ordering the rows by geography so that the same value
+-- is received in consecutive calls, compared with the rows ordered by temporal
+-- point so that the geography changes at every call
+WITH geo AS (SELECT k, g FROM tbl_geography WHERE k % 10 = 1),
+  cached AS (SELECT k1, k2, nearestApproachDistance(temp, g) AS r FROM
+    (SELECT t.k AS k1, geo.k AS k2, temp, g FROM tbl_tgeogpoint t, geo
+     ORDER BY geo.k, t.k OFFSET 0) s),
+  uncached AS (SELECT k1, k2, nearestApproachDistance(temp, g) AS r FROM
+    (SELECT t.k AS k1, geo.k AS k2, temp, g FROM tbl_tgeogpoint t, geo
+     ORDER BY t.k, geo.k OFFSET 0) s)
+SELECT COUNT(*) FROM cached c JOIN uncached u USING (k1, k2)
+WHERE c.r IS DISTINCT FROM u.r;
+WITH geo AS (SELECT k, g FROM tbl_geography WHERE k % 10 = 1),
+  cached AS (SELECT k1, k2, nearestApproachDistance(g, temp) AS r FROM
+    (SELECT t.k AS k1, geo.k AS k2, temp, g FROM tbl_tgeogpoint t, geo
+     ORDER BY geo.k, t.k OFFSET 0) s),
+  uncached AS (SELECT k1, k2, nearestApproachDistance(g, temp) AS r FROM
+    (SELECT t.k AS k1, geo.k AS k2, temp, g FROM tbl_tgeogpoint t, geo
+     ORDER BY t.k, geo.k OFFSET 0) s)
+SELECT COUNT(*) FROM cached c JOIN uncached u USING (k1, k2)
+WHERE c.r IS DISTINCT FROM u.r;
+WITH geo AS (SELECT k, g FROM tbl_geography WHERE k % 10 = 1),
+  cached AS (SELECT k1, k2, nearestApproachInstant(temp, g) AS r FROM
+    (SELECT t.k AS k1, geo.k AS k2, temp, g FROM tbl_tgeogpoint t, geo
+     ORDER BY geo.k, t.k OFFSET 0) s),
+  uncached AS (SELECT k1, k2, nearestApproachInstant(temp, g) AS r FROM
+    (SELECT t.k AS k1, geo.k AS k2, temp, g FROM tbl_tgeogpoint t, geo
+     ORDER BY t.k, geo.k OFFSET 0) s)
+SELECT COUNT(*) FROM cached c JOIN uncached u USING (k1, k2)
+WHERE c.r IS DISTINCT FROM u.r;
+WITH geo AS (SELECT k, g FROM tbl_geography WHERE k % 10 = 1),
+  cached AS (SELECT k1, k2, nearestApproachInstant(g, temp) AS r FROM
+    (SELECT t.k AS k1, geo.k AS k2, temp, g FROM tbl_tgeogpoint t, geo
+     ORDER BY geo.k, t.k OFFSET 0) s),
+  uncached AS (SELECT k1, k2, nearestApproachInstant(g, temp) AS r FROM
+    (SELECT t.k AS k1, geo.k AS k2, temp, g FROM tbl_tgeogpoint t, geo
+     ORDER BY t.k, geo.k OFFSET 0) s)
+SELECT COUNT(*) FROM cached c JOIN uncached u USING (k1, k2)
+WHERE c.r IS DISTINCT FROM u.r;
+
+-- Nearest approach distance on the sphere, with the geography prepared in the
+-- cache of the function or for a single call, compared with the distance of
+-- the trajectory on the sphere and with the distance on the spheroid
+WITH geo AS (SELECT k, g FROM tbl_geography WHERE k % 10 = 1),
+  cached AS (SELECT k1, k2, nearestApproachDistance(temp, g, false) AS r FROM
+    (SELECT t.k AS k1, geo.k AS k2, temp, g FROM tbl_tgeogpoint t, geo
+     ORDER BY geo.k, t.k OFFSET 0) s),
+  uncached AS (SELECT k1, k2, nearestApproachDistance(temp, g, false) AS r FROM
+    (SELECT t.k AS k1, geo.k AS k2, temp, g FROM tbl_tgeogpoint t, geo
+     ORDER BY t.k, geo.k OFFSET 0) s)
+SELECT COUNT(*) FROM cached c JOIN uncached u USING (k1, k2)
+WHERE c.r IS DISTINCT FROM u.r;
+SELECT COUNT(*) FROM tbl_tgeogpoint t,
+  (SELECT g FROM tbl_geography WHERE k % 10 = 1) geo
+WHERE abs(nearestApproachDistance(g, temp, false) -
+  ST_Distance(trajectory(temp), g, false)) > 1e-3;
+SELECT COUNT(*) > 0 FROM tbl_tgeogpoint t,
+  (SELECT g FROM tbl_geography WHERE k % 10 = 1) geo
+WHERE nearestApproachDistance(temp, g, false) <> (temp |=| g);
+
 --------------------------------------------------------
 
 -- set parallel_tuple_cost=100;
@@ -186,4 +186,45 @@ temp2(seq) AS (
   GROUP BY k / 3)
 SELECT numInstants(appendSequence(seq ORDER BY seq)) FROM temp2;
 
+-- Long sequences built with an expandable structure, including instants
+-- removed by normalization, maintain their segment index while appending and
+-- keep it when compacted, so that they have the same size as those built in
+-- one call
+WITH temp1(k, inst) AS (
+  SELECT k, tgeompoint(ST_Point(k, CASE WHEN k < 1500 THEN k % 2 ELSE 0 END),
+    timestamptz '2000-01-01' + k * interval '1 minute')
+  FROM generate_series(0, 1599) AS k ),
+temp2(seq1, seq2) AS (
+  SELECT appendInstant(inst ORDER BY k), tgeompointSeq(array_agg(inst ORDER BY k))
+  FROM temp1 )
+SELECT numInstants(seq1), numInstants(seq1) = numInstants(seq2) FROM temp2;
+WITH temp1(k, inst) AS (
+  SELECT k, tgeompoint(ST_Point(k, CASE WHEN k < 1500 THEN k % 2 ELSE 0 END),
+    timestamptz '2000-01-01' + k * interval '1 minute')
+  FROM generate_series(0, 1599) AS k ),
+temp2(seq1, seq2) AS (
+  SELECT appendInstant(inst ORDER BY k), tgeompointSeq(array_agg(inst ORDER BY k))
+  FROM temp1 )
+SELECT memSize(seq1) = memSize(seq2) FROM temp2;
+WITH temp1(k, inst) AS (
+  SELECT k, tgeompoint(ST_Point(k, CASE WHEN k < 1500 THEN k % 2 ELSE 0 END),
+    timestamptz '2000-01-01' + k * interval '1 minute')
+  FROM generate_series(0, 1599) AS k ),
+temp2(seq1, seq2) AS (
+  SELECT appendInstant(inst ORDER BY k), tgeompointSeq(array_agg(inst ORDER BY k))
+  FROM temp1 )
+SELECT numInstants(atStbox(seq1, stbox 'STBOX X((100,0),(110,1))')),
+  atStbox(seq1, stbox 'STBOX X((100,0),(110,1))') = atStbox(seq2, stbox 'STBOX X((100,0),(110,1))')
+FROM temp2;
+WITH temp1(k, inst) AS (
+  SELECT k, tgeompoint(ST_Point(k, CASE WHEN k < 1500 THEN k % 2 ELSE 0 END),
+    timestamptz '2000-01-01' + k * interval '1 minute')
+  FROM generate_series(0, 1599) AS k ),
+temp2(seq1, seq2) AS (
+  SELECT appendInstant(inst ORDER BY k), tgeompointSeq(array_agg(inst ORDER BY k))
+  FROM temp1 )
+SELECT numInstants(atStbox(seq1, stbox 'STBOX X((1550,0),(1560,1))')),
+  atStbox(seq1, stbox 'STBOX X((1550,0),(1560,1))') = atStbox(seq2, stbox 'STBOX X((1550,0),(1560,1))')
+FROM temp2;
+
 -------------------------------------------------------------------------------
@@ -523,4 +523,45 @@ SELECT eDwithin(geography 'SRID=4283;Point(1 1)', tgeogpoint 'Point(1 1)@2000-01
 SELECT eDwithin(tgeogpoint 'Point(1 1)@2000-01-01', geography 'SRID=4283;Point(1 1)', 2);
 SELECT eDwithin(tgeogpoint 'SRID=4283;Point(1 1)@2000-01-01', tgeogpoint 'Point(1 1)@2000-01-01', 2);
 
+-- Repeated geometry, prepared after the first call
+WITH temp(trip) AS (
+  SELECT tgeompoint(ST_Point(i, i), timestamptz '2000-01-01')
+  FROM generate_series(1, 10) i )
+SELECT COUNT(*) FROM temp
+WHERE eIntersects(trip, geometry 'Polygon((0 0,0 5,5 5,5 0,0 0))');
+WITH temp(trip) AS (
+  SELECT tgeompoint(ST_Point(i, i), timestamptz '2000-01-01')
+  FROM generate_series(1, 10) i )
+SELECT COUNT(*) FROM temp
+WHERE aContains(geometry 'Polygon((0 0,0 5,5 5,5 0,0 0))', trip);
+WITH temp(trip) AS (
+  SELECT tgeompoint(ST_Point(i, i), timestamptz '2000-01-01')
+  FROM generate_series(1, 10) i )
+SELECT COUNT(*) FROM temp
+WHERE eDisjoint(trip, geometry 'Polygon((0 0,0 5,5 5,5 0,0 0))');
+WITH temp(trip) AS (
+  SELECT tgeompointSeq(ARRAY[tgeompoint(ST_Point(i, 1), timestamptz '2000-01-01'),
+    tgeompoint(ST_Point(i, 2), timestamptz '2000-01-02')])
+  FROM generate_series(1, 10) i )
+SELECT COUNT(*) FROM temp
+WHERE aIntersects(trip, geometry 'Polygon((0 0,0 5,5 5,5 0,0 0))');
+WITH temp(trip) AS (
+  SELECT tgeompointSeq(ARRAY[tgeompoint(ST_Point(i, 1), timestamptz '2000-01-01'),
+    tgeompoint(ST_Point(i, 2), timestamptz '2000-01-02')])
+  FROM generate_series(1, 10) i )
+SELECT COUNT(*) FROM temp
+WHERE aDisjoint(geometry 'Polygon((0 0,0 5,5 5,5 0,0 0))', trip);
+
+-- Segment by segment evaluation
+SELECT eIntersects(tgeompoint '[Point(1.5 1)@2000-01-01, Point(2.5 1)@2000-01-02]', geometry 'Polygon((0 0,0 2,4 2,4 0,0 0),(1 0.5,1 1.5,3 1.5,3 0.5,1 0.5))');
+SELECT eIntersects(tgeompoint '[Point(1.5 1)@2000-01-01, Point(3.5 1)@2000-01-02]', geometry 'Polygon((0 0,0 2,4 2,4 0,0 0),(1 0.5,1 1.5,3 1.5,3 0.5,1 0.5))');
+SELECT eContains(geometry 'Polygon((0 0,0 2,4 2,4 0,0 0),(1 0.5,1 1.5,3 1.5,3 0.5,1 0.5))', tgeompoint '[Point(1 1)@2000-01-01, Point(1 1.5)@2000-01-02, Point(3 1.5)@2000-01-03]');
+SELECT eDwithin(tgeompoint '[Point(0 3)@2000-01-01, Point(4 3)@2000-01-02]', geometry 'Linestring(2 0,2 2)', 1);
+SELECT eDwithin(tgeompoint '[Point(0 3)@2000-01-01, Point(4 3)@2000-01-02]', geometry 'Linestring(2 0,2 2)', 0.5);
+
+-- Temporal points traversed without synchronization
+SELECT eDwithin(tgeompoint '{[Point(0 0)@2000-01-01, Point(10 0)@2000-01-11], [Point(11 5)@2000-01-12, Point(21 5)@2000-01-22]}', tgeompoint '[Point(0 4)@2000-01-01, Point(21 4)@2000-01-22]', 1);
+SELECT eDwithin(tgeompoint '{[Point(0 0)@2000-01-01, Point(10 0)@2000-01-11], [Point(11 5)@2000-01-12, Point(21 5)@2000-01-22]}', tgeompoint '[Point(0 4)@2000-01-01, Point(21 4)@2000-01-22]', 0.5);
+SELECT aDwithin(tgeompoint '{[Point(0 0)@2000-01-01, Point(10 0)@2000-01-11], [Point(11 5)@2000-01-12, Point(21 5)@2000-01-22]}', tgeompoint '[Point(0 4)@2000-01-01, Point(21 4)@2000-01-22]', 4);
+SELECT aDwithin(tgeompoint '{[Point(0 0)@2000-01-01, Point(10 0)@2000-01-11], [Point(11 5)@2000-01-12, Point(21 5)@2000-01-22]}', tgeompoint '[Point(0 4)@2000-01-01, Point(21 4)@2000-01-22]', 3);
 -------------------------------------------------------------------------------
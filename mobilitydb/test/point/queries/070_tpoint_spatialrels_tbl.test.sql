@@ -245,6 +245,46 @@ SELECT COUNT(*) FROM tbl_tgeogpoint WHERE eDwithin(temp, tgeogpoint '[Point(0 0)
 -- PostGIS ST_Buffer() function which is performed by GEOS
 SELECT COUNT(*) FROM tbl_tgeogpoint WHERE aDwithin(temp, tgeogpoint '[Point(0 0)@2001-01-01, Point(5 5)@2001-02-01]', 5);
 
+-- Test the rewriting of the ever/always comparisons of temporal relationships
+
+SELECT COUNT(*) FROM tbl_tgeompoint WHERE tContains(geometry 'Polygon((0 0,0 5,5 5,5 0,0 0))', temp) ?= true;
+SELECT COUNT(*) FROM tbl_tgeompoint WHERE tContains(geometry 'Polygon((0 0,0 5,5 5,5 0,0 0))', temp) %= true;
+SELECT COUNT(*) FROM tbl_tgeompoint WHERE tIntersects(temp, geometry 'Linestring(0 0,5 5)') ?= true;
+SELECT COUNT(*) FROM tbl_tgeompoint WHERE true ?= tIntersects(geometry 'Linestring(0 0,5 5)', temp);
+SELECT COUNT(*) FROM tbl_tgeompoint WHERE tIntersects(temp, geometry 'Linestring(0 0,5 5)') %= true;
+SELECT COUNT(*) FROM tbl_tgeompoint WHERE tTouches(temp, geometry 'Linestring(0 0,5 5)') ?= true;
+SELECT COUNT(*) FROM tbl_tgeompoint WHERE tDwithin(temp, geometry 'Linestring(0 0,15 15)', 5) ?= true;
+SELECT COUNT(*) FROM tbl_tgeompoint WHERE tDwithin(geometry 'Linestring(0 0,5 5)', temp, 5) ?= true;
+SELECT COUNT(*) FROM tbl_tgeompoint WHERE tDwithin(temp, geometry 'Linestring(0 0,15 15)', 5) %= true;
+SELECT COUNT(*) FROM tbl_tgeompoint WHERE atTime(tIntersects(temp, geometry 'Linestring(0 0,5 5)'), tstzspan '[2001-01-01, 2001-06-01]') ?= true;
+SELECT COUNT(*) FROM tbl_tgeompoint WHERE atTime(tContains(geometry 'Polygon((0 0,0 5,5 5,5 0,0 0))', temp), tstzspan '[2001-01-01, 2001-06-01]') %= true;
+
+CREATE FUNCTION plan_has_index_cond(query text)
+RETURNS boolean AS $$
+DECLARE
+  line text;
+BEGIN
+  FOR line IN EXECUTE 'EXPLAIN (COSTS OFF) ' || query LOOP
+    IF line LIKE '%Index Cond%' THEN
+      RETURN true;
+    END IF;
+  END LOOP;
+  RETURN false;
+END;
+$$ LANGUAGE plpgsql;
+
+SET enable_seqscan = off;
+SELECT plan_has_index_cond('SELECT * FROM tbl_tgeompoint WHERE tIntersects(temp, geometry ''Linestring(0 0,5 5)'') ?= true');
+SELECT plan_has_index_cond('SELECT * FROM tbl_tgeompoint WHERE tDwithin(temp, geometry ''Linestring(0 0,15 15)'', 5) ?= true');
+SELECT plan_has_index_cond('SELECT * FROM tbl_tgeompoint WHERE tDwithin(temp, geometry ''Linestring(0 0,15 15)'', 5) %= true');
+SELECT plan_has_index_cond('SELECT * FROM tbl_tgeompoint WHERE tDwithin(temp, geometry ''Linestring(0 0,15 15)'', 5, true) ?= true');
+SELECT plan_has_index_cond('SELECT * FROM tbl_tgeompoint WHERE atTime(tDwithin(temp, geometry ''Linestring(0 0,15 15)'', 5), tstzspan ''[2001-01-01, 2001-06-01]'') ?= true');
+SELECT plan_has_index_cond('SELECT * FROM tbl_tgeompoint WHERE atTime(tDwithin(temp, geometry ''Linestring(0 0,15 15)'', 5), tstzspan ''[2001-01-01, 2001-06-01]'') %= true');
+SELECT plan_has_index_cond('SELECT * FROM tbl_tgeompoint WHERE nearestApproachDistance(temp, geometry ''Linestring(0 0,15 15)'') < 5');
+RESET enable_seqscan;
+
+DROP FUNCTION plan_has_index_cond;
+
 DROP INDEX tbl_tgeompoint_rtree_idx;
 DROP INDEX tbl_tgeogpoint_rtree_idx;
 
@@ -315,6 +355,86 @@ SELECT COUNT(*) FROM tbl_tgeogpoint WHERE aDwithin(temp, tgeogpoint '[Point(0 0)
 DROP INDEX tbl_tgeompoint_quadtree_idx;
 DROP INDEX tbl_tgeogpoint_quadtree_idx;
 
+-- Prepared geometry shared by all the rows compared with a geometry that
+-- alternates between two serializations and is thus never prepared
+SELECT COUNT(*) FROM tbl_tgeompoint_seqset,
+  (SELECT geometry 'Polygon((20 20,20 80,50 50,80 80,80 20,20 20))' AS g) t
+  WHERE eIntersects(ts, g) IS DISTINCT FROM
+    eIntersects(ts, CASE WHEN k % 2 = 0 THEN g ELSE ST_DropBBox(g) END);
+SELECT COUNT(*) FROM tbl_tgeompoint_seqset,
+  (SELECT geometry 'Polygon((20 20,20 80,50 50,80 80,80 20,20 20))' AS g) t
+  WHERE aDisjoint(ts, g) IS DISTINCT FROM
+    aDisjoint(ts, CASE WHEN k % 2 = 0 THEN g ELSE ST_DropBBox(g) END);
+SELECT COUNT(*) FROM tbl_tgeompoint,
+  (SELECT geometry 'Linestring(10 10,30 60,60 30,90 90)' AS g) t
+  WHERE eIntersects(temp, g) IS DISTINCT FROM
+    eIntersects(temp, CASE WHEN k % 2 = 0 THEN g ELSE ST_DropBBox(g) END);
+SELECT COUNT(*) FROM tbl_tgeompoint,
+  (SELECT geometry 'Linestring(10 10,30 60,60 30,90 90)' AS g) t
+  WHERE aDisjoint(temp, g) IS DISTINCT FROM
+    aDisjoint(temp, CASE WHEN k % 2 = 0 THEN g ELSE ST_DropBBox(g) END);
+
+-- Pairs of two arrays compared with the nested loop
+WITH arr AS (SELECT array_agg(temp ORDER BY k) AS a FROM tbl_tgeompoint),
+  pairs AS (SELECT (eDwithinPairs(a, a, 5)).* FROM arr),
+  nums AS (SELECT row_number() OVER (ORDER BY k) AS n, temp FROM tbl_tgeompoint),
+  nested AS (SELECT t1.n AS index1, t2.n AS index2 FROM nums t1, nums t2
+    WHERE eDwithin(t1.temp, t2.temp, 5))
+SELECT COUNT(*) FROM ((TABLE pairs EXCEPT TABLE nested) UNION ALL
+  (TABLE nested EXCEPT TABLE pairs)) t;
+
+-- Every temporal point is within the distance of itself
+WITH arr AS (SELECT array_agg(temp ORDER BY k) AS a FROM tbl_tgeompoint)
+SELECT COUNT(*) >= (SELECT COUNT(*) FROM tbl_tgeompoint)
+FROM arr, eDwithinPairs(a, a, 5);
+
+-- No pair
+WITH arr AS (SELECT array_agg(temp ORDER BY k) AS a FROM tbl_tgeompoint)
+SELECT COUNT(*) FROM arr,
+  eDwithinPairs(ARRAY[tgeompoint 'Point(1000 1000)@2001-01-01'], a, 5);
+SELECT COUNT(*) FROM eDwithinPairs(ARRAY[]::tgeompoint[],
+  ARRAY[tgeompoint 'Point(1 1)@2001-01-01'], 5);
+
+-- Partition-based join compared with the nested loop
+WITH arr AS (SELECT array_agg(temp ORDER BY k) AS a FROM tbl_tgeompoint),
+  pairs AS (SELECT (dwithinJoin(a, a, 5, 10, 10)).* FROM arr),
+  nums AS (SELECT row_number() OVER (ORDER BY k) AS n, temp FROM tbl_tgeompoint),
+  nested AS (SELECT t1.n AS index1, t2.n AS index2 FROM nums t1, nums t2
+    WHERE eDwithin(t1.temp, t2.temp, 5))
+SELECT COUNT(*) FROM ((TABLE pairs EXCEPT TABLE nested) UNION ALL
+  (TABLE nested EXCEPT TABLE pairs)) t;
+WITH arr AS (SELECT array_agg(temp ORDER BY k) AS a FROM tbl_tgeompoint),
+  pairs AS (SELECT (dwithinJoin(a, a, 5, 7, 3, '30 days')).* FROM arr),
+  nums AS (SELECT row_number() OVER (ORDER BY k) AS n, temp FROM tbl_tgeompoint),
+  nested AS (SELECT t1.n AS index1, t2.n AS index2 FROM nums t1, nums t2
+    WHERE eDwithin(t1.temp, t2.temp, 5))
+SELECT COUNT(*) FROM ((TABLE pairs EXCEPT TABLE nested) UNION ALL
+  (TABLE nested EXCEPT TABLE pairs)) t;
+
+-- Pairs whose boxes span several tiles are returned once
+WITH arr AS (SELECT array_agg(temp ORDER BY k) AS a FROM tbl_tgeompoint),
+  pairs AS (SELECT (dwithinJoin(a, a, 5, 5, 5, '30 days')).* FROM arr)
+SELECT COUNT(*) FROM (SELECT index1, index2 FROM pairs
+  GROUP BY index1, index2 HAVING COUNT(*) > 1) t;
+SELECT * FROM dwithinJoin(
+  ARRAY[tgeompoint '[Point(9 5)@2001-01-01, Point(11 5)@2001-01-02]',
+    tgeompoint '[Point(9.5 9.5)@2001-01-01, Point(10.5 10.5)@2001-01-02]'],
+  ARRAY[tgeompoint '[Point(11 5)@2001-01-01, Point(9 5)@2001-01-02]',
+    tgeompoint '[Point(10.5 9.5)@2001-01-01, Point(9.5 10.5)@2001-01-02]'],
+  0.5, 10, 10, '1 day');
+
+-- Tiles without any pair between two clusters
+SELECT * FROM dwithinJoin(
+  ARRAY[tgeompoint '[Point(0 0)@2001-01-01, Point(1 1)@2001-01-02]',
+    tgeompoint '[Point(99 99)@2001-01-01, Point(100 100)@2001-01-02]'],
+  ARRAY[tgeompoint '[Point(1 0)@2001-01-01, Point(0 1)@2001-01-02]',
+    tgeompoint '[Point(100 99)@2001-01-01, Point(99 100)@2001-01-02]'],
+  1, 1, 1);
+SELECT COUNT(*) FROM dwithinJoin(
+  ARRAY[tgeompoint '[Point(0 0)@2001-01-01, Point(1 1)@2001-01-02]'],
+  ARRAY[tgeompoint '[Point(100 100)@2001-01-01, Point(99 99)@2001-01-02]'],
+  1, 1, 1);
+
 -------------------------------------------------------------------------------
 
 -- END;
@@ -198,6 +198,59 @@ SELECT COUNT(*) FROM tbl_tgeompoint t1, tbl_tgeompoint3D t2
 SELECT COUNT(*) FROM tbl_tgeompoint3D t1, tbl_tgeompoint t2
   WHERE tDwithin(t1.temp, t2.temp, 10) ?= true <> edwithin(t1.temp, t2.temp, 10);
 
+-- Prepared geometry shared by all the rows compared with a geometry that
+-- alternates between two serializations and is thus never prepared
+
+SELECT COUNT(*) FROM tbl_tgeompoint_seqset,
+  (SELECT geometry 'Polygon((20 20,20 80,50 50,80 80,80 20,20 20))' AS g) t
+  WHERE tIntersects(ts, g) IS DISTINCT FROM
+    tIntersects(ts, CASE WHEN k % 2 = 0 THEN g ELSE ST_DropBBox(g) END);
+SELECT COUNT(*) FROM tbl_tgeompoint_seqset,
+  (SELECT geometry 'Polygon((20 20,20 80,50 50,80 80,80 20,20 20))' AS g) t
+  WHERE tDisjoint(ts, g) IS DISTINCT FROM
+    tDisjoint(ts, CASE WHEN k % 2 = 0 THEN g ELSE ST_DropBBox(g) END);
+
+-- Geometry with many vertices intersected tile by tile
+SELECT COUNT(*) FROM tbl_tgeompoint,
+  (SELECT ST_MakeLine(ARRAY(SELECT ST_Point(i / 50.0, 50 + 40 * sin(i / 100.0))
+    FROM generate_series(0, 5000) AS i)) AS g) t
+  WHERE tIntersects(temp, g) ?= true <> eIntersects(temp, g);
+SELECT COUNT(*) FROM tbl_tgeompoint_seqset,
+  (SELECT ST_MakeLine(ARRAY(SELECT ST_Point(i / 50.0, 50 + 40 * sin(i / 100.0))
+    FROM generate_series(0, 5000) AS i)) AS g) t
+  WHERE tIntersects(ts, g) ?= true <> eIntersects(ts, g);
+
+-- Pairs of two arrays compared with the nested loop
+WITH arr AS (SELECT array_agg(temp ORDER BY k) AS a FROM tbl_tgeompoint),
+  pairs AS (SELECT (tDwithinPairs(a, a, 5)).* FROM arr),
+  nums AS (SELECT row_number() OVER (ORDER BY k) AS n, temp FROM tbl_tgeompoint),
+  nested AS (SELECT t1.n AS index1, t2.n AS index2,
+    tDwithin(t1.temp, t2.temp, 5) AS tdwithin FROM nums t1, nums t2)
+SELECT COUNT(*) FROM pairs FULL OUTER JOIN
+  (SELECT * FROM nested WHERE tdwithin IS NOT NULL) n USING (index1, index2)
+WHERE pairs.tdwithin IS DISTINCT FROM n.tdwithin;
+WITH arr AS (SELECT array_agg(temp ORDER BY k) AS a FROM tbl_tgeompoint),
+  pairs AS (SELECT (tDwithinPairs(a, a, 5, true)).* FROM arr),
+  nums AS (SELECT row_number() OVER (ORDER BY k) AS n, temp FROM tbl_tgeompoint),
+  nested AS (SELECT t1.n AS index1, t2.n AS index2,
+    tDwithin(t1.temp, t2.temp, 5, true) AS tdwithin FROM nums t1, nums t2)
+SELECT COUNT(*) FROM pairs FULL OUTER JOIN
+  (SELECT * FROM nested WHERE tdwithin IS NOT NULL) n USING (index1, index2)
+WHERE pairs.tdwithin IS DISTINCT FROM n.tdwithin;
+WITH arr AS (SELECT array_agg(temp ORDER BY k) AS a FROM tbl_tgeompoint),
+  pairs AS (SELECT (tDwithinPairs(a, a, 5, false)).* FROM arr),
+  nums AS (SELECT row_number() OVER (ORDER BY k) AS n, temp FROM tbl_tgeompoint),
+  nested AS (SELECT t1.n AS index1, t2.n AS index2,
+    tDwithin(t1.temp, t2.temp, 5, false) AS tdwithin FROM nums t1, nums t2)
+SELECT COUNT(*) FROM pairs FULL OUTER JOIN
+  (SELECT * FROM nested WHERE tdwithin IS NOT NULL) n USING (index1, index2)
+WHERE pairs.tdwithin IS DISTINCT FROM n.tdwithin;
+
+-- The pairs that do not intersect in time have no result
+SELECT COUNT(*) FROM tDwithinPairs(
+  ARRAY[tgeompoint '[Point(1 1)@2001-01-01, Point(2 2)@2001-01-02]'],
+  ARRAY[tgeompoint '[Point(1 1)@2002-01-01, Point(2 2)@2002-01-02]'], 5);
+
 -------------------------------------------------------------------------------
 -- END;
 -- $$ LANGUAGE plpgsql;
@@ -219,6 +219,82 @@ SELECT asText(DouglasPeuckerSimplify(tgeompoint '[Point(1 1)@2000-01-01, Point(2
 
 -------------------------------------------------------------------------------
 
+-- Simplification with a budget of instants
+
+SELECT maxInstantsSimplify(tfloat '[1@2000-01-01, 3@2000-01-02, 2@2000-01-03, 7@2000-01-04, 5@2000-01-05, 9@2000-01-06, 4@2000-01-07]', 3);
+SELECT maxInstantsSimplify(tfloat '[1@2000-01-01, 3@2000-01-02, 2@2000-01-03, 7@2000-01-04, 5@2000-01-05, 9@2000-01-06, 4@2000-01-07]', 4);
+SELECT maxInstantsSimplify(tfloat '{[1@2000-01-01, 3@2000-01-02, 2@2000-01-03, 7@2000-01-04], [5@2000-01-05, 8@2000-01-06, 4@2000-01-07]}', 5);
+SELECT asText(maxInstantsSimplify(tgeompoint '[Point(0 0)@2000-01-01, Point(1 2)@2000-01-02, Point(2 1)@2000-01-03, Point(4 5)@2000-01-04, Point(5 3)@2000-01-05, Point(7 8)@2000-01-06, Point(9 4)@2000-01-07]', 4));
+
+SELECT visvalingamWhyattSimplify(tfloat '[1@2000-01-01, 3@2000-01-02, 2@2000-01-03, 7@2000-01-04, 5@2000-01-05, 9@2000-01-06, 4@2000-01-07]', 3);
+SELECT visvalingamWhyattSimplify(tfloat '[1@2000-01-01, 3@2000-01-02, 2@2000-01-03, 7@2000-01-04, 5@2000-01-05, 9@2000-01-06, 4@2000-01-07]', 4);
+SELECT visvalingamWhyattSimplify(tfloat '{[1@2000-01-01, 3@2000-01-02, 2@2000-01-03, 7@2000-01-04], [5@2000-01-05, 8@2000-01-06, 4@2000-01-07]}', 5);
+SELECT asText(visvalingamWhyattSimplify(tgeompoint '[Point(0 0)@2000-01-01, Point(1 2)@2000-01-02, Point(2 1)@2000-01-03, Point(4 5)@2000-01-04, Point(5 3)@2000-01-05, Point(7 8)@2000-01-06, Point(9 4)@2000-01-07]', 4));
+
+-- No simplification, return a copy of the original temporal value
+SELECT maxInstantsSimplify(tfloat '[1@2000-01-01, 3@2000-01-02, 2@2000-01-03]', 3);
+SELECT visvalingamWhyattSimplify(tfloat 'Interp=Step;[1@2000-01-01, 3@2000-01-02, 2@2000-01-03]', 2);
+
+/* Errors */
+SELECT maxInstantsSimplify(tfloat '[1@2000-01-01, 3@2000-01-02, 2@2000-01-03, 7@2000-01-04, 5@2000-01-05, 9@2000-01-06, 4@2000-01-07]', 1);
+SELECT visvalingamWhyattSimplify(tfloat '[1@2000-01-01, 3@2000-01-02, 2@2000-01-03, 7@2000-01-04, 5@2000-01-05, 9@2000-01-06, 4@2000-01-07]', 1);
+
+-- Online simplification
+
+-- The opening window method gives the result of maxDistSimplify when the
+-- window does not overflow
+SELECT openingWindowSimplify(tfloat '[4@2000-01-01, 1@2000-01-02, 3@2000-01-03, 1@2000-01-04, 3@2000-01-05, 0@2000-01-06, 4@2000-01-07]', 2) = maxDistSimplify(tfloat '[4@2000-01-01, 1@2000-01-02, 3@2000-01-03, 1@2000-01-04, 3@2000-01-05, 0@2000-01-06, 4@2000-01-07]', 2);
+SELECT openingWindowSimplify(tfloat '{[1@2000-01-01, 3@2000-01-02, 2@2000-01-03, 7@2000-01-04], [5@2000-01-05, 8@2000-01-06, 4@2000-01-07]}', 2) = maxDistSimplify(tfloat '{[1@2000-01-01, 3@2000-01-02, 2@2000-01-03, 7@2000-01-04], [5@2000-01-05, 8@2000-01-06, 4@2000-01-07]}', 2);
+SELECT openingWindowSimplify(tgeompoint '[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(3 1)@2000-01-04]', 1) = maxDistSimplify(tgeompoint '[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(3 1)@2000-01-04]', 1);
+SELECT openingWindowSimplify(tgeompoint '[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(3 1)@2000-01-04]', 1, 64, false) = maxDistSimplify(tgeompoint '[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(3 1)@2000-01-04]', 1, false);
+-- An overflowing window keeps the bounds and a subset of the instants
+SELECT startInstant(temp1) = startInstant(temp) AND endInstant(temp1) = endInstant(temp) AND
+  timestamps(temp1) <@ timestamps(temp)
+FROM (SELECT temp, openingWindowSimplify(temp, 2, 4) AS temp1
+  FROM (SELECT tfloat '[4@2000-01-01, 1@2000-01-02, 3@2000-01-03, 1@2000-01-04, 3@2000-01-05, 0@2000-01-06, 4@2000-01-07]' AS temp) t) t;
+
+-- SQUISH-E keeps the bounds and every removed instant is within the
+-- distance of the simplified value
+SELECT startInstant(temp1) = startInstant(temp) AND endInstant(temp1) = endInstant(temp) AND
+  timestamps(temp1) <@ timestamps(temp)
+FROM (SELECT temp, squishESimplify(temp, 2) AS temp1
+  FROM (SELECT tfloat '[4@2000-01-01, 1@2000-01-02, 3@2000-01-03, 1@2000-01-04, 3@2000-01-05, 0@2000-01-06, 4@2000-01-07]' AS temp) t) t;
+SELECT MAX(abs(getValue(inst) - valueAtTimestamp(squishESimplify(tfloat '[4@2000-01-01, 1@2000-01-02, 3@2000-01-03, 1@2000-01-04, 3@2000-01-05, 0@2000-01-06, 4@2000-01-07]', 3), getTimestamp(inst)))) <= 3
+FROM unnest(instants(tfloat '[4@2000-01-01, 1@2000-01-02, 3@2000-01-03, 1@2000-01-04, 3@2000-01-05, 0@2000-01-06, 4@2000-01-07]')) AS inst;
+SELECT MAX(abs(getValue(inst) - valueAtTimestamp(squishESimplify(tfloat '[4@2000-01-01, 1@2000-01-02, 3@2000-01-03, 1@2000-01-04, 3@2000-01-05, 0@2000-01-06, 4@2000-01-07]', 3, 3), getTimestamp(inst)))) <= 3
+FROM unnest(instants(tfloat '[4@2000-01-01, 1@2000-01-02, 3@2000-01-03, 1@2000-01-04, 3@2000-01-05, 0@2000-01-06, 4@2000-01-07]')) AS inst;
+SELECT MAX(abs(getValue(inst) - valueAtTimestamp(squishESimplify(tfloat '{[1@2000-01-01, 3@2000-01-02, 2@2000-01-03, 7@2000-01-04], [5@2000-01-05, 8@2000-01-06, 4@2000-01-07]}', 2), getTimestamp(inst)))) <= 2
+FROM unnest(instants(tfloat '{[1@2000-01-01, 3@2000-01-02, 2@2000-01-03, 7@2000-01-04], [5@2000-01-05, 8@2000-01-06, 4@2000-01-07]}')) AS inst;
+SELECT MAX(ST_Distance(getValue(inst), valueAtTimestamp(squishESimplify(tgeompoint '[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(3 1)@2000-01-04]', 1), getTimestamp(inst)))) <= 1
+FROM unnest(instants(tgeompoint '[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(3 1)@2000-01-04]')) AS inst;
+SELECT MAX(ST_Distance(getValue(inst), trajectory(squishESimplify(tgeompoint '[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(3 1)@2000-01-04]', 1, 64, false)))) <= 1
+FROM unnest(instants(tgeompoint '[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(3 1)@2000-01-04]')) AS inst;
+
+-- No simplification, return a copy of the original temporal value
+SELECT squishESimplify(tfloat '4@2000-01-01', 1);
+SELECT openingWindowSimplify(tfloat 'Interp=Step;[4@2000-01-01, 1@2000-01-02, 3@2000-01-03]', 1);
+
+/* Errors */
+SELECT openingWindowSimplify(tfloat '[4@2000-01-01, 1@2000-01-02, 3@2000-01-03, 1@2000-01-04, 3@2000-01-05, 0@2000-01-06, 4@2000-01-07]', 2, 2);
+SELECT squishESimplify(tfloat '[4@2000-01-01, 1@2000-01-02, 3@2000-01-03, 1@2000-01-04, 3@2000-01-05, 0@2000-01-06, 4@2000-01-07]', -1);
+
+-- Level-of-detail pyramid
+
+SELECT array_agg(numInstants(l) ORDER BY n) FROM unnest(douglasPeuckerPyramid(tfloat '[4@2000-01-01, 1@2000-01-02, 3@2000-01-03, 1@2000-01-04, 3@2000-01-05, 0@2000-01-06, 4@2000-01-07]', 1, 3)) WITH ORDINALITY AS t(l, n);
+SELECT numInstants(pyramidLevel(douglasPeuckerPyramid(tfloat '[4@2000-01-01, 1@2000-01-02, 3@2000-01-03, 1@2000-01-04, 3@2000-01-05, 0@2000-01-06, 4@2000-01-07]', 1, 3), 1, 5));
+SELECT numInstants(pyramidLevel(douglasPeuckerPyramid(tfloat '[4@2000-01-01, 1@2000-01-02, 3@2000-01-03, 1@2000-01-04, 3@2000-01-05, 0@2000-01-06, 4@2000-01-07]', 1, 3), 1, 0.5));
+SELECT pyramidLevel(douglasPeuckerPyramid(tgeompoint '[Point(0 4)@2000-01-01, Point(1 1)@2000-01-02, Point(2 3)@2000-01-03, Point(3 1)@2000-01-04, Point(4 3)@2000-01-05, Point(5 0)@2000-01-06, Point(6 4)@2000-01-07]', 1.5, 2), 1.5, 3) = DouglasPeuckerSimplify(tgeompoint '[Point(0 4)@2000-01-01, Point(1 1)@2000-01-02, Point(2 3)@2000-01-03, Point(3 1)@2000-01-04, Point(4 3)@2000-01-05, Point(5 0)@2000-01-06, Point(6 4)@2000-01-07]', 3);
+SELECT pyramidLevel(douglasPeuckerPyramid(tgeompoint '{[Point(0 4)@2000-01-01, Point(1 1)@2000-01-02, Point(2 3)@2000-01-03, Point(3 1)@2000-01-04], [Point(4 3)@2000-01-05, Point(5 0)@2000-01-06, Point(6 4)@2000-01-07]}', 1, 3, false), 1, 4) = DouglasPeuckerSimplify(tgeompoint '{[Point(0 4)@2000-01-01, Point(1 1)@2000-01-02, Point(2 3)@2000-01-03, Point(3 1)@2000-01-04], [Point(4 3)@2000-01-05, Point(5 0)@2000-01-06, Point(6 4)@2000-01-07]}', 4, false);
+
+SELECT ST_AsText(round((mvt).geom, 6))
+FROM (SELECT asMVTGeom(douglasPeuckerPyramid(tgeompoint '[Point(0 0)@2000-01-01, Point(100 100)@2000-04-10]', 1, 4, false), 1,
+  stbox 'STBOX X((40,40),(60,60))') AS mvt ) AS t;
+
+/* Errors */
+SELECT douglasPeuckerPyramid(tfloat '[1@2000-01-01, 3@2000-01-02, 2@2000-01-03]', 1, 0);
+
+-------------------------------------------------------------------------------
+
 -- PostGIS 3.3 changed the output of MULTIPOINT
 -- SELECT ST_AsText(round((mvt).geom, 6))
 -- FROM (SELECT asMVTGeom(tgeompoint '{Point(0 0 0)@2000-01-01, Point(100 100 100)@2000-04-10}',
@@ -251,4 +327,29 @@ SELECT asMVTGeom(tgeompoint '[Point(0 0)@2000-01-01, Point(100 100)@2000-04-10]'
 SELECT asMVTGeom(tgeompoint '[Point(0 0)@2000-01-01, Point(100 100)@2000-04-10]',
   stbox 'STBOX X((40,40),(60,60))', 0);
 
+-- Encoding of arrays of temporal points
+
+SELECT * FROM asMVTCommands(ARRAY[
+  tgeompoint '[Point(45 45)@2000-01-01, Point(50 55)@2000-01-02, Point(55 50)@2000-01-03]',
+  tgeompoint '[Point(200 200)@2000-01-01, Point(300 300)@2000-01-02]',
+  tgeompoint '{Point(50 50)@2000-01-01, Point(55 55)@2000-01-02}'],
+  stbox 'STBOX X((40,40),(60,60))');
+SELECT * FROM asMVTCommands(ARRAY[
+  tgeompoint '[Point(200 200)@2000-01-01, Point(300 300)@2000-01-02]'],
+  stbox 'STBOX X((40,40),(60,60))', clip := false);
+SELECT * FROM asMVTCommands(ARRAY[
+  tgeompoint '[Point(200 200)@2000-01-01, Point(300 300)@2000-01-02]'],
+  stbox 'STBOX X((40,40),(60,60))');
+SELECT * FROM asMVTCommands(ARRAY[
+  tgeompoint '[Point(50 50)@2000-01-01, Point(100 50)@2000-01-11, Point(50 55)@2000-01-21]'],
+  stbox 'STBOX X((40,40),(60,60))');
+
+/* Errors */
+SELECT * FROM asMVTCommands(ARRAY[
+  tgeompoint '[Point(0 0)@2000-01-01, Point(100 100)@2000-04-10]'],
+  stbox 'STBOX X((40,40),(40,40))');
+SELECT * FROM asMVTCommands(ARRAY[
+  tgeompoint '[Point(0 0)@2000-01-01, Point(100 100)@2000-04-10]'],
+  stbox 'STBOX X((40,40),(60,60))', 0);
+
 -------------------------------------------------------------------------------
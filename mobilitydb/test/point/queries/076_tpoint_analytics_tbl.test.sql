@@ -102,12 +102,90 @@ SELECT MAX(numInstants(DouglasPeuckerSimplify(temp, 4))) FROM tbl_tfloat;
 SELECT MAX(numInstants(DouglasPeuckerSimplify(temp, 4))) FROM tbl_tgeompoint;
 SELECT MAX(numInstants(DouglasPeuckerSimplify(temp, 4, false))) FROM tbl_tgeompoint;
 
+-- Every removed instant is within the distance of the simplified value
+SELECT COUNT(*) FROM tbl_tgeompoint, unnest(instants(temp)) AS inst
+WHERE ST_Distance(getValue(inst),
+  trajectory(DouglasPeuckerSimplify(temp, 4, false))) > 4 + 1e-6;
+SELECT COUNT(*) FROM tbl_tgeompoint3D, unnest(instants(temp)) AS inst
+WHERE ST_3DDistance(getValue(inst),
+  trajectory(DouglasPeuckerSimplify(temp, 4, false))) > 4 + 1e-6;
+SELECT COUNT(*) FROM tbl_tgeompoint, unnest(instants(temp)) AS inst
+WHERE ST_Distance(getValue(inst), valueAtTimestamp(
+  DouglasPeuckerSimplify(temp, 4), getTimestamp(inst))) > 4 + 1e-6;
+SELECT COUNT(*) FROM tbl_tgeompoint3D, unnest(instants(temp)) AS inst
+WHERE ST_3DDistance(getValue(inst), valueAtTimestamp(
+  DouglasPeuckerSimplify(temp, 4), getTimestamp(inst))) > 4 + 1e-6;
+
+-- The opening window method is the single-pass Douglas-Peucker when the
+-- window does not overflow
+SELECT COUNT(*) FROM tbl_tfloat WHERE interp(temp) = 'Linear' AND
+  openingWindowSimplify(temp, 4, 1000) <> maxDistSimplify(temp, 4);
+SELECT COUNT(*) FROM tbl_tgeompoint WHERE interp(temp) = 'Linear' AND
+  openingWindowSimplify(temp, 4, 1000) <> maxDistSimplify(temp, 4);
+SELECT COUNT(*) FROM tbl_tgeompoint WHERE interp(temp) = 'Linear' AND
+  openingWindowSimplify(temp, 4, 1000, false) <> maxDistSimplify(temp, 4, false);
+SELECT COUNT(*) FROM tbl_tgeompoint3D WHERE interp(temp) = 'Linear' AND
+  openingWindowSimplify(temp, 4, 1000) <> maxDistSimplify(temp, 4);
+
+-- SQUISH-E keeps the bounds and every removed instant is within the
+-- Synchronized Euclidean Distance of the simplified value
+SELECT COUNT(*) FROM tbl_tgeompoint WHERE
+  startInstant(squishESimplify(temp, 4, 8)) <> startInstant(temp) OR
+  endInstant(squishESimplify(temp, 4, 8)) <> endInstant(temp);
+SELECT COUNT(*) FROM tbl_tfloat, unnest(instants(temp)) AS inst
+WHERE abs(getValue(inst) - valueAtTimestamp(
+  squishESimplify(temp, 4, 8), getTimestamp(inst))) > 4 + 1e-6;
+SELECT COUNT(*) FROM tbl_tgeompoint, unnest(instants(temp)) AS inst
+WHERE ST_Distance(getValue(inst), valueAtTimestamp(
+  squishESimplify(temp, 4, 8), getTimestamp(inst))) > 4 + 1e-6;
+SELECT COUNT(*) FROM tbl_tgeompoint3D, unnest(instants(temp)) AS inst
+WHERE ST_3DDistance(getValue(inst), valueAtTimestamp(
+  squishESimplify(temp, 4, 8), getTimestamp(inst))) > 4 + 1e-6;
+
 -------------------------------------------------------------------------------
 
 SELECT round(MAX(ST_Length((mvt).geom))::numeric, 6), MAX(array_length((mvt).times, 1))
 FROM (SELECT asMVTGeom(temp, stbox 'STBOX X((0,0),(50,50))') AS mvt
   FROM tbl_tgeompoint ) AS t;
 
+-- Away from the border of the tile, the lines encoded by asMVTCommands are
+-- those of asMVTGeom without the consecutive duplicate vertices
+WITH temps AS (
+  SELECT k, temp FROM tbl_tgeompoint
+  WHERE tempSubtype(temp) = 'Sequence' AND interp(temp) = 'Linear' AND
+    numInstants(temp) > 1 ),
+mvts AS (
+  SELECT k, asMVTGeom(temp, stbox 'STBOX X((-10,-10),(110,110))') AS mvt
+  FROM temps ),
+vertices AS (
+  SELECT k, n, ST_PointN((mvt).geom, n) AS point,
+    ST_PointN((mvt).geom, n - 1) AS prev, (mvt).times[n] AS t
+  FROM mvts, generate_series(1, ST_NPoints((mvt).geom)) AS n ),
+geoms AS (
+  SELECT k, ST_MakeLine(array_agg(point ORDER BY n)) AS geom,
+    array_agg(t ORDER BY n) AS times
+  FROM vertices
+  WHERE prev IS NULL OR NOT ST_Equals(point, prev)
+  GROUP BY k
+  HAVING COUNT(*) > 1 ),
+commands AS (
+  SELECT k, c.geom, c.times
+  FROM temps, asMVTCommands(ARRAY[temp],
+    stbox 'STBOX X((-10,-10),(110,110))') AS c ),
+decoded AS (
+  SELECT k, ST_MakeLine(array_agg(ST_Point(x, y) ORDER BY n)) AS geom, times
+  FROM (
+    SELECT k, n, times,
+      SUM((geom[i] >> 1) # -(geom[i] & 1)) OVER w AS x,
+      SUM((geom[i + 1] >> 1) # -(geom[i + 1] & 1)) OVER w AS y
+    FROM commands, generate_series(0, cardinality(times) - 1) AS n,
+      LATERAL (SELECT CASE WHEN n = 0 THEN 2 ELSE 3 + 2 * n END AS i) AS pos
+    WINDOW w AS (PARTITION BY k ORDER BY n) ) AS v
+  GROUP BY k, times )
+SELECT COUNT(*) FROM geoms g FULL OUTER JOIN decoded d ON g.k = d.k
+WHERE g.k IS NULL OR d.k IS NULL OR g.times <> d.times OR
+  ST_AsText(g.geom) <> ST_AsText(d.geom);
+
 -------------------------------------------------------------------------------
 
 -- set parallel_tuple_cost=100;